@@ -0,0 +1,54 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include "raylib.h"
+#include <stddef.h>
+
+#define ARENA_BLOCK_SIZE (1024 * 1024)  // Default bytes per block, larger allocations get a block of their own
+#define ARENA_ALIGNMENT 16              // Every allocation starts on this boundary (SIMD loads, mesh arrays)
+
+typedef struct ArenaBlock ArenaBlock;
+
+// Linear allocator over a chain of blocks. Allocations are never freed one by one, the whole arena is
+// reset at once and its blocks are handed out again, so an arena that is reset every cycle (a frame, a
+// scene load) stops calling malloc once it has grown to its peak. Not thread safe: one thread at a time.
+typedef struct MemoryArena {
+    ArenaBlock* first;
+    ArenaBlock* current;        // Block allocations come from, the ones after it are free
+    size_t blockSize;
+
+    // Statistics
+    size_t used;                // Bytes handed out since the last reset
+    size_t peak;                // Highest used since creation
+    size_t capacity;            // Bytes held in blocks
+    int allocCount;             // Allocations since the last reset
+    long long totalAllocs;
+    int blockCount;
+    long long blockMallocs;     // malloc calls made for blocks, steady once the arena is reused
+    int resetCount;
+} MemoryArena;
+
+// Create an empty arena (blockSize 0 uses ARENA_BLOCK_SIZE), blocks are allocated on first use
+MemoryArena* CreateArena(size_t blockSize);
+void UnloadArena(MemoryArena* arena);
+
+// ARENA_ALIGNMENT aligned memory valid until the next reset, NULL when out of memory
+void* ArenaAlloc(MemoryArena* arena, size_t size);
+void* ArenaCalloc(MemoryArena* arena, size_t count, size_t size);
+
+// Release every allocation at once and keep the blocks for the next cycle
+void ResetArena(MemoryArena* arena);
+
+// Release every allocation and free the blocks as well
+void ClearArena(MemoryArena* arena);
+
+// Allocate the vertex, texcoord, normal, color and 16-bit index arrays of a mesh and set its counts.
+// With an arena every array comes from one arena allocation and the mesh must be unloaded with
+// UnloadArenaModel, without one each array is a separate MemAlloc owned by raylib as usual.
+bool AllocMeshBuffers(Mesh* mesh, int vertexCount, int triangleCount, MemoryArena* arena);
+
+// Unload a model whose mesh arrays come from AllocMeshBuffers with an arena: GPU buffers and raylib's own
+// allocations are released, the arrays go with the arena
+void UnloadArenaModel(Model model);
+
+#endif // ARENA_H
@@ -2,11 +2,16 @@
 #define GAME_TYPES_H
 
 #include "raylib.h"
+#include <stddef.h>
 
 #define MAX_CUBES 50
 #define CUBE_SIZE 10.0f
 #define PLAYER_SPEED 8.0f
+#define PLAYER_RADIUS 1.5f      // Collision circle of the camera against scene walls
 #define MOUSE_SENSITIVITY 0.01f
+#define SIMULATION_RATE 120     // Fixed simulation steps per second, independent of the frame rate
+#define SIMULATION_STEP (1.0f / SIMULATION_RATE)
+#define SIMULATION_MAX_STEPS 8  // Catch-up steps per frame, time beyond them is dropped instead of simulated
 #define WORLD_SIZE 200.0f
 #define FLOOR_SEGMENTS 50
 #define WALL_HEIGHT 5.0f
@@ -15,7 +20,7 @@
 #define SUN_POSITION_Z 50.0f
 #define DEFAULT_WIREFRAME_THICKNESS 2.0f
 #define MAX_WIREFRAME_THICKNESS 5.0f
-#define MAX_LIGHTS 8
+#define MAX_SHADER_LIGHTS 256   // Lights uploaded to lighting.fs, the CPU lighting paths have no limit
 
 typedef struct {
     Vector3 position;
@@ -39,15 +44,28 @@ typedef struct {
     float range;
     float spotAngle;
     bool enabled;
+    bool dynamic;           // Moved at runtime: relit every frame and left out of baked lightmaps
 } Light;
 
 typedef struct {
-    Light lights[MAX_LIGHTS];
+    Light* lights;          // Grows in AddLight, freed by UnloadLightingSystem
     int lightCount;
+    int lightCapacity;
     Color ambientColor;
     float ambientIntensity;
+    const struct ProbeGrid* ambientProbes;  // Replaces the flat ambient in advanced shading when set
+    unsigned int version;   // Incremented whenever a light is added or changed
+    struct LightCache* cache;   // Compiled lights reused by CalculateMeshLighting until they change, NULL compiles per call
 } LightingSystem;
 
+// How the maze scene draws its walls (F8 cycles)
+typedef enum {
+    WALL_RENDER_BATCHED,            // Merged chunk meshes with frustum culling
+    WALL_RENDER_INSTANCED,          // One instanced draw of the wall cube
+    WALL_RENDER_PER_CELL,           // One DrawModel per wall cell
+    WALL_RENDER_MODE_COUNT
+} WallRenderMode;
+
 typedef struct {
     bool antialiasingEnabled;
     float wireframeThickness;
@@ -57,20 +75,23 @@ typedef struct {
     float specularStrength;
     float shininess;
     bool wireframeShaderEnabled;    // Toggle for wireframe shader mode
+    bool perPixelLightingEnabled;   // Light with lighting.fs instead of baked vertex colors
+    WallRenderMode wallRenderMode;
     Color wireframeColor;           // Color for wireframe lines
 } GraphicsConfig;
 
-// Maze data structure
-#define MAX_MAZE_WIDTH 50
-#define MAX_MAZE_HEIGHT 50
+// Maze grid of any size with one bit per cell (set for walls), every row starts on a new word
+#define MAZE_WORD_BITS 32
 typedef struct {
-    char data[MAX_MAZE_HEIGHT][MAX_MAZE_WIDTH];
+    unsigned int* walls;        // height * wordsPerRow words, released with UnloadMaze
+    int wordsPerRow;
     int width;
     int height;
 } Maze;
 
 // Terrain data structure
 #define TERRAIN_SIZE 1024
+#define TERRAIN_PLANE_SIZE 100.0f   // World-space width of the terrain mesh
 typedef struct {
     float heights[TERRAIN_SIZE][TERRAIN_SIZE];
     int size;
@@ -79,25 +100,30 @@ typedef struct {
     bool loaded;
     float heightMultiplier;  // Dynamic height scaling
     bool needsRebuild;       // Flag to rebuild mesh
+    struct HorizonMap* horizonMap; // Baked horizon angles for sun shadows and AO, NULL = unshaded
+    Image heightImage;       // Decoded heightmap waiting for its texture upload, data is NULL otherwise
 } TerrainData;
 
 // Cube-Sphere data structure
 #define MAX_SPHERE_SUBDIVISIONS 8
 typedef struct {
-    Mesh sphereMesh;
-    Model sphereModel;
+    struct PlanetLodChain* lodChain; // Pre-built heightmap planet meshes at several subdivision levels
     bool loaded;
-    int subdivisionLevel;
+    int subdivisionLevel; // Subdivisions of the finest LOD level
     float radius;
     Vector3 center;
     bool needsRebuild;
     float lastCameraDistance;
-    int dynamicSubdivisions;
+    int dynamicSubdivisions; // Subdivisions of the LOD level currently drawn
     float morphFactor; // 0.0 = cube, 1.0 = sphere
     bool wireframeMode; // Toggle between solid and wireframe rendering
     Shader planetShader; // Wireframe shader for planet rendering
     bool shaderLoaded; // Whether planet shader is loaded
     int wireframeModeLocation; // Uniform location for wireframe mode
+    bool proceduralMode; // Use procedural fBm heights instead of heightmap.png
+    int proceduralLevel; // Patch level for procedural mode (2^level x 2^level patches per face)
+    struct PlanetHeightCache* heightCache; // Cached procedural patch heights
+    Model proceduralModel; // One mesh per cube face
 } CubeSphereData;
 
 // Scene types
@@ -109,13 +135,40 @@ typedef enum {
 
 // Forward declarations
 typedef struct Scene Scene;
+typedef struct SceneLoadTask SceneLoadTask;
 struct WireframeShader;
+struct MemoryArena;
+struct RenderQueue;
 
 // Scene function pointers
 typedef void (*SceneInitFunc)(Scene* scene, LightingSystem* lighting, GraphicsConfig* gfxConfig);
 typedef void (*SceneUpdateFunc)(Scene* scene, float deltaTime, Camera3D* camera);
+typedef void (*SceneStepFunc)(Scene* scene, float stepTime);
 typedef void (*SceneRenderFunc)(Scene* scene, Camera3D camera, GraphicsConfig* gfxConfig, struct WireframeShader* wireframeShader);
 typedef void (*SceneCleanupFunc)(Scene* scene);
+typedef Vector3 (*SceneMoveFunc)(Scene* scene, Vector3 position, Vector3 delta, float radius);
+typedef void (*SceneSuspendFunc)(Scene* scene);
+typedef void (*SceneResumeFunc)(Scene* scene);
+typedef size_t (*SceneMemoryFunc)(const Scene* scene);
+// CPU part of loading a scene, runs as a job on the thread pool and must not touch the GPU. Returns the
+// scene data allocated from the scene arena, the GPU part is left to the scene's upload function.
+typedef void* (*SceneLoadFunc)(SceneLoadTask* task, struct MemoryArena* arena);
+// GPU part of a scene load, first run by the load job's completion on the main thread. Returns false while
+// it waits on jobs of its own to be called again next frame, unless wait is set.
+typedef bool (*SceneUploadFunc)(SceneLoadTask* task, void* data, bool wait);
+
+// Per-frame counters filled by the scene's render function
+typedef struct {
+    int drawCalls;
+    int triangles;
+    int culledObjects;      // Objects skipped by frustum culling
+    int queuedCommands;     // Draws submitted through the render queue
+    int stateChanges;       // Blend mode, shader and material changes of the sorted queue
+    int unsortedStateChanges;   // The same in recording order, for comparison
+    int uniformUploads;     // Uniforms the queue sent
+    int uniformsSkipped;    // Uniforms not sent because the shader already held the value
+    double submitMs;        // CPU time sorting and submitting the queue
+} RenderStats;
 
 // Scene structure
 typedef struct Scene {
@@ -123,20 +176,46 @@ typedef struct Scene {
     char name[64];
     bool initialized;
     void* sceneData;  // Scene-specific data
+    RenderStats stats;  // Of the last render call
+    float interpolation;    // Fraction of a step the rendered frame lies past the last simulated state
     
     SceneInitFunc init;
-    SceneUpdateFunc update;
+    SceneUpdateFunc update;     // Once per frame: input, uploads and other work tied to rendering
+    SceneStepFunc step;         // SIMULATION_RATE times per second: movement and simulation, may be NULL
     SceneRenderFunc render;
     SceneCleanupFunc cleanup;
+    SceneMoveFunc move;     // Collision response for a moving body, NULL moves freely
+    SceneSuspendFunc suspend;   // Switched away from but kept loaded (release shared state), may be NULL
+    SceneResumeFunc resume;     // Made current again without init, may be NULL
+    SceneMemoryFunc memory;     // Bytes held while loaded, weighed against the warm scene budget
+    long long lastActive;       // Switch count when the scene was last made current, for LRU eviction
+    SceneLoadFunc load;         // Loads in the background instead of with init when set, may be NULL
+    SceneUploadFunc upload;     // Finishes a background load on the main thread, set along with load
+    SceneLoadTask* loading;     // Background load in progress, NULL otherwise
+    struct MemoryArena* arena;      // Scene data and meshes, cleared in one go when the scene is unloaded
+    struct MemoryArena* frameArena; // Main-thread scratch shared by all scenes, reset every frame
+    struct RenderQueue* renderQueue;    // Draws recorded by render, sorted and submitted after it
 } Scene;
 
 // Scene manager
 #define MAX_SCENES 10
+#define SCENE_CACHE_BUDGET (256u * 1024u * 1024u)  // Default bytes of suspended scenes kept loaded
+#define SCENE_PREFETCH_DELAY 2.0        // Seconds a scene has been current before the next one is prefetched
 typedef struct {
     Scene scenes[MAX_SCENES];
     int sceneCount;
     int currentSceneIndex;
     Scene* currentScene;
+    size_t cacheBudget;     // Suspended scenes stay loaded up to this many bytes, 0 unloads on every switch
+    long long switchCount;
+    double lastSwitchMs;    // Duration of the last SwitchScene, including any init and eviction
+    bool lastSwitchWarm;    // The last switch resumed a loaded scene instead of initializing it
+    double lastSwitchTime;
+    int pendingSceneIndex;  // Scene to switch to once its background load finishes, -1 for none
+    bool prefetchEnabled;   // Load the likeliest next scene in the background while the current one runs
+    bool prefetchChecked;   // Prefetch already considered since the last switch
+    int transitions[MAX_SCENES][MAX_SCENES];   // Switches from one scene to another, to predict the next one
+    struct MemoryArena* frameArena;
 } SceneManager;
 
 #endif // GAME_TYPES_H
\ No newline at end of file
@@ -0,0 +1,40 @@
+#ifndef HORIZON_MAP_H
+#define HORIZON_MAP_H
+
+#include "raylib.h"
+#include "game_types.h"
+
+#define HORIZON_DIRECTIONS 8            // Default number of azimuth directions
+#define HORIZON_MAX_DIRECTIONS 32
+#define HORIZON_SUN_PENUMBRA 0.05f      // Elevation band (radians) over which the sun fades out behind a ridge
+
+// Horizon elevation per height texel in N azimuth directions, for O(1) sun shadow and AO lookups.
+// Angles are stored for unscaled heights so any height scale can be applied at lookup time.
+typedef struct HorizonMap {
+    int size;                   // Texels per side (same as the height grid)
+    int directionCount;         // Direction i points along angle 2*PI*i/directionCount from +x towards +z
+    float texelSize;            // World distance between neighbouring height texels
+    unsigned char* angles;      // [direction][z * size + x] atan(horizon slope), 0..255 maps to 0..PI/2
+} HorizonMap;
+
+// Bake the horizon of a size x size height grid (heights[z * size + x]) with a sweep-line convex hull
+// walk per direction. Lines are processed on the thread pool. directionCount <= 0 uses HORIZON_DIRECTIONS.
+// NULL when out of memory.
+HorizonMap* BakeHorizonMap(const float* heights, int size, float texelSize, int directionCount);
+
+// Bake the horizon map of a TerrainData height grid
+HorizonMap* BakeTerrainHorizonMap(const TerrainData* terrain, float texelSize, int directionCount);
+
+// Recompute every line that crosses the texel rectangle [x0,x1] x [z0,z1] after its heights changed.
+// False when out of memory, some of those lines then keep their old angles.
+bool UpdateHorizonMapRegion(HorizonMap* map, const float* heights, int x0, int z0, int x1, int z1);
+
+// Sun visibility (0-1) at a texel for a direction towards the sun, heights scaled by heightScale
+float GetHorizonSunVisibility(const HorizonMap* map, int x, int z, Vector3 toSun, float heightScale);
+
+// Cosine-weighted fraction of the sky (0-1) left open by the horizon, heights scaled by heightScale
+float GetHorizonAmbientOcclusion(const HorizonMap* map, int x, int z, float heightScale);
+
+void UnloadHorizonMap(HorizonMap* map);
+
+#endif // HORIZON_MAP_H
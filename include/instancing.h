@@ -0,0 +1,48 @@
+#ifndef INSTANCING_H
+#define INSTANCING_H
+
+#include "raylib.h"
+#include "game_types.h"
+
+#define INSTANCED_MAX_BATCHES 16
+#define INSTANCED_INITIAL_CAPACITY 64   // Transforms per batch before the first growth
+
+// Instances of one mesh and material collected during a frame
+typedef struct {
+    Mesh mesh;                  // Shared geometry, not owned
+    Material material;          // Copy of the caller's material (maps not owned)
+    Color tint;                 // Diffuse color of every instance
+    Matrix* transforms;         // Added since the last flush, kept allocated between frames
+    int count;
+    int capacity;
+} InstanceBatch;
+
+// Draws every batch with one DrawMeshInstanced call through instancing.vs/instancing.fs. Without the
+// shader each instance falls back to its own DrawMesh, so the output is the same either way.
+typedef struct {
+    Shader shader;
+    bool shaderLoaded;
+    InstanceBatch batches[INSTANCED_MAX_BATCHES];
+    int batchCount;
+
+    // Counters of the last flush, plus a running total of draw calls
+    int drawCalls;
+    int instanceCount;
+    long long totalDrawCalls;
+} InstancedRenderer;
+
+// Create a renderer and load the instancing shader (run from the repository root)
+InstancedRenderer* CreateInstancedRenderer(void);
+void UnloadInstancedRenderer(InstancedRenderer* renderer);
+
+// Register a mesh/material pair (both must outlive the renderer), returns the batch id or -1 when full
+int AddInstanceBatch(InstancedRenderer* renderer, Mesh mesh, Material material, Color tint);
+
+// Queue one instance of a batch for this frame
+void AddInstance(InstancedRenderer* renderer, int batchId, Matrix transform);
+
+// Draw and clear all queued instances (inside BeginMode3D), returns the number of draw calls.
+// Draw calls and triangles are added to stats when it isn't NULL.
+int FlushInstancedRenderer(InstancedRenderer* renderer, RenderStats* stats);
+
+#endif // INSTANCING_H
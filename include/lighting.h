@@ -5,11 +5,59 @@
 #include "raymath.h"
 #include "game_types.h"
 
+#define LIGHT_CLUSTER_CELL_SIZE 10.0f     // Default world-space cluster edge length
+#define LIGHT_CLUSTER_MAX_CELLS 262144      // Cell size is raised until the grid fits (64^3)
+#define LIGHT_CLUSTER_MIN_LIGHTS 16         // Fewer point/spot lights than this are cheaper to loop over directly
+#define LIGHTING_PARALLEL_GRAIN 4096        // Vertices per thread pool chunk in CalculateMeshLighting, a multiple of 4
+#define LIGHT_CLUSTER_PADDING 1.0f          // Added around the light bounds so points on a range boundary stay inside
+
+// Lights compiled into structure-of-arrays form for batch lighting (disabled lights are dropped)
+typedef struct {
+    int count;
+    int capacity;
+    LightType* type;
+    float *posX, *posY, *posZ;
+    float *dirX, *dirY, *dirZ;          // Normalized light direction
+    float *colorR, *colorG, *colorB;
+    float* intensity;
+    float* range;
+    float* spotCutoff;                  // cos(spotAngle), precomputed once
+    float ambientR, ambientG, ambientB; // ambientColor * ambientIntensity / 255
+    const struct ProbeGrid* ambientProbes; // Per-vertex ambient from SH probes instead, when set
+    float specularStrength;
+    float shininess;
+    int shininessInt;                   // Integer exponent for the fast specular path, 0 = use powf
+    bool advanced;                      // false = simple sun lighting like CalculateSimpleLighting
+} LightBlock;
+
+// World-space grid of cells, each listing the point/spot lights whose range overlaps it.
+// Directional lights reach everything and are kept in a separate global list.
+typedef struct {
+    Vector3 origin;             // Minimum corner of the grid
+    float cellSize;
+    int sizeX, sizeY, sizeZ;
+    int cellCount;
+    int* cellStart;             // cellCount + 1 offsets into cellLights
+    int* cellLights;            // LightBlock indices, grouped by cell
+    int cellLightCount;         // Total entries in cellLights (sum of lights per cell)
+    int* globalLights;          // Directional lights, evaluated for every vertex
+    int globalCount;
+    int localCount;             // Point and spot lights that were assigned
+    int maxLightsPerCell;
+    bool coversLights;          // Every point/spot light sphere lies inside, so outside only directional lights reach
+    int cellCapacity;           // Allocated sizes, reused between builds
+    int cellLightCapacity;
+    int globalCapacity;
+} LightClusterGrid;
+
 // Initialize the lighting system
 LightingSystem InitLightingSystem(void);
 
-// Add a light to the lighting system
-void AddLight(LightingSystem* lighting, LightType type, Vector3 position, Vector3 direction, Color color, float intensity, float range, float spotAngle);
+// Add a light to the lighting system, returns its index (-1 if out of memory)
+int AddLight(LightingSystem* lighting, LightType type, Vector3 position, Vector3 direction, Color color, float intensity, float range, float spotAngle);
+
+// Free the light array
+void UnloadLightingSystem(LightingSystem* lighting);
 
 // Update lighting system (for dynamic lights)
 void UpdateLightingSystem(LightingSystem* lighting, float deltaTime);
@@ -17,6 +65,42 @@ void UpdateLightingSystem(LightingSystem* lighting, float deltaTime);
 // Calculate lighting for a vertex with multiple lights
 Color CalculateVertexLighting(Vector3 vertexPos, Vector3 normal, Vector3 viewDir, Color baseColor, const LightingSystem* lighting, const GraphicsConfig* config);
 
+// Compile the lighting system and graphics settings into a LightBlock (free with UnloadLightBlock)
+LightBlock CompileLightBlock(const LightingSystem* lighting, const GraphicsConfig* config);
+void UnloadLightBlock(LightBlock* block);
+
+// Light count vertices at once: positions/normals are xyz triplets like mesh.vertices/mesh.normals,
+// colors holds the base RGBA colors on input and receives the lit colors (can be mesh.colors directly)
+void CalculateVertexLightingBatch(const float* positions, const float* normals, unsigned char* colors, int count, Vector3 viewDir, const LightBlock* block);
+
+// Assign the block's lights to a world-space grid covering bounds. The grid starts zeroed and keeps its
+// allocations between builds, so it can be rebuilt every frame as lights move.
+void BuildLightClusters(LightClusterGrid* grid, const LightBlock* block, BoundingBox bounds, float cellSize);
+void UnloadLightClusters(LightClusterGrid* grid);
+
+// Bounds of the point/spot light spheres of a block, padded by LIGHT_CLUSTER_PADDING. False without such lights.
+bool GetLocalLightBounds(const LightBlock* block, BoundingBox* bounds);
+
+// Same as CalculateVertexLightingBatch, but each vertex only evaluates the lights of its cluster cell
+// (vertices outside the grid get the directional lights when it covers every light, all lights otherwise)
+void CalculateVertexLightingClustered(const float* positions, const float* normals, unsigned char* colors, int count, Vector3 viewDir,
+                                      const LightBlock* block, const LightClusterGrid* grid);
+
+// Relight a mesh whose colors hold base colors, clustering the lights when there are many of them
+// (meshes larger than LIGHTING_PARALLEL_GRAIN vertices are lit on the thread pool). The compiled lights and
+// cluster grid come from lighting->cache when they are still current, so meshes lit with the same lights
+// share one grid.
+void CalculateMeshLighting(Mesh* mesh, Vector3 viewDir, const LightingSystem* lighting, const GraphicsConfig* config);
+
+// Compiled lights and cluster grid of one lighting system, rebuilt when its version, lights or the shading
+// settings change. Thread safe: a rebuild leaves meshes being lit with the previous lights unaffected.
+typedef struct LightCache LightCache;
+LightCache* CreateLightCache(void);
+void UnloadLightCache(LightCache* cache);
+
+// Number of times the cache compiled its lights
+int GetLightCacheBuilds(const LightCache* cache);
+
 // Calculate simple lighting for backward compatibility
 Color CalculateSimpleLighting(Vector3 vertexPos, Vector3 normal, Color baseColor);
 
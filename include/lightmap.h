@@ -0,0 +1,48 @@
+#ifndef LIGHTMAP_H
+#define LIGHTMAP_H
+
+#include "raylib.h"
+#include "game_types.h"
+
+#define LIGHTMAP_RESOLUTION 512         // Texels per side of the floor lightmap
+#define LIGHTMAP_AO_RAYS 16             // Occlusion rays per texel
+#define LIGHTMAP_AO_RADIUS 12.0f        // Walls further away than this don't occlude
+#define LIGHTMAP_AO_STRENGTH 0.8f       // Ambient left in a fully enclosed texel is 1 - strength
+#define LIGHTMAP_BAKE_VERSION 1         // Bump when the bake changes so old cache files are ignored
+
+// Baked light arriving at the maze floor (multiply with the albedo), row 0 is the -z edge
+typedef struct {
+    int width;
+    int height;
+    Color* texels;              // Light per texel, 255 = 1.0
+    unsigned long long key;     // Hash of the maze, static lights and shading settings
+    bool fromCache;
+} Lightmap;
+
+typedef struct LightmapBakeTask LightmapBakeTask;
+
+// Cache key for a floor lightmap: maze contents, static lights, shading settings and resolution
+unsigned long long GetMazeLightmapKey(const Maze* maze, const LightingSystem* lighting, const GraphicsConfig* config,
+                                      float floorSize, int resolution);
+
+// Bake direct light from the static lights (shadows traced through the maze grid) plus ambient occlusion
+// for a floorSize x floorSize floor centered on the origin. Rows are baked on the thread pool.
+Lightmap BakeMazeLightmap(const Maze* maze, const LightingSystem* lighting, const GraphicsConfig* config,
+                          float floorSize, int resolution);
+
+// Load the cache file for this setup (lightmap_<key>.bin) or bake and write it
+Lightmap LoadOrBakeMazeLightmap(const Maze* maze, const LightingSystem* lighting, const GraphicsConfig* config,
+                                float floorSize, int resolution);
+
+void UnloadLightmap(Lightmap* lightmap);
+
+// LoadOrBakeMazeLightmap as a thread pool job from copies of the maze, lights and settings, so the scene keeps
+// drawing its current lightmap. The ambient probes are shared and must stay loaded until the task is finished.
+// Poll IsLightmapBakeFinished, then FinishLightmapBake waits for the job and returns the lightmap (no texels
+// if the bake failed).
+LightmapBakeTask* StartMazeLightmapBake(const Maze* maze, const LightingSystem* lighting, const GraphicsConfig* config,
+                                        float floorSize, int resolution);
+bool IsLightmapBakeFinished(LightmapBakeTask* task);
+Lightmap FinishLightmapBake(LightmapBakeTask* task);
+
+#endif // LIGHTMAP_H
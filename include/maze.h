@@ -2,8 +2,48 @@
 #define MAZE_H
 
 #include "game_types.h"
+#include <stddef.h>
 
-// Function to load maze from ASCII file
+#define MAZE_CELL_SIZE 10.0f                                        // Wall cubes are one cell wide
+#define MAZE_WALL_TOP (WALL_HEIGHT / 2.0f + MAZE_CELL_SIZE / 2.0f)  // Cubes are drawn centered at WALL_HEIGHT / 2
+
+// Load a maze from an ASCII file ('#' is a wall, anything else is open) or a binary maze file. The file
+// is memory-mapped and unpacked in a single pass, text lines may differ in length (the widest sets the width).
 Maze LoadMazeFromFile(const char* filename);
 
+// Pack ASCII maze text of the given size (no terminator needed)
+Maze LoadMazeFromMemory(const char* text, size_t size);
+
+// Binary mazes start with this magic, then version, width and height as little-endian 32-bit values.
+// Every row follows as one tag byte and its payload, whichever encoding is smallest for the row:
+// the cells packed 8 per byte (bit i is cell i), run lengths (LEB128, alternating open and wall
+// runs starting with open), or nothing to repeat the row above.
+#define MAZE_BINARY_MAGIC "MAZB"
+#define MAZE_BINARY_VERSION 1
+
+// Whether the bytes start like a binary maze (LoadMazeFromFile checks this to pick the format)
+bool IsMazeBinary(const void* data, size_t size);
+
+// Unpack a binary maze, an empty maze when the data is truncated or malformed
+Maze LoadMazeFromBinary(const void* data, size_t size);
+
+// Write a maze in the binary format or as ASCII ('#' for walls, spaces for open cells)
+bool ExportMazeBinary(const Maze* maze, const char* filename);
+bool ExportMazeText(const Maze* maze, const char* filename);
+
+// Deep copy, for handing a maze to another thread
+Maze CopyMaze(const Maze* maze);
+
+void UnloadMaze(Maze* maze);
+
+// True for wall cells, everything outside the maze is open
+bool MazeIsWall(const Maze* maze, int col, int row);
+
+// World-space x/z of the minimum corner of cell (0, 0), the maze is centered on the origin
+Vector2 GetMazeGridOrigin(const Maze* maze);
+
+// Closest hit of a ray (dir normalized) with the wall columns or the floor (y = 0) within maxDistance.
+// hitDistance and hitNormal may be NULL.
+bool MazeRaycast(const Maze* maze, Vector3 origin, Vector3 dir, float maxDistance, float* hitDistance, Vector3* hitNormal);
+
 #endif // MAZE_H
\ No newline at end of file
@@ -0,0 +1,44 @@
+#ifndef MAZE_BATCH_H
+#define MAZE_BATCH_H
+
+#include "raylib.h"
+#include "game_types.h"
+#include "rendering.h"
+#include "maze.h"
+#include "maze_pvs.h"
+#include "render_queue.h"
+
+#define MAZE_CHUNK_CELLS 8                          // Chunks are MAZE_CHUNK_CELLS x MAZE_CHUNK_CELLS maze cells
+#define MAZE_WALL_QUAD_SIZE (MAZE_CELL_SIZE / 2.0f) // Edge limit for vertex-lit walls, 3x3 vertices per cell face
+
+// Maze walls merged into one static mesh per chunk, vertices in world space
+typedef struct {
+    Model model;                // One mesh per chunk with walls, all drawn with material 0
+    BoundingBox* bounds;        // World bounds of each mesh for frustum culling
+    int* chunkCoords;           // Chunk x and z of each mesh
+    int chunkCells;
+    int chunkCount;             // Same as model.meshCount
+    int wallCount;
+    int triangleCount;          // Over all chunks
+} MazeWallBatch;
+
+// Mesh of the walls in cells [col0,col1) x [row0,row1). Only faces that border an open cell and the tops are
+// emitted (the maze sits on the floor, so no bottoms), and coplanar runs are merged into larger quads (greedy
+// meshing). Quads are then split so no edge is longer than maxQuadSize, <= 0 keeps them whole.
+// World-space vertices with unlit base colors, CPU side only.
+Mesh BuildMeshMazeWalls(const Maze* maze, int col0, int row0, int col1, int row1, float maxQuadSize);
+
+// Mesh and upload the walls of every chunk (chunkCells <= 0 uses MAZE_CHUNK_CELLS, it shrinks to keep chunks
+// under 65536 vertices)
+MazeWallBatch LoadMazeWallBatch(const Maze* maze, int chunkCells, float maxQuadSize);
+
+// Draw the chunks inside the frustum (all when frustum is NULL) that are in the visible set (all when
+// visible is NULL, pvs must use the batch's chunk size), returns the number of draw calls. With a queue the
+// chunks are recorded into it instead of drawn, and its submission counts their draw calls and triangles.
+// Draw calls, triangles and culled chunks are added to stats when it isn't NULL.
+int DrawMazeWallBatch(const MazeWallBatch* batch, const Frustum* frustum, const MazePvs* pvs, const MazePvsSet* visible,
+                      RenderQueue* queue, RenderStats* stats);
+
+void UnloadMazeWallBatch(MazeWallBatch* batch);
+
+#endif // MAZE_BATCH_H
@@ -0,0 +1,25 @@
+#ifndef MAZE_COLLISION_H
+#define MAZE_COLLISION_H
+
+#include "raylib.h"
+#include "game_types.h"
+
+#define COLLISION_MAX_SLIDES 3          // Contacts resolved per move before the rest is dropped
+#define COLLISION_SKIN 0.001f           // Gap kept to walls so the next move doesn't start touching
+#define COLLISION_PARALLEL_MIN 1024     // Batches at least this large are split over the thread pool
+
+// Positions are world-space x/z (Vector2.y is z). The maze grid is the broadphase: only wall cells
+// inside the bounds of a move are tested, so a query costs the same in any maze size.
+
+// Earliest contact of a circle moving by delta with a wall cell. fraction is the part of delta
+// travelled before touching, normal points out of the wall. Either may be NULL.
+bool SweepCircleInMaze(const Maze* maze, Vector2 position, Vector2 delta, float radius, float* fraction, Vector2* normal);
+
+// Move a circle by delta and slide along the walls it touches, returns the final position.
+// A circle that starts overlapping a wall is pushed out first.
+Vector2 MoveCircleInMaze(const Maze* maze, Vector2 position, Vector2 delta, float radius);
+
+// MoveCircleInMaze for many bodies of the same radius, positions are updated in place
+void MoveCirclesInMaze(const Maze* maze, Vector2* positions, const Vector2* deltas, int count, float radius);
+
+#endif // MAZE_COLLISION_H
@@ -0,0 +1,77 @@
+#ifndef MAZE_CROWD_H
+#define MAZE_CROWD_H
+
+#include "raylib.h"
+#include "game_types.h"
+
+#define CROWD_MAX_GOALS 8               // Flow fields per crowd
+#define CROWD_AGENT_RADIUS 0.6f
+#define CROWD_AGENT_HEIGHT 3.0f         // Height of the box agents are drawn as
+#define CROWD_MAX_SPEED 6.0f            // World units per second
+#define CROWD_STEER_RATE 6.0f           // Fraction of the way to the desired velocity per second
+#define CROWD_SEPARATION_RANGE 2.0f     // Agents closer than this push each other apart
+#define CROWD_SEPARATION_STRENGTH 40.0f // Acceleration of two agents on top of each other
+#define CROWD_PARALLEL_MIN 1024         // Crowds at least this large are stepped on the thread pool
+
+// Direction from every open cell toward the nearest of a set of goal cells. Distances come from one
+// multi-source Dijkstra pass over 8-connected cells (diagonals may not cut a wall corner), the grid
+// version of the eikonal distance.
+typedef struct {
+    int width, height;
+    float* distances;           // Cells (row * width + col) to the nearest goal, FLT_MAX for walls and unreachable cells
+    signed char* directions;    // Neighbour (0-7) on the way to the goal, -1 at goals, walls and unreachable cells
+    int goalCount;
+} MazeFlowField;
+
+// Agents stored one array per attribute, so steering and separation run four agents or four
+// neighbours at a time. Each agent follows the flow field of its goal.
+typedef struct {
+    const Maze* maze;           // Not owned, must outlive the crowd
+    MazeFlowField* fields[CROWD_MAX_GOALS];
+    int fieldCount;
+
+    int count;
+    int capacity;               // Arrays hold capacity rounded up to 4
+    float* positionX;           // World x/z
+    float* positionZ;
+    float* previousX;           // Positions before the last step, for interpolated rendering
+    float* previousZ;
+    float* velocityX;
+    float* velocityZ;
+    unsigned char* goals;       // Flow field index
+    unsigned char* arrived;     // Set by the last step for agents standing on one of their goal cells
+    float radius;
+    float maxSpeed;
+
+    // Spatial hash of agent positions, rebuilt each step
+    int binMask;                // Bins - 1, a power of two
+    int* binStart;              // binMask + 2 offsets into sortedX / sortedZ
+    int* agentBins;
+    float* sortedX;             // Positions grouped by bin
+    float* sortedZ;
+} MazeCrowd;
+
+// Flow field toward the given goal cells (row * width + col), walls among them are ignored
+MazeFlowField* BuildMazeFlowField(const Maze* maze, const int* goalCells, int goalCount);
+void UnloadMazeFlowField(MazeFlowField* field);
+
+// Unit x/z direction toward the goal from a cell, zero at goals and where no goal can be reached
+Vector2 GetMazeFlowDirection(const MazeFlowField* field, int col, int row);
+
+MazeCrowd* CreateMazeCrowd(const Maze* maze, int capacity);
+void UnloadMazeCrowd(MazeCrowd* crowd);
+
+// Build the flow field of a goal, returns its index or -1 (CROWD_MAX_GOALS reached or out of memory)
+int AddMazeCrowdGoal(MazeCrowd* crowd, const int* goalCells, int goalCount);
+
+// Add an agent at rest at a world x/z position, returns its index or -1 when the crowd is full
+int AddMazeCrowdAgent(MazeCrowd* crowd, Vector2 position, int goal);
+
+// Steer every agent along its flow field, push apart agents that are too close and move them
+// against the maze walls
+void StepMazeCrowd(MazeCrowd* crowd, float deltaTime);
+
+// Position of an agent between its last two steps, alpha 0 is the previous step and 1 the last one
+Vector2 GetMazeCrowdRenderPosition(const MazeCrowd* crowd, int agent, float alpha);
+
+#endif // MAZE_CROWD_H
@@ -0,0 +1,75 @@
+#ifndef MAZE_PATH_H
+#define MAZE_PATH_H
+
+#include "raylib.h"
+#include "game_types.h"
+
+#define MAZE_PATH_CLUSTER_CELLS 16      // HPA* cluster edge in cells
+#define MAZE_PATH_ENTRANCE_SPLIT 6      // Border openings this wide get a transition at each end instead of the middle
+#define MAZE_PATH_CACHE_SLOTS 4096      // Cached paths, a power of two
+#define MAZE_PATH_CACHE_WAYS 4          // Slots a start/goal pair may occupy, the least recently used is replaced
+
+// Paths move between the 8 neighbours of a cell. Diagonal steps need both orthogonal cells open, so
+// paths never cut a wall corner. Straight steps cost 1 and diagonal steps sqrt(2).
+
+// Waypoints (row * width + col) from start to goal, consecutive waypoints are joined by a straight
+// or diagonal run of open cells
+typedef struct {
+    int* cells;
+    int count;
+    int capacity;
+    float cost;
+} MazePath;
+
+typedef struct {
+    int start, goal;            // -1 for an empty slot
+    long long lastUse;
+    MazePath path;
+} MazePathCacheEntry;
+
+typedef struct MazePathSearch MazePathSearch;
+
+// HPA* abstraction over a maze: clusters of clusterCells x clusterCells cells, a node on each side of
+// every opening in a cluster border, and edges between the nodes of a cluster weighted with their
+// shortest path inside it. Queries search this graph and refine each step with Jump Point Search.
+typedef struct {
+    const Maze* maze;           // Not owned, must outlive the pathfinder
+    int clusterCells;
+    int clustersX, clustersZ;
+
+    int nodeCount;
+    int* nodeCells;
+    int* nodeClusters;
+    int* clusterFirstNode;      // clustersX * clustersZ + 1 offsets into clusterNodes
+    int* clusterNodes;
+
+    int edgeCount;
+    int* edgeFirst;             // nodeCount + 1 offsets into edgeTargets / edgeCosts
+    int* edgeTargets;
+    float* edgeCosts;
+
+    MazePathCacheEntry* cache;  // MAZE_PATH_CACHE_SLOTS entries
+    long long cacheHits;
+    long long cacheMisses;
+    long long queryCount;       // Use stamps for the cache
+
+    MazePathSearch* search;     // Scratch state reused by every query
+} MazePathfinder;
+
+// Build the abstraction (clusterCells <= 0 uses MAZE_PATH_CLUSTER_CELLS), clusters are connected on the thread pool
+MazePathfinder* CreateMazePathfinder(const Maze* maze, int clusterCells);
+void UnloadMazePathfinder(MazePathfinder* pathfinder);
+
+// Route between two open cells. Start and goal in one cluster are searched with JPS inside it, longer
+// routes go through the abstract graph (near-optimal). Results are cached by start and goal.
+bool FindMazePath(MazePathfinder* pathfinder, int startCol, int startRow, int goalCol, int goalRow, MazePath* path);
+
+// Optimal route with Jump Point Search over the whole maze, no abstraction and no cache
+bool FindMazePathJps(MazePathfinder* pathfinder, int startCol, int startRow, int goalCol, int goalRow, MazePath* path);
+
+// Drop every cached path (after the maze changed)
+void ClearMazePathCache(MazePathfinder* pathfinder);
+
+void UnloadMazePath(MazePath* path);
+
+#endif // MAZE_PATH_H
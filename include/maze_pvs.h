@@ -0,0 +1,47 @@
+#ifndef MAZE_PVS_H
+#define MAZE_PVS_H
+
+#include "raylib.h"
+#include "game_types.h"
+
+// Bounding rectangle of a visible set in chunk coordinates with one bit per chunk inside it
+typedef struct MazePvsSet {
+    int x0, z0;
+    int width, height;
+    int firstWord;              // Offset into MazePvs.words, bits run row by row
+    int chunkCount;             // Set bits
+} MazePvsSet;
+
+// Potentially visible wall chunks of every open maze cell. Cells with the same set share it.
+typedef struct MazePvs {
+    int width, height;          // Maze cells
+    int chunkCells;             // Chunk edge in cells (same as the wall batch)
+    int chunksX, chunksZ;
+    int* cellSets;              // Set index per cell (row * width + col), -1 for walls
+    MazePvsSet* sets;
+    int setCount;
+    unsigned int* words;
+    int wordCount;
+} MazePvs;
+
+// Bake the PVS of a grid of wall flags (walls[row * width + col] != 0). The set of an open cell holds the
+// chunk of every wall some straight line from anywhere in the cell reaches through open cells, plus the
+// cell's own chunk. It is conservative: lines that only graze a wall corner count as getting past it.
+// Rows are baked on the thread pool, returns NULL when out of memory.
+MazePvs* BakeMazeGridPvs(const unsigned char* walls, int width, int height, int chunkCells);
+
+// Bake the PVS of a maze
+MazePvs* BakeMazePvs(const Maze* maze, int chunkCells);
+
+// Visible set of a cell, NULL for walls and cells outside the maze (treat everything as visible)
+const MazePvsSet* GetMazePvsSet(const MazePvs* pvs, int col, int row);
+
+// Whether the chunk is in the set
+bool IsMazePvsChunkVisible(const MazePvs* pvs, const MazePvsSet* set, int chunkX, int chunkZ);
+
+// Bytes used by the sets, words and per-cell indices
+size_t GetMazePvsMemory(const MazePvs* pvs);
+
+void UnloadMazePvs(MazePvs* pvs);
+
+#endif // MAZE_PVS_H
@@ -3,10 +3,14 @@
 
 #include "raylib.h"
 #include "game_types.h"
+#include "planet_noise.h"
 
 // Generate a custom floor mesh with vertex colors and lighting
 Mesh GenMeshFloorWithColors(float width, float height, int resX, int resZ);
 
+// Generate a floor mesh with unlit base colors (lit per pixel by lighting.fs)
+Mesh GenMeshFloorBase(float width, float height, int resX, int resZ);
+
 // Generate floor mesh with advanced lighting
 Mesh GenMeshFloorWithAdvancedLighting(float width, float height, int resX, int resZ, const LightingSystem* lighting, const GraphicsConfig* config);
 
@@ -19,9 +23,24 @@ Mesh GenMeshWallWithAdvancedLighting(float width, float height, int resX, int re
 // Generate a cube mesh for maze walls with vertex colors and lighting
 Mesh GenMeshMazeWallCube(float size, const LightingSystem* lighting, const GraphicsConfig* config);
 
+// Generate a maze wall cube with unlit base colors and minimal vertices (lit per pixel by lighting.fs)
+Mesh GenMeshMazeWallCubeBase(float size);
+
+// Unlit brick color of a maze wall face (0-3 sides, 4 top, 5 bottom) at face coordinates s, t in [0, 1]
+Color GetMazeWallBaseColor(int face, float s, float t);
+
+#define TERRAIN_MESH_RESOLUTION 128      // Quads along each side of the terrain mesh
+
+// Build terrain mesh on the CPU without uploading it (safe to call from a worker thread). Its arrays come
+// from the arena when one is given, see AllocMeshBuffers.
+Mesh BuildMeshTerrainFromHeightMap(const TerrainData* terrain, float scale, float heightScale, struct MemoryArena* arena);
+
 // Generate terrain mesh from height map with vertex colors based on height
 Mesh GenMeshTerrainFromHeightMap(const TerrainData* terrain, float scale, float heightScale);
 
+// Recompute heights, normals and colors of a terrain mesh in place and update its GPU buffers if uploaded
+void UpdateMeshTerrainFromHeightMap(Mesh* mesh, const TerrainData* terrain, float heightScale);
+
 // Generate a cube projected to sphere with dynamic tessellation
 Mesh GenMeshCubeSphere(float radius, int subdivisions, Vector3 center);
 
@@ -34,7 +53,15 @@ Mesh GenMeshSubdividedCube(float size, int subdivisions, float morphFactor);
 // Generate cube with terrain height map displacement on each face
 Mesh GenMeshTerrainCube(float size, int subdivisions, const TerrainData* terrain, float heightScale);
 
+// Build morphing terrain cube on the CPU without uploading it (safe to call from a worker thread). Heights are
+// scaled by heightMultiplier, terrain->heightMultiplier is not read.
+Mesh BuildMeshTerrainCubeMorphing(float size, int subdivisions, const TerrainData* terrain, float heightScale,
+                                  float heightMultiplier, float morphFactor);
+
 // Generate cube with terrain displacement that can morph towards a sphere
 Mesh GenMeshTerrainCubeMorphing(float size, int subdivisions, const TerrainData* terrain, float heightScale, float morphFactor);
 
+// Generate one mesh per cube face with heights evaluated from procedural fBm patches (cached by patch key)
+void GenMeshProceduralPlanet(Mesh faceMeshes[6], float size, int level, PlanetHeightCache* cache, float heightScale, float heightMultiplier, float morphFactor);
+
 #endif // MESH_GENERATION_H
\ No newline at end of file
@@ -0,0 +1,47 @@
+#ifndef PLANET_LOD_H
+#define PLANET_LOD_H
+
+#include "raylib.h"
+#include "game_types.h"
+
+#define PLANET_LOD_LEVELS 4             // Finest level first, each level halves the face segments
+#define PLANET_LOD_HYSTERESIS 0.15f     // Fraction of camera distance a band boundary must be crossed by before switching
+
+// Chain of pre-built planet meshes at decreasing subdivision levels
+typedef struct PlanetLodChain {
+    Model models[PLANET_LOD_LEVELS];        // Uploaded models, meshCount is 0 until a level has been built
+    int subdivisions[PLANET_LOD_LEVELS];    // Subdivisions passed to the mesh builder for each level
+    int currentLevel;                       // Level being drawn (0 = finest)
+    float size;
+    float heightScale;
+    Shader shader;
+    bool hasShader;
+    struct PlanetLodBuilder* builder;       // Level builds in flight on the job system
+} PlanetLodChain;
+
+// Create a chain for a terrain cube planet, nothing is built until the first RequestPlanetLodBuild. Builds read
+// terrain's heights (not its heightMultiplier), so they must not change until UnloadPlanetLodChain. NULL when
+// out of memory.
+PlanetLodChain* CreatePlanetLodChain(const TerrainData* terrain, float size, int finestSubdivisions, float heightScale);
+void UnloadPlanetLodChain(PlanetLodChain* chain);
+
+// Shader applied to every model in the chain (also to models uploaded later)
+void SetPlanetLodShader(PlanetLodChain* chain, Shader shader);
+
+// Rebuild all levels for new height/morph settings, one job per level whose completion uploads it.
+// Current models stay valid until replaced. Main thread only, like the rest of the chain functions.
+void RequestPlanetLodBuild(PlanetLodChain* chain, float heightMultiplier, float morphFactor);
+
+// Block until the requested build is finished and uploaded (used while loading a scene)
+void WaitPlanetLodBuild(PlanetLodChain* chain);
+
+// True once every level of the requested build has been uploaded by the job completions
+bool IsPlanetLodBuildFinished(const PlanetLodChain* chain);
+
+// Pick the level for this camera distance, returns the distance
+float UpdatePlanetLodChain(PlanetLodChain* chain, Vector3 center, Vector3 cameraPosition, float radius);
+
+// Model to draw this frame (NULL if nothing has been built yet)
+const Model* GetPlanetLodModel(const PlanetLodChain* chain);
+
+#endif // PLANET_LOD_H
@@ -0,0 +1,61 @@
+#ifndef PLANET_NOISE_H
+#define PLANET_NOISE_H
+
+#include "raylib.h"
+
+#define PLANET_PATCH_RESOLUTION 16      // Quads along each patch edge
+#define PLANET_PATCH_SAMPLES ((PLANET_PATCH_RESOLUTION + 1) * (PLANET_PATCH_RESOLUTION + 1))
+#define PLANET_MAX_PATCH_LEVEL 3        // 8x8 patches per face keeps a face mesh under 65536 vertices
+#define PLANET_DEFAULT_CACHE_PATCHES 1024
+#define PLANET_NOISE_HEIGHT_RANGE 50.0f // Same 0-50 unit range as heightmap.png samples
+
+// Identifies one patch: cube face, quadtree level and patch coordinates on that level
+typedef struct {
+    int face;
+    int level;
+    int x;
+    int y;
+} PlanetPatchKey;
+
+// Cached height samples for one patch
+typedef struct {
+    PlanetPatchKey key;
+    unsigned long long packedKey;
+    unsigned int lastUsed;
+    bool valid;
+    float heights[PLANET_PATCH_SAMPLES];   // Normalized 0-1 heights, row-major
+} PlanetPatch;
+
+// Patch cache keyed by PlanetPatchKey with least-recently-used eviction
+typedef struct PlanetHeightCache {
+    PlanetPatch* patches;
+    int capacity;
+    int count;
+    int* table;             // Open addressing table of patch slots, -1 = empty
+    int tableSize;
+    unsigned int frame;     // Incremented on every request, used for LRU
+    int seed;
+    int hits;
+    int misses;
+} PlanetHeightCache;
+
+// Evaluate the planet fBm height (0-1) for a single unit-sphere direction
+float PlanetNoiseHeight(Vector3 direction, int seed);
+
+// Evaluate the planet fBm height (0-1) for count unit-sphere directions given as separate x/y/z arrays
+void PlanetNoiseHeightBatch(const float* x, const float* y, const float* z, float* heights, int count, int seed);
+
+// Unit-sphere direction of sample (i, j) inside a patch
+Vector3 GetPlanetPatchDirection(PlanetPatchKey key, int i, int j);
+
+// Create/destroy a patch height cache
+PlanetHeightCache* CreatePlanetHeightCache(int capacity, int seed);
+void UnloadPlanetHeightCache(PlanetHeightCache* cache);
+
+// Make sure all requested patches are cached, evaluating missing ones in parallel
+void RequestPlanetPatches(PlanetHeightCache* cache, const PlanetPatchKey* keys, int count);
+
+// Get cached heights for a patch (NULL if the patch is not resident)
+const float* GetPlanetPatchHeights(const PlanetHeightCache* cache, PlanetPatchKey key);
+
+#endif // PLANET_NOISE_H
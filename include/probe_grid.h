@@ -0,0 +1,56 @@
+#ifndef PROBE_GRID_H
+#define PROBE_GRID_H
+
+#include "raylib.h"
+#include "game_types.h"
+
+#define PROBE_SH_COEFFICIENTS 9             // L2 spherical harmonics
+#define PROBE_LAYERS 2                      // One layer inside the corridors, one above the walls
+#define PROBE_FLOOR_HEIGHT 1.0f             // Height of the lower probe layer
+#define PROBE_RAYS 128                      // Rays per probe
+#define PROBE_MAX_DISTANCE 200.0f
+#define PROBE_INDIRECT_STRENGTH 0.6f        // Scale of bounce light (the direct model isn't energy normalized)
+#define PROBE_BAKE_VERSION 1                // Bump when the bake changes so old cache files are ignored
+
+// Grid of L2 spherical-harmonic irradiance probes, one per maze cell and layer. Coefficients are
+// pre-convolved with the cosine lobe, so evaluating a normal gives a multiplier like ambientR/G/B.
+typedef struct ProbeGrid {
+    Vector3 origin;             // Position of probe (0, 0, 0)
+    float spacing;
+    int sizeX, sizeY, sizeZ;
+    int probeCount;             // Probe (x, y, z) is at index (z * sizeY + y) * sizeX + x
+    float* coefficients;        // PROBE_SH_COEFFICIENTS red, then green, then blue values per probe
+    unsigned char* valid;       // 0 for probes buried in walls, skipped when interpolating
+    Vector3 fallback;           // Flat ambient used where no valid probe is near
+    unsigned long long key;     // Hash of the maze, static lights and ambient settings
+} ProbeGrid;
+
+typedef struct ProbeBakeTask ProbeBakeTask;
+
+// Cache key for a maze probe grid: maze contents, static lights and ambient light
+unsigned long long GetMazeProbeKey(const Maze* maze, const LightingSystem* lighting);
+
+// Bake probes over the maze: each probe traces PROBE_RAYS rays through the maze grid, shades the hit
+// walls and floor with the static lights (one bounce) and sees the flat ambient as sky.
+// Probes are baked on the thread pool.
+ProbeGrid* BakeMazeProbeGrid(const Maze* maze, const LightingSystem* lighting);
+
+// Load the cache file for this setup (probes_<key>.bin) or bake and write it
+ProbeGrid* LoadOrBakeMazeProbeGrid(const Maze* maze, const LightingSystem* lighting);
+
+bool SaveProbeGrid(const ProbeGrid* grid, const char* path);
+ProbeGrid* LoadProbeGrid(const char* path);
+
+// Irradiance multiplier at a point for a surface normal, trilinear between the valid probes around it
+Vector3 EvaluateProbeGrid(const ProbeGrid* grid, Vector3 position, Vector3 normal);
+
+void UnloadProbeGrid(ProbeGrid* grid);
+
+// Bake as a thread pool job from copies of the maze and lights, so the scene keeps running. A second job
+// that depends on the bake writes the cache file. Poll IsProbeBakeFinished, then FinishProbeBake waits
+// for both jobs and returns the grid.
+ProbeBakeTask* StartMazeProbeBake(const Maze* maze, const LightingSystem* lighting);
+bool IsProbeBakeFinished(ProbeBakeTask* task);
+ProbeGrid* FinishProbeBake(ProbeBakeTask* task);
+
+#endif // PROBE_GRID_H
@@ -0,0 +1,78 @@
+#ifndef RELIGHT_H
+#define RELIGHT_H
+
+#include "raylib.h"
+#include "game_types.h"
+
+#define RELIGHT_MAX_MESHES 64         // Enough for every wall chunk of a 50x50 maze
+#define RELIGHT_CELL_SIZE 10.0f         // World-space edge length of a vertex grid cell
+
+// A baked mesh that keeps its unlit colors so it can be relit in place
+typedef struct {
+    Mesh* mesh;                 // Mesh with world-space vertices, colors hold the lit result
+    unsigned char* albedo;      // Unlit base colors (RGBA per vertex)
+    int firstVertex;            // Index of vertex 0 in the grid's global numbering
+    int dirtyMin, dirtyMax;     // Vertex range relit since the last upload, dirtyMin > dirtyMax when clean
+} RelightMesh;
+
+// Per-scene spatial grid of the vertices of all relit meshes, plus the lights they were last lit with
+typedef struct {
+    RelightMesh meshes[RELIGHT_MAX_MESHES];
+    int meshCount;
+    int vertexCount;            // Total over all meshes
+
+    Vector3 origin;
+    float cellSize;
+    int sizeX, sizeY, sizeZ;
+    int cellCount;
+    int* cellStart;             // cellCount + 1 offsets into cellVertices
+    int* cellVertices;          // Global vertex indices, ascending within each cell
+    unsigned char* cellDirty;
+    bool built;
+    bool dynamicLightsOnly;     // Light with dynamic lights only and no ambient (drawn on top of a lightmap)
+
+    // Lights and settings of the last relight
+    Light* litLights;
+    int litLightCount;
+    int litLightCapacity;
+    unsigned int litVersion;    // LightingSystem.version of the snapshot
+    bool litValid;
+    bool litAdvanced;
+    float litSpecularStrength;
+    float litShininess;
+    unsigned long long litProbeKey;     // Key of the ambient probe grid, 0 = flat ambient
+
+    // Gather buffers for the dirty vertices, reused between updates. With a scratch arena (a frame arena
+    // reset between updates) they are taken from it instead and not owned by the grid.
+    struct MemoryArena* scratchArena;
+    float* scratchPositions;
+    float* scratchNormals;
+    unsigned char* scratchColors;
+    int* scratchIndices;
+    int scratchCapacity;
+    Light* scratchLights;
+    int scratchLightCapacity;
+    struct LightCache* dynamicLightCache;   // Compiled moving lights, kept while they don't change
+
+    // Statistics of the last update
+    int lastDirtyVertices;
+    int lastUploadBytes;
+} RelightGrid;
+
+// Create an empty grid (cellSize <= 0 uses RELIGHT_CELL_SIZE), NULL when out of memory
+RelightGrid* CreateRelightGrid(float cellSize);
+void UnloadRelightGrid(RelightGrid* grid);
+
+// Register a mesh whose colors currently hold unlit base colors (the mesh must outlive the grid).
+// Returns the mesh slot or -1 when the grid is full, NULL or out of memory.
+int AddRelightMesh(RelightGrid* grid, Mesh* mesh);
+
+// Relight vertices near lights that were added, moved or changed since the last update (everything on
+// the first update or when shading settings change). CPU only, returns the number of relit vertices, or -1
+// for a NULL grid or when out of memory (nothing is relit and the same vertices are retried next update).
+int UpdateRelightGrid(RelightGrid* grid, const LightingSystem* lighting, const GraphicsConfig* config, Vector3 viewDir);
+
+// Push the relit vertex ranges to the GPU with UpdateMeshBuffer (main thread, NULL is ignored)
+void UploadRelightGrid(RelightGrid* grid);
+
+#endif // RELIGHT_H
@@ -0,0 +1,63 @@
+#ifndef RENDER_QUEUE_H
+#define RENDER_QUEUE_H
+
+#include "raylib.h"
+#include "game_types.h"
+
+#define RENDER_QUEUE_INITIAL_CAPACITY 256   // Commands before the first growth
+#define RENDER_QUEUE_MAX_UNIFORMS 64        // Distinct (shader, location) pairs a queue tracks values for
+#define RENDER_OPAQUE -1                    // Blend mode of commands drawn without blending
+
+// One recorded draw: a mesh with a material, and the material's shader, at a transform
+typedef struct {
+    const Mesh* mesh;           // Not owned, must stay valid until the queue is submitted
+    const Material* material;   // Not owned, its diffuse color is tinted while the command draws
+    Matrix transform;
+    Color tint;
+    int blendMode;              // BlendMode, or RENDER_OPAQUE
+    unsigned long long key;     // Blend mode, shader, material and mesh, most significant first
+    int order;                  // Recording order, keeps commands with equal keys in order
+} RenderCommand;
+
+// Value of a shader uniform, queued for this frame and as last sent to the shader
+typedef struct {
+    Shader shader;
+    int locIndex;
+    int uniformType;
+    unsigned char queued[16];   // Up to a vec4
+    unsigned char sent[16];
+    bool pending;               // queued is waiting for the shader's first draw
+    bool hasSent;               // sent holds what the shader has
+} RenderUniform;
+
+// Draws recorded by a scene during its render call and submitted sorted by state, so draws sharing a
+// shader and material run back to back and each uniform is set at most once per frame
+typedef struct RenderQueue {
+    RenderCommand* commands;
+    int count;
+    int capacity;
+    RenderUniform uniforms[RENDER_QUEUE_MAX_UNIFORMS];
+    int uniformCount;
+} RenderQueue;
+
+RenderQueue* CreateRenderQueue(void);
+void UnloadRenderQueue(RenderQueue* queue);
+
+// Record a draw of one mesh, or of every mesh of a model at a position like DrawModel
+void QueueMesh(RenderQueue* queue, const Mesh* mesh, const Material* material, Matrix transform, Color tint, int blendMode);
+void QueueModel(RenderQueue* queue, Model model, Vector3 position, Color tint, int blendMode);
+
+// Record a float or int uniform (up to 4 components) for this frame. It is set before the first draw that
+// uses the shader, and skipped when the shader still holds the same value from an earlier frame. The last
+// value queued for a location wins, so it can't change between draws of one frame.
+void QueueShaderValue(RenderQueue* queue, Shader shader, int locIndex, const void* value, int uniformType);
+
+// Sort the commands (opaque first, then by blend mode, shader, material and mesh), draw them and clear the
+// queue. Call inside BeginMode3D. Draw calls, triangles, state changes, uniform uploads and the CPU time
+// spent are added to stats when it isn't NULL.
+void SubmitRenderQueue(RenderQueue* queue, RenderStats* stats);
+
+// Forget the values shaders hold, for when the shaders are unloaded
+void ResetRenderQueueUniforms(RenderQueue* queue);
+
+#endif // RENDER_QUEUE_H
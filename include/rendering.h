@@ -4,6 +4,7 @@
 #include "raylib.h"
 #include "rlgl.h"
 #include "game_types.h"
+#include "lighting.h"
 
 // Wireframe shader management
 typedef struct {
@@ -14,12 +15,63 @@ typedef struct {
     int wireframeThicknessLoc;
 } WireframeShader;
 
+#define LIGHT_DATA_TEXELS 4             // RGBA32F texels per light row in the light data texture
+#define CLUSTER_TEXTURE_WIDTH 256       // Cluster data texture size in texels, cell headers then light lists
+#define CLUSTER_TEXTURE_HEIGHT 64
+#define MAX_SHADER_CELL_LIGHTS 64       // Lights lighting.fs evaluates per cluster cell, and directional lights
+
+// Per-pixel lighting shader (lighting.vs/lighting.fs). The lights are stored in a float data texture and
+// assigned to a world-space cluster grid, so each pixel only evaluates the lights of its cell. The shader
+// takes up to MAX_SHADER_LIGHTS lights and MAX_SHADER_CELL_LIGHTS per cell, lights beyond that are dropped
+// with a warning.
+typedef struct {
+    Shader shader;
+    bool loaded;
+    Texture2D lightData;            // MAX_SHADER_LIGHTS rows: position/type, direction/spot cutoff, color/intensity, range
+    Texture2D clusterData;          // Cell headers (first texel, count), then light indices, one per texel
+    float* lightTexels;             // CPU copies of the textures, reused between uploads
+    float* clusterTexels;
+    LightClusterGrid grid;
+    int clusterOriginLoc;
+    int clusterCellSizeLoc;
+    int clusterSizeLoc;
+    int globalLightsLoc;
+    int ambientLoc;
+    int specularStrengthLoc;
+    int shininessLoc;
+    int advancedShadingLoc;
+    int sunPositionLoc;
+    int viewPosLoc;
+    bool uploaded;                  // Light data below has been sent at least once
+    unsigned int uploadedVersion;   // LightingSystem.version of the last light upload
+    bool uploadedAdvanced;
+    float uploadedSpecularStrength;
+    float uploadedShininess;
+    int uploadCount;                // Number of light uploads so far (for the HUD/tests)
+    int droppedLights;              // Lights and cell entries of the last upload the shader can't evaluate
+} LightingShader;
+
+// View frustum as six planes (x, y, z = normal pointing inside, w = distance)
+typedef struct {
+    Vector4 planes[6];
+} Frustum;
+
 // Initialize wireframe shader system
 WireframeShader LoadWireframeShader(void);
 
 // Cleanup wireframe shader
 void UnloadWireframeShader(WireframeShader* wireframeShader);
 
+// Load/unload the per-pixel lighting shader
+LightingShader LoadLightingShader(void);
+void UnloadLightingShader(LightingShader* lightingShader);
+
+// Draw a material with the lighting shader, its light textures take the emission and height map slots
+void SetLightingShaderMaterial(const LightingShader* lightingShader, Material* material);
+
+// Upload lights only if the lighting system or shading settings changed, the view position every call
+void UpdateLightingShader(LightingShader* lightingShader, const LightingSystem* lighting, const GraphicsConfig* config, Vector3 viewPos);
+
 // Draw model with wireframe shader
 void DrawModelWireframe(Model model, Vector3 position, float scale, Color tint, 
                        WireframeShader* wireframeShader, GraphicsConfig* config);
@@ -30,4 +82,13 @@ void DrawCubeWiresThick(Vector3 position, float width, float height, float lengt
 // Draw cube-sphere wireframe with dynamic tessellation
 void DrawCubeSphereWires(Vector3 center, float radius, int subdivisions, Color color, GraphicsConfig* config);
 
+// Frustum of a perspective camera with the projection BeginMode3D uses
+Frustum GetCameraFrustum(Camera3D camera, float aspect);
+
+// False when the box lies completely outside one of the frustum planes
+bool IsBoxInFrustum(const Frustum* frustum, BoundingBox box);
+
+// Build a model that owns several already uploaded meshes sharing one default material
+Model LoadModelFromMeshes(const Mesh* meshes, int meshCount);
+
 #endif // RENDERING_H
\ No newline at end of file
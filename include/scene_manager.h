@@ -7,11 +7,42 @@
 // Scene manager functions
 SceneManager InitSceneManager(void);
 void AddScene(SceneManager* manager, Scene scene);
-void SwitchScene(SceneManager* manager, int sceneIndex);
+
+// Make a scene current. The previous scene is suspended and stays loaded, the new one is resumed when it is
+// still loaded or initialized otherwise. Suspended scenes over the cache budget are then unloaded, least
+// recently used first. The time taken is kept in lastSwitchMs.
+// A scene that loads in the background is preloaded instead while the current scene keeps running, the
+// switch happens in UpdateSceneLoads once it is ready (pendingSceneIndex until then).
+void SwitchScene(SceneManager* manager, int sceneIndex, LightingSystem* lighting, GraphicsConfig* gfxConfig);
+
+// Start loading a scene in the background, returns false for scenes without a load function
+bool PreloadScene(SceneManager* manager, int sceneIndex);
+
+// Once per frame on the main thread: run a few upload steps of background loads, finish the pending switch
+// when its scene is ready and prefetch the likeliest next scene after the current one has settled
+void UpdateSceneLoads(SceneManager* manager, LightingSystem* lighting, GraphicsConfig* gfxConfig);
+
+// 0 to 1 for a scene being loaded in the background, 1 when loaded and 0 when not loading
+float GetSceneLoadProgress(const SceneManager* manager, int sceneIndex);
+
+// Bytes of suspended scenes to keep loaded (0 unloads every scene switched away from), evicts right away
+void SetSceneCacheBudget(SceneManager* manager, size_t bytes);
+
+// Bytes held by suspended scenes
+size_t GetSceneCacheMemory(const SceneManager* manager);
+
 void UpdateCurrentScene(SceneManager* manager, float deltaTime, Camera3D* camera);
-void RenderCurrentScene(SceneManager* manager, Camera3D camera, GraphicsConfig* gfxConfig, struct WireframeShader* wireframeShader);
+
+// Advance the simulation of the current scene by one fixed step
+void StepCurrentScene(SceneManager* manager, float stepTime);
+
+// Draw the current scene, interpolation (0 to 1) places moving objects between their last two steps
+void RenderCurrentScene(SceneManager* manager, Camera3D camera, float interpolation, GraphicsConfig* gfxConfig, struct WireframeShader* wireframeShader);
 void CleanupSceneManager(SceneManager* manager);
 
+// Move a body of the given radius through the current scene, returns where it ends up after collisions
+Vector3 MoveInCurrentScene(SceneManager* manager, Vector3 position, Vector3 delta, float radius);
+
 // Scene creation functions
 Scene CreateMazeScene(void);
 Scene CreateTerrainScene(void);
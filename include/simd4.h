@@ -0,0 +1,172 @@
+#ifndef SIMD4_H
+#define SIMD4_H
+
+// Minimal 4-wide float/int vector helpers.
+// Uses SSE2 on x86, NEON on ARM (Pi 4) and plain structs elsewhere.
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define SIMD4_SSE2
+    #include <emmintrin.h>
+    typedef __m128 float4;
+    typedef __m128i int4;
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+    #define SIMD4_NEON
+    #include <arm_neon.h>
+    typedef float32x4_t float4;
+    typedef int32x4_t int4;
+#else
+    #define SIMD4_SCALAR
+    #include <math.h>
+    typedef struct { float v[4]; } float4;
+    typedef struct { int v[4]; } int4;
+#endif
+
+#define SIMD4_WIDTH 4
+
+#if defined(SIMD4_SSE2)
+
+static inline float4 F4Load(const float* p) { return _mm_loadu_ps(p); }
+static inline void F4Store(float* p, float4 a) { _mm_storeu_ps(p, a); }
+static inline float4 F4Set1(float x) { return _mm_set1_ps(x); }
+static inline float4 F4Add(float4 a, float4 b) { return _mm_add_ps(a, b); }
+static inline float4 F4Sub(float4 a, float4 b) { return _mm_sub_ps(a, b); }
+static inline float4 F4Mul(float4 a, float4 b) { return _mm_mul_ps(a, b); }
+static inline float4 F4Div(float4 a, float4 b) { return _mm_div_ps(a, b); }
+static inline float4 F4Min(float4 a, float4 b) { return _mm_min_ps(a, b); }
+static inline float4 F4Max(float4 a, float4 b) { return _mm_max_ps(a, b); }
+static inline float4 F4Sqrt(float4 a) { return _mm_sqrt_ps(a); }
+static inline float4 F4CmpLt(float4 a, float4 b) { return _mm_cmplt_ps(a, b); }
+static inline float4 F4CmpGt(float4 a, float4 b) { return _mm_cmpgt_ps(a, b); }
+static inline float4 F4And(float4 a, float4 b) { return _mm_and_ps(a, b); }
+static inline float4 F4Select(float4 mask, float4 a, float4 b) { return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b)); }
+static inline int F4AnyTrue(float4 mask) { return _mm_movemask_ps(mask) != 0; }
+static inline int4 F4ToInt(float4 a) { return _mm_cvttps_epi32(a); }
+
+static inline int4 I4Set1(int x) { return _mm_set1_epi32(x); }
+static inline int4 I4Add(int4 a, int4 b) { return _mm_add_epi32(a, b); }
+static inline int4 I4Sub(int4 a, int4 b) { return _mm_sub_epi32(a, b); }
+static inline int4 I4Xor(int4 a, int4 b) { return _mm_xor_si128(a, b); }
+static inline int4 I4And(int4 a, int4 b) { return _mm_and_si128(a, b); }
+static inline int4 I4ShiftLeft(int4 a, int n) { return _mm_sll_epi32(a, _mm_cvtsi32_si128(n)); }
+static inline float4 I4ToFloat(int4 a) { return _mm_cvtepi32_ps(a); }
+static inline float4 I4AsFloat(int4 a) { return _mm_castsi128_ps(a); }
+
+// SSE2 has no 32-bit low multiply, build it from two 32x32->64 multiplies
+static inline int4 I4Mul(int4 a, int4 b) {
+    __m128i even = _mm_mul_epu32(a, b);
+    __m128i odd = _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+    return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)),
+                              _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+}
+
+// Floor without SSE4.1: truncate, then subtract one where truncation rounded up
+static inline float4 F4Floor(float4 a) {
+    float4 t = _mm_cvtepi32_ps(_mm_cvttps_epi32(a));
+    return _mm_sub_ps(t, _mm_and_ps(_mm_cmpgt_ps(t, a), _mm_set1_ps(1.0f)));
+}
+
+#elif defined(SIMD4_NEON)
+
+static inline float4 F4Load(const float* p) { return vld1q_f32(p); }
+static inline void F4Store(float* p, float4 a) { vst1q_f32(p, a); }
+static inline float4 F4Set1(float x) { return vdupq_n_f32(x); }
+static inline float4 F4Add(float4 a, float4 b) { return vaddq_f32(a, b); }
+static inline float4 F4Sub(float4 a, float4 b) { return vsubq_f32(a, b); }
+static inline float4 F4Mul(float4 a, float4 b) { return vmulq_f32(a, b); }
+static inline float4 F4Min(float4 a, float4 b) { return vminq_f32(a, b); }
+static inline float4 F4Max(float4 a, float4 b) { return vmaxq_f32(a, b); }
+static inline float4 F4CmpLt(float4 a, float4 b) { return vreinterpretq_f32_u32(vcltq_f32(a, b)); }
+static inline float4 F4CmpGt(float4 a, float4 b) { return vreinterpretq_f32_u32(vcgtq_f32(a, b)); }
+static inline float4 F4And(float4 a, float4 b) { return vreinterpretq_f32_u32(vandq_u32(vreinterpretq_u32_f32(a), vreinterpretq_u32_f32(b))); }
+static inline float4 F4Select(float4 mask, float4 a, float4 b) { return vbslq_f32(vreinterpretq_u32_f32(mask), a, b); }
+static inline int4 F4ToInt(float4 a) { return vcvtq_s32_f32(a); }
+
+#if defined(__aarch64__)
+static inline float4 F4Div(float4 a, float4 b) { return vdivq_f32(a, b); }
+static inline float4 F4Sqrt(float4 a) { return vsqrtq_f32(a); }
+static inline float4 F4Floor(float4 a) { return vrndmq_f32(a); }
+static inline int F4AnyTrue(float4 mask) { return vmaxvq_u32(vreinterpretq_u32_f32(mask)) != 0; }
+#else
+static inline float4 F4Div(float4 a, float4 b) {
+    float4 r = vrecpeq_f32(b);
+    r = vmulq_f32(vrecpsq_f32(b, r), r);
+    r = vmulq_f32(vrecpsq_f32(b, r), r);
+    return vmulq_f32(a, r);
+}
+static inline float4 F4Sqrt(float4 a) {
+    float4 r = vrsqrteq_f32(a);
+    r = vmulq_f32(vrsqrtsq_f32(vmulq_f32(a, r), r), r);
+    r = vmulq_f32(vrsqrtsq_f32(vmulq_f32(a, r), r), r);
+    return F4Select(F4CmpGt(a, vdupq_n_f32(0.0f)), vmulq_f32(a, r), vdupq_n_f32(0.0f));
+}
+static inline float4 F4Floor(float4 a) {
+    float4 t = vcvtq_f32_s32(vcvtq_s32_f32(a));
+    return vsubq_f32(t, F4And(F4CmpGt(t, a), vdupq_n_f32(1.0f)));
+}
+static inline int F4AnyTrue(float4 mask) {
+    uint32x2_t m = vorr_u32(vget_low_u32(vreinterpretq_u32_f32(mask)), vget_high_u32(vreinterpretq_u32_f32(mask)));
+    return (vget_lane_u32(m, 0) | vget_lane_u32(m, 1)) != 0;
+}
+#endif
+
+static inline int4 I4Set1(int x) { return vdupq_n_s32(x); }
+static inline int4 I4Add(int4 a, int4 b) { return vaddq_s32(a, b); }
+static inline int4 I4Sub(int4 a, int4 b) { return vsubq_s32(a, b); }
+static inline int4 I4Xor(int4 a, int4 b) { return veorq_s32(a, b); }
+static inline int4 I4And(int4 a, int4 b) { return vandq_s32(a, b); }
+static inline int4 I4Mul(int4 a, int4 b) { return vmulq_s32(a, b); }
+static inline int4 I4ShiftLeft(int4 a, int n) { return vshlq_s32(a, vdupq_n_s32(n)); }
+static inline float4 I4ToFloat(int4 a) { return vcvtq_f32_s32(a); }
+static inline float4 I4AsFloat(int4 a) { return vreinterpretq_f32_s32(a); }
+
+#else // SIMD4_SCALAR
+
+#define SIMD4_MAP(expr) float4 r; for (int i = 0; i < 4; i++) r.v[i] = (expr); return r
+#define SIMD4_IMAP(expr) int4 r; for (int i = 0; i < 4; i++) r.v[i] = (expr); return r
+
+static inline float4 F4Load(const float* p) { SIMD4_MAP(p[i]); }
+static inline void F4Store(float* p, float4 a) { for (int i = 0; i < 4; i++) p[i] = a.v[i]; }
+static inline float4 F4Set1(float x) { SIMD4_MAP(x); }
+static inline float4 F4Add(float4 a, float4 b) { SIMD4_MAP(a.v[i] + b.v[i]); }
+static inline float4 F4Sub(float4 a, float4 b) { SIMD4_MAP(a.v[i] - b.v[i]); }
+static inline float4 F4Mul(float4 a, float4 b) { SIMD4_MAP(a.v[i] * b.v[i]); }
+static inline float4 F4Div(float4 a, float4 b) { SIMD4_MAP(a.v[i] / b.v[i]); }
+static inline float4 F4Min(float4 a, float4 b) { SIMD4_MAP(a.v[i] < b.v[i] ? a.v[i] : b.v[i]); }
+static inline float4 F4Max(float4 a, float4 b) { SIMD4_MAP(a.v[i] > b.v[i] ? a.v[i] : b.v[i]); }
+static inline float4 F4Sqrt(float4 a) { SIMD4_MAP(sqrtf(a.v[i])); }
+static inline float4 F4Floor(float4 a) { SIMD4_MAP(floorf(a.v[i])); }
+// Masks are all-ones/all-zeros lanes stored as floats, like the SIMD versions
+static inline float SIMD4MaskValue(int on) { union { unsigned int u; float f; } m; m.u = on ? 0xFFFFFFFFu : 0u; return m.f; }
+static inline unsigned int SIMD4MaskBits(float f) { union { unsigned int u; float f; } m; m.f = f; return m.u; }
+static inline float4 F4CmpLt(float4 a, float4 b) { SIMD4_MAP(SIMD4MaskValue(a.v[i] < b.v[i])); }
+static inline float4 F4CmpGt(float4 a, float4 b) { SIMD4_MAP(SIMD4MaskValue(a.v[i] > b.v[i])); }
+static inline float4 F4And(float4 a, float4 b) {
+    float4 r;
+    for (int i = 0; i < 4; i++) { union { unsigned int u; float f; } m; m.u = SIMD4MaskBits(a.v[i]) & SIMD4MaskBits(b.v[i]); r.v[i] = m.f; }
+    return r;
+}
+static inline float4 F4Select(float4 mask, float4 a, float4 b) { SIMD4_MAP(SIMD4MaskBits(mask.v[i]) ? a.v[i] : b.v[i]); }
+static inline int F4AnyTrue(float4 mask) { return (SIMD4MaskBits(mask.v[0]) | SIMD4MaskBits(mask.v[1]) | SIMD4MaskBits(mask.v[2]) | SIMD4MaskBits(mask.v[3])) != 0; }
+static inline int4 F4ToInt(float4 a) { SIMD4_IMAP((int)a.v[i]); }
+
+static inline int4 I4Set1(int x) { SIMD4_IMAP(x); }
+static inline int4 I4Add(int4 a, int4 b) { SIMD4_IMAP((int)((unsigned int)a.v[i] + (unsigned int)b.v[i])); }
+static inline int4 I4Sub(int4 a, int4 b) { SIMD4_IMAP((int)((unsigned int)a.v[i] - (unsigned int)b.v[i])); }
+static inline int4 I4Xor(int4 a, int4 b) { SIMD4_IMAP(a.v[i] ^ b.v[i]); }
+static inline int4 I4And(int4 a, int4 b) { SIMD4_IMAP(a.v[i] & b.v[i]); }
+static inline int4 I4Mul(int4 a, int4 b) { SIMD4_IMAP((int)((unsigned int)a.v[i] * (unsigned int)b.v[i])); }
+static inline int4 I4ShiftLeft(int4 a, int n) { SIMD4_IMAP((int)((unsigned int)a.v[i] << n)); }
+static inline float4 I4ToFloat(int4 a) { SIMD4_MAP((float)a.v[i]); }
+static inline float4 I4AsFloat(int4 a) { float4 r; for (int i = 0; i < 4; i++) { union { int s; float f; } m; m.s = a.v[i]; r.v[i] = m.f; } return r; }
+
+#undef SIMD4_MAP
+#undef SIMD4_IMAP
+
+#endif
+
+// Fused helpers shared by all backends
+static inline float4 F4MulAdd(float4 a, float4 b, float4 c) { return F4Add(F4Mul(a, b), c); }
+static inline float4 F4Lerp(float4 a, float4 b, float4 t) { return F4Add(a, F4Mul(t, F4Sub(b, a))); }
+static inline float4 F4Clamp(float4 a, float4 lo, float4 hi) { return F4Min(F4Max(a, lo), hi); }
+
+#endif // SIMD4_H
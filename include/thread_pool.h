@@ -0,0 +1,73 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <stdbool.h>
+
+#define MAX_POOL_THREADS 16
+#define JOB_CAPACITY 4096               // Jobs scheduled and not finished yet, a power of two
+#define JOB_MAX_DEPENDENTS 8            // Jobs waiting on one job, scheduling a further one waits for the job instead
+#define JOB_COMPLETIONS_PER_FRAME 8     // Completions the game runs each frame
+
+// Work callback for ParallelFor, processes items [start, end)
+typedef void (*ParallelForFunc)(void* context, int start, int end);
+
+// Work or completion callback of a job
+typedef void (*JobFunc)(void* context);
+
+// A scheduled job. The handle stays valid after the job finished and its slot was reused, it then
+// reads as done. The zero handle is always done.
+typedef struct {
+    int index;
+    unsigned int generation;
+} JobHandle;
+
+// Scheduler counters since InitThreadPool
+typedef struct {
+    long long scheduled;
+    long long stolen;           // Jobs taken from another worker's queue
+    long long sleeps;           // Times a worker ran out of jobs and blocked
+    long long completions;      // Completions run on the main thread
+} JobStats;
+
+// Start worker threads (threadCount <= 0 uses the number of CPU cores). Each worker owns a job deque,
+// takes its newest job first and steals the oldest job of another worker when its own deque is empty.
+void InitThreadPool(int threadCount);
+
+// Stop and join all worker threads, jobs still queued are run first
+void ShutdownThreadPool(void);
+
+// Number of threads that take part in a ParallelFor (workers + caller)
+int GetThreadPoolSize(void);
+
+// Number of online CPU cores
+int GetCPUCoreCount(void);
+
+// Split [0, count) into chunks of grainSize and run them on the pool, returns when all are done.
+// The caller works on the chunks too. Nested calls from inside a job or another ParallelFor are
+// spread over the pool as well, the waiting thread runs other jobs meanwhile.
+void ParallelFor(int count, int grainSize, ParallelForFunc func, void* context);
+
+// Run func(context) on the pool once the dependencies (may be NULL) have finished. Any thread can
+// schedule jobs, including jobs themselves. Starts the pool if it isn't running. With all JOB_CAPACITY
+// jobs in flight it blocks until a slot frees up, and outside the workers it runs no jobs meanwhile.
+JobHandle ScheduleJob(JobFunc func, void* context, const JobHandle* dependencies, int dependencyCount);
+
+// Same, then queue completion(context) for the main thread. Completions run in RunJobCompletions in
+// the order their jobs finished, which makes them the place for GPU uploads of results built on the
+// pool. Jobs depending on this one don't wait for the completion. context must outlive it.
+JobHandle ScheduleJobWithCompletion(JobFunc func, JobFunc completion, void* context, const JobHandle* dependencies, int dependencyCount);
+
+bool IsJobDone(JobHandle job);
+
+// Block until the job finished, running queued jobs on this thread meanwhile. Outside the workers only
+// the job itself and the jobs it depends on are run, so waiting on the main thread never picks up
+// unrelated long jobs.
+void WaitJob(JobHandle job);
+
+// Run up to maxCount queued completions (maxCount <= 0 runs all of them), main thread only.
+// Returns the number run.
+int RunJobCompletions(int maxCount);
+
+JobStats GetJobStats(void);
+
+#endif // THREAD_POOL_H
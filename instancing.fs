@@ -0,0 +1,21 @@
+#version 100
+
+#ifdef GL_FRAGMENT_PRECISION_HIGH
+precision highp float;
+#else
+precision mediump float;
+#endif
+
+// Input vertex attributes (from vertex shader)
+varying vec3 fragPosition;
+varying vec2 fragTexCoord;
+varying vec4 fragColor;
+varying vec3 fragNormal;
+
+uniform vec4 colDiffuse;
+
+void main()
+{
+    // Colors are baked into the vertices like the default raylib shader, tinted per batch
+    gl_FragColor = fragColor * colDiffuse;
+}
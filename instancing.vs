@@ -0,0 +1,30 @@
+#version 100
+
+// Input vertex attributes (from vertex buffer)
+attribute vec3 vertexPosition;    // vertex position in local space
+attribute vec2 vertexTexCoord;    // vertex texture coordinates
+attribute vec3 vertexNormal;      // vertex normal
+attribute vec4 vertexColor;       // vertex color
+attribute mat4 instanceTransform; // model matrix of this instance (DrawMeshInstanced)
+
+// Input uniform values
+uniform mat4 mvp;          // view-projection matrix (the model matrix comes per instance)
+
+// Output values to fragment shader, same as lighting.vs
+varying vec3 fragPosition;     // vertex position in world space
+varying vec2 fragTexCoord;     // vertex texture coordinates
+varying vec4 fragColor;        // vertex color
+varying vec3 fragNormal;       // vertex normal in world space
+
+void main()
+{
+    vec4 worldPosition = instanceTransform * vec4(vertexPosition, 1.0);
+    fragPosition = worldPosition.xyz;
+    fragTexCoord = vertexTexCoord;
+    fragColor = vertexColor;
+    
+    // Instances are translated, rotated and uniformly scaled, so the model matrix also turns the normals
+    fragNormal = normalize(vec3(instanceTransform * vec4(vertexNormal, 0.0)));
+    
+    gl_Position = mvp * worldPosition;
+}
@@ -0,0 +1,113 @@
+#version 100
+
+#ifdef GL_FRAGMENT_PRECISION_HIGH
+precision highp float;
+#else
+precision mediump float;
+#endif
+
+// Must match MAX_SHADER_LIGHTS in game_types.h and the CLUSTER_TEXTURE_* / MAX_SHADER_CELL_LIGHTS in rendering.h
+#define MAX_LIGHTS 256.0
+#define CLUSTER_TEXTURE_WIDTH 256.0
+#define CLUSTER_TEXTURE_HEIGHT 64.0
+#define MAX_CELL_LIGHTS 64
+
+// Input vertex attributes (from vertex shader)
+varying vec3 fragPosition;
+varying vec2 fragTexCoord;
+varying vec4 fragColor;
+varying vec3 fragNormal;
+
+uniform vec4 colDiffuse;
+
+// Lighting system, uploaded by UpdateLightingShader only when the lights change
+uniform sampler2D lightData;                // Row per light: position/type, direction/spot cutoff, color (0-1)/intensity, range
+uniform sampler2D clusterData;              // Cell headers (first texel, count), then light indices, one per texel
+uniform vec3 clusterOrigin;                 // Minimum corner of the cluster grid
+uniform float clusterCellSize;
+uniform vec3 clusterSize;                   // Cells per axis
+uniform vec2 globalLights;                  // First texel and count of the directional lights
+uniform vec3 ambient;                       // ambientColor * ambientIntensity
+uniform float specularStrength;
+uniform float shininess;
+uniform float advancedShading;              // 0 = simple sun lighting like CalculateSimpleLighting
+uniform vec3 sunPosition;
+uniform vec3 viewPos;
+
+vec4 FetchCluster(float texel)
+{
+    float row = floor(texel/CLUSTER_TEXTURE_WIDTH);
+    float col = texel - row*CLUSTER_TEXTURE_WIDTH;
+    return texture2D(clusterData, vec2((col + 0.5)/CLUSTER_TEXTURE_WIDTH, (row + 0.5)/CLUSTER_TEXTURE_HEIGHT));
+}
+
+// Same Blinn-Phong model as CalculateVertexLighting, evaluated per pixel for one light
+vec3 ShadeLight(float light, vec3 base, vec3 normal, vec3 viewDir)
+{
+    float v = (light + 0.5)/MAX_LIGHTS;
+    vec4 positionType = texture2D(lightData, vec2(0.125, v));
+    vec4 directionCutoff = texture2D(lightData, vec2(0.375, v));
+    vec4 colorIntensity = texture2D(lightData, vec2(0.625, v));
+    float range = texture2D(lightData, vec2(0.875, v)).x;
+    
+    vec3 lightDir;
+    float attenuation = 1.0;
+    
+    if (positionType.w < 0.5) {
+        lightDir = -directionCutoff.xyz;
+    } else {
+        vec3 toLight = positionType.xyz - fragPosition;
+        float dist = length(toLight);
+        if (dist > range) return vec3(0.0);
+        
+        lightDir = toLight/max(dist, 1e-4);
+        attenuation = 1.0/(1.0 + 0.09*dist + 0.032*dist*dist);
+        
+        if (positionType.w > 1.5) {
+            float spotCos = dot(-lightDir, directionCutoff.xyz);
+            if (spotCos < directionCutoff.w) return vec3(0.0);
+            attenuation *= spotCos;
+        }
+    }
+    
+    float NdotL = max(dot(normal, lightDir), 0.0);
+    vec3 halfDir = normalize(lightDir + viewDir);
+    float NdotH = max(dot(normal, halfDir), 0.0);
+    float specular = pow(NdotH, shininess)*specularStrength;
+    
+    float intensity = colorIntensity.w*attenuation;
+    return base*intensity*NdotL + colorIntensity.rgb*intensity*specular;
+}
+
+void main()
+{
+    vec3 base = fragColor.rgb;
+    vec3 normal = normalize(fragNormal);
+    vec3 total;
+    
+    if (advancedShading < 0.5) {
+        // 0.3 ambient + 0.7 Lambert towards the sun
+        vec3 sunDir = normalize(sunPosition - fragPosition);
+        total = base*(0.3 + 0.7*max(dot(normal, sunDir), 0.0));
+    } else {
+        vec3 viewDir = normalize(viewPos - fragPosition);
+        total = base*ambient;
+        
+        for (int i = 0; i < MAX_CELL_LIGHTS; i++) {
+            if (float(i) >= globalLights.y) break;
+            total += ShadeLight(FetchCluster(globalLights.x + float(i)).x, base, normal, viewDir);
+        }
+        
+        // Point and spot lights of the fragment's cluster cell, none reach outside the grid
+        vec3 cell = floor((fragPosition - clusterOrigin)/clusterCellSize);
+        if (all(greaterThanEqual(cell, vec3(0.0))) && all(lessThan(cell, clusterSize))) {
+            vec4 header = FetchCluster((cell.z*clusterSize.y + cell.y)*clusterSize.x + cell.x);
+            for (int i = 0; i < MAX_CELL_LIGHTS; i++) {
+                if (float(i) >= header.y) break;
+                total += ShadeLight(FetchCluster(header.x + float(i)).x, base, normal, viewDir);
+            }
+        }
+    }
+    
+    gl_FragColor = vec4(clamp(total, 0.0, 1.0), fragColor.a)*colDiffuse;
+}
@@ -0,0 +1,154 @@
+#include "arena.h"
+#include <stdlib.h>
+#include <string.h>
+
+struct ArenaBlock {
+    ArenaBlock* next;
+    size_t size;                // Usable bytes after the header
+    size_t used;
+};
+
+// Size rounded up to ARENA_ALIGNMENT
+static size_t AlignArenaSize(size_t size) {
+    return (size + ARENA_ALIGNMENT - 1) & ~(size_t)(ARENA_ALIGNMENT - 1);
+}
+
+// First usable byte of a block, the header is padded to the alignment
+static unsigned char* GetArenaBlockData(ArenaBlock* block) {
+    return (unsigned char*)block + AlignArenaSize(sizeof(ArenaBlock));
+}
+
+MemoryArena* CreateArena(size_t blockSize) {
+    MemoryArena* arena = (MemoryArena*)calloc(1, sizeof(MemoryArena));
+    if (!arena) return NULL;
+    arena->blockSize = blockSize > 0 ? blockSize : ARENA_BLOCK_SIZE;
+    return arena;
+}
+
+void UnloadArena(MemoryArena* arena) {
+    if (!arena) return;
+    ClearArena(arena);
+    free(arena);
+}
+
+void* ArenaAlloc(MemoryArena* arena, size_t size) {
+    size = AlignArenaSize(size > 0 ? size : 1);
+
+    // Move on to the next free block that fits, the rest of the current one waits for the reset
+    ArenaBlock* block = arena->current;
+    while (block && block->used + size > block->size) {
+        block = block->next;
+        if (block && block->used != 0) block = NULL;
+    }
+
+    if (!block) {
+        size_t blockSize = size > arena->blockSize ? size : arena->blockSize;
+        block = (ArenaBlock*)malloc(AlignArenaSize(sizeof(ArenaBlock)) + blockSize);
+        if (!block) return NULL;
+        block->size = blockSize;
+        block->used = 0;
+        block->next = NULL;
+
+        // Append after the last block so the free blocks behind current stay in order
+        if (!arena->first) {
+            arena->first = block;
+        } else {
+            ArenaBlock* last = arena->current ? arena->current : arena->first;
+            while (last->next) last = last->next;
+            last->next = block;
+        }
+        arena->capacity += blockSize;
+        arena->blockCount++;
+        arena->blockMallocs++;
+    }
+    arena->current = block;
+
+    void* memory = GetArenaBlockData(block) + block->used;
+    block->used += size;
+    arena->used += size;
+    if (arena->used > arena->peak) arena->peak = arena->used;
+    arena->allocCount++;
+    arena->totalAllocs++;
+    return memory;
+}
+
+void* ArenaCalloc(MemoryArena* arena, size_t count, size_t size) {
+    void* memory = ArenaAlloc(arena, count * size);
+    if (memory) memset(memory, 0, count * size);
+    return memory;
+}
+
+void ResetArena(MemoryArena* arena) {
+    for (ArenaBlock* block = arena->first; block; block = block->next) block->used = 0;
+    arena->current = arena->first;
+    arena->used = 0;
+    arena->allocCount = 0;
+    arena->resetCount++;
+}
+
+void ClearArena(MemoryArena* arena) {
+    ArenaBlock* block = arena->first;
+    while (block) {
+        ArenaBlock* next = block->next;
+        free(block);
+        block = next;
+    }
+    arena->first = NULL;
+    arena->current = NULL;
+    arena->capacity = 0;
+    arena->blockCount = 0;
+    arena->used = 0;
+    arena->allocCount = 0;
+    arena->resetCount++;
+}
+
+bool AllocMeshBuffers(Mesh* mesh, int vertexCount, int triangleCount, MemoryArena* arena) {
+    size_t sizes[5] = {
+        (size_t)vertexCount * 3 * sizeof(float),            // vertices
+        (size_t)vertexCount * 2 * sizeof(float),            // texcoords
+        (size_t)vertexCount * 3 * sizeof(float),            // normals
+        (size_t)vertexCount * 4,                            // colors
+        (size_t)triangleCount * 3 * sizeof(unsigned short)  // indices
+    };
+    void* arrays[5] = { NULL };
+
+    if (arena) {
+        size_t total = 0;
+        for (int i = 0; i < 5; i++) total += AlignArenaSize(sizes[i]);
+        unsigned char* memory = (unsigned char*)ArenaAlloc(arena, total);
+        if (!memory) return false;
+        for (int i = 0; i < 5; i++) {
+            arrays[i] = memory;
+            memory += AlignArenaSize(sizes[i]);
+        }
+    } else {
+        for (int i = 0; i < 5; i++) {
+            arrays[i] = MemAlloc((unsigned int)sizes[i]);
+            if (!arrays[i]) {
+                for (int j = 0; j < i; j++) MemFree(arrays[j]);
+                return false;
+            }
+        }
+    }
+
+    mesh->vertexCount = vertexCount;
+    mesh->triangleCount = triangleCount;
+    mesh->vertices = (float*)arrays[0];
+    mesh->texcoords = (float*)arrays[1];
+    mesh->normals = (float*)arrays[2];
+    mesh->colors = (unsigned char*)arrays[3];
+    mesh->indices = (unsigned short*)arrays[4];
+    return true;
+}
+
+void UnloadArenaModel(Model model) {
+    for (int i = 0; i < model.meshCount; i++) {
+        Mesh* mesh = &model.meshes[i];
+        mesh->vertices = NULL;
+        mesh->texcoords = NULL;
+        mesh->normals = NULL;
+        mesh->colors = NULL;
+        mesh->indices = NULL;
+    }
+    UnloadModel(model);
+}
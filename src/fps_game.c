@@ -11,6 +11,8 @@
 #include "rendering.h"
 #include "maze.h"
 #include "scene_manager.h"
+#include "thread_pool.h"
+#include "arena.h"
 
 int main(void)
 {
@@ -27,6 +29,8 @@ int main(void)
     gfxConfig.specularStrength = 0.5f;
     gfxConfig.shininess = 32.0f;
     gfxConfig.wireframeShaderEnabled = false;
+    gfxConfig.perPixelLightingEnabled = false;
+    gfxConfig.wallRenderMode = WALL_RENDER_BATCHED;
     gfxConfig.wireframeColor = WHITE;
     
     // Initialize lighting system
@@ -37,8 +41,9 @@ int main(void)
              (Vector3){-0.3f, -1.0f, -0.2f}, YELLOW, 1.0f, 1000.0f, 0.0f);
     
     // Add a moving point light
-    AddLight(&lighting, LIGHT_POINT, (Vector3){0.0f, 15.0f, 0.0f}, (Vector3){0.0f, 0.0f, 0.0f}, 
+    int movingLight = AddLight(&lighting, LIGHT_POINT, (Vector3){0.0f, 15.0f, 0.0f}, (Vector3){0.0f, 0.0f, 0.0f}, 
              ORANGE, 2.0f, 100.0f, 0.0f);
+    if (movingLight >= 0) lighting.lights[movingLight].dynamic = true;
     
     // Add a spot light
     AddLight(&lighting, LIGHT_SPOT, (Vector3){50.0f, 20.0f, 0.0f}, (Vector3){-1.0f, -1.0f, 0.0f}, 
@@ -75,6 +80,9 @@ int main(void)
     
     srand(time(NULL));
     
+    // Worker threads for parallel mesh and noise generation
+    InitThreadPool(0);
+    
     // Initialize scene manager
     SceneManager sceneManager = InitSceneManager();
     
@@ -88,12 +96,7 @@ int main(void)
     AddScene(&sceneManager, cubeSphereScene);
     
     // Start with maze scene
-    SwitchScene(&sceneManager, 0);
-    
-    // Initialize current scene
-    if (sceneManager.currentScene && sceneManager.currentScene->init) {
-        sceneManager.currentScene->init(sceneManager.currentScene, &lighting, &gfxConfig);
-    }
+    SwitchScene(&sceneManager, 0, &lighting, &gfxConfig);
     
     bool cursorLocked = false;
     Vector2 mousePos = {0};
@@ -109,8 +112,18 @@ int main(void)
     
     SetTargetFPS(60);
     
+    const char* wallModeNames[WALL_RENDER_MODE_COUNT] = { "BATCHED", "INSTANCED", "PER CELL" };
+    double cpuFrameMs = 0.0;    // Update and draw submission of the last frame, without the vsync wait
+    
+    // Fixed-rate simulation: frame time is added up and simulated in whole steps, the remainder carries over
+    float simulationTime = 0.0f;
+    Vector3 previousPosition = camera.position;     // Camera position before the last step
+    int lastFrameSteps = 0;
+    double droppedSimulationTime = 0.0;             // Seconds not simulated because frames were too slow
+    
     while (!WindowShouldClose())
     {
+        double frameStart = GetTime();
         float deltaTime = GetFrameTime();
         
         if (IsKeyPressed(KEY_TAB))
@@ -127,29 +140,21 @@ int main(void)
             }
         }
         
-        // Scene switching controls
+        // Scene switching controls (scenes switched away from stay loaded within the cache budget,
+        // terrain and planet load in the background and switch in when ready)
         if (IsKeyPressed(KEY_ONE))
         {
-            SwitchScene(&sceneManager, 0);
-            if (sceneManager.currentScene && sceneManager.currentScene->init) {
-                sceneManager.currentScene->init(sceneManager.currentScene, &lighting, &gfxConfig);
-            }
+            SwitchScene(&sceneManager, 0, &lighting, &gfxConfig);
         }
         
         if (IsKeyPressed(KEY_TWO))
         {
-            SwitchScene(&sceneManager, 1);
-            if (sceneManager.currentScene && sceneManager.currentScene->init) {
-                sceneManager.currentScene->init(sceneManager.currentScene, &lighting, &gfxConfig);
-            }
+            SwitchScene(&sceneManager, 1, &lighting, &gfxConfig);
         }
         
         if (IsKeyPressed(KEY_THREE))
         {
-            SwitchScene(&sceneManager, 2);
-            if (sceneManager.currentScene && sceneManager.currentScene->init) {
-                sceneManager.currentScene->init(sceneManager.currentScene, &lighting, &gfxConfig);
-            }
+            SwitchScene(&sceneManager, 2, &lighting, &gfxConfig);
         }
         
         // Graphics config controls
@@ -193,10 +198,21 @@ int main(void)
             TraceLog(LOG_INFO, "Wireframe Shader: %s", gfxConfig.wireframeShaderEnabled ? "ON" : "OFF");
         }
         
-        // Update lighting system
-        UpdateLightingSystem(&lighting, deltaTime);
+        if (IsKeyPressed(KEY_F7))
+        {
+            gfxConfig.perPixelLightingEnabled = !gfxConfig.perPixelLightingEnabled;
+            TraceLog(LOG_INFO, "Per-pixel Lighting: %s", gfxConfig.perPixelLightingEnabled ? "ON" : "OFF");
+        }
+        
+        if (IsKeyPressed(KEY_F8))
+        {
+            gfxConfig.wallRenderMode = (WallRenderMode)((gfxConfig.wallRenderMode + 1) % WALL_RENDER_MODE_COUNT);
+            TraceLog(LOG_INFO, "Wall Rendering: %s", wallModeNames[gfxConfig.wallRenderMode]);
+        }
         
-        // Update current scene
+        // Hand finished jobs back to the main thread, advance background scene loads, then update current scene
+        RunJobCompletions(JOB_COMPLETIONS_PER_FRAME);
+        UpdateSceneLoads(&sceneManager, &lighting, &gfxConfig);
         UpdateCurrentScene(&sceneManager, deltaTime, &camera);
         
         if (cursorLocked)
@@ -236,33 +252,61 @@ int main(void)
         if (IsKeyDown(KEY_S)) moveVector = Vector3Subtract(moveVector, forward);
         if (IsKeyDown(KEY_A)) moveVector = Vector3Subtract(moveVector, right);
         if (IsKeyDown(KEY_D)) moveVector = Vector3Add(moveVector, right);
+        if (Vector3Length(moveVector) > 0) moveVector = Vector3Normalize(moveVector);
         
-        if (Vector3Length(moveVector) > 0)
+        // Simulate the time that passed in fixed steps. After SIMULATION_MAX_STEPS the rest is dropped,
+        // so a slow frame slows the game down instead of making the next frame slower still.
+        simulationTime += deltaTime;
+        lastFrameSteps = 0;
+        while (simulationTime >= SIMULATION_STEP && lastFrameSteps < SIMULATION_MAX_STEPS)
+        {
+            previousPosition = camera.position;
+            
+            UpdateLightingSystem(&lighting, SIMULATION_STEP);
+            
+            if (Vector3Length(moveVector) > 0)
+            {
+                // The scene resolves collisions, the target follows by the distance actually moved
+                Vector3 moved = MoveInCurrentScene(&sceneManager, camera.position, Vector3Scale(moveVector, PLAYER_SPEED * SIMULATION_STEP), PLAYER_RADIUS);
+                camera.target = Vector3Add(camera.target, Vector3Subtract(moved, camera.position));
+                camera.position = moved;
+            }
+            
+            // Floor collision detection - prevent falling too far underground
+            float minHeight = -2.0f; // Allow going below sea level but not too far
+            if (camera.position.y < minHeight) {
+                camera.position.y = minHeight;
+                camera.target.y = camera.target.y + (minHeight - (camera.position.y - (camera.target.y - camera.position.y)));
+            }
+            
+            StepCurrentScene(&sceneManager, SIMULATION_STEP);
+            
+            simulationTime -= SIMULATION_STEP;
+            lastFrameSteps++;
+        }
+        if (simulationTime >= SIMULATION_STEP)
         {
-            moveVector = Vector3Normalize(moveVector);
-            moveVector = Vector3Scale(moveVector, PLAYER_SPEED * deltaTime);
-            camera.position = Vector3Add(camera.position, moveVector);
-            camera.target = Vector3Add(camera.target, moveVector);
+            droppedSimulationTime += simulationTime;
+            simulationTime = 0.0f;
         }
         
-        // Floor collision detection - prevent falling too far underground
-        float minHeight = -2.0f; // Allow going below sea level but not too far
-        if (camera.position.y < minHeight) {
-            camera.position.y = minHeight;
-            camera.target.y = camera.target.y + (minHeight - (camera.position.y - (camera.target.y - camera.position.y)));
-        }
+        // Render between the last two steps, the view direction is the latest mouse look
+        float interpolation = simulationTime / SIMULATION_STEP;
+        Camera3D renderCamera = camera;
+        renderCamera.position = Vector3Lerp(previousPosition, camera.position, interpolation);
+        renderCamera.target = Vector3Add(renderCamera.position, Vector3Subtract(camera.target, camera.position));
         
         BeginDrawing();
         
         ClearBackground(SKYBLUE);
         
-        BeginMode3D(camera);
+        BeginMode3D(renderCamera);
         
         // Draw all lights in the lighting system
         DrawLights(&lighting);
         
         // Render current scene
-        RenderCurrentScene(&sceneManager, camera, &gfxConfig, &wireframeShader);
+        RenderCurrentScene(&sceneManager, renderCamera, interpolation, &gfxConfig, &wireframeShader);
         
         DrawGrid(100, 1.0f);
         
@@ -277,7 +321,7 @@ int main(void)
         
         DrawText("1: Maze Scene, 2: Terrain Scene", 10, 70, 16, DARKGRAY);
         DrawText("+/-: Terrain Height (in Terrain Scene)", 10, 90, 16, DARKGRAY);
-        DrawText("F1: AA, F2: Wireframe, F3: Quality, F4: Shading, F5: Specular, F6: Wireframe Shader", 10, 110, 12, DARKGRAY);
+        DrawText("F1: AA, F2: Wireframe, F3: Quality, F4: Shading, F5: Specular, F6: Wireframe Shader, F7: Per-pixel Lights, F8: Wall Rendering", 10, 110, 12, DARKGRAY);
         
         // Display current scene
         if (sceneManager.currentScene) {
@@ -297,9 +341,10 @@ int main(void)
             camera.target.x, camera.target.y, camera.target.z);
         DrawText(debugText, 10, 170, 16, DARKGREEN);
         
-        sprintf(debugText, "Graphics: AA:%s Shading:%s Specular:%.1f WireShader:%s Lights:%d", 
+        sprintf(debugText, "Graphics: AA:%s Shading:%s%s Specular:%.1f WireShader:%s Lights:%d", 
             gfxConfig.antialiasingEnabled ? "ON" : "OFF",
             gfxConfig.advancedShadingEnabled ? "ADV" : "SIM",
+            gfxConfig.perPixelLightingEnabled ? "/PIXEL" : "",
             gfxConfig.specularStrength,
             gfxConfig.wireframeShaderEnabled ? "ON" : "OFF",
             lighting.lightCount);
@@ -309,8 +354,45 @@ int main(void)
             cursorLocked ? "LOCKED" : "FREE", yaw * 180.0f / PI, pitch * 180.0f / PI);
         DrawText(debugText, 10, 210, 16, DARKGREEN);
         
+        if (sceneManager.currentScene) {
+            RenderStats stats = sceneManager.currentScene->stats;
+            sprintf(debugText, "Draw calls: %d  Triangles: %d  Culled: %d  CPU: %.2f ms  Walls: %s",
+                stats.drawCalls, stats.triangles, stats.culledObjects, cpuFrameMs,
+                wallModeNames[gfxConfig.wallRenderMode]);
+            DrawText(debugText, 10, 230, 16, DARKGREEN);
+            
+            sprintf(debugText, "Last scene switch: %.2f ms (%s)  Suspended scenes: %.1f / %.0f MB",
+                sceneManager.lastSwitchMs, sceneManager.lastSwitchWarm ? "resumed" : "loaded",
+                GetSceneCacheMemory(&sceneManager) / (1024.0 * 1024.0), sceneManager.cacheBudget / (1024.0 * 1024.0));
+            DrawText(debugText, 10, 250, 16, DARKGREEN);
+            
+            for (int i = 0; i < sceneManager.sceneCount; i++) {
+                if (!sceneManager.scenes[i].loading) continue;
+                sprintf(debugText, "%s %s: %.0f%%", i == sceneManager.pendingSceneIndex ? "Loading" : "Prefetching",
+                    sceneManager.scenes[i].name, GetSceneLoadProgress(&sceneManager, i) * 100.0f);
+                DrawText(debugText, 10, 270, 16, i == sceneManager.pendingSceneIndex ? YELLOW : DARKGREEN);
+                break;
+            }
+            
+            const MemoryArena* sceneArena = sceneManager.currentScene->arena;
+            const MemoryArena* frameArena = sceneManager.frameArena;
+            sprintf(debugText, "Scene arena: %.1f MB in %d allocs (peak %.1f MB)  Frame arena: %.0f KB peak, %lld block mallocs",
+                sceneArena->used / (1024.0 * 1024.0), sceneArena->allocCount, sceneArena->peak / (1024.0 * 1024.0),
+                frameArena->peak / 1024.0, frameArena->blockMallocs);
+            DrawText(debugText, 10, 290, 16, DARKGREEN);
+            
+            sprintf(debugText, "Render queue: %d commands, %d state changes (%d unsorted), uniforms %d sent / %d skipped, submit %.3f ms",
+                stats.queuedCommands, stats.stateChanges, stats.unsortedStateChanges,
+                stats.uniformUploads, stats.uniformsSkipped, stats.submitMs);
+            DrawText(debugText, 10, 330, 16, DARKGREEN);
+        }
+        
+        sprintf(debugText, "Simulation: %d Hz, %d steps this frame, %.2f s dropped", SIMULATION_RATE, lastFrameSteps, droppedSimulationTime);
+        DrawText(debugText, 10, 310, 16, DARKGREEN);
+        
         DrawFPS(screenWidth - 100, 10);
         
+        cpuFrameMs = (GetTime() - frameStart) * 1000.0;
         EndDrawing();
     }
     
@@ -319,6 +401,9 @@ int main(void)
     
     // Cleanup wireframe shader
     UnloadWireframeShader(&wireframeShader);
+    UnloadLightingSystem(&lighting);
+    
+    ShutdownThreadPool();
     
     CloseWindow();
     
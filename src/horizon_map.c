@@ -0,0 +1,258 @@
+#include "horizon_map.h"
+#include "thread_pool.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define HORIZON_ANGLE_SCALE (255.0f / (PI * 0.5f))
+
+// tan() of every stored angle, filled on the first bake
+static float horizonTangents[256];
+static bool horizonTangentsReady = false;
+
+// One azimuth direction walked as parallel lines: the major axis advances one texel per step and the
+// minor axis by slope. Texel (u, round(c + u * slope)) belongs to line c, so every texel is on one line.
+typedef struct {
+    HorizonMap* map;
+    const float* heights;
+    int direction;
+    bool xMajor;
+    bool reverse;               // Major index runs against the axis (u = size - 1 - major)
+    float slope;
+    float stepDistance;         // World distance between consecutive samples of a line
+    int firstLine;
+    bool failed;                // Out of memory for a hull, set atomically, those lines were not written
+} HorizonSweepJob;
+
+static void InitHorizonTangents(void) {
+    if (horizonTangentsReady) return;
+    for (int i = 0; i < 256; i++) {
+        horizonTangents[i] = (i == 255) ? 1e6f : tanf(i / HORIZON_ANGLE_SCALE);
+    }
+    horizonTangentsReady = true;
+}
+
+// Stored angle of a non-negative slope. Polynomial atan (error < 1e-5 rad), libm atanf dominated the sweep.
+static inline unsigned char EncodeHorizonSlope(float slope) {
+    bool inverted = slope > 1.0f;
+    float x = inverted ? 1.0f / slope : slope;
+    float x2 = x * x;
+    float angle = x * (0.9998660f + x2 * (-0.3302995f + x2 * (0.1801410f + x2 * (-0.0851330f + x2 * 0.0208351f))));
+    if (inverted) angle = PI * 0.5f - angle;
+    return (unsigned char)(angle * HORIZON_ANGLE_SCALE + 0.5f);
+}
+
+static HorizonSweepJob GetHorizonSweep(HorizonMap* map, const float* heights, int direction) {
+    float angle = 2.0f * PI * direction / map->directionCount;
+    float dx = cosf(angle);
+    float dz = sinf(angle);
+
+    HorizonSweepJob job = { 0 };
+    job.map = map;
+    job.heights = heights;
+    job.direction = direction;
+    job.xMajor = fabsf(dx) >= fabsf(dz);
+    float major = job.xMajor ? dx : dz;
+    float minor = job.xMajor ? dz : dx;
+    job.reverse = major < 0.0f;
+    job.slope = minor / fabsf(major);
+    job.stepDistance = sqrtf(1.0f + job.slope * job.slope) * map->texelSize;
+    return job;
+}
+
+// Range of line offsets c whose texels fall inside minor [n0,n1] for some u in [u0,u1]
+static void GetHorizonLineRange(const HorizonSweepJob* job, int u0, int u1, int n0, int n1, int* first, int* last) {
+    float a = u0 * job->slope;
+    float b = u1 * job->slope;
+    float lo = fminf(a, b);
+    float hi = fmaxf(a, b);
+    *first = (int)floorf(n0 - 0.5f - hi);
+    *last = (int)ceilf(n1 + 0.5f - lo);
+}
+
+// Walk each line from its far end (in the sweep direction) back, keeping the upper convex hull of the
+// samples already passed. The hull vertex left on top after popping is the horizon of the new sample.
+static void SweepHorizonLines(void* context, int start, int end) {
+    HorizonSweepJob* job = (HorizonSweepJob*)context;
+    const HorizonMap* map = job->map;
+    int size = map->size;
+    unsigned char* angles = map->angles + (size_t)job->direction * size * size;
+
+    float* hullS = (float*)malloc(size * 2 * sizeof(float));
+    if (!hullS) {
+        __atomic_store_n(&job->failed, true, __ATOMIC_RELAXED);
+        return;
+    }
+    float* hullH = hullS + size;
+
+    for (int line = start; line < end; line++) {
+        float c = (float)(job->firstLine + line);
+        int hullCount = 0;
+
+        for (int u = size - 1; u >= 0; u--) {
+            int n = (int)floorf(c + u * job->slope + 0.5f);
+            if (n < 0 || n >= size) continue;
+            int m = job->reverse ? size - 1 - u : u;
+            int index = job->xMajor ? n * size + m : m * size + n;
+
+            float s = u * job->stepDistance;
+            float h = job->heights[index];
+
+            // Pop hull points hidden below the line from this sample to the point behind them
+            while (hullCount >= 2 &&
+                   (hullH[hullCount - 2] - h) * (hullS[hullCount - 1] - s) >=
+                   (hullH[hullCount - 1] - h) * (hullS[hullCount - 2] - s)) {
+                hullCount--;
+            }
+
+            float horizonSlope = 0.0f;
+            if (hullCount > 0) horizonSlope = (hullH[hullCount - 1] - h) / (hullS[hullCount - 1] - s);
+            angles[index] = (horizonSlope > 0.0f) ? EncodeHorizonSlope(horizonSlope) : 0;
+
+            hullS[hullCount] = s;
+            hullH[hullCount] = h;
+            hullCount++;
+        }
+    }
+
+    free(hullS);
+}
+
+// Sweep the lines of one direction that touch the texel rectangle [x0,x1] x [z0,z1], false when
+// some of them were skipped for lack of memory
+static bool SweepHorizonDirection(HorizonMap* map, const float* heights, int direction, int x0, int z0, int x1, int z1) {
+    HorizonSweepJob job = GetHorizonSweep(map, heights, direction);
+    int size = map->size;
+
+    int m0 = job.xMajor ? x0 : z0;
+    int m1 = job.xMajor ? x1 : z1;
+    int n0 = job.xMajor ? z0 : x0;
+    int n1 = job.xMajor ? z1 : x1;
+    int u0 = job.reverse ? size - 1 - m1 : m0;
+    int u1 = job.reverse ? size - 1 - m0 : m1;
+
+    int first, last;
+    GetHorizonLineRange(&job, u0, u1, n0, n1, &first, &last);
+
+    // Lines that never enter the grid
+    int gridFirst, gridLast;
+    GetHorizonLineRange(&job, 0, size - 1, 0, size - 1, &gridFirst, &gridLast);
+    if (first < gridFirst) first = gridFirst;
+    if (last > gridLast) last = gridLast;
+    if (last < first) return true;
+
+    job.firstLine = first;
+    int lineCount = last - first + 1;
+    int grainSize = lineCount / (GetThreadPoolSize() * 8);
+    ParallelFor(lineCount, grainSize > 0 ? grainSize : 1, SweepHorizonLines, &job);
+    return !job.failed;
+}
+
+HorizonMap* BakeHorizonMap(const float* heights, int size, float texelSize, int directionCount) {
+    if (directionCount <= 0) directionCount = HORIZON_DIRECTIONS;
+    if (directionCount > HORIZON_MAX_DIRECTIONS) directionCount = HORIZON_MAX_DIRECTIONS;
+    if (!heights || size <= 0) return NULL;
+
+    HorizonMap* map = (HorizonMap*)calloc(1, sizeof(HorizonMap));
+    if (!map) return NULL;
+    map->size = size;
+    map->directionCount = directionCount;
+    map->texelSize = texelSize;
+    map->angles = (unsigned char*)malloc((size_t)directionCount * size * size);
+    if (!map->angles) {
+        TraceLog(LOG_WARNING, "HORIZON: Failed to allocate a %dx%d horizon map", size, size);
+        free(map);
+        return NULL;
+    }
+
+    InitHorizonTangents();
+    double start = GetTime();
+    for (int d = 0; d < directionCount; d++) {
+        // Skipped lines would leave uninitialized angles behind
+        if (!SweepHorizonDirection(map, heights, d, 0, 0, size - 1, size - 1)) {
+            TraceLog(LOG_WARNING, "HORIZON: Out of memory while baking a %dx%d horizon map", size, size);
+            UnloadHorizonMap(map);
+            return NULL;
+        }
+    }
+    TraceLog(LOG_INFO, "HORIZON: Baked %dx%d horizon map (%d directions) in %.1f ms",
+             size, size, directionCount, (GetTime() - start) * 1000.0);
+    return map;
+}
+
+HorizonMap* BakeTerrainHorizonMap(const TerrainData* terrain, float texelSize, int directionCount) {
+    // TerrainData rows are TERRAIN_SIZE floats apart, so only a full-size grid is contiguous
+    if (terrain->size == TERRAIN_SIZE) return BakeHorizonMap(&terrain->heights[0][0], TERRAIN_SIZE, texelSize, directionCount);
+
+    float* heights = (float*)malloc((size_t)terrain->size * terrain->size * sizeof(float));
+    if (!heights) return NULL;
+    for (int z = 0; z < terrain->size; z++) {
+        memcpy(&heights[z * terrain->size], terrain->heights[z], terrain->size * sizeof(float));
+    }
+    HorizonMap* map = BakeHorizonMap(heights, terrain->size, texelSize, directionCount);
+    free(heights);
+    return map;
+}
+
+bool UpdateHorizonMapRegion(HorizonMap* map, const float* heights, int x0, int z0, int x1, int z1) {
+    if (!map) return false;
+    if (x0 < 0) x0 = 0;
+    if (z0 < 0) z0 = 0;
+    if (x1 >= map->size) x1 = map->size - 1;
+    if (z1 >= map->size) z1 = map->size - 1;
+    if (x1 < x0 || z1 < z0) return true;
+
+    bool ok = true;
+    for (int d = 0; d < map->directionCount; d++) {
+        ok = SweepHorizonDirection(map, heights, d, x0, z0, x1, z1) && ok;
+    }
+    return ok;
+}
+
+float GetHorizonSunVisibility(const HorizonMap* map, int x, int z, Vector3 toSun, float heightScale) {
+    float horizontal = sqrtf(toSun.x * toSun.x + toSun.z * toSun.z);
+    float sunElevation = atan2f(toSun.y, horizontal);
+    if (!map || horizontal <= 0.0f) return (sunElevation > 0.0f) ? 1.0f : 0.0f;
+
+    x = (x < 0) ? 0 : ((x >= map->size) ? map->size - 1 : x);
+    z = (z < 0) ? 0 : ((z >= map->size) ? map->size - 1 : z);
+    size_t texel = (size_t)z * map->size + x;
+    size_t plane = (size_t)map->size * map->size;
+
+    // Blend the two stored directions either side of the sun azimuth
+    float azimuth = atan2f(toSun.z, toSun.x);
+    if (azimuth < 0.0f) azimuth += 2.0f * PI;
+    float position = azimuth / (2.0f * PI) * map->directionCount;
+    int d0 = (int)position % map->directionCount;
+    int d1 = (d0 + 1) % map->directionCount;
+    float t = position - floorf(position);
+
+    float e0 = atanf(horizonTangents[map->angles[d0 * plane + texel]] * heightScale);
+    float e1 = atanf(horizonTangents[map->angles[d1 * plane + texel]] * heightScale);
+    float horizonElevation = e0 + (e1 - e0) * t;
+
+    float visibility = (sunElevation - horizonElevation) / HORIZON_SUN_PENUMBRA + 0.5f;
+    return (visibility < 0.0f) ? 0.0f : ((visibility > 1.0f) ? 1.0f : visibility);
+}
+
+float GetHorizonAmbientOcclusion(const HorizonMap* map, int x, int z, float heightScale) {
+    if (!map) return 1.0f;
+    x = (x < 0) ? 0 : ((x >= map->size) ? map->size - 1 : x);
+    z = (z < 0) ? 0 : ((z >= map->size) ? map->size - 1 : z);
+    size_t texel = (size_t)z * map->size + x;
+    size_t plane = (size_t)map->size * map->size;
+
+    // Open sky above elevation h in one azimuth slice, cosine weighted: cos^2(h) = 1 / (1 + tan^2(h))
+    float open = 0.0f;
+    for (int d = 0; d < map->directionCount; d++) {
+        float tangent = horizonTangents[map->angles[d * plane + texel]] * heightScale;
+        open += 1.0f / (1.0f + tangent * tangent);
+    }
+    return open / map->directionCount;
+}
+
+void UnloadHorizonMap(HorizonMap* map) {
+    if (!map) return;
+    free(map->angles);
+    free(map);
+}
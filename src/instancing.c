@@ -0,0 +1,84 @@
+#include "instancing.h"
+#include "rlgl.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+InstancedRenderer* CreateInstancedRenderer(void) {
+    InstancedRenderer* renderer = (InstancedRenderer*)calloc(1, sizeof(InstancedRenderer));
+    if (!renderer) return NULL;
+
+    renderer->shader = LoadShader("instancing.vs", "instancing.fs");
+    if (renderer->shader.id != rlGetShaderIdDefault()) {
+        // DrawMeshInstanced binds the per-instance matrices to the model matrix location
+        renderer->shader.locs[SHADER_LOC_MATRIX_MODEL] = GetShaderLocationAttrib(renderer->shader, "instanceTransform");
+        renderer->shaderLoaded = true;
+        printf("SHADER: Instancing shader loaded successfully!\n");
+    } else {
+        printf("SHADER: Failed to load instancing shader, drawing instances one by one\n");
+    }
+    return renderer;
+}
+
+void UnloadInstancedRenderer(InstancedRenderer* renderer) {
+    if (!renderer) return;
+    for (int i = 0; i < renderer->batchCount; i++) free(renderer->batches[i].transforms);
+    if (renderer->shaderLoaded) UnloadShader(renderer->shader);
+    free(renderer);
+}
+
+int AddInstanceBatch(InstancedRenderer* renderer, Mesh mesh, Material material, Color tint) {
+    if (renderer->batchCount >= INSTANCED_MAX_BATCHES) return -1;
+    InstanceBatch* batch = &renderer->batches[renderer->batchCount];
+    memset(batch, 0, sizeof(InstanceBatch));
+    batch->mesh = mesh;
+    batch->material = material;
+    batch->tint = tint;
+    return renderer->batchCount++;
+}
+
+void AddInstance(InstancedRenderer* renderer, int batchId, Matrix transform) {
+    if (batchId < 0 || batchId >= renderer->batchCount) return;
+    InstanceBatch* batch = &renderer->batches[batchId];
+    if (batch->count == batch->capacity) {
+        int capacity = batch->capacity ? batch->capacity * 2 : INSTANCED_INITIAL_CAPACITY;
+        Matrix* transforms = (Matrix*)realloc(batch->transforms, capacity * sizeof(Matrix));
+        if (!transforms) return;
+        batch->transforms = transforms;
+        batch->capacity = capacity;
+    }
+    batch->transforms[batch->count++] = transform;
+}
+
+int FlushInstancedRenderer(InstancedRenderer* renderer, RenderStats* stats) {
+    renderer->drawCalls = 0;
+    renderer->instanceCount = 0;
+
+    for (int i = 0; i < renderer->batchCount; i++) {
+        InstanceBatch* batch = &renderer->batches[i];
+        if (batch->count == 0) continue;
+
+        // The tint goes through colDiffuse, restore the caller's color afterwards
+        Material material = batch->material;
+        Color diffuse = material.maps[MATERIAL_MAP_DIFFUSE].color;
+        material.maps[MATERIAL_MAP_DIFFUSE].color = batch->tint;
+
+        if (renderer->shaderLoaded) {
+            material.shader = renderer->shader;
+            DrawMeshInstanced(batch->mesh, material, batch->transforms, batch->count);
+            renderer->drawCalls++;
+        } else {
+            for (int j = 0; j < batch->count; j++) DrawMesh(batch->mesh, material, batch->transforms[j]);
+            renderer->drawCalls += batch->count;
+        }
+
+        material.maps[MATERIAL_MAP_DIFFUSE].color = diffuse;
+        renderer->instanceCount += batch->count;
+        if (stats) stats->triangles += batch->mesh.triangleCount * batch->count;
+        batch->count = 0;
+    }
+
+    renderer->totalDrawCalls += renderer->drawCalls;
+    if (stats) stats->drawCalls += renderer->drawCalls;
+    return renderer->drawCalls;
+}
@@ -1,5 +1,11 @@
 #include "lighting.h"
+#include "probe_grid.h"
+#include "simd4.h"
+#include "thread_pool.h"
 #include <math.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
 
 // Initialize the lighting system
 LightingSystem InitLightingSystem(void)
@@ -8,13 +14,20 @@ LightingSystem InitLightingSystem(void)
     lighting.lightCount = 0;
     lighting.ambientColor = (Color){30, 30, 40, 255};
     lighting.ambientIntensity = 0.2f;
+    lighting.cache = CreateLightCache();
     return lighting;
 }
 
-// Add a light to the lighting system
-void AddLight(LightingSystem* lighting, LightType type, Vector3 position, Vector3 direction, Color color, float intensity, float range, float spotAngle)
+// Add a light to the lighting system, returns its index (-1 if out of memory)
+int AddLight(LightingSystem* lighting, LightType type, Vector3 position, Vector3 direction, Color color, float intensity, float range, float spotAngle)
 {
-    if (lighting->lightCount >= MAX_LIGHTS) return;
+    if (lighting->lightCount >= lighting->lightCapacity) {
+        int capacity = (lighting->lightCapacity > 0) ? lighting->lightCapacity * 2 : 8;
+        Light* lights = (Light*)realloc(lighting->lights, capacity * sizeof(Light));
+        if (!lights) return -1;
+        lighting->lights = lights;
+        lighting->lightCapacity = capacity;
+    }
     
     Light* light = &lighting->lights[lighting->lightCount];
     light->type = type;
@@ -25,23 +38,38 @@ void AddLight(LightingSystem* lighting, LightType type, Vector3 position, Vector
     light->range = range;
     light->spotAngle = spotAngle;
     light->enabled = true;
+    light->dynamic = false;
     
-    lighting->lightCount++;
+    lighting->version++;
+    return lighting->lightCount++;
+}
+
+// Free the light array
+void UnloadLightingSystem(LightingSystem* lighting)
+{
+    free(lighting->lights);
+    lighting->lights = NULL;
+    lighting->lightCount = 0;
+    lighting->lightCapacity = 0;
+    lighting->version++;
+    UnloadLightCache(lighting->cache);
+    lighting->cache = NULL;
 }
 
 // Update lighting system (for dynamic lights)
 void UpdateLightingSystem(LightingSystem* lighting, float deltaTime)
 {
-    // Example: Animate first light if it exists
-    if (lighting->lightCount > 0) {
-        static float time = 0.0f;
-        time += deltaTime;
-        
-        // Make the first light orbit around the center
-        if (lighting->lights[0].type == LIGHT_POINT) {
+    static float time = 0.0f;
+    time += deltaTime;
+    
+    // Make the first dynamic point light orbit around the center
+    for (int i = 0; i < lighting->lightCount; i++) {
+        if (lighting->lights[i].type == LIGHT_POINT && lighting->lights[i].dynamic) {
             float radius = 80.0f;
-            lighting->lights[0].position.x = cosf(time * 0.5f) * radius;
-            lighting->lights[0].position.z = sinf(time * 0.5f) * radius;
+            lighting->lights[i].position.x = cosf(time * 0.5f) * radius;
+            lighting->lights[i].position.z = sinf(time * 0.5f) * radius;
+            lighting->version++;
+            break;
         }
     }
 }
@@ -81,6 +109,12 @@ Color CalculateVertexLighting(Vector3 vertexPos, Vector3 normal, Vector3 viewDir
     float ambientR = lighting->ambientColor.r * lighting->ambientIntensity / 255.0f;
     float ambientG = lighting->ambientColor.g * lighting->ambientIntensity / 255.0f;
     float ambientB = lighting->ambientColor.b * lighting->ambientIntensity / 255.0f;
+    if (lighting->ambientProbes) {
+        Vector3 ambient = EvaluateProbeGrid(lighting->ambientProbes, vertexPos, normal);
+        ambientR = ambient.x;
+        ambientG = ambient.y;
+        ambientB = ambient.z;
+    }
     
     float totalR = baseColor.r * ambientR;
     float totalG = baseColor.g * ambientG;
@@ -147,6 +181,644 @@ Color CalculateVertexLighting(Vector3 vertexPos, Vector3 normal, Vector3 viewDir
     return result;
 }
 
+// Compile the lighting system and graphics settings into a LightBlock
+LightBlock CompileLightBlock(const LightingSystem* lighting, const GraphicsConfig* config)
+{
+    LightBlock block = { 0 };
+    block.advanced = (config && config->advancedShadingEnabled && lighting);
+    if (!block.advanced) return block;
+    
+    // One allocation holds every per-light array
+    int capacity = lighting->lightCount;
+    if (capacity > 0) {
+        float* storage = (float*)malloc(capacity * 12 * sizeof(float));
+        block.type = (LightType*)malloc(capacity * sizeof(LightType));
+        if (!storage || !block.type) {
+            free(storage);
+            free(block.type);
+            block.type = NULL;
+            return block;
+        }
+        block.capacity = capacity;
+        float** arrays[12] = { &block.posX, &block.posY, &block.posZ, &block.dirX, &block.dirY, &block.dirZ,
+                               &block.colorR, &block.colorG, &block.colorB, &block.intensity, &block.range, &block.spotCutoff };
+        for (int a = 0; a < 12; a++) *arrays[a] = storage + a * capacity;
+    }
+    
+    block.ambientR = lighting->ambientColor.r * lighting->ambientIntensity / 255.0f;
+    block.ambientG = lighting->ambientColor.g * lighting->ambientIntensity / 255.0f;
+    block.ambientB = lighting->ambientColor.b * lighting->ambientIntensity / 255.0f;
+    block.ambientProbes = lighting->ambientProbes;
+    block.specularStrength = config->specularStrength;
+    block.shininess = config->shininess;
+    
+    // Integer exponents (the usual 8/16/32/64) are evaluated by repeated squaring instead of powf
+    int exponent = (int)config->shininess;
+    block.shininessInt = ((float)exponent == config->shininess && exponent > 0 && exponent <= 1024) ? exponent : 0;
+    
+    for (int i = 0; i < lighting->lightCount; i++) {
+        const Light* light = &lighting->lights[i];
+        if (!light->enabled) continue;
+        
+        int n = block.count++;
+        block.type[n] = light->type;
+        block.posX[n] = light->position.x;
+        block.posY[n] = light->position.y;
+        block.posZ[n] = light->position.z;
+        block.dirX[n] = light->direction.x;
+        block.dirY[n] = light->direction.y;
+        block.dirZ[n] = light->direction.z;
+        block.colorR[n] = light->color.r;
+        block.colorG[n] = light->color.g;
+        block.colorB[n] = light->color.b;
+        block.intensity[n] = light->intensity;
+        block.range[n] = light->range;
+        block.spotCutoff[n] = cosf(light->spotAngle * PI / 180.0f);
+    }
+    
+    return block;
+}
+
+void UnloadLightBlock(LightBlock* block)
+{
+    free(block->posX);  // Start of the shared storage
+    free(block->type);
+    memset(block, 0, sizeof(LightBlock));
+}
+
+// x^n for a fixed integer n >= 1, by repeated squaring
+static inline float4 F4PowInt(float4 x, int n)
+{
+    float4 result = F4Set1(1.0f);
+    while (n > 0) {
+        if (n & 1) result = F4Mul(result, x);
+        x = F4Mul(x, x);
+        n >>= 1;
+    }
+    return result;
+}
+
+static inline float4 F4PowScalar(float4 x, float exponent)
+{
+    float v[4];
+    F4Store(v, x);
+    for (int k = 0; k < 4; k++) v[k] = powf(v[k], exponent);
+    return F4Load(v);
+}
+
+// Four vertices deinterleaved into SIMD lanes, with their running light totals
+typedef struct {
+    float4 posX, posY, posZ;
+    float4 normX, normY, normZ;
+    float4 baseR, baseG, baseB;
+    float4 totalR, totalG, totalB;
+} VertexLanes;
+
+// Deinterleave vertices base..base+lanes-1 (missing tail lanes get a harmless up normal)
+static void LoadVertexLanes(VertexLanes* v, const float* positions, const float* normals, const unsigned char* colors, int base, int lanes)
+{
+    float px[4] = { 0 }, py[4] = { 0 }, pz[4] = { 0 };
+    float nx[4] = { 0 }, ny[4] = { 1, 1, 1, 1 }, nz[4] = { 0 };
+    float br[4] = { 0 }, bg[4] = { 0 }, bb[4] = { 0 };
+    for (int k = 0; k < lanes; k++) {
+        int index = base + k;
+        px[k] = positions[index * 3]; py[k] = positions[index * 3 + 1]; pz[k] = positions[index * 3 + 2];
+        nx[k] = normals[index * 3]; ny[k] = normals[index * 3 + 1]; nz[k] = normals[index * 3 + 2];
+        br[k] = colors[index * 4]; bg[k] = colors[index * 4 + 1]; bb[k] = colors[index * 4 + 2];
+    }
+    
+    v->posX = F4Load(px); v->posY = F4Load(py); v->posZ = F4Load(pz);
+    v->normX = F4Load(nx); v->normY = F4Load(ny); v->normZ = F4Load(nz);
+    v->baseR = F4Load(br); v->baseG = F4Load(bg); v->baseB = F4Load(bb);
+}
+
+// Single clamp per channel, then back to bytes
+static void StoreVertexLanes(const VertexLanes* v, unsigned char* colors, int base, int lanes)
+{
+    const float4 zero = F4Set1(0.0f);
+    const float4 maxColor = F4Set1(255.0f);
+    float outR[4], outG[4], outB[4];
+    F4Store(outR, F4Clamp(v->totalR, zero, maxColor));
+    F4Store(outG, F4Clamp(v->totalG, zero, maxColor));
+    F4Store(outB, F4Clamp(v->totalB, zero, maxColor));
+    for (int k = 0; k < lanes; k++) {
+        int index = base + k;
+        colors[index * 4] = (unsigned char)outR[k];
+        colors[index * 4 + 1] = (unsigned char)outG[k];
+        colors[index * 4 + 2] = (unsigned char)outB[k];
+    }
+}
+
+// Same model as CalculateSimpleLighting: 0.3 ambient + 0.7 Lambert towards the sun
+static void ApplySimpleLightingLanes(VertexLanes* v)
+{
+    const float4 zero = F4Set1(0.0f);
+    const float4 one = F4Set1(1.0f);
+    float4 lx = F4Sub(F4Set1(SUN_POSITION_X), v->posX);
+    float4 ly = F4Sub(F4Set1(SUN_POSITION_Y), v->posY);
+    float4 lz = F4Sub(F4Set1(SUN_POSITION_Z), v->posZ);
+    float4 invLength = F4Div(one, F4Max(F4Sqrt(F4Add(F4Add(F4Mul(lx, lx), F4Mul(ly, ly)), F4Mul(lz, lz))), F4Set1(1e-6f)));
+    float4 NdotL = F4Mul(F4Add(F4Add(F4Mul(v->normX, lx), F4Mul(v->normY, ly)), F4Mul(v->normZ, lz)), invLength);
+    float4 lightIntensity = F4MulAdd(F4Max(NdotL, zero), F4Set1(0.7f), F4Set1(0.3f));
+    v->totalR = F4Mul(v->baseR, lightIntensity);
+    v->totalG = F4Mul(v->baseG, lightIntensity);
+    v->totalB = F4Mul(v->baseB, lightIntensity);
+}
+
+static void ApplyAmbientLanes(VertexLanes* v, const LightBlock* block)
+{
+    if (!block->ambientProbes) {
+        v->totalR = F4Mul(v->baseR, F4Set1(block->ambientR));
+        v->totalG = F4Mul(v->baseG, F4Set1(block->ambientG));
+        v->totalB = F4Mul(v->baseB, F4Set1(block->ambientB));
+        return;
+    }
+    
+    // Probe lookups are scalar, one per lane
+    float px[4], py[4], pz[4], nx[4], ny[4], nz[4];
+    float ambientR[4], ambientG[4], ambientB[4];
+    F4Store(px, v->posX); F4Store(py, v->posY); F4Store(pz, v->posZ);
+    F4Store(nx, v->normX); F4Store(ny, v->normY); F4Store(nz, v->normZ);
+    for (int k = 0; k < SIMD4_WIDTH; k++) {
+        Vector3 ambient = EvaluateProbeGrid(block->ambientProbes, (Vector3){ px[k], py[k], pz[k] }, (Vector3){ nx[k], ny[k], nz[k] });
+        ambientR[k] = ambient.x;
+        ambientG[k] = ambient.y;
+        ambientB[k] = ambient.z;
+    }
+    v->totalR = F4Mul(v->baseR, F4Load(ambientR));
+    v->totalG = F4Mul(v->baseG, F4Load(ambientG));
+    v->totalB = F4Mul(v->baseB, F4Load(ambientB));
+}
+
+// Add light i of the block to the lanes selected by laneMask
+static void AccumulateLightLanes(VertexLanes* v, const LightBlock* block, int i, float4 laneMask, Vector3 viewDir)
+{
+    const float4 zero = F4Set1(0.0f);
+    const float4 one = F4Set1(1.0f);
+    const float4 minDistance = F4Set1(1e-6f);
+    float4 lx, ly, lz;
+    float4 attenuation = F4Select(laneMask, one, zero);
+    
+    if (block->type[i] == LIGHT_DIRECTIONAL) {
+        lx = F4Set1(-block->dirX[i]);
+        ly = F4Set1(-block->dirY[i]);
+        lz = F4Set1(-block->dirZ[i]);
+    } else {
+        float4 tx = F4Sub(F4Set1(block->posX[i]), v->posX);
+        float4 ty = F4Sub(F4Set1(block->posY[i]), v->posY);
+        float4 tz = F4Sub(F4Set1(block->posZ[i]), v->posZ);
+        float4 distance = F4Sqrt(F4Add(F4Add(F4Mul(tx, tx), F4Mul(ty, ty)), F4Mul(tz, tz)));
+        
+        // Lanes outside the light range get zero attenuation
+        float4 inRange = F4And(F4CmpGt(F4Set1(block->range[i]), distance), laneMask);
+        if (!F4AnyTrue(inRange)) return;
+        
+        float4 invDistance = F4Div(one, F4Max(distance, minDistance));
+        lx = F4Mul(tx, invDistance);
+        ly = F4Mul(ty, invDistance);
+        lz = F4Mul(tz, invDistance);
+        attenuation = F4Div(one, F4Add(one, F4Mul(distance, F4MulAdd(distance, F4Set1(0.032f), F4Set1(0.09f)))));
+        attenuation = F4Select(inRange, attenuation, zero);
+        
+        if (block->type[i] == LIGHT_SPOT) {
+            float4 spotCos = F4Sub(zero, F4Add(F4Add(F4Mul(lx, F4Set1(block->dirX[i])), F4Mul(ly, F4Set1(block->dirY[i]))),
+                                               F4Mul(lz, F4Set1(block->dirZ[i]))));
+            float4 inCone = F4CmpGt(spotCos, F4Set1(block->spotCutoff[i]));
+            attenuation = F4Select(inCone, F4Mul(attenuation, spotCos), zero);
+        }
+    }
+    
+    // Blinn-Phong diffuse + specular
+    float4 NdotL = F4Max(F4Add(F4Add(F4Mul(v->normX, lx), F4Mul(v->normY, ly)), F4Mul(v->normZ, lz)), zero);
+    float4 hx = F4Add(lx, F4Set1(viewDir.x));
+    float4 hy = F4Add(ly, F4Set1(viewDir.y));
+    float4 hz = F4Add(lz, F4Set1(viewDir.z));
+    float4 halfLength = F4Sqrt(F4Add(F4Add(F4Mul(hx, hx), F4Mul(hy, hy)), F4Mul(hz, hz)));
+    float4 NdotH = F4Div(F4Add(F4Add(F4Mul(v->normX, hx), F4Mul(v->normY, hy)), F4Mul(v->normZ, hz)), F4Max(halfLength, minDistance));
+    NdotH = F4Clamp(NdotH, zero, one);
+    float4 specular = (block->shininessInt > 0) ? F4PowInt(NdotH, block->shininessInt) : F4PowScalar(NdotH, block->shininess);
+    
+    float4 lightIntensity = F4Mul(F4Set1(block->intensity[i]), attenuation);
+    float4 diffuse = F4Mul(lightIntensity, NdotL);
+    float4 specularContribution = F4Mul(lightIntensity, F4Mul(specular, F4Set1(block->specularStrength)));
+    
+    v->totalR = F4MulAdd(v->baseR, diffuse, F4MulAdd(F4Set1(block->colorR[i]), specularContribution, v->totalR));
+    v->totalG = F4MulAdd(v->baseG, diffuse, F4MulAdd(F4Set1(block->colorG[i]), specularContribution, v->totalG));
+    v->totalB = F4MulAdd(v->baseB, diffuse, F4MulAdd(F4Set1(block->colorB[i]), specularContribution, v->totalB));
+}
+
+// Light count vertices at once, four vertices per iteration
+void CalculateVertexLightingBatch(const float* positions, const float* normals, unsigned char* colors, int count, Vector3 viewDir, const LightBlock* block)
+{
+    const float4 allLanes = F4CmpLt(F4Set1(0.0f), F4Set1(1.0f));
+    
+    for (int base = 0; base < count; base += SIMD4_WIDTH) {
+        int lanes = (count - base < SIMD4_WIDTH) ? count - base : SIMD4_WIDTH;
+        VertexLanes v;
+        LoadVertexLanes(&v, positions, normals, colors, base, lanes);
+        
+        if (!block->advanced) {
+            ApplySimpleLightingLanes(&v);
+        } else {
+            ApplyAmbientLanes(&v, block);
+            for (int i = 0; i < block->count; i++) {
+                AccumulateLightLanes(&v, block, i, allLanes, viewDir);
+            }
+        }
+        
+        StoreVertexLanes(&v, colors, base, lanes);
+    }
+}
+
+// Squared distance from a point to an axis-aligned box
+static float PointBoxDistanceSqr(float x, float y, float z, Vector3 boxMin, Vector3 boxMax)
+{
+    float dx = fmaxf(fmaxf(boxMin.x - x, 0.0f), x - boxMax.x);
+    float dy = fmaxf(fmaxf(boxMin.y - y, 0.0f), y - boxMax.y);
+    float dz = fmaxf(fmaxf(boxMin.z - z, 0.0f), z - boxMax.z);
+    return dx * dx + dy * dy + dz * dz;
+}
+
+// Cell range covered by light i, false if its sphere misses the grid
+static bool GetLightCellRange(const LightClusterGrid* grid, const LightBlock* block, int i, int cellMin[3], int cellMax[3])
+{
+    float center[3] = { block->posX[i], block->posY[i], block->posZ[i] };
+    float origin[3] = { grid->origin.x, grid->origin.y, grid->origin.z };
+    int size[3] = { grid->sizeX, grid->sizeY, grid->sizeZ };
+    for (int axis = 0; axis < 3; axis++) {
+        cellMin[axis] = (int)floorf((center[axis] - block->range[i] - origin[axis]) / grid->cellSize);
+        cellMax[axis] = (int)floorf((center[axis] + block->range[i] - origin[axis]) / grid->cellSize);
+        if (cellMax[axis] < 0 || cellMin[axis] >= size[axis]) return false;
+        if (cellMin[axis] < 0) cellMin[axis] = 0;
+        if (cellMax[axis] >= size[axis]) cellMax[axis] = size[axis] - 1;
+    }
+    return true;
+}
+
+// Visit every cell whose box the light sphere touches: counting pass (cellLights NULL) or fill pass
+static void AssignLightToCells(LightClusterGrid* grid, const LightBlock* block, int i, int* cellLights)
+{
+    int cellMin[3], cellMax[3];
+    if (!GetLightCellRange(grid, block, i, cellMin, cellMax)) return;
+    
+    float rangeSqr = block->range[i] * block->range[i];
+    for (int z = cellMin[2]; z <= cellMax[2]; z++) {
+        for (int y = cellMin[1]; y <= cellMax[1]; y++) {
+            for (int x = cellMin[0]; x <= cellMax[0]; x++) {
+                Vector3 boxMin = { grid->origin.x + x * grid->cellSize, grid->origin.y + y * grid->cellSize, grid->origin.z + z * grid->cellSize };
+                Vector3 boxMax = { boxMin.x + grid->cellSize, boxMin.y + grid->cellSize, boxMin.z + grid->cellSize };
+                if (PointBoxDistanceSqr(block->posX[i], block->posY[i], block->posZ[i], boxMin, boxMax) > rangeSqr) continue;
+                
+                int cell = (z * grid->sizeY + y) * grid->sizeX + x;
+                if (cellLights) {
+                    cellLights[--grid->cellStart[cell]] = i;
+                } else {
+                    grid->cellStart[cell]++;
+                }
+            }
+        }
+    }
+}
+
+// Grow an int array to at least count entries (contents are not preserved)
+static bool ReserveClusterArray(int** array, int* capacity, int count)
+{
+    if (count <= *capacity) return true;
+    int* grown = (int*)malloc(count * sizeof(int));
+    if (!grown) return false;
+    free(*array);
+    *array = grown;
+    *capacity = count;
+    return true;
+}
+
+// Assign the block's lights to a world-space grid covering bounds
+void BuildLightClusters(LightClusterGrid* grid, const LightBlock* block, BoundingBox bounds, float cellSize)
+{
+    if (cellSize <= 0.0f) cellSize = LIGHT_CLUSTER_CELL_SIZE;
+    Vector3 extent = Vector3Subtract(bounds.max, bounds.min);
+    
+    // Coarsen the grid until it fits the cell limit
+    int sizeX, sizeY, sizeZ;
+    while (true) {
+        sizeX = (int)ceilf(fmaxf(extent.x, 0.0f) / cellSize); if (sizeX < 1) sizeX = 1;
+        sizeY = (int)ceilf(fmaxf(extent.y, 0.0f) / cellSize); if (sizeY < 1) sizeY = 1;
+        sizeZ = (int)ceilf(fmaxf(extent.z, 0.0f) / cellSize); if (sizeZ < 1) sizeZ = 1;
+        if ((long long)sizeX * sizeY * sizeZ <= LIGHT_CLUSTER_MAX_CELLS) break;
+        cellSize *= 1.25f;
+    }
+    
+    grid->origin = bounds.min;
+    grid->cellSize = cellSize;
+    grid->sizeX = sizeX;
+    grid->sizeY = sizeY;
+    grid->sizeZ = sizeZ;
+    grid->cellCount = sizeX * sizeY * sizeZ;
+    grid->cellLightCount = 0;
+    grid->globalCount = 0;
+    grid->localCount = 0;
+    grid->maxLightsPerCell = 0;
+    grid->coversLights = true;
+    
+    if (!ReserveClusterArray(&grid->cellStart, &grid->cellCapacity, grid->cellCount + 1) ||
+        !ReserveClusterArray(&grid->globalLights, &grid->globalCapacity, block->count > 0 ? block->count : 1)) {
+        grid->cellCount = 0;
+        return;
+    }
+    memset(grid->cellStart, 0, (grid->cellCount + 1) * sizeof(int));
+    
+    // Count lights per cell
+    for (int i = 0; i < block->count; i++) {
+        if (block->type[i] == LIGHT_DIRECTIONAL) {
+            grid->globalLights[grid->globalCount++] = i;
+        } else {
+            AssignLightToCells(grid, block, i, NULL);
+            grid->localCount++;
+            float range = block->range[i];
+            if (block->posX[i] - range < bounds.min.x || block->posX[i] + range > bounds.max.x ||
+                block->posY[i] - range < bounds.min.y || block->posY[i] + range > bounds.max.y ||
+                block->posZ[i] - range < bounds.min.z || block->posZ[i] + range > bounds.max.z) {
+                grid->coversLights = false;
+            }
+        }
+    }
+    
+    // Inclusive prefix sum: cellStart[c] is the end of cell c until the fill pass moves it to the start
+    int total = 0;
+    for (int c = 0; c < grid->cellCount; c++) {
+        if (grid->cellStart[c] > grid->maxLightsPerCell) grid->maxLightsPerCell = grid->cellStart[c];
+        total += grid->cellStart[c];
+        grid->cellStart[c] = total;
+    }
+    grid->cellStart[grid->cellCount] = total;
+    grid->cellLightCount = total;
+    
+    if (!ReserveClusterArray(&grid->cellLights, &grid->cellLightCapacity, total > 0 ? total : 1)) {
+        grid->cellCount = 0;
+        return;
+    }
+    
+    // Fill back to front so every cell lists its lights in ascending block order
+    for (int i = block->count - 1; i >= 0; i--) {
+        if (block->type[i] != LIGHT_DIRECTIONAL) AssignLightToCells(grid, block, i, grid->cellLights);
+    }
+}
+
+void UnloadLightClusters(LightClusterGrid* grid)
+{
+    free(grid->cellStart);
+    free(grid->cellLights);
+    free(grid->globalLights);
+    memset(grid, 0, sizeof(LightClusterGrid));
+}
+
+bool GetLocalLightBounds(const LightBlock* block, BoundingBox* bounds)
+{
+    bool found = false;
+    for (int i = 0; i < block->count; i++) {
+        if (block->type[i] == LIGHT_DIRECTIONAL) continue;
+        float range = block->range[i] + LIGHT_CLUSTER_PADDING;
+        Vector3 lightMin = { block->posX[i] - range, block->posY[i] - range, block->posZ[i] - range };
+        Vector3 lightMax = { block->posX[i] + range, block->posY[i] + range, block->posZ[i] + range };
+        bounds->min = found ? Vector3Min(bounds->min, lightMin) : lightMin;
+        bounds->max = found ? Vector3Max(bounds->max, lightMax) : lightMax;
+        found = true;
+    }
+    return found;
+}
+
+// Grid cell containing a point, -1 outside the grid
+static int GetLightClusterCell(const LightClusterGrid* grid, float x, float y, float z)
+{
+    float invCellSize = 1.0f / grid->cellSize;
+    int cx = (int)floorf((x - grid->origin.x) * invCellSize);
+    int cy = (int)floorf((y - grid->origin.y) * invCellSize);
+    int cz = (int)floorf((z - grid->origin.z) * invCellSize);
+    if (cx < 0 || cy < 0 || cz < 0 || cx >= grid->sizeX || cy >= grid->sizeY || cz >= grid->sizeZ) return -1;
+    return (cz * grid->sizeY + cy) * grid->sizeX + cx;
+}
+
+// Like CalculateVertexLightingBatch, but each lane only evaluates the lights listed for its cell
+void CalculateVertexLightingClustered(const float* positions, const float* normals, unsigned char* colors, int count, Vector3 viewDir,
+                                      const LightBlock* block, const LightClusterGrid* grid)
+{
+    if (!block->advanced || grid->cellCount == 0) {
+        CalculateVertexLightingBatch(positions, normals, colors, count, viewDir, block);
+        return;
+    }
+    
+    const float4 zero = F4Set1(0.0f);
+    
+    for (int base = 0; base < count; base += SIMD4_WIDTH) {
+        int lanes = (count - base < SIMD4_WIDTH) ? count - base : SIMD4_WIDTH;
+        VertexLanes v;
+        LoadVertexLanes(&v, positions, normals, colors, base, lanes);
+        ApplyAmbientLanes(&v, block);
+        
+        int cells[4];
+        for (int k = 0; k < lanes; k++) {
+            int index = base + k;
+            cells[k] = GetLightClusterCell(grid, positions[index * 3], positions[index * 3 + 1], positions[index * 3 + 2]);
+        }
+        
+        // Neighbouring vertices usually share a cell, so each distinct cell is walked once with a lane mask
+        for (int k = 0; k < lanes; k++) {
+            bool seen = false;
+            for (int j = 0; j < k; j++) seen = seen || (cells[j] == cells[k]);
+            if (seen) continue;
+            
+            float maskValues[4] = { 0 };
+            for (int j = k; j < lanes; j++) maskValues[j] = (cells[j] == cells[k]) ? 1.0f : 0.0f;
+            float4 laneMask = F4CmpGt(F4Load(maskValues), zero);
+            
+            if (cells[k] < 0) {
+                // Outside the grid: the directional lights when no point/spot light reaches out here, else every light
+                if (grid->coversLights) {
+                    for (int j = 0; j < grid->globalCount; j++) {
+                        AccumulateLightLanes(&v, block, grid->globalLights[j], laneMask, viewDir);
+                    }
+                } else {
+                    for (int i = 0; i < block->count; i++) {
+                        AccumulateLightLanes(&v, block, i, laneMask, viewDir);
+                    }
+                }
+                continue;
+            }
+            
+            // Merge the cell list with the directional lights so lights are added in block order,
+            // which keeps the result identical to CalculateVertexLightingBatch
+            const int* cellLights = grid->cellLights + grid->cellStart[cells[k]];
+            int cellCount = grid->cellStart[cells[k] + 1] - grid->cellStart[cells[k]];
+            int local = 0, global = 0;
+            while (local < cellCount || global < grid->globalCount) {
+                bool takeLocal = (global >= grid->globalCount) ||
+                                 (local < cellCount && cellLights[local] < grid->globalLights[global]);
+                int i = takeLocal ? cellLights[local++] : grid->globalLights[global++];
+                AccumulateLightLanes(&v, block, i, laneMask, viewDir);
+            }
+        }
+        
+        StoreVertexLanes(&v, colors, base, lanes);
+    }
+}
+
+typedef struct {
+    Mesh* mesh;
+    Vector3 viewDir;
+    const LightBlock* block;
+    const LightClusterGrid* grid;   // NULL to loop over every light
+} MeshLightingJob;
+
+// Light the vertices [start, end) of a mesh, ranges start on a SIMD group so lanes match a single pass
+static void LightMeshRange(void* context, int start, int end)
+{
+    MeshLightingJob* job = (MeshLightingJob*)context;
+    const Mesh* mesh = job->mesh;
+    const float* positions = mesh->vertices + start * 3;
+    const float* normals = mesh->normals + start * 3;
+    unsigned char* colors = mesh->colors + start * 4;
+    
+    if (job->grid) {
+        CalculateVertexLightingClustered(positions, normals, colors, end - start, job->viewDir, job->block, job->grid);
+    } else {
+        CalculateVertexLightingBatch(positions, normals, colors, end - start, job->viewDir, job->block);
+    }
+}
+
+// Compiled lights shared by the CalculateMeshLighting calls that use them, freed with the last reference
+typedef struct {
+    LightBlock block;
+    LightClusterGrid grid;      // cellCount 0 when there are too few point/spot lights to cluster
+    int references;
+    
+    // What it was compiled from
+    const Light* lights;
+    int lightCount;
+    unsigned int version;
+    Color ambientColor;
+    float ambientIntensity;
+    const struct ProbeGrid* ambientProbes;
+    bool advanced;
+    float specularStrength;
+    float shininess;
+} LightSnapshot;
+
+struct LightCache {
+    pthread_mutex_t mutex;
+    LightSnapshot* current;
+    int builds;
+};
+
+// Compile the lights, with a grid over the light spheres (it fits any mesh) when there are enough of them
+static LightSnapshot* CreateLightSnapshot(const LightingSystem* lighting, const GraphicsConfig* config)
+{
+    LightSnapshot* snapshot = (LightSnapshot*)calloc(1, sizeof(LightSnapshot));
+    if (!snapshot) return NULL;
+    snapshot->block = CompileLightBlock(lighting, config);
+    snapshot->references = 1;
+    
+    int localCount = 0;
+    for (int i = 0; i < snapshot->block.count; i++) {
+        if (snapshot->block.type[i] != LIGHT_DIRECTIONAL) localCount++;
+    }
+    BoundingBox bounds;
+    if (localCount >= LIGHT_CLUSTER_MIN_LIGHTS && GetLocalLightBounds(&snapshot->block, &bounds)) {
+        BuildLightClusters(&snapshot->grid, &snapshot->block, bounds, LIGHT_CLUSTER_CELL_SIZE);
+    }
+    
+    if (lighting) {
+        snapshot->lights = lighting->lights;
+        snapshot->lightCount = lighting->lightCount;
+        snapshot->version = lighting->version;
+        snapshot->ambientColor = lighting->ambientColor;
+        snapshot->ambientIntensity = lighting->ambientIntensity;
+        snapshot->ambientProbes = lighting->ambientProbes;
+    }
+    if (config) {
+        snapshot->advanced = config->advancedShadingEnabled;
+        snapshot->specularStrength = config->specularStrength;
+        snapshot->shininess = config->shininess;
+    }
+    return snapshot;
+}
+
+static void ReleaseLightSnapshot(LightSnapshot* snapshot)
+{
+    if (!snapshot || __atomic_sub_fetch(&snapshot->references, 1, __ATOMIC_ACQ_REL) > 0) return;
+    UnloadLightClusters(&snapshot->grid);
+    UnloadLightBlock(&snapshot->block);
+    free(snapshot);
+}
+
+// True when the snapshot was compiled from the current lights and settings
+static bool IsLightSnapshotCurrent(const LightSnapshot* snapshot, const LightingSystem* lighting, const GraphicsConfig* config)
+{
+    return snapshot->lights == lighting->lights && snapshot->lightCount == lighting->lightCount &&
+           snapshot->version == lighting->version && snapshot->ambientProbes == lighting->ambientProbes &&
+           snapshot->ambientIntensity == lighting->ambientIntensity &&
+           memcmp(&snapshot->ambientColor, &lighting->ambientColor, sizeof(Color)) == 0 &&
+           snapshot->advanced == config->advancedShadingEnabled &&
+           snapshot->specularStrength == config->specularStrength && snapshot->shininess == config->shininess;
+}
+
+// Snapshot of the current lights with a reference for the caller, from the cache when it is still current
+static LightSnapshot* AcquireLightSnapshot(const LightingSystem* lighting, const GraphicsConfig* config)
+{
+    LightCache* cache = (lighting && config) ? lighting->cache : NULL;
+    if (!cache) return CreateLightSnapshot(lighting, config);
+    
+    pthread_mutex_lock(&cache->mutex);
+    if (!cache->current || !IsLightSnapshotCurrent(cache->current, lighting, config)) {
+        LightSnapshot* snapshot = CreateLightSnapshot(lighting, config);
+        if (!snapshot) {
+            pthread_mutex_unlock(&cache->mutex);
+            return NULL;
+        }
+        ReleaseLightSnapshot(cache->current);
+        cache->current = snapshot;
+        cache->builds++;
+    }
+    LightSnapshot* snapshot = cache->current;
+    __atomic_add_fetch(&snapshot->references, 1, __ATOMIC_RELAXED);
+    pthread_mutex_unlock(&cache->mutex);
+    return snapshot;
+}
+
+LightCache* CreateLightCache(void)
+{
+    LightCache* cache = (LightCache*)calloc(1, sizeof(LightCache));
+    if (!cache) return NULL;
+    pthread_mutex_init(&cache->mutex, NULL);
+    return cache;
+}
+
+void UnloadLightCache(LightCache* cache)
+{
+    if (!cache) return;
+    ReleaseLightSnapshot(cache->current);
+    pthread_mutex_destroy(&cache->mutex);
+    free(cache);
+}
+
+int GetLightCacheBuilds(const LightCache* cache)
+{
+    return cache ? cache->builds : 0;
+}
+
+// Relight a mesh whose colors hold base colors, clustering the lights when there are many of them.
+// Large meshes are split over the thread pool.
+void CalculateMeshLighting(Mesh* mesh, Vector3 viewDir, const LightingSystem* lighting, const GraphicsConfig* config)
+{
+    LightSnapshot* snapshot = AcquireLightSnapshot(lighting, config);
+    if (!snapshot) return;
+    
+    const LightClusterGrid* grid = (snapshot->grid.cellCount > 0) ? &snapshot->grid : NULL;
+    MeshLightingJob job = { mesh, viewDir, &snapshot->block, grid };
+    ParallelFor(mesh->vertexCount, LIGHTING_PARALLEL_GRAIN, LightMeshRange, &job);
+    
+    ReleaseLightSnapshot(snapshot);
+}
+
 // Calculate simple lighting for backward compatibility
 Color CalculateSimpleLighting(Vector3 vertexPos, Vector3 normal, Color baseColor)
 {
@@ -0,0 +1,353 @@
+#include "lightmap.h"
+#include "lighting.h"
+#include "maze.h"
+#include "probe_grid.h"
+#include "thread_pool.h"
+#include "raymath.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define LIGHTMAP_FLOOR_BIAS 0.05f           // Rays start slightly above the floor
+#define LIGHTMAP_SHADOW_DISTANCE 1000.0f    // Ray length towards directional lights
+
+struct LightmapBakeTask {
+    JobHandle job;
+    Maze maze;
+    LightingSystem lighting;    // Copy with its own light array, shares the scene's ambient probes
+    GraphicsConfig config;
+    float floorSize;
+    int resolution;
+    Lightmap result;
+};
+
+typedef struct {
+    const Maze* maze;
+    Light* lights;              // Enabled static lights
+    int lightCount;
+    const GraphicsConfig* config;
+    bool advanced;
+    float ambientR, ambientG, ambientB;
+    const ProbeGrid* probes;    // Replaces the flat ambient when set
+    float floorSize;
+    int resolution;
+    Color* texels;
+} LightmapBakeJob;
+
+// True if a wall blocks the ray within maxDistance (rays start above the floor and never go down)
+static bool MazeRayBlocked(const Maze* maze, Vector3 origin, Vector3 dir, float maxDistance) {
+    return MazeRaycast(maze, origin, dir, maxDistance, NULL, NULL);
+}
+
+// Fraction of ambient light reaching a floor point, from short rays in a ring of directions
+static float BakeAmbientOcclusion(const LightmapBakeJob* job, Vector3 position, unsigned int seed) {
+    // Rotate the ring per texel so the rays don't band
+    seed ^= seed >> 16; seed *= 0x7feb352dU; seed ^= seed >> 15; seed *= 0x846ca68bU; seed ^= seed >> 16;
+    float rotation = (seed & 0xffff) / 65536.0f;
+
+    int blocked = 0;
+    for (int k = 0; k < LIGHTMAP_AO_RAYS; k++) {
+        float azimuth = (k + rotation) / LIGHTMAP_AO_RAYS * 2.0f * PI;
+        float elevation = (k % 2) ? 0.96f : 0.44f;      // About 55 and 25 degrees
+        Vector3 dir = { cosf(elevation) * cosf(azimuth), sinf(elevation), cosf(elevation) * sinf(azimuth) };
+        if (MazeRayBlocked(job->maze, position, dir, LIGHTMAP_AO_RADIUS)) blocked++;
+    }
+    return 1.0f - LIGHTMAP_AO_STRENGTH * (float)blocked / LIGHTMAP_AO_RAYS;
+}
+
+// Light arriving at one floor texel, same models as the vertex lighting plus shadows and ambient occlusion
+static Color BakeLightmapTexel(const LightmapBakeJob* job, float x, float z, unsigned int seed) {
+    Vector3 position = { x, LIGHTMAP_FLOOR_BIAS, z };
+    Vector3 normal = { 0.0f, 1.0f, 0.0f };
+    float ambientOcclusion = BakeAmbientOcclusion(job, position, seed);
+    float r, g, b;
+
+    if (!job->advanced) {
+        // CalculateSimpleLighting: 0.3 ambient + 0.7 Lambert towards the sun
+        Vector3 toSun = Vector3Subtract((Vector3){ SUN_POSITION_X, SUN_POSITION_Y, SUN_POSITION_Z }, position);
+        float distance = Vector3Length(toSun);
+        Vector3 dir = Vector3Scale(toSun, 1.0f / distance);
+        float direct = 0.7f * fmaxf(0.0f, dir.y);
+        if (direct > 0.0f && MazeRayBlocked(job->maze, position, dir, distance)) direct = 0.0f;
+        r = g = b = 0.3f * ambientOcclusion + direct;
+    } else {
+        Vector3 ambient = { job->ambientR, job->ambientG, job->ambientB };
+        if (job->probes) ambient = EvaluateProbeGrid(job->probes, position, normal);
+        r = ambient.x * ambientOcclusion;
+        g = ambient.y * ambientOcclusion;
+        b = ambient.z * ambientOcclusion;
+
+        // One light at a time through CalculateVertexLighting, with a white base color
+        for (int i = 0; i < job->lightCount; i++) {
+            LightingSystem single = { 0 };
+            single.lights = &job->lights[i];
+            single.lightCount = 1;
+            Color lit = CalculateVertexLighting(position, normal, normal, WHITE, &single, job->config);
+            if (lit.r == 0 && lit.g == 0 && lit.b == 0) continue;
+
+            const Light* light = &job->lights[i];
+            Vector3 dir;
+            float distance;
+            if (light->type == LIGHT_DIRECTIONAL) {
+                dir = Vector3Negate(light->direction);
+                distance = LIGHTMAP_SHADOW_DISTANCE;
+            } else {
+                Vector3 toLight = Vector3Subtract(light->position, position);
+                distance = Vector3Length(toLight);
+                dir = Vector3Scale(toLight, 1.0f / fmaxf(distance, 1e-6f));
+            }
+            if (MazeRayBlocked(job->maze, position, dir, distance)) continue;
+
+            r += lit.r / 255.0f;
+            g += lit.g / 255.0f;
+            b += lit.b / 255.0f;
+        }
+    }
+
+    Color texel;
+    texel.r = (unsigned char)(fminf(r, 1.0f) * 255.0f);
+    texel.g = (unsigned char)(fminf(g, 1.0f) * 255.0f);
+    texel.b = (unsigned char)(fminf(b, 1.0f) * 255.0f);
+    texel.a = 255;
+    return texel;
+}
+
+static void BakeLightmapRows(void* context, int start, int end) {
+    const LightmapBakeJob* job = (const LightmapBakeJob*)context;
+    float texelSize = job->floorSize / job->resolution;
+    for (int row = start; row < end; row++) {
+        float z = -job->floorSize / 2.0f + (row + 0.5f) * texelSize;
+        for (int col = 0; col < job->resolution; col++) {
+            float x = -job->floorSize / 2.0f + (col + 0.5f) * texelSize;
+            unsigned int index = (unsigned int)(row * job->resolution + col);
+            job->texels[index] = BakeLightmapTexel(job, x, z, index);
+        }
+    }
+}
+
+// FNV-1a over raw bytes
+static unsigned long long HashBytes(unsigned long long hash, const void* data, size_t size) {
+    const unsigned char* bytes = (const unsigned char*)data;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+// Cache key for a floor lightmap: maze contents, static lights, shading settings and resolution
+unsigned long long GetMazeLightmapKey(const Maze* maze, const LightingSystem* lighting, const GraphicsConfig* config,
+                                      float floorSize, int resolution) {
+    unsigned long long hash = 14695981039346656037ULL;
+    int version = LIGHTMAP_BAKE_VERSION;
+    hash = HashBytes(hash, &version, sizeof(version));
+    hash = HashBytes(hash, &resolution, sizeof(resolution));
+    hash = HashBytes(hash, &floorSize, sizeof(floorSize));
+
+    hash = HashBytes(hash, &maze->width, sizeof(maze->width));
+    hash = HashBytes(hash, &maze->height, sizeof(maze->height));
+    for (int row = 0; row < maze->height; row++) {
+        for (int col = 0; col < maze->width; col++) {
+            bool wall = MazeIsWall(maze, col, row);
+            hash = HashBytes(hash, &wall, sizeof(wall));
+        }
+    }
+
+    bool advanced = config->advancedShadingEnabled;
+    hash = HashBytes(hash, &advanced, sizeof(advanced));
+    if (!advanced) return hash;     // Simple shading only uses the fixed sun
+
+    hash = HashBytes(hash, &config->specularStrength, sizeof(config->specularStrength));
+    hash = HashBytes(hash, &config->shininess, sizeof(config->shininess));
+    hash = HashBytes(hash, &lighting->ambientColor, sizeof(lighting->ambientColor));
+    hash = HashBytes(hash, &lighting->ambientIntensity, sizeof(lighting->ambientIntensity));
+    if (lighting->ambientProbes) hash = HashBytes(hash, &lighting->ambientProbes->key, sizeof(lighting->ambientProbes->key));
+    for (int i = 0; i < lighting->lightCount; i++) {
+        const Light* light = &lighting->lights[i];
+        if (!light->enabled || light->dynamic) continue;
+        int type = (int)light->type;
+        hash = HashBytes(hash, &type, sizeof(type));
+        hash = HashBytes(hash, &light->position, sizeof(light->position));
+        hash = HashBytes(hash, &light->direction, sizeof(light->direction));
+        hash = HashBytes(hash, &light->color, sizeof(light->color));
+        hash = HashBytes(hash, &light->intensity, sizeof(light->intensity));
+        hash = HashBytes(hash, &light->range, sizeof(light->range));
+        hash = HashBytes(hash, &light->spotAngle, sizeof(light->spotAngle));
+    }
+    return hash;
+}
+
+// Bake direct light from the static lights plus ambient occlusion for the maze floor
+Lightmap BakeMazeLightmap(const Maze* maze, const LightingSystem* lighting, const GraphicsConfig* config,
+                          float floorSize, int resolution) {
+    Lightmap lightmap = { 0 };
+    lightmap.width = resolution;
+    lightmap.height = resolution;
+    lightmap.key = GetMazeLightmapKey(maze, lighting, config, floorSize, resolution);
+    lightmap.texels = (Color*)malloc(resolution * resolution * sizeof(Color));
+    if (!lightmap.texels) {
+        lightmap.width = lightmap.height = 0;
+        return lightmap;
+    }
+
+    LightmapBakeJob job = { 0 };
+    job.maze = maze;
+    job.config = config;
+    job.advanced = config->advancedShadingEnabled;
+    job.ambientR = lighting->ambientColor.r * lighting->ambientIntensity / 255.0f;
+    job.ambientG = lighting->ambientColor.g * lighting->ambientIntensity / 255.0f;
+    job.ambientB = lighting->ambientColor.b * lighting->ambientIntensity / 255.0f;
+    job.probes = lighting->ambientProbes;
+    job.floorSize = floorSize;
+    job.resolution = resolution;
+    job.texels = lightmap.texels;
+
+    // Moving lights are left to the runtime lighting. Without room for the light list there is no lightmap,
+    // and the scene keeps its vertex-lit floor.
+    job.lights = (Light*)malloc((lighting->lightCount > 0 ? lighting->lightCount : 1) * sizeof(Light));
+    if (!job.lights) {
+        TraceLog(LOG_WARNING, "LIGHTMAP: Out of memory for the light list, floor stays vertex lit");
+        UnloadLightmap(&lightmap);
+        return lightmap;
+    }
+    for (int i = 0; i < lighting->lightCount; i++) {
+        if (lighting->lights[i].enabled && !lighting->lights[i].dynamic) job.lights[job.lightCount++] = lighting->lights[i];
+    }
+
+    int grainSize = resolution / (GetThreadPoolSize() * 8);
+    ParallelFor(resolution, grainSize > 0 ? grainSize : 1, BakeLightmapRows, &job);
+
+    free(job.lights);
+    return lightmap;
+}
+
+static void GetLightmapCachePath(unsigned long long key, char* path, size_t size) {
+    snprintf(path, size, "lightmap_%016llx.bin", key);
+}
+
+// Read a cache file written by SaveLightmapCache, false if missing or stale
+static bool LoadLightmapCache(Lightmap* lightmap, unsigned long long key, int resolution) {
+    char path[64];
+    GetLightmapCachePath(key, path, sizeof(path));
+    FILE* file = fopen(path, "rb");
+    if (!file) return false;
+
+    char magic[4];
+    int version = 0, width = 0, height = 0;
+    unsigned long long fileKey = 0;
+    bool valid = fread(magic, 1, 4, file) == 4 && memcmp(magic, "LMAP", 4) == 0 &&
+                 fread(&version, sizeof(version), 1, file) == 1 && version == LIGHTMAP_BAKE_VERSION &&
+                 fread(&fileKey, sizeof(fileKey), 1, file) == 1 && fileKey == key &&
+                 fread(&width, sizeof(width), 1, file) == 1 && width == resolution &&
+                 fread(&height, sizeof(height), 1, file) == 1 && height == resolution;
+
+    if (valid) {
+        lightmap->texels = (Color*)malloc(width * height * sizeof(Color));
+        valid = lightmap->texels && fread(lightmap->texels, sizeof(Color), width * height, file) == (size_t)(width * height);
+    }
+    fclose(file);
+
+    if (!valid) {
+        free(lightmap->texels);
+        lightmap->texels = NULL;
+        TraceLog(LOG_WARNING, "LIGHTMAP: Ignoring invalid cache file %s", path);
+        return false;
+    }
+
+    lightmap->width = width;
+    lightmap->height = height;
+    lightmap->key = key;
+    lightmap->fromCache = true;
+    return true;
+}
+
+static void SaveLightmapCache(const Lightmap* lightmap) {
+    char path[64];
+    GetLightmapCachePath(lightmap->key, path, sizeof(path));
+    FILE* file = fopen(path, "wb");
+    if (!file) {
+        TraceLog(LOG_WARNING, "LIGHTMAP: Failed to write cache file %s", path);
+        return;
+    }
+
+    int version = LIGHTMAP_BAKE_VERSION;
+    fwrite("LMAP", 1, 4, file);
+    fwrite(&version, sizeof(version), 1, file);
+    fwrite(&lightmap->key, sizeof(lightmap->key), 1, file);
+    fwrite(&lightmap->width, sizeof(lightmap->width), 1, file);
+    fwrite(&lightmap->height, sizeof(lightmap->height), 1, file);
+    fwrite(lightmap->texels, sizeof(Color), lightmap->width * lightmap->height, file);
+    fclose(file);
+}
+
+// Load the cache file for this setup or bake and write it
+Lightmap LoadOrBakeMazeLightmap(const Maze* maze, const LightingSystem* lighting, const GraphicsConfig* config,
+                                float floorSize, int resolution) {
+    Lightmap lightmap = { 0 };
+    unsigned long long key = GetMazeLightmapKey(maze, lighting, config, floorSize, resolution);
+    if (LoadLightmapCache(&lightmap, key, resolution)) {
+        TraceLog(LOG_INFO, "LIGHTMAP: Loaded %dx%d lightmap from cache", lightmap.width, lightmap.height);
+        return lightmap;
+    }
+
+    double start = GetTime();
+    lightmap = BakeMazeLightmap(maze, lighting, config, floorSize, resolution);
+    if (!lightmap.texels) return lightmap;
+    TraceLog(LOG_INFO, "LIGHTMAP: Baked %dx%d lightmap in %.1f ms", lightmap.width, lightmap.height, (GetTime() - start) * 1000.0);
+
+    SaveLightmapCache(&lightmap);
+    return lightmap;
+}
+
+void UnloadLightmap(Lightmap* lightmap) {
+    free(lightmap->texels);
+    memset(lightmap, 0, sizeof(Lightmap));
+}
+
+static void RunLightmapBake(void* context) {
+    LightmapBakeTask* task = (LightmapBakeTask*)context;
+    task->result = LoadOrBakeMazeLightmap(&task->maze, &task->lighting, &task->config, task->floorSize, task->resolution);
+}
+
+LightmapBakeTask* StartMazeLightmapBake(const Maze* maze, const LightingSystem* lighting, const GraphicsConfig* config,
+                                        float floorSize, int resolution) {
+    LightmapBakeTask* task = (LightmapBakeTask*)calloc(1, sizeof(LightmapBakeTask));
+    if (!task) return NULL;
+    task->maze = CopyMaze(maze);
+    task->lighting = *lighting;
+    task->lighting.cache = NULL;
+    task->lighting.lights = NULL;
+    task->lighting.lightCapacity = task->lighting.lightCount;
+    if (lighting->lightCount > 0) {
+        task->lighting.lights = (Light*)malloc(lighting->lightCount * sizeof(Light));
+        if (!task->lighting.lights) {
+            UnloadMaze(&task->maze);
+            free(task);
+            return NULL;
+        }
+        memcpy(task->lighting.lights, lighting->lights, lighting->lightCount * sizeof(Light));
+    }
+    task->config = *config;
+    task->floorSize = floorSize;
+    task->resolution = resolution;
+
+    task->job = ScheduleJob(RunLightmapBake, task, NULL, 0);
+    return task;
+}
+
+bool IsLightmapBakeFinished(LightmapBakeTask* task) {
+    return IsJobDone(task->job);
+}
+
+Lightmap FinishLightmapBake(LightmapBakeTask* task) {
+    Lightmap lightmap = { 0 };
+    if (!task) return lightmap;
+    WaitJob(task->job);
+
+    lightmap = task->result;
+    free(task->lighting.lights);
+    UnloadMaze(&task->maze);
+    free(task);
+    return lightmap;
+}
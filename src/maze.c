@@ -1,34 +1,502 @@
+#define _POSIX_C_SOURCE 200112L
 #include "maze.h"
 #include "raylib.h"
+#include "simd4.h"
+#include <float.h>
+#include <math.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 
-// Function to load maze from ASCII file
-Maze LoadMazeFromFile(const char* filename) {
-    Maze maze = {0};
-    FILE* file = fopen(filename, "r");
-    
-    if (file == NULL) {
-        TraceLog(LOG_ERROR, "Failed to open maze file: %s", filename);
+#if !defined(_WIN32)
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+// Read-only bytes of a whole file, mapped where the platform allows it
+typedef struct {
+    const char* bytes;
+    size_t size;
+    bool mapped;
+} MazeFileView;
+
+// Map the file (POSIX), or read it with one fread when mapping isn't available
+static bool OpenMazeFileView(const char* filename, MazeFileView* view) {
+    memset(view, 0, sizeof(*view));
+#if !defined(_WIN32)
+    int fd = open(filename, O_RDONLY);
+    if (fd >= 0) {
+        struct stat info;
+        bool sized = fstat(fd, &info) == 0;
+        if (sized && info.st_size == 0) {
+            close(fd);
+            return true;
+        }
+        if (sized && info.st_size > 0) {
+            void* bytes = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (bytes != MAP_FAILED) {
+                posix_madvise(bytes, (size_t)info.st_size, POSIX_MADV_SEQUENTIAL);
+                view->bytes = (const char*)bytes;
+                view->size = (size_t)info.st_size;
+                view->mapped = true;
+                close(fd);
+                return true;
+            }
+        }
+        close(fd);
+    }
+#endif
+    FILE* file = fopen(filename, "rb");
+    if (!file) return false;
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    if (size <= 0) {
+        fclose(file);
+        return size == 0;
+    }
+    char* bytes = (char*)malloc((size_t)size);
+    if (bytes && fread(bytes, 1, (size_t)size, file) == (size_t)size) {
+        view->bytes = bytes;
+        view->size = (size_t)size;
+    } else {
+        free(bytes);
+    }
+    fclose(file);
+    return view->bytes != NULL;
+}
+
+static void CloseMazeFileView(MazeFileView* view) {
+#if !defined(_WIN32)
+    if (view->mapped) {
+        munmap((void*)view->bytes, view->size);
+        return;
+    }
+#endif
+    free((void*)view->bytes);
+}
+
+// Pack one line of text into wall bits, 32 characters per word (two 16-byte compares on SSE2)
+static void PackMazeRow(unsigned int* words, const char* line, int length) {
+    int col = 0;
+#if defined(SIMD4_SSE2)
+    const __m128i wall = _mm_set1_epi8('#');
+    for (; col + MAZE_WORD_BITS <= length; col += MAZE_WORD_BITS) {
+        __m128i low = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(line + col)), wall);
+        __m128i high = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(line + col + 16)), wall);
+        *words++ = (unsigned int)_mm_movemask_epi8(low) | ((unsigned int)_mm_movemask_epi8(high) << 16);
+    }
+#endif
+    for (; col + MAZE_WORD_BITS <= length; col += MAZE_WORD_BITS) {
+        unsigned int word = 0;
+        for (int i = 0; i < MAZE_WORD_BITS; i++) word |= (unsigned int)(line[col + i] == '#') << i;
+        *words++ = word;
+    }
+    if (col < length) {
+        unsigned int word = 0;
+        for (int i = 0; col + i < length; i++) word |= (unsigned int)(line[col + i] == '#') << i;
+        *words = word;
+    }
+}
+
+// Widen every packed row to wordsPerRow words (a line longer than the first one came up)
+static bool WidenMazeRows(Maze* maze, int rowCapacity, int wordsPerRow) {
+    unsigned int* walls = (unsigned int*)calloc((size_t)rowCapacity * wordsPerRow, sizeof(unsigned int));
+    if (!walls) return false;
+    for (int row = 0; row < maze->height; row++) {
+        memcpy(walls + (size_t)row * wordsPerRow, maze->walls + (size_t)row * maze->wordsPerRow,
+               maze->wordsPerRow * sizeof(unsigned int));
+    }
+    free(maze->walls);
+    maze->walls = walls;
+    maze->wordsPerRow = wordsPerRow;
+    return true;
+}
+
+// Single pass over the text: every line is packed straight from the buffer. Rows are sized from the
+// first line and only widened or extended when a longer line or more lines than estimated turn up.
+Maze LoadMazeFromMemory(const char* text, size_t size) {
+    Maze maze = { 0 };
+    if (!text || size == 0) return maze;
+
+    const char* end = text + size;
+    const char* firstEnd = (const char*)memchr(text, '\n', size);
+    size_t firstLength = (firstEnd ? (size_t)(firstEnd - text) : size);
+    if (firstLength > (size_t)0x7fffffff) return maze;
+    maze.wordsPerRow = ((int)firstLength + MAZE_WORD_BITS - 1) / MAZE_WORD_BITS;
+    if (maze.wordsPerRow < 1) maze.wordsPerRow = 1;
+    size_t estimate = size / (firstLength + 1) + 1;
+    int rowCapacity = (estimate < (size_t)0x7fffffff) ? (int)estimate : 0x7fffffff;
+    maze.walls = (unsigned int*)calloc((size_t)rowCapacity * maze.wordsPerRow, sizeof(unsigned int));
+    if (!maze.walls) {
+        TraceLog(LOG_ERROR, "MAZE: Out of memory for %d rows", rowCapacity);
         return maze;
     }
-    
-    char line[MAX_MAZE_WIDTH + 2]; // +2 for newline and null terminator
-    int row = 0;
-    
-    while (fgets(line, sizeof(line), file) && row < MAX_MAZE_HEIGHT) {
-        int col = 0;
-        for (int i = 0; line[i] != '\0' && line[i] != '\n' && col < MAX_MAZE_WIDTH; i++) {
-            maze.data[row][col] = line[i];
-            col++;
+
+    const char* line = text;
+    while (line < end) {
+        const char* newline = (const char*)memchr(line, '\n', (size_t)(end - line));
+        const char* lineEnd = newline ? newline : end;
+        size_t length = (size_t)(lineEnd - line);
+        if (length > 0 && line[length - 1] == '\r') length--;
+        if (length > (size_t)0x7fffffff - MAZE_WORD_BITS) break;
+
+        int wordsNeeded = ((int)length + MAZE_WORD_BITS - 1) / MAZE_WORD_BITS;
+        if (wordsNeeded > maze.wordsPerRow && !WidenMazeRows(&maze, rowCapacity, wordsNeeded)) break;
+        if (maze.height == rowCapacity) {
+            int capacity = rowCapacity * 2;
+            unsigned int* walls = (unsigned int*)realloc(maze.walls, (size_t)capacity * maze.wordsPerRow * sizeof(unsigned int));
+            if (!walls) break;
+            memset(walls + (size_t)rowCapacity * maze.wordsPerRow, 0, (size_t)rowCapacity * maze.wordsPerRow * sizeof(unsigned int));
+            maze.walls = walls;
+            rowCapacity = capacity;
+        }
+
+        PackMazeRow(maze.walls + (size_t)maze.height * maze.wordsPerRow, line, (int)length);
+        if ((int)length > maze.width) maze.width = (int)length;
+        maze.height++;
+        if (!newline) break;
+        line = newline + 1;
+    }
+
+    // Give back the rows reserved by the estimate
+    if (maze.height < rowCapacity && maze.height > 0) {
+        unsigned int* walls = (unsigned int*)realloc(maze.walls, (size_t)maze.height * maze.wordsPerRow * sizeof(unsigned int));
+        if (walls) maze.walls = walls;
+    }
+    return maze;
+}
+
+// Row encodings of the binary format
+#define MAZE_ROW_PACKED 0
+#define MAZE_ROW_RUNS 1
+#define MAZE_ROW_REPEAT 2
+#define MAZE_BINARY_HEADER 16
+
+static unsigned int ReadMazeU32(const unsigned char* bytes) {
+    return (unsigned int)bytes[0] | ((unsigned int)bytes[1] << 8) | ((unsigned int)bytes[2] << 16) | ((unsigned int)bytes[3] << 24);
+}
+
+static void WriteMazeU32(unsigned char* bytes, unsigned int value) {
+    for (int i = 0; i < 4; i++) bytes[i] = (unsigned char)(value >> (i * 8));
+}
+
+// Set the wall bits of cells [start, start + count) in a row
+static void SetMazeRowBits(unsigned int* words, int start, int count) {
+    while (count > 0) {
+        int bit = start % MAZE_WORD_BITS;
+        int span = MAZE_WORD_BITS - bit < count ? MAZE_WORD_BITS - bit : count;
+        unsigned int mask = (span == MAZE_WORD_BITS) ? 0xFFFFFFFFu : ((1u << span) - 1u) << bit;
+        words[start / MAZE_WORD_BITS] |= mask;
+        start += span;
+        count -= span;
+    }
+}
+
+// LEB128 value at *cursor, false when it runs past end or doesn't fit an int
+static bool ReadMazeVarint(const unsigned char** cursor, const unsigned char* end, int* value) {
+    unsigned int result = 0;
+    for (int shift = 0; shift < 32; shift += 7) {
+        if (*cursor >= end) return false;
+        unsigned char byte = *(*cursor)++;
+        result |= (unsigned int)(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) {
+            if (result > 0x7fffffffu) return false;
+            *value = (int)result;
+            return true;
         }
-        
-        if (col > maze.width) maze.width = col;
-        row++;
+    }
+    return false;
+}
+
+static int WriteMazeVarint(unsigned char* bytes, unsigned int value) {
+    int length = 0;
+    do {
+        unsigned char byte = value & 0x7F;
+        value >>= 7;
+        bytes[length++] = byte | (value ? 0x80 : 0);
+    } while (value);
+    return length;
+}
+
+// Decode the rows that follow the header into maze->walls (zeroed), false when the data is malformed
+static bool UnpackMazeRows(Maze* maze, const unsigned char* cursor, const unsigned char* end) {
+    size_t packedBytes = ((size_t)maze->width + 7) / 8;
+    for (int row = 0; row < maze->height; row++) {
+        unsigned int* words = maze->walls + (size_t)row * maze->wordsPerRow;
+        if (cursor >= end) return false;
+        int tag = *cursor++;
+        if (tag == MAZE_ROW_PACKED) {
+            if ((size_t)(end - cursor) < packedBytes) return false;
+            // Whole words straight from the bytes, then the tail byte by byte
+            size_t byte = 0;
+            int word = 0;
+            for (; byte + 4 <= packedBytes; byte += 4) words[word++] = ReadMazeU32(cursor + byte);
+            for (int shift = 0; byte < packedBytes; byte++, shift += 8) words[word] |= (unsigned int)cursor[byte] << shift;
+            if (maze->width % MAZE_WORD_BITS) words[maze->wordsPerRow - 1] &= (1u << (maze->width % MAZE_WORD_BITS)) - 1u;
+            cursor += packedBytes;
+        } else if (tag == MAZE_ROW_RUNS) {
+            int col = 0;
+            bool wall = false;
+            while (col < maze->width) {
+                int run;
+                if (!ReadMazeVarint(&cursor, end, &run) || run > maze->width - col) return false;
+                if (wall) SetMazeRowBits(words, col, run);
+                col += run;
+                wall = !wall;
+            }
+        } else if (tag == MAZE_ROW_REPEAT && row > 0) {
+            memcpy(words, words - maze->wordsPerRow, maze->wordsPerRow * sizeof(unsigned int));
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool IsMazeBinary(const void* data, size_t size) {
+    return data && size >= MAZE_BINARY_HEADER && memcmp(data, MAZE_BINARY_MAGIC, 4) == 0;
+}
+
+Maze LoadMazeFromBinary(const void* data, size_t size) {
+    Maze maze = { 0 };
+    if (!IsMazeBinary(data, size)) return maze;
+    const unsigned char* bytes = (const unsigned char*)data;
+    const unsigned char* end = bytes + size;
+    unsigned int version = ReadMazeU32(bytes + 4);
+    unsigned int width = ReadMazeU32(bytes + 8);
+    unsigned int height = ReadMazeU32(bytes + 12);
+    if (version != MAZE_BINARY_VERSION || width > 0x7fffffffu - MAZE_WORD_BITS || height > 0x7fffffffu) {
+        TraceLog(LOG_ERROR, "MAZE: Unsupported binary maze (version %u, %ux%u)", version, width, height);
+        return maze;
+    }
+    if (height > size - MAZE_BINARY_HEADER) {
+        // Every row takes at least its tag byte, don't allocate for rows that can't be there
+        TraceLog(LOG_ERROR, "MAZE: Truncated or malformed binary maze");
+        return maze;
+    }
+
+    maze.wordsPerRow = ((int)width + MAZE_WORD_BITS - 1) / MAZE_WORD_BITS;
+    if (maze.wordsPerRow < 1) maze.wordsPerRow = 1;
+    maze.walls = (unsigned int*)calloc((size_t)(height > 0 ? height : 1) * maze.wordsPerRow, sizeof(unsigned int));
+    if (!maze.walls) {
+        TraceLog(LOG_ERROR, "MAZE: Out of memory for a %ux%u maze", width, height);
+        maze.wordsPerRow = 0;
+        return maze;
+    }
+    maze.width = (int)width;
+    maze.height = (int)height;
+
+    if (!UnpackMazeRows(&maze, bytes + MAZE_BINARY_HEADER, end)) {
+        TraceLog(LOG_ERROR, "MAZE: Truncated or malformed binary maze");
+        UnloadMaze(&maze);
+        maze.wordsPerRow = 0;
+    }
+    return maze;
+}
+
+// Run lengths of a row into bytes, returns their size or 0 once it would exceed limit
+static size_t EncodeMazeRowRuns(const Maze* maze, int row, unsigned char* bytes, size_t limit) {
+    size_t length = 0;
+    int col = 0;
+    bool wall = false;
+    while (col < maze->width) {
+        int run = 0;
+        while (col + run < maze->width && MazeIsWall(maze, col + run, row) == wall) run++;
+        if (length + 5 > limit) return 0;
+        length += WriteMazeVarint(bytes + length, (unsigned int)run);
+        col += run;
+        wall = !wall;
+    }
+    return length;
+}
+
+bool ExportMazeBinary(const Maze* maze, const char* filename) {
+    size_t packedBytes = ((size_t)maze->width + 7) / 8;
+    unsigned char* row = (unsigned char*)malloc(packedBytes + 8);
+    FILE* file = fopen(filename, "wb");
+    if (!row || !file) {
+        free(row);
+        if (file) fclose(file);
+        TraceLog(LOG_ERROR, "MAZE: Failed to write binary maze: %s", filename);
+        return false;
+    }
+
+    unsigned char header[MAZE_BINARY_HEADER];
+    memcpy(header, MAZE_BINARY_MAGIC, 4);
+    WriteMazeU32(header + 4, MAZE_BINARY_VERSION);
+    WriteMazeU32(header + 8, (unsigned int)maze->width);
+    WriteMazeU32(header + 12, (unsigned int)maze->height);
+    bool ok = fwrite(header, 1, sizeof(header), file) == sizeof(header);
+
+    for (int r = 0; r < maze->height && ok; r++) {
+        const unsigned int* words = maze->walls + (size_t)r * maze->wordsPerRow;
+        unsigned char tag = MAZE_ROW_PACKED;
+        size_t length = 0;
+        if (r > 0 && memcmp(words, words - maze->wordsPerRow, maze->wordsPerRow * sizeof(unsigned int)) == 0) {
+            tag = MAZE_ROW_REPEAT;
+        } else if ((length = EncodeMazeRowRuns(maze, r, row, packedBytes)) > 0) {
+            tag = MAZE_ROW_RUNS;
+        } else {
+            for (size_t b = 0; b < packedBytes; b++) row[b] = (unsigned char)(words[b / 4] >> ((b % 4) * 8));
+            length = packedBytes;
+        }
+        ok = fputc(tag, file) != EOF && fwrite(row, 1, length, file) == length;
+    }
+    ok = (fclose(file) == 0) && ok;
+    free(row);
+    if (!ok) TraceLog(LOG_ERROR, "MAZE: Failed to write binary maze: %s", filename);
+    return ok;
+}
+
+bool ExportMazeText(const Maze* maze, const char* filename) {
+    char* line = (char*)malloc((size_t)maze->width + 1);
+    FILE* file = fopen(filename, "wb");
+    if (!line || !file) {
+        free(line);
+        if (file) fclose(file);
+        TraceLog(LOG_ERROR, "MAZE: Failed to write maze: %s", filename);
+        return false;
+    }
+    bool ok = true;
+    for (int row = 0; row < maze->height && ok; row++) {
+        for (int col = 0; col < maze->width; col++) line[col] = MazeIsWall(maze, col, row) ? '#' : ' ';
+        line[maze->width] = '\n';
+        ok = fwrite(line, 1, (size_t)maze->width + 1, file) == (size_t)maze->width + 1;
+    }
+    ok = (fclose(file) == 0) && ok;
+    free(line);
+    if (!ok) TraceLog(LOG_ERROR, "MAZE: Failed to write maze: %s", filename);
+    return ok;
+}
+
+Maze LoadMazeFromFile(const char* filename) {
+    MazeFileView view;
+    if (!OpenMazeFileView(filename, &view)) {
+        TraceLog(LOG_ERROR, "Failed to open maze file: %s", filename);
+        Maze empty = { 0 };
+        return empty;
     }
     
-    maze.height = row;
-    fclose(file);
+    Maze maze = IsMazeBinary(view.bytes, view.size) ? LoadMazeFromBinary(view.bytes, view.size)
+                                                    : LoadMazeFromMemory(view.bytes, view.size);
+    CloseMazeFileView(&view);
     
     TraceLog(LOG_INFO, "Loaded maze: %dx%d", maze.width, maze.height);
     return maze;
-}
\ No newline at end of file
+}
+
+Maze CopyMaze(const Maze* maze) {
+    Maze copy = *maze;
+    size_t bytes = (size_t)maze->height * maze->wordsPerRow * sizeof(unsigned int);
+    copy.walls = (bytes > 0) ? (unsigned int*)malloc(bytes) : NULL;
+    if (copy.walls) {
+        memcpy(copy.walls, maze->walls, bytes);
+    } else {
+        copy.width = copy.height = 0;
+    }
+    return copy;
+}
+
+void UnloadMaze(Maze* maze) {
+    free(maze->walls);
+    maze->walls = NULL;
+    maze->width = maze->height = 0;
+}
+
+// True for wall cells, everything outside the maze is open
+bool MazeIsWall(const Maze* maze, int col, int row) {
+    if (col < 0 || row < 0 || col >= maze->width || row >= maze->height) return false;
+    unsigned int word = maze->walls[(size_t)row * maze->wordsPerRow + col / MAZE_WORD_BITS];
+    return (word >> (col % MAZE_WORD_BITS)) & 1u;
+}
+
+// World-space x/z of the minimum corner of cell (0, 0), the maze is centered on the origin
+Vector2 GetMazeGridOrigin(const Maze* maze) {
+    Vector2 origin;
+    origin.x = -(maze->width * MAZE_CELL_SIZE) / 2.0f - MAZE_CELL_SIZE / 2.0f;
+    origin.y = -(maze->height * MAZE_CELL_SIZE) / 2.0f - MAZE_CELL_SIZE / 2.0f;
+    return origin;
+}
+
+// March a ray through the maze grid (2D DDA over x/z) and return the closest wall or floor hit
+bool MazeRaycast(const Maze* maze, Vector3 origin, Vector3 dir, float maxDistance, float* hitDistance, Vector3* hitNormal) {
+    // The floor is the y = 0 plane, walls only have to be searched up to it
+    float floorDistance = (dir.y < 0.0f && origin.y >= 0.0f) ? -origin.y / dir.y : FLT_MAX;
+    bool floorHit = floorDistance <= maxDistance;
+    if (floorHit) maxDistance = floorDistance;
+
+    Vector2 gridOrigin = GetMazeGridOrigin(maze);
+    float gridX = (origin.x - gridOrigin.x) / MAZE_CELL_SIZE;
+    float gridZ = (origin.z - gridOrigin.y) / MAZE_CELL_SIZE;
+    int col = (int)floorf(gridX);
+    int row = (int)floorf(gridZ);
+    int stepX = (dir.x > 0.0f) ? 1 : -1;
+    int stepZ = (dir.z > 0.0f) ? 1 : -1;
+
+    // Ray distance to the next cell boundary on each axis, and between boundaries
+    float tDeltaX = (dir.x != 0.0f) ? fabsf(MAZE_CELL_SIZE / dir.x) : FLT_MAX;
+    float tDeltaZ = (dir.z != 0.0f) ? fabsf(MAZE_CELL_SIZE / dir.z) : FLT_MAX;
+    float tMaxX = (dir.x > 0.0f) ? (col + 1 - gridX) * MAZE_CELL_SIZE / dir.x :
+                  (dir.x < 0.0f) ? (gridX - col) * MAZE_CELL_SIZE / -dir.x : FLT_MAX;
+    float tMaxZ = (dir.z > 0.0f) ? (row + 1 - gridZ) * MAZE_CELL_SIZE / dir.z :
+                  (dir.z < 0.0f) ? (gridZ - row) * MAZE_CELL_SIZE / -dir.z : FLT_MAX;
+
+    float tEnter = 0.0f;
+    Vector3 enterNormal = { -dir.x, -dir.y, -dir.z };  // Starting inside a wall
+    float distance = -1.0f;
+    Vector3 normal = { 0.0f, 1.0f, 0.0f };
+
+    while (tEnter < maxDistance) {
+        float tExit = fminf(fminf(tMaxX, tMaxZ), maxDistance);
+
+        // Walls are full columns up to MAZE_WALL_TOP: hit the side when entering below the top,
+        // or the top face when coming down onto it inside the cell
+        if (MazeIsWall(maze, col, row)) {
+            if (origin.y + dir.y * tEnter < MAZE_WALL_TOP) {
+                distance = tEnter;
+                normal = enterNormal;
+                break;
+            }
+            if (dir.y < 0.0f) {
+                float tTop = (MAZE_WALL_TOP - origin.y) / dir.y;
+                if (tTop < tExit) {
+                    distance = tTop;
+                    break;
+                }
+            }
+        }
+
+        // Climbing above every wall, nothing further along can be hit
+        if (dir.y >= 0.0f && origin.y + dir.y * tExit >= MAZE_WALL_TOP) break;
+
+        if (tMaxX < tMaxZ) {
+            col += stepX;
+            tEnter = tMaxX;
+            tMaxX += tDeltaX;
+            enterNormal = (Vector3){ (float)-stepX, 0.0f, 0.0f };
+        } else {
+            row += stepZ;
+            tEnter = tMaxZ;
+            tMaxZ += tDeltaZ;
+            enterNormal = (Vector3){ 0.0f, 0.0f, (float)-stepZ };
+        }
+
+        // Left the maze and moving away from it
+        if ((col < 0 && (stepX < 0 || dir.x == 0.0f)) || (col >= maze->width && (stepX > 0 || dir.x == 0.0f)) ||
+            (row < 0 && (stepZ < 0 || dir.z == 0.0f)) || (row >= maze->height && (stepZ > 0 || dir.z == 0.0f))) {
+            break;
+        }
+    }
+
+    if (distance < 0.0f) {
+        if (!floorHit) return false;
+        distance = floorDistance;
+        normal = (Vector3){ 0.0f, 1.0f, 0.0f };
+    }
+    if (hitDistance) *hitDistance = distance;
+    if (hitNormal) *hitNormal = normal;
+    return true;
+}
@@ -0,0 +1,320 @@
+#include "maze_batch.h"
+#include "mesh_generation.h"
+#include "raymath.h"
+#include <float.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Face ids of GetMazeWallBaseColor
+#define WALL_FACE_POS_Z 0
+#define WALL_FACE_NEG_Z 1
+#define WALL_FACE_NEG_X 2
+#define WALL_FACE_POS_X 3
+#define WALL_FACE_TOP 4
+
+// One merged rectangle: corner origin, edges u and v with u x v along the outward normal
+typedef struct {
+    Vector3 origin;
+    Vector3 u;
+    Vector3 v;
+    Vector3 normal;
+    int face;
+} WallQuad;
+
+typedef struct {
+    WallQuad* quads;
+    int count;
+    int capacity;
+} WallQuadList;
+
+static void AddWallQuad(WallQuadList* list, Vector3 origin, Vector3 u, Vector3 v, Vector3 normal, int face) {
+    if (list->count == list->capacity) {
+        int capacity = list->capacity ? list->capacity * 2 : 64;
+        WallQuad* quads = (WallQuad*)realloc(list->quads, capacity * sizeof(WallQuad));
+        if (!quads) return;
+        list->quads = quads;
+        list->capacity = capacity;
+    }
+    list->quads[list->count++] = (WallQuad){ origin, u, v, normal, face };
+}
+
+// Wall side facing the neighbour (dx, dz) is visible when that neighbour is open
+static bool IsWallSideExposed(const Maze* maze, int col, int row, int dx, int dz) {
+    return MazeIsWall(maze, col, row) && !MazeIsWall(maze, col + dx, row + dz);
+}
+
+// Segments a quad edge is split into
+static int GetWallQuadSegments(Vector3 edge, float maxQuadSize) {
+    if (maxQuadSize <= 0.0f) return 1;
+    int segments = (int)ceilf(Vector3Length(edge) / maxQuadSize - 0.001f);
+    return (segments < 1) ? 1 : segments;
+}
+
+// Position within a cell (0-1) of a distance along a wall
+static float GetWallCellFraction(float distance) {
+    float cells = distance / MAZE_CELL_SIZE;
+    float fraction = cells - floorf(cells + 0.001f);
+    return (fraction < 0.0f) ? 0.0f : fraction;
+}
+
+// Greedy-merge the visible faces of the walls in a cell rectangle
+static void CollectWallQuads(const Maze* maze, int col0, int row0, int col1, int row1, WallQuadList* list) {
+    Vector2 gridOrigin = GetMazeGridOrigin(maze);
+    float cs = MAZE_CELL_SIZE;
+    float bottom = WALL_HEIGHT / 2.0f - cs / 2.0f;
+    Vector3 up = { 0.0f, cs, 0.0f };
+
+    // Sides facing +z/-z: runs along x within each row
+    for (int row = row0; row < row1; row++) {
+        for (int side = 0; side < 2; side++) {
+            int dz = (side == 0) ? 1 : -1;
+            int col = col0;
+            while (col < col1) {
+                if (!IsWallSideExposed(maze, col, row, 0, dz)) { col++; continue; }
+                int start = col;
+                while (col < col1 && IsWallSideExposed(maze, col, row, 0, dz)) col++;
+
+                float x0 = gridOrigin.x + start * cs;
+                float x1 = gridOrigin.x + col * cs;
+                if (dz > 0) {
+                    float z = gridOrigin.y + (row + 1) * cs;
+                    AddWallQuad(list, (Vector3){ x0, bottom, z }, (Vector3){ x1 - x0, 0.0f, 0.0f }, up,
+                                (Vector3){ 0.0f, 0.0f, 1.0f }, WALL_FACE_POS_Z);
+                } else {
+                    float z = gridOrigin.y + row * cs;
+                    AddWallQuad(list, (Vector3){ x1, bottom, z }, (Vector3){ x0 - x1, 0.0f, 0.0f }, up,
+                                (Vector3){ 0.0f, 0.0f, -1.0f }, WALL_FACE_NEG_Z);
+                }
+            }
+        }
+    }
+
+    // Sides facing +x/-x: runs along z within each column
+    for (int col = col0; col < col1; col++) {
+        for (int side = 0; side < 2; side++) {
+            int dx = (side == 0) ? 1 : -1;
+            int row = row0;
+            while (row < row1) {
+                if (!IsWallSideExposed(maze, col, row, dx, 0)) { row++; continue; }
+                int start = row;
+                while (row < row1 && IsWallSideExposed(maze, col, row, dx, 0)) row++;
+
+                float z0 = gridOrigin.y + start * cs;
+                float z1 = gridOrigin.y + row * cs;
+                if (dx > 0) {
+                    float x = gridOrigin.x + (col + 1) * cs;
+                    AddWallQuad(list, (Vector3){ x, bottom, z1 }, (Vector3){ 0.0f, 0.0f, z0 - z1 }, up,
+                                (Vector3){ 1.0f, 0.0f, 0.0f }, WALL_FACE_POS_X);
+                } else {
+                    float x = gridOrigin.x + col * cs;
+                    AddWallQuad(list, (Vector3){ x, bottom, z0 }, (Vector3){ 0.0f, 0.0f, z1 - z0 }, up,
+                                (Vector3){ -1.0f, 0.0f, 0.0f }, WALL_FACE_NEG_X);
+                }
+            }
+        }
+    }
+
+    // Tops: grow a rectangle along x, then along z while whole rows stay walls
+    int width = col1 - col0;
+    int height = row1 - row0;
+    unsigned char* used = (unsigned char*)calloc(width * height, 1);
+    if (!used) return;
+    for (int r = 0; r < height; r++) {
+        for (int c = 0; c < width; c++) {
+            if (used[r * width + c] || !MazeIsWall(maze, col0 + c, row0 + r)) continue;
+
+            int w = 1;
+            while (c + w < width && !used[r * width + c + w] && MazeIsWall(maze, col0 + c + w, row0 + r)) w++;
+            int h = 1;
+            for (; r + h < height; h++) {
+                bool full = true;
+                for (int i = 0; i < w && full; i++) {
+                    full = !used[(r + h) * width + c + i] && MazeIsWall(maze, col0 + c + i, row0 + r + h);
+                }
+                if (!full) break;
+            }
+            for (int j = 0; j < h; j++) memset(&used[(r + j) * width + c], 1, w);
+
+            Vector3 origin = { gridOrigin.x + (col0 + c) * cs, MAZE_WALL_TOP, gridOrigin.y + (row0 + r) * cs };
+            AddWallQuad(list, origin, (Vector3){ 0.0f, 0.0f, h * cs }, (Vector3){ w * cs, 0.0f, 0.0f },
+                        (Vector3){ 0.0f, 1.0f, 0.0f }, WALL_FACE_TOP);
+        }
+    }
+    free(used);
+}
+
+Mesh BuildMeshMazeWalls(const Maze* maze, int col0, int row0, int col1, int row1, float maxQuadSize) {
+    Mesh mesh = { 0 };
+    WallQuadList list = { 0 };
+    CollectWallQuads(maze, col0, row0, col1, row1, &list);
+
+    for (int q = 0; q < list.count; q++) {
+        int segU = GetWallQuadSegments(list.quads[q].u, maxQuadSize);
+        int segV = GetWallQuadSegments(list.quads[q].v, maxQuadSize);
+        mesh.vertexCount += (segU + 1) * (segV + 1);
+        mesh.triangleCount += segU * segV * 2;
+    }
+    if (mesh.vertexCount == 0 || mesh.vertexCount > 65535) {
+        if (mesh.vertexCount > 0) TraceLog(LOG_WARNING, "BATCH: %d wall vertices don't fit 16-bit indices", mesh.vertexCount);
+        free(list.quads);
+        return (Mesh){ 0 };
+    }
+
+    mesh.vertices = (float*)MemAlloc(mesh.vertexCount * 3 * sizeof(float));
+    mesh.normals = (float*)MemAlloc(mesh.vertexCount * 3 * sizeof(float));
+    mesh.texcoords = (float*)MemAlloc(mesh.vertexCount * 2 * sizeof(float));
+    mesh.colors = (unsigned char*)MemAlloc(mesh.vertexCount * 4);
+    mesh.indices = (unsigned short*)MemAlloc(mesh.triangleCount * 3 * sizeof(unsigned short));
+
+    int vertex = 0;
+    int index = 0;
+    for (int q = 0; q < list.count; q++) {
+        const WallQuad* quad = &list.quads[q];
+        int segU = GetWallQuadSegments(quad->u, maxQuadSize);
+        int segV = GetWallQuadSegments(quad->v, maxQuadSize);
+        float lengthU = Vector3Length(quad->u);
+        float lengthV = Vector3Length(quad->v);
+        int first = vertex;
+
+        for (int j = 0; j <= segV; j++) {
+            for (int i = 0; i <= segU; i++) {
+                float a = (float)i / segU;
+                float b = (float)j / segV;
+                Vector3 p = Vector3Add(quad->origin, Vector3Add(Vector3Scale(quad->u, a), Vector3Scale(quad->v, b)));
+
+                mesh.vertices[vertex * 3 + 0] = p.x;
+                mesh.vertices[vertex * 3 + 1] = p.y;
+                mesh.vertices[vertex * 3 + 2] = p.z;
+                mesh.normals[vertex * 3 + 0] = quad->normal.x;
+                mesh.normals[vertex * 3 + 1] = quad->normal.y;
+                mesh.normals[vertex * 3 + 2] = quad->normal.z;
+
+                // Texture and brick coordinates repeat once per cell like on the cube faces
+                mesh.texcoords[vertex * 2 + 0] = a * lengthU / MAZE_CELL_SIZE;
+                mesh.texcoords[vertex * 2 + 1] = b * lengthV / MAZE_CELL_SIZE;
+                Color color = GetMazeWallBaseColor(quad->face, GetWallCellFraction(a * lengthU), b);
+                mesh.colors[vertex * 4 + 0] = color.r;
+                mesh.colors[vertex * 4 + 1] = color.g;
+                mesh.colors[vertex * 4 + 2] = color.b;
+                mesh.colors[vertex * 4 + 3] = color.a;
+                vertex++;
+            }
+        }
+
+        // Counter-clockwise seen from outside, since u x v points along the normal
+        for (int j = 0; j < segV; j++) {
+            for (int i = 0; i < segU; i++) {
+                int v00 = first + j * (segU + 1) + i;
+                int v10 = v00 + 1;
+                int v01 = v00 + segU + 1;
+                int v11 = v01 + 1;
+                mesh.indices[index++] = (unsigned short)v00;
+                mesh.indices[index++] = (unsigned short)v10;
+                mesh.indices[index++] = (unsigned short)v11;
+                mesh.indices[index++] = (unsigned short)v00;
+                mesh.indices[index++] = (unsigned short)v11;
+                mesh.indices[index++] = (unsigned short)v01;
+            }
+        }
+    }
+
+    free(list.quads);
+    return mesh;
+}
+
+MazeWallBatch LoadMazeWallBatch(const Maze* maze, int chunkCells, float maxQuadSize) {
+    MazeWallBatch batch = { 0 };
+    if (chunkCells <= 0) chunkCells = MAZE_CHUNK_CELLS;
+
+    // 16-bit indices: worst case every cell of a chunk shows four sides and a top
+    int segments = (maxQuadSize > 0.0f) ? (int)ceilf(MAZE_CELL_SIZE / maxQuadSize) : 1;
+    while (chunkCells > 1 && chunkCells * chunkCells * 5 * (segments + 1) * (segments + 1) > 65535) chunkCells--;
+
+    int chunksX = (maze->width + chunkCells - 1) / chunkCells;
+    int chunksZ = (maze->height + chunkCells - 1) / chunkCells;
+    Mesh* meshes = (Mesh*)calloc(chunksX * chunksZ, sizeof(Mesh));
+    batch.bounds = (BoundingBox*)calloc(chunksX * chunksZ, sizeof(BoundingBox));
+    batch.chunkCoords = (int*)calloc(chunksX * chunksZ * 2, sizeof(int));
+    if (!meshes || !batch.bounds || !batch.chunkCoords) {
+        free(meshes);
+        free(batch.bounds);
+        free(batch.chunkCoords);
+        batch.bounds = NULL;
+        batch.chunkCoords = NULL;
+        return batch;
+    }
+    batch.chunkCells = chunkCells;
+
+    double start = GetTime();
+
+    for (int cz = 0; cz < chunksZ; cz++) {
+        for (int cx = 0; cx < chunksX; cx++) {
+            int col0 = cx * chunkCells;
+            int row0 = cz * chunkCells;
+            int col1 = (col0 + chunkCells < maze->width) ? col0 + chunkCells : maze->width;
+            int row1 = (row0 + chunkCells < maze->height) ? row0 + chunkCells : maze->height;
+
+            Mesh chunk = BuildMeshMazeWalls(maze, col0, row0, col1, row1, maxQuadSize);
+            if (chunk.vertexCount == 0) continue;
+
+            for (int row = row0; row < row1; row++) {
+                for (int col = col0; col < col1; col++) {
+                    if (MazeIsWall(maze, col, row)) batch.wallCount++;
+                }
+            }
+
+            BoundingBox bounds = { { FLT_MAX, FLT_MAX, FLT_MAX }, { -FLT_MAX, -FLT_MAX, -FLT_MAX } };
+            for (int v = 0; v < chunk.vertexCount; v++) {
+                Vector3 p = { chunk.vertices[v * 3], chunk.vertices[v * 3 + 1], chunk.vertices[v * 3 + 2] };
+                bounds.min = Vector3Min(bounds.min, p);
+                bounds.max = Vector3Max(bounds.max, p);
+            }
+
+            UploadMesh(&chunk, false);
+            batch.bounds[batch.chunkCount] = bounds;
+            batch.chunkCoords[batch.chunkCount * 2] = cx;
+            batch.chunkCoords[batch.chunkCount * 2 + 1] = cz;
+            meshes[batch.chunkCount] = chunk;
+            batch.chunkCount++;
+            batch.triangleCount += chunk.triangleCount;
+        }
+    }
+
+    if (batch.chunkCount > 0) batch.model = LoadModelFromMeshes(meshes, batch.chunkCount);
+    free(meshes);
+
+    TraceLog(LOG_INFO, "BATCH: Meshed %d walls into %d chunks of %dx%d cells (%d triangles) in %.1f ms",
+             batch.wallCount, batch.chunkCount, chunkCells, chunkCells, batch.triangleCount, (GetTime() - start) * 1000.0);
+    return batch;
+}
+
+int DrawMazeWallBatch(const MazeWallBatch* batch, const Frustum* frustum, const MazePvs* pvs, const MazePvsSet* visible,
+                      RenderQueue* queue, RenderStats* stats) {
+    int drawn = 0;
+    for (int i = 0; i < batch->chunkCount; i++) {
+        bool potentiallyVisible = !visible || IsMazePvsChunkVisible(pvs, visible, batch->chunkCoords[i * 2], batch->chunkCoords[i * 2 + 1]);
+        if (!potentiallyVisible || (frustum && !IsBoxInFrustum(frustum, batch->bounds[i]))) {
+            if (stats) stats->culledObjects++;
+            continue;
+        }
+
+        // Vertices are already in world space
+        drawn++;
+        if (queue) {
+            QueueMesh(queue, &batch->model.meshes[i], &batch->model.materials[0], MatrixIdentity(), WHITE, RENDER_OPAQUE);
+            continue;
+        }
+        DrawMesh(batch->model.meshes[i], batch->model.materials[0], MatrixIdentity());
+        if (stats) stats->triangles += batch->model.meshes[i].triangleCount;
+    }
+    if (stats && !queue) stats->drawCalls += drawn;
+    return drawn;
+}
+
+void UnloadMazeWallBatch(MazeWallBatch* batch) {
+    if (batch->chunkCount > 0) UnloadModel(batch->model);
+    free(batch->bounds);
+    free(batch->chunkCoords);
+    memset(batch, 0, sizeof(MazeWallBatch));
+}
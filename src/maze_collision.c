@@ -0,0 +1,209 @@
+#include "maze_collision.h"
+#include "maze.h"
+#include "thread_pool.h"
+#include <float.h>
+#include <math.h>
+
+// Range of cells touched by the bounds of a circle moving from a to a + delta
+typedef struct {
+    int col0, row0, col1, row1;
+} CellRange;
+
+typedef struct {
+    const Maze* maze;
+    Vector2* positions;
+    const Vector2* deltas;
+    float radius;
+} CollisionJob;
+
+static CellRange GetMoveCellRange(const Maze* maze, Vector2 position, Vector2 delta, float radius) {
+    Vector2 gridOrigin = GetMazeGridOrigin(maze);
+    float minX = fminf(position.x, position.x + delta.x) - radius;
+    float maxX = fmaxf(position.x, position.x + delta.x) + radius;
+    float minZ = fminf(position.y, position.y + delta.y) - radius;
+    float maxZ = fmaxf(position.y, position.y + delta.y) + radius;
+
+    CellRange range;
+    range.col0 = (int)floorf((minX - gridOrigin.x) / MAZE_CELL_SIZE);
+    range.col1 = (int)floorf((maxX - gridOrigin.x) / MAZE_CELL_SIZE);
+    range.row0 = (int)floorf((minZ - gridOrigin.y) / MAZE_CELL_SIZE);
+    range.row1 = (int)floorf((maxZ - gridOrigin.y) / MAZE_CELL_SIZE);
+
+    // Cells outside the maze are open
+    if (range.col0 < 0) range.col0 = 0;
+    if (range.row0 < 0) range.row0 = 0;
+    if (range.col1 >= maze->width) range.col1 = maze->width - 1;
+    if (range.row1 >= maze->height) range.row1 = maze->height - 1;
+    return range;
+}
+
+// Earliest t in [0, 1] at which a circle moving from p by d touches the box [boxMin, boxMax]. This is a
+// ray against the box grown by the radius, with rounded corners (a ray-circle test at each corner).
+static bool SweepCircleBox(Vector2 p, Vector2 d, float radius, Vector2 boxMin, Vector2 boxMax, float* tHit, Vector2* normal) {
+    float tEnter = -FLT_MAX, tExit = FLT_MAX;
+    Vector2 enterNormal = { 0.0f, 0.0f };
+    float pos[2] = { p.x, p.y };
+    float dir[2] = { d.x, d.y };
+    float lo[2] = { boxMin.x - radius, boxMin.y - radius };
+    float hi[2] = { boxMax.x + radius, boxMax.y + radius };
+    for (int axis = 0; axis < 2; axis++) {
+        if (fabsf(dir[axis]) < 1e-12f) {
+            if (pos[axis] <= lo[axis] || pos[axis] >= hi[axis]) return false;
+            continue;
+        }
+        float t0 = (lo[axis] - pos[axis]) / dir[axis];
+        float t1 = (hi[axis] - pos[axis]) / dir[axis];
+        float side = -1.0f;
+        if (t0 > t1) {
+            float swap = t0;
+            t0 = t1;
+            t1 = swap;
+            side = 1.0f;
+        }
+        if (t0 > tEnter) {
+            tEnter = t0;
+            enterNormal = (axis == 0) ? (Vector2){ side, 0.0f } : (Vector2){ 0.0f, side };
+        }
+        if (t1 < tExit) tExit = t1;
+    }
+    if (tEnter > tExit || tEnter > 1.0f || tExit < 0.0f) return false;
+    bool startsInside = tEnter < 0.0f;
+    if (startsInside) tEnter = 0.0f;
+
+    // Inside the grown box on a face, or in a corner square where only the rounded corner counts.
+    // Overlaps at the start are left to the push-out.
+    float cx = p.x + d.x * tEnter;
+    float cz = p.y + d.y * tEnter;
+    bool outsideX = cx < boxMin.x || cx > boxMax.x;
+    bool outsideZ = cz < boxMin.y || cz > boxMax.y;
+    if (!(outsideX && outsideZ)) {
+        if (startsInside) return false;
+        *tHit = tEnter;
+        *normal = enterNormal;
+        return true;
+    }
+
+    Vector2 corner = { (cx < boxMin.x) ? boxMin.x : boxMax.x, (cz < boxMin.y) ? boxMin.y : boxMax.y };
+    float mx = p.x - corner.x;
+    float mz = p.y - corner.y;
+    float a = d.x * d.x + d.y * d.y;
+    float b = mx * d.x + mz * d.y;
+    float c = mx * mx + mz * mz - radius * radius;
+    float discriminant = b * b - a * c;
+    if (b >= 0.0f || discriminant < 0.0f) return false;
+    float t = (-b - sqrtf(discriminant)) / a;
+    if (t < 0.0f || t > 1.0f) return false;
+    float hx = mx + d.x * t;
+    float hz = mz + d.y * t;
+    float length = sqrtf(hx * hx + hz * hz);
+    *tHit = t;
+    *normal = (length > 0.0f) ? (Vector2){ hx / length, hz / length } : enterNormal;
+    return true;
+}
+
+bool SweepCircleInMaze(const Maze* maze, Vector2 position, Vector2 delta, float radius, float* fraction, Vector2* normal) {
+    CellRange range = GetMoveCellRange(maze, position, delta, radius);
+    Vector2 gridOrigin = GetMazeGridOrigin(maze);
+    float best = FLT_MAX;
+    Vector2 bestNormal = { 0.0f, 0.0f };
+    for (int row = range.row0; row <= range.row1; row++) {
+        for (int col = range.col0; col <= range.col1; col++) {
+            if (!MazeIsWall(maze, col, row)) continue;
+            Vector2 boxMin = { gridOrigin.x + col * MAZE_CELL_SIZE, gridOrigin.y + row * MAZE_CELL_SIZE };
+            Vector2 boxMax = { boxMin.x + MAZE_CELL_SIZE, boxMin.y + MAZE_CELL_SIZE };
+            float t;
+            Vector2 n;
+            if (SweepCircleBox(position, delta, radius, boxMin, boxMax, &t, &n) && t < best) {
+                best = t;
+                bestNormal = n;
+            }
+        }
+    }
+    if (best == FLT_MAX) return false;
+    if (fraction) *fraction = best;
+    if (normal) *normal = bestNormal;
+    return true;
+}
+
+// Push a circle out of every wall cell it overlaps, along the shortest way out of each
+static Vector2 PushCircleOutOfWalls(const Maze* maze, Vector2 position, float radius) {
+    CellRange range = GetMoveCellRange(maze, position, (Vector2){ 0.0f, 0.0f }, radius);
+    Vector2 gridOrigin = GetMazeGridOrigin(maze);
+    for (int row = range.row0; row <= range.row1; row++) {
+        for (int col = range.col0; col <= range.col1; col++) {
+            if (!MazeIsWall(maze, col, row)) continue;
+            float minX = gridOrigin.x + col * MAZE_CELL_SIZE;
+            float minZ = gridOrigin.y + row * MAZE_CELL_SIZE;
+            float nearX = fminf(fmaxf(position.x, minX), minX + MAZE_CELL_SIZE);
+            float nearZ = fminf(fmaxf(position.y, minZ), minZ + MAZE_CELL_SIZE);
+            float dx = position.x - nearX;
+            float dz = position.y - nearZ;
+            float distanceSq = dx * dx + dz * dz;
+            if (distanceSq >= radius * radius) continue;
+
+            if (distanceSq > 0.0f) {
+                float distance = sqrtf(distanceSq);
+                float push = radius + COLLISION_SKIN - distance;
+                position.x += dx / distance * push;
+                position.y += dz / distance * push;
+            } else {
+                // Center inside the cell: leave through the nearest face
+                float exits[4] = { position.x - minX, minX + MAZE_CELL_SIZE - position.x,
+                                   position.y - minZ, minZ + MAZE_CELL_SIZE - position.y };
+                int face = 0;
+                for (int i = 1; i < 4; i++) if (exits[i] < exits[face]) face = i;
+                float push = exits[face] + radius + COLLISION_SKIN;
+                if (face == 0) position.x -= push;
+                else if (face == 1) position.x += push;
+                else if (face == 2) position.y -= push;
+                else position.y += push;
+            }
+        }
+    }
+    return position;
+}
+
+Vector2 MoveCircleInMaze(const Maze* maze, Vector2 position, Vector2 delta, float radius) {
+    if (maze->width <= 0 || maze->height <= 0) return (Vector2){ position.x + delta.x, position.y + delta.y };
+    position = PushCircleOutOfWalls(maze, position, radius);
+
+    for (int slide = 0; slide < COLLISION_MAX_SLIDES; slide++) {
+        float length = sqrtf(delta.x * delta.x + delta.y * delta.y);
+        if (length < 1e-6f) break;
+
+        float t;
+        Vector2 normal;
+        if (!SweepCircleInMaze(maze, position, delta, radius, &t, &normal)) {
+            position.x += delta.x;
+            position.y += delta.y;
+            return position;
+        }
+
+        // Stop just short of the contact, then keep only the part of the rest along the wall
+        float travel = fmaxf(t - COLLISION_SKIN / length, 0.0f);
+        position.x += delta.x * travel;
+        position.y += delta.y * travel;
+        Vector2 rest = { delta.x * (1.0f - travel), delta.y * (1.0f - travel) };
+        float into = rest.x * normal.x + rest.y * normal.y;
+        delta.x = rest.x - normal.x * into;
+        delta.y = rest.y - normal.y * into;
+    }
+    return position;
+}
+
+static void MoveCircleRange(void* context, int start, int end) {
+    CollisionJob* job = (CollisionJob*)context;
+    for (int i = start; i < end; i++) {
+        job->positions[i] = MoveCircleInMaze(job->maze, job->positions[i], job->deltas[i], job->radius);
+    }
+}
+
+void MoveCirclesInMaze(const Maze* maze, Vector2* positions, const Vector2* deltas, int count, float radius) {
+    CollisionJob job = { maze, positions, deltas, radius };
+    if (count < COLLISION_PARALLEL_MIN) {
+        MoveCircleRange(&job, 0, count);
+        return;
+    }
+    int grainSize = count / (GetThreadPoolSize() * 4);
+    ParallelFor(count, grainSize > 0 ? grainSize : 1, MoveCircleRange, &job);
+}
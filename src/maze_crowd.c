@@ -0,0 +1,392 @@
+#include "maze_crowd.h"
+#include "maze.h"
+#include "maze_collision.h"
+#include "simd4.h"
+#include "thread_pool.h"
+#include <float.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define CROWD_SQRT2 1.41421356f
+
+// Neighbour offsets, opposite directions are 7 - index
+static const int flowOffsets[8][2] = {
+    { -1, -1 }, { 0, -1 }, { 1, -1 }, { -1, 0 }, { 1, 0 }, { -1, 1 }, { 0, 1 }, { 1, 1 }
+};
+
+typedef struct {
+    float distance;
+    int cell;
+} FlowHeapItem;
+
+typedef struct {
+    FlowHeapItem* items;
+    int count;
+    int capacity;
+} FlowHeap;
+
+typedef struct {
+    MazeCrowd* crowd;
+    float deltaTime;
+} CrowdStepJob;
+
+static bool PushFlowHeap(FlowHeap* heap, float distance, int cell) {
+    if (heap->count == heap->capacity) {
+        int capacity = heap->capacity ? heap->capacity * 2 : 1024;
+        FlowHeapItem* items = (FlowHeapItem*)realloc(heap->items, capacity * sizeof(FlowHeapItem));
+        if (!items) return false;
+        heap->items = items;
+        heap->capacity = capacity;
+    }
+    int i = heap->count++;
+    while (i > 0) {
+        int parent = (i - 1) / 2;
+        if (heap->items[parent].distance <= distance) break;
+        heap->items[i] = heap->items[parent];
+        i = parent;
+    }
+    heap->items[i] = (FlowHeapItem){ distance, cell };
+    return true;
+}
+
+static FlowHeapItem PopFlowHeap(FlowHeap* heap) {
+    FlowHeapItem top = heap->items[0];
+    FlowHeapItem last = heap->items[--heap->count];
+    int i = 0;
+    for (;;) {
+        int child = i * 2 + 1;
+        if (child >= heap->count) break;
+        if (child + 1 < heap->count && heap->items[child + 1].distance < heap->items[child].distance) child++;
+        if (heap->items[child].distance >= last.distance) break;
+        heap->items[i] = heap->items[child];
+        i = child;
+    }
+    if (heap->count > 0) heap->items[i] = last;
+    return top;
+}
+
+MazeFlowField* BuildMazeFlowField(const Maze* maze, const int* goalCells, int goalCount) {
+    MazeFlowField* field = (MazeFlowField*)calloc(1, sizeof(MazeFlowField));
+    if (!field) return NULL;
+    size_t cellCount = (size_t)maze->width * maze->height;
+    field->width = maze->width;
+    field->height = maze->height;
+    field->distances = (float*)malloc(cellCount * sizeof(float));
+    field->directions = (signed char*)malloc(cellCount);
+    if (!field->distances || !field->directions) {
+        TraceLog(LOG_WARNING, "FLOW: Out of memory for a %dx%d flow field", maze->width, maze->height);
+        UnloadMazeFlowField(field);
+        return NULL;
+    }
+    for (size_t i = 0; i < cellCount; i++) field->distances[i] = FLT_MAX;
+    memset(field->directions, -1, cellCount);
+
+    // Every goal starts the search at distance 0, each cell then points at the neighbour it was reached from
+    FlowHeap heap = { 0 };
+    for (int g = 0; g < goalCount; g++) {
+        int cell = goalCells[g];
+        if (cell < 0 || (size_t)cell >= cellCount) continue;
+        if (MazeIsWall(maze, cell % maze->width, cell / maze->width) || field->distances[cell] == 0.0f) continue;
+        field->distances[cell] = 0.0f;
+        field->goalCount++;
+        PushFlowHeap(&heap, 0.0f, cell);
+    }
+
+    while (heap.count > 0) {
+        FlowHeapItem item = PopFlowHeap(&heap);
+        if (item.distance > field->distances[item.cell]) continue;
+        int x = item.cell % maze->width, z = item.cell / maze->width;
+        for (int d = 0; d < 8; d++) {
+            int nx = x + flowOffsets[d][0], nz = z + flowOffsets[d][1];
+            if (nx < 0 || nz < 0 || nx >= maze->width || nz >= maze->height || MazeIsWall(maze, nx, nz)) continue;
+            bool diagonal = flowOffsets[d][0] != 0 && flowOffsets[d][1] != 0;
+            if (diagonal && (MazeIsWall(maze, nx, z) || MazeIsWall(maze, x, nz))) continue;
+            float distance = item.distance + (diagonal ? CROWD_SQRT2 : 1.0f);
+            int neighbour = nz * maze->width + nx;
+            if (distance >= field->distances[neighbour]) continue;
+            field->distances[neighbour] = distance;
+            field->directions[neighbour] = (signed char)(7 - d);
+            if (!PushFlowHeap(&heap, distance, neighbour)) {
+                TraceLog(LOG_WARNING, "FLOW: Out of memory, flow field left incomplete");
+                heap.count = 0;
+                break;
+            }
+        }
+    }
+    free(heap.items);
+    return field;
+}
+
+void UnloadMazeFlowField(MazeFlowField* field) {
+    if (!field) return;
+    free(field->distances);
+    free(field->directions);
+    free(field);
+}
+
+Vector2 GetMazeFlowDirection(const MazeFlowField* field, int col, int row) {
+    if (col < 0 || row < 0 || col >= field->width || row >= field->height) return (Vector2){ 0.0f, 0.0f };
+    int direction = field->directions[row * field->width + col];
+    if (direction < 0) return (Vector2){ 0.0f, 0.0f };
+    float scale = (flowOffsets[direction][0] != 0 && flowOffsets[direction][1] != 0) ? 1.0f / CROWD_SQRT2 : 1.0f;
+    return (Vector2){ flowOffsets[direction][0] * scale, flowOffsets[direction][1] * scale };
+}
+
+MazeCrowd* CreateMazeCrowd(const Maze* maze, int capacity) {
+    MazeCrowd* crowd = (MazeCrowd*)calloc(1, sizeof(MazeCrowd));
+    if (!crowd) return NULL;
+    crowd->maze = maze;
+    crowd->capacity = capacity > 0 ? capacity : 0;
+    crowd->radius = CROWD_AGENT_RADIUS;
+    crowd->maxSpeed = CROWD_MAX_SPEED;
+
+    // Steering reads whole groups of four, so every array is padded to a multiple of 4
+    int padded = (crowd->capacity + 3) & ~3;
+    int bins = 64;
+    while (bins < crowd->capacity * 2) bins *= 2;
+    crowd->binMask = bins - 1;
+    crowd->positionX = (float*)calloc(padded + 4, sizeof(float));
+    crowd->positionZ = (float*)calloc(padded + 4, sizeof(float));
+    crowd->previousX = (float*)calloc(padded + 4, sizeof(float));
+    crowd->previousZ = (float*)calloc(padded + 4, sizeof(float));
+    crowd->velocityX = (float*)calloc(padded + 4, sizeof(float));
+    crowd->velocityZ = (float*)calloc(padded + 4, sizeof(float));
+    crowd->goals = (unsigned char*)calloc(padded + 4, 1);
+    crowd->arrived = (unsigned char*)calloc(padded + 4, 1);
+    crowd->binStart = (int*)calloc(bins + 1, sizeof(int));
+    crowd->agentBins = (int*)calloc(padded + 4, sizeof(int));
+    crowd->sortedX = (float*)calloc(padded + 4, sizeof(float));
+    crowd->sortedZ = (float*)calloc(padded + 4, sizeof(float));
+    if (!crowd->positionX || !crowd->positionZ || !crowd->previousX || !crowd->previousZ || !crowd->velocityX || !crowd->velocityZ || !crowd->goals ||
+        !crowd->arrived || !crowd->binStart || !crowd->agentBins || !crowd->sortedX || !crowd->sortedZ) {
+        TraceLog(LOG_WARNING, "CROWD: Out of memory for %d agents", capacity);
+        UnloadMazeCrowd(crowd);
+        return NULL;
+    }
+    return crowd;
+}
+
+void UnloadMazeCrowd(MazeCrowd* crowd) {
+    if (!crowd) return;
+    for (int i = 0; i < crowd->fieldCount; i++) UnloadMazeFlowField(crowd->fields[i]);
+    free(crowd->positionX);
+    free(crowd->positionZ);
+    free(crowd->previousX);
+    free(crowd->previousZ);
+    free(crowd->velocityX);
+    free(crowd->velocityZ);
+    free(crowd->goals);
+    free(crowd->arrived);
+    free(crowd->binStart);
+    free(crowd->agentBins);
+    free(crowd->sortedX);
+    free(crowd->sortedZ);
+    free(crowd);
+}
+
+int AddMazeCrowdGoal(MazeCrowd* crowd, const int* goalCells, int goalCount) {
+    if (crowd->fieldCount >= CROWD_MAX_GOALS) return -1;
+    MazeFlowField* field = BuildMazeFlowField(crowd->maze, goalCells, goalCount);
+    if (!field) return -1;
+    crowd->fields[crowd->fieldCount] = field;
+    return crowd->fieldCount++;
+}
+
+int AddMazeCrowdAgent(MazeCrowd* crowd, Vector2 position, int goal) {
+    if (crowd->count >= crowd->capacity || goal < 0 || goal >= crowd->fieldCount) return -1;
+    int i = crowd->count++;
+    crowd->positionX[i] = position.x;
+    crowd->positionZ[i] = position.y;
+    crowd->previousX[i] = position.x;
+    crowd->previousZ[i] = position.y;
+    crowd->velocityX[i] = 0.0f;
+    crowd->velocityZ[i] = 0.0f;
+    crowd->goals[i] = (unsigned char)goal;
+    crowd->arrived[i] = 0;
+    return i;
+}
+
+// Hash slot of the bin at bin coordinates (bx, bz), bins are CROWD_SEPARATION_RANGE wide
+static inline int GetCrowdBin(const MazeCrowd* crowd, int bx, int bz) {
+    unsigned int hash = ((unsigned int)bx * 73856093u) ^ ((unsigned int)bz * 19349663u);
+    return (int)(hash & (unsigned int)crowd->binMask);
+}
+
+// Counting sort of the agent positions into their bins
+static void BinMazeCrowd(MazeCrowd* crowd) {
+    int bins = crowd->binMask + 1;
+    memset(crowd->binStart, 0, (bins + 1) * sizeof(int));
+    for (int i = 0; i < crowd->count; i++) {
+        int bx = (int)floorf(crowd->positionX[i] / CROWD_SEPARATION_RANGE);
+        int bz = (int)floorf(crowd->positionZ[i] / CROWD_SEPARATION_RANGE);
+        int bin = GetCrowdBin(crowd, bx, bz);
+        crowd->agentBins[i] = bin;
+        crowd->binStart[bin]++;
+    }
+
+    // Running totals give the end of each bin, filling backwards leaves binStart at the start of each bin
+    for (int b = 1; b <= bins; b++) crowd->binStart[b] += crowd->binStart[b - 1];
+    for (int i = crowd->count - 1; i >= 0; i--) {
+        int slot = --crowd->binStart[crowd->agentBins[i]];
+        crowd->sortedX[slot] = crowd->positionX[i];
+        crowd->sortedZ[slot] = crowd->positionZ[i];
+    }
+}
+
+// Sum of the pushes of every agent within CROWD_SEPARATION_RANGE of (px, pz), four neighbours at a time
+static void GetCrowdSeparation(const MazeCrowd* crowd, float px, float pz, float* pushX, float* pushZ) {
+    static const float laneOffsets[4] = { 0.0f, 1.0f, 2.0f, 3.0f };
+    const float range = CROWD_SEPARATION_RANGE;
+    float4 lanes = F4Load(laneOffsets);
+    float4 x = F4Set1(px), z = F4Set1(pz);
+    float4 rangeSq = F4Set1(range * range);
+    float4 epsilon = F4Set1(1e-6f);
+    float4 rangeV = F4Set1(range);
+    float4 strength = F4Set1(CROWD_SEPARATION_STRENGTH / range);
+    float4 sumX = F4Set1(0.0f), sumZ = F4Set1(0.0f);
+
+    int bx = (int)floorf(px / range), bz = (int)floorf(pz / range);
+    int visited[9];
+    int visitedCount = 0;
+    for (int dz = -1; dz <= 1; dz++) {
+        for (int dx = -1; dx <= 1; dx++) {
+            // Neighbouring bins may share a hash slot, each slot is read once
+            int bin = GetCrowdBin(crowd, bx + dx, bz + dz);
+            bool seen = false;
+            for (int v = 0; v < visitedCount; v++) seen |= visited[v] == bin;
+            if (seen) continue;
+            visited[visitedCount++] = bin;
+
+            int end = crowd->binStart[bin + 1];
+            float4 endV = F4Set1((float)end);
+            for (int j = crowd->binStart[bin]; j < end; j += 4) {
+                float4 valid = F4CmpLt(F4Add(F4Set1((float)j), lanes), endV);
+                float4 ox = F4Sub(x, F4Load(crowd->sortedX + j));
+                float4 oz = F4Sub(z, F4Load(crowd->sortedZ + j));
+                float4 distanceSq = F4Add(F4Mul(ox, ox), F4Mul(oz, oz));
+
+                // The agent itself is at distance 0 and is left out with the other exact overlaps
+                float4 near = F4And(valid, F4And(F4CmpLt(distanceSq, rangeSq), F4CmpGt(distanceSq, epsilon)));
+                if (!F4AnyTrue(near)) continue;
+                float4 distance = F4Sqrt(F4Max(distanceSq, epsilon));
+                float4 weight = F4Div(F4Mul(strength, F4Sub(rangeV, distance)), distance);
+                sumX = F4Add(sumX, F4Select(near, F4Mul(ox, weight), F4Set1(0.0f)));
+                sumZ = F4Add(sumZ, F4Select(near, F4Mul(oz, weight), F4Set1(0.0f)));
+            }
+        }
+    }
+
+    float sx[4], sz[4];
+    F4Store(sx, sumX);
+    F4Store(sz, sumZ);
+    *pushX = sx[0] + sx[1] + sx[2] + sx[3];
+    *pushZ = sz[0] + sz[1] + sz[2] + sz[3];
+}
+
+// Steer and move groups of four agents: flow targets and separation are gathered per agent, the
+// velocity update runs on all four lanes, then each agent slides against the walls
+static void StepCrowdGroups(void* context, int start, int end) {
+    CrowdStepJob* job = (CrowdStepJob*)context;
+    MazeCrowd* crowd = job->crowd;
+    const Maze* maze = crowd->maze;
+    float dt = job->deltaTime;
+    Vector2 gridOrigin = GetMazeGridOrigin(maze);
+    float4 arriveScale = F4Set1(1.0f / (MAZE_CELL_SIZE * 0.5f));
+    float4 one = F4Set1(1.0f);
+    float4 epsilon = F4Set1(1e-6f);
+    float4 maxSpeed = F4Set1(crowd->maxSpeed);
+    float4 maxSpeedSq = F4Set1(crowd->maxSpeed * crowd->maxSpeed);
+    float4 steer = F4Set1(fminf(CROWD_STEER_RATE * dt, 1.0f));
+    float4 step = F4Set1(dt);
+
+    for (int group = start; group < end; group++) {
+        int base = group * 4;
+        float targetX[4], targetZ[4], pushX[4], pushZ[4];
+        for (int lane = 0; lane < 4; lane++) {
+            int i = base + lane;
+            float px = crowd->positionX[i], pz = crowd->positionZ[i];
+            targetX[lane] = px;
+            targetZ[lane] = pz;
+            pushX[lane] = 0.0f;
+            pushZ[lane] = 0.0f;
+            if (i >= crowd->count) continue;
+
+            // Head for the center of the next cell toward the goal, or of the goal cell itself
+            const MazeFlowField* field = crowd->fields[crowd->goals[i]];
+            int col = (int)floorf((px - gridOrigin.x) / MAZE_CELL_SIZE);
+            int row = (int)floorf((pz - gridOrigin.y) / MAZE_CELL_SIZE);
+            crowd->arrived[i] = 0;
+            if (col >= 0 && row >= 0 && col < field->width && row < field->height) {
+                int cell = row * field->width + col;
+                int direction = field->directions[cell];
+                if (direction >= 0) {
+                    col += flowOffsets[direction][0];
+                    row += flowOffsets[direction][1];
+                }
+                if (direction >= 0 || field->distances[cell] == 0.0f) {
+                    targetX[lane] = gridOrigin.x + (col + 0.5f) * MAZE_CELL_SIZE;
+                    targetZ[lane] = gridOrigin.y + (row + 0.5f) * MAZE_CELL_SIZE;
+                }
+                crowd->arrived[i] = field->distances[cell] == 0.0f;
+            }
+            GetCrowdSeparation(crowd, px, pz, &pushX[lane], &pushZ[lane]);
+        }
+
+        // Desired velocity toward the target at full speed, slowing down within half a cell of it
+        float4 px = F4Load(crowd->positionX + base);
+        float4 pz = F4Load(crowd->positionZ + base);
+        float4 vx = F4Load(crowd->velocityX + base);
+        float4 vz = F4Load(crowd->velocityZ + base);
+        float4 tx = F4Sub(F4Load(targetX), px);
+        float4 tz = F4Sub(F4Load(targetZ), pz);
+        float4 length = F4Sqrt(F4Max(F4Add(F4Mul(tx, tx), F4Mul(tz, tz)), epsilon));
+        float4 speed = F4Mul(maxSpeed, F4Min(F4Mul(length, arriveScale), one));
+        float4 desiredX = F4Mul(tx, F4Div(speed, length));
+        float4 desiredZ = F4Mul(tz, F4Div(speed, length));
+
+        vx = F4Add(vx, F4Add(F4Mul(F4Sub(desiredX, vx), steer), F4Mul(F4Load(pushX), step)));
+        vz = F4Add(vz, F4Add(F4Mul(F4Sub(desiredZ, vz), steer), F4Mul(F4Load(pushZ), step)));
+        float4 speedSq = F4Add(F4Mul(vx, vx), F4Mul(vz, vz));
+        float4 clamp = F4Select(F4CmpGt(speedSq, maxSpeedSq), F4Div(maxSpeed, F4Sqrt(F4Max(speedSq, epsilon))), one);
+        vx = F4Mul(vx, clamp);
+        vz = F4Mul(vz, clamp);
+        F4Store(crowd->velocityX + base, vx);
+        F4Store(crowd->velocityZ + base, vz);
+
+        // Walls take away the part of the velocity they block
+        int laneCount = crowd->count - base < 4 ? crowd->count - base : 4;
+        for (int lane = 0; lane < laneCount; lane++) {
+            int i = base + lane;
+            Vector2 from = { crowd->positionX[i], crowd->positionZ[i] };
+            Vector2 delta = { crowd->velocityX[i] * dt, crowd->velocityZ[i] * dt };
+            Vector2 to = MoveCircleInMaze(maze, from, delta, crowd->radius);
+            crowd->positionX[i] = to.x;
+            crowd->positionZ[i] = to.y;
+            crowd->velocityX[i] = (to.x - from.x) / dt;
+            crowd->velocityZ[i] = (to.y - from.y) / dt;
+        }
+    }
+}
+
+void StepMazeCrowd(MazeCrowd* crowd, float deltaTime) {
+    if (crowd->count == 0 || crowd->fieldCount == 0 || deltaTime <= 0.0f) return;
+    memcpy(crowd->previousX, crowd->positionX, crowd->count * sizeof(float));
+    memcpy(crowd->previousZ, crowd->positionZ, crowd->count * sizeof(float));
+    BinMazeCrowd(crowd);
+
+    CrowdStepJob job = { crowd, deltaTime };
+    int groups = (crowd->count + 3) / 4;
+    if (crowd->count < CROWD_PARALLEL_MIN) {
+        StepCrowdGroups(&job, 0, groups);
+        return;
+    }
+    int grainSize = groups / (GetThreadPoolSize() * 4);
+    ParallelFor(groups, grainSize > 0 ? grainSize : 1, StepCrowdGroups, &job);
+}
+
+Vector2 GetMazeCrowdRenderPosition(const MazeCrowd* crowd, int agent, float alpha) {
+    float x = crowd->previousX[agent] + (crowd->positionX[agent] - crowd->previousX[agent]) * alpha;
+    float z = crowd->previousZ[agent] + (crowd->positionZ[agent] - crowd->previousZ[agent]) * alpha;
+    return (Vector2){ x, z };
+}
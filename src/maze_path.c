@@ -0,0 +1,891 @@
+#include "maze_path.h"
+#include "thread_pool.h"
+#include <float.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define PATH_SQRT2 1.41421356f
+
+// Rectangle of cells a search may enter (inclusive)
+typedef struct {
+    const Maze* maze;
+    int x0, z0, x1, z1;
+} PathBounds;
+
+// Search state of a grid cell, stored in a hash map so large mazes need no per-cell arrays
+typedef struct {
+    int cell;
+    int stamp;                  // Slot belongs to the current search when equal to MazePathSearch.stamp
+    int parent;                 // Cell, -1 for the start
+    float g;
+    bool closed;
+} PathRecord;
+
+typedef struct {
+    float f;
+    float g;
+    int key;
+} PathHeapItem;
+
+typedef struct {
+    PathHeapItem* items;
+    int count;
+    int capacity;
+} PathHeap;
+
+struct MazePathSearch {
+    PathRecord* records;
+    int recordCapacity;         // Power of two
+    int recordCount;
+    int stamp;
+    PathHeap heap;
+
+    // Abstract search over nodeCount + 2 nodes (start and goal are appended)
+    float* nodeG;
+    int* nodeParent;
+    int* nodeStamp;
+    unsigned char* nodeClosed;
+    float* nodeToGoal;          // Cost to the goal from nodes of the goal cluster, FLT_MAX otherwise
+    int nodeStampValue;
+
+    float* localDistances;      // clusterCells^2
+    int* startTargets;
+    float* startCosts;
+    int startEdgeCount;
+    int* abstractPath;
+    MazePath segment;
+};
+
+static inline bool PathCellOpen(const PathBounds* bounds, int x, int z) {
+    if (x < bounds->x0 || z < bounds->z0 || x > bounds->x1 || z > bounds->z1) return false;
+    const Maze* maze = bounds->maze;
+    return !((maze->walls[(size_t)z * maze->wordsPerRow + (x >> 5)] >> (x & 31)) & 1u);
+}
+
+static inline float OctileDistance(int ax, int az, int bx, int bz) {
+    int dx = abs(ax - bx);
+    int dz = abs(az - bz);
+    return (dx > dz) ? dx + (PATH_SQRT2 - 1.0f) * dz : dz + (PATH_SQRT2 - 1.0f) * dx;
+}
+
+static bool PushPathHeap(PathHeap* heap, float f, float g, int key) {
+    if (heap->count == heap->capacity) {
+        int capacity = heap->capacity ? heap->capacity * 2 : 256;
+        PathHeapItem* items = (PathHeapItem*)realloc(heap->items, capacity * sizeof(PathHeapItem));
+        if (!items) return false;
+        heap->items = items;
+        heap->capacity = capacity;
+    }
+    int i = heap->count++;
+    while (i > 0) {
+        int parent = (i - 1) / 2;
+        if (heap->items[parent].f <= f) break;
+        heap->items[i] = heap->items[parent];
+        i = parent;
+    }
+    heap->items[i] = (PathHeapItem){ f, g, key };
+    return true;
+}
+
+static PathHeapItem PopPathHeap(PathHeap* heap) {
+    PathHeapItem top = heap->items[0];
+    PathHeapItem last = heap->items[--heap->count];
+    int i = 0;
+    for (;;) {
+        int child = i * 2 + 1;
+        if (child >= heap->count) break;
+        if (child + 1 < heap->count && heap->items[child + 1].f < heap->items[child].f) child++;
+        if (heap->items[child].f >= last.f) break;
+        heap->items[i] = heap->items[child];
+        i = child;
+    }
+    if (heap->count > 0) heap->items[i] = last;
+    return top;
+}
+
+static bool AppendPathCell(MazePath* path, int cell) {
+    if (path->count > 0 && path->cells[path->count - 1] == cell) return true;
+    if (path->count == path->capacity) {
+        int capacity = path->capacity ? path->capacity * 2 : 32;
+        int* cells = (int*)realloc(path->cells, capacity * sizeof(int));
+        if (!cells) return false;
+        path->cells = cells;
+        path->capacity = capacity;
+    }
+    path->cells[path->count++] = cell;
+    return true;
+}
+
+static bool CopyPath(MazePath* destination, const MazePath* source) {
+    destination->count = 0;
+    for (int i = 0; i < source->count; i++) {
+        if (!AppendPathCell(destination, source->cells[i])) return false;
+    }
+    destination->cost = source->cost;
+    return true;
+}
+
+// Find or insert the record of a cell in the current search, NULL when out of memory
+static PathRecord* GetPathRecord(MazePathSearch* search, int cell, bool create) {
+    if (create && (search->recordCount + 1) * 2 > search->recordCapacity) {
+        int capacity = search->recordCapacity ? search->recordCapacity * 2 : 1024;
+        PathRecord* records = (PathRecord*)calloc(capacity, sizeof(PathRecord));
+        if (!records) return NULL;
+        for (int i = 0; i < search->recordCapacity; i++) {
+            PathRecord* old = &search->records[i];
+            if (old->stamp != search->stamp) continue;
+            unsigned int slot = ((unsigned int)old->cell * 2654435761u) & (unsigned int)(capacity - 1);
+            while (records[slot].stamp == search->stamp) slot = (slot + 1) & (unsigned int)(capacity - 1);
+            records[slot] = *old;
+        }
+        free(search->records);
+        search->records = records;
+        search->recordCapacity = capacity;
+    }
+    if (search->recordCapacity == 0) return NULL;
+
+    unsigned int mask = (unsigned int)(search->recordCapacity - 1);
+    unsigned int slot = ((unsigned int)cell * 2654435761u) & mask;
+    while (search->records[slot].stamp == search->stamp) {
+        if (search->records[slot].cell == cell) return &search->records[slot];
+        slot = (slot + 1) & mask;
+    }
+    if (!create) return NULL;
+    PathRecord* record = &search->records[slot];
+    record->cell = cell;
+    record->stamp = search->stamp;
+    record->parent = -1;
+    record->g = FLT_MAX;
+    record->closed = false;
+    search->recordCount++;
+    return record;
+}
+
+// Start a fresh grid search, old records become stale without clearing
+static void BeginPathSearch(MazePathSearch* search) {
+    search->stamp++;
+    if (search->stamp == 0) {
+        memset(search->records, 0, search->recordCapacity * sizeof(PathRecord));
+        search->stamp = 1;
+    }
+    search->recordCount = 0;
+    search->heap.count = 0;
+}
+
+// Walk from (x, z) along (dx, dz) until a jump point: the goal, a cell with a forced neighbour, or
+// (moving diagonally) a cell from which a straight jump finds one. Returns the cell, or -1 at a wall.
+static int JumpPath(const PathBounds* bounds, int x, int z, int dx, int dz, int goalX, int goalZ) {
+    int width = bounds->maze->width;
+    for (;;) {
+        if (!PathCellOpen(bounds, x, z)) return -1;
+        if (x == goalX && z == goalZ) return z * width + x;
+
+        if (dx != 0 && dz != 0) {
+            if (JumpPath(bounds, x + dx, z, dx, 0, goalX, goalZ) >= 0 ||
+                JumpPath(bounds, x, z + dz, 0, dz, goalX, goalZ) >= 0) {
+                return z * width + x;
+            }
+            if (!PathCellOpen(bounds, x + dx, z) || !PathCellOpen(bounds, x, z + dz)) return -1;
+        } else if (dx != 0) {
+            if ((PathCellOpen(bounds, x, z - 1) && !PathCellOpen(bounds, x - dx, z - 1)) ||
+                (PathCellOpen(bounds, x, z + 1) && !PathCellOpen(bounds, x - dx, z + 1))) {
+                return z * width + x;
+            }
+        } else {
+            if ((PathCellOpen(bounds, x - 1, z) && !PathCellOpen(bounds, x - 1, z - dz)) ||
+                (PathCellOpen(bounds, x + 1, z) && !PathCellOpen(bounds, x + 1, z - dz))) {
+                return z * width + x;
+            }
+        }
+        x += dx;
+        z += dz;
+    }
+}
+
+// Directions worth searching from a cell reached along (dx, dz), all open ones for the start
+static int GetPrunedDirections(const PathBounds* bounds, int x, int z, int dx, int dz, int directions[8][2]) {
+    int count = 0;
+    if (dx == 0 && dz == 0) {
+        for (int nz = -1; nz <= 1; nz++) {
+            for (int nx = -1; nx <= 1; nx++) {
+                if (nx == 0 && nz == 0) continue;
+                if (!PathCellOpen(bounds, x + nx, z + nz)) continue;
+                if (nx != 0 && nz != 0 && (!PathCellOpen(bounds, x + nx, z) || !PathCellOpen(bounds, x, z + nz))) continue;
+                directions[count][0] = nx;
+                directions[count][1] = nz;
+                count++;
+            }
+        }
+        return count;
+    }
+
+    if (dx != 0 && dz != 0) {
+        bool openZ = PathCellOpen(bounds, x, z + dz);
+        bool openX = PathCellOpen(bounds, x + dx, z);
+        if (openZ) { directions[count][0] = 0; directions[count][1] = dz; count++; }
+        if (openX) { directions[count][0] = dx; directions[count][1] = 0; count++; }
+        if (openZ && openX) { directions[count][0] = dx; directions[count][1] = dz; count++; }
+    } else if (dx != 0) {
+        bool next = PathCellOpen(bounds, x + dx, z);
+        bool up = PathCellOpen(bounds, x, z + 1);
+        bool down = PathCellOpen(bounds, x, z - 1);
+        if (next) {
+            directions[count][0] = dx; directions[count][1] = 0; count++;
+            if (up) { directions[count][0] = dx; directions[count][1] = 1; count++; }
+            if (down) { directions[count][0] = dx; directions[count][1] = -1; count++; }
+        }
+        if (up) { directions[count][0] = 0; directions[count][1] = 1; count++; }
+        if (down) { directions[count][0] = 0; directions[count][1] = -1; count++; }
+    } else {
+        bool next = PathCellOpen(bounds, x, z + dz);
+        bool right = PathCellOpen(bounds, x + 1, z);
+        bool left = PathCellOpen(bounds, x - 1, z);
+        if (next) {
+            directions[count][0] = 0; directions[count][1] = dz; count++;
+            if (right) { directions[count][0] = 1; directions[count][1] = dz; count++; }
+            if (left) { directions[count][0] = -1; directions[count][1] = dz; count++; }
+        }
+        if (right) { directions[count][0] = 1; directions[count][1] = 0; count++; }
+        if (left) { directions[count][0] = -1; directions[count][1] = 0; count++; }
+    }
+    return count;
+}
+
+// Jump Point Search inside bounds, waypoints are appended to path (which is cleared first)
+static bool SearchJps(MazePathSearch* search, const PathBounds* bounds, int start, int goal, MazePath* path) {
+    int width = bounds->maze->width;
+    int goalX = goal % width, goalZ = goal / width;
+    path->count = 0;
+    path->cost = 0.0f;
+    if (start == goal) return AppendPathCell(path, start);
+
+    BeginPathSearch(search);
+    PathRecord* startRecord = GetPathRecord(search, start, true);
+    if (!startRecord) return false;
+    startRecord->g = 0.0f;
+    PushPathHeap(&search->heap, OctileDistance(start % width, start / width, goalX, goalZ), 0.0f, start);
+
+    bool found = false;
+    while (search->heap.count > 0) {
+        PathHeapItem item = PopPathHeap(&search->heap);
+        PathRecord* record = GetPathRecord(search, item.key, false);
+        if (!record || record->closed || item.g > record->g) continue;
+        record->closed = true;
+        if (item.key == goal) {
+            found = true;
+            break;
+        }
+
+        int x = item.key % width, z = item.key / width;
+        int dx = 0, dz = 0;
+        if (record->parent >= 0) {
+            int px = record->parent % width, pz = record->parent / width;
+            dx = (x > px) - (x < px);
+            dz = (z > pz) - (z < pz);
+        }
+        float g = record->g;
+        int directions[8][2];
+        int directionCount = GetPrunedDirections(bounds, x, z, dx, dz, directions);
+        for (int d = 0; d < directionCount; d++) {
+            int jump = JumpPath(bounds, x + directions[d][0], z + directions[d][1], directions[d][0], directions[d][1], goalX, goalZ);
+            if (jump < 0) continue;
+            int jx = jump % width, jz = jump / width;
+            float jumpG = g + OctileDistance(x, z, jx, jz);
+            PathRecord* next = GetPathRecord(search, jump, true);
+            if (!next) return false;
+            if (next->closed || jumpG >= next->g) continue;
+            next->g = jumpG;
+            next->parent = item.key;
+            PushPathHeap(&search->heap, jumpG + OctileDistance(jx, jz, goalX, goalZ), jumpG, jump);
+        }
+    }
+    if (!found) return false;
+
+    // Walk back from the goal, then reverse into start-to-goal order
+    PathRecord* record = GetPathRecord(search, goal, false);
+    path->cost = record->g;
+    for (int cell = goal; cell >= 0; cell = GetPathRecord(search, cell, false)->parent) {
+        if (!AppendPathCell(path, cell)) return false;
+    }
+    for (int i = 0, j = path->count - 1; i < j; i++, j--) {
+        int swap = path->cells[i];
+        path->cells[i] = path->cells[j];
+        path->cells[j] = swap;
+    }
+    return true;
+}
+
+static PathBounds GetClusterBounds(const MazePathfinder* pathfinder, int cluster) {
+    PathBounds bounds;
+    bounds.maze = pathfinder->maze;
+    bounds.x0 = (cluster % pathfinder->clustersX) * pathfinder->clusterCells;
+    bounds.z0 = (cluster / pathfinder->clustersX) * pathfinder->clusterCells;
+    bounds.x1 = bounds.x0 + pathfinder->clusterCells - 1;
+    bounds.z1 = bounds.z0 + pathfinder->clusterCells - 1;
+    if (bounds.x1 >= pathfinder->maze->width) bounds.x1 = pathfinder->maze->width - 1;
+    if (bounds.z1 >= pathfinder->maze->height) bounds.z1 = pathfinder->maze->height - 1;
+    return bounds;
+}
+
+static int GetCellCluster(const MazePathfinder* pathfinder, int cell) {
+    int width = pathfinder->maze->width;
+    return (cell / width / pathfinder->clusterCells) * pathfinder->clustersX + (cell % width) / pathfinder->clusterCells;
+}
+
+// Dijkstra from a cell to every cell of the bounds, distances indexed by local (z - z0) * w + (x - x0)
+static void GetClusterDistances(const PathBounds* bounds, int source, float* distances, PathHeap* heap) {
+    int width = bounds->maze->width;
+    int w = bounds->x1 - bounds->x0 + 1;
+    int h = bounds->z1 - bounds->z0 + 1;
+    for (int i = 0; i < w * h; i++) distances[i] = FLT_MAX;
+    int sx = source % width - bounds->x0, sz = source / width - bounds->z0;
+    distances[sz * w + sx] = 0.0f;
+    heap->count = 0;
+    PushPathHeap(heap, 0.0f, 0.0f, sz * w + sx);
+
+    while (heap->count > 0) {
+        PathHeapItem item = PopPathHeap(heap);
+        if (item.g > distances[item.key]) continue;
+        int lx = item.key % w, lz = item.key / w;
+        int x = lx + bounds->x0, z = lz + bounds->z0;
+        for (int nz = -1; nz <= 1; nz++) {
+            for (int nx = -1; nx <= 1; nx++) {
+                if (nx == 0 && nz == 0) continue;
+                if (!PathCellOpen(bounds, x + nx, z + nz)) continue;
+                bool diagonal = nx != 0 && nz != 0;
+                if (diagonal && (!PathCellOpen(bounds, x + nx, z) || !PathCellOpen(bounds, x, z + nz))) continue;
+                float g = item.g + (diagonal ? PATH_SQRT2 : 1.0f);
+                int local = (lz + nz) * w + lx + nx;
+                if (g >= distances[local]) continue;
+                distances[local] = g;
+                PushPathHeap(heap, g, g, local);
+            }
+        }
+    }
+}
+
+// Growable list of nodes and inter-cluster edges collected while scanning the borders
+typedef struct {
+    int* cells;
+    int* clusters;
+    int count;
+    int capacity;
+} PathNodeList;
+
+static int AddPathNode(PathNodeList* nodes, int cell, int cluster) {
+    if (nodes->count == nodes->capacity) {
+        int capacity = nodes->capacity ? nodes->capacity * 2 : 1024;
+        int* cells = (int*)realloc(nodes->cells, capacity * sizeof(int));
+        if (!cells) return -1;
+        nodes->cells = cells;
+        int* clusters = (int*)realloc(nodes->clusters, capacity * sizeof(int));
+        if (!clusters) return -1;
+        nodes->clusters = clusters;
+        nodes->capacity = capacity;
+    }
+    nodes->cells[nodes->count] = cell;
+    nodes->clusters[nodes->count] = cluster;
+    return nodes->count++;
+}
+
+// One transition (a node on each side) per narrow opening, two for wide ones. Paired nodes are added
+// back to back, so node i ^ 1 is the other side of node i.
+static bool AddBorderTransitions(PathNodeList* nodes, const MazePathfinder* pathfinder, int cellA, int cellB, int stepCell,
+                                 int length) {
+    int offsets[2] = { length / 2, -1 };
+    if (length >= MAZE_PATH_ENTRANCE_SPLIT) {
+        offsets[0] = 0;
+        offsets[1] = length - 1;
+    }
+    for (int i = 0; i < 2 && offsets[i] >= 0; i++) {
+        int a = cellA + offsets[i] * stepCell;
+        int b = cellB + offsets[i] * stepCell;
+        if (AddPathNode(nodes, a, GetCellCluster(pathfinder, a)) < 0) return false;
+        if (AddPathNode(nodes, b, GetCellCluster(pathfinder, b)) < 0) return false;
+    }
+    return true;
+}
+
+// Scan every border between neighbouring clusters for runs of cells open on both sides
+static bool FindClusterTransitions(const MazePathfinder* pathfinder, PathNodeList* nodes) {
+    const Maze* maze = pathfinder->maze;
+    PathBounds all = { maze, 0, 0, maze->width - 1, maze->height - 1 };
+    int width = maze->width;
+    int c = pathfinder->clusterCells;
+
+    // Vertical borders between columns x and x + 1
+    for (int x = c - 1; x + 1 < maze->width; x += c) {
+        int run = 0;
+        for (int z = 0; z <= maze->height; z++) {
+            bool open = z < maze->height && PathCellOpen(&all, x, z) && PathCellOpen(&all, x + 1, z);
+            bool clusterEdge = z < maze->height && z % c == 0 && run > 0;
+            if ((!open || clusterEdge) && run > 0) {
+                int first = z - run;
+                if (!AddBorderTransitions(nodes, pathfinder, first * width + x, first * width + x + 1, width, run)) return false;
+                run = 0;
+            }
+            if (open) run++;
+        }
+    }
+
+    // Horizontal borders between rows z and z + 1
+    for (int z = c - 1; z + 1 < maze->height; z += c) {
+        int run = 0;
+        for (int x = 0; x <= maze->width; x++) {
+            bool open = x < maze->width && PathCellOpen(&all, x, z) && PathCellOpen(&all, x, z + 1);
+            bool clusterEdge = x < maze->width && x % c == 0 && run > 0;
+            if ((!open || clusterEdge) && run > 0) {
+                int first = x - run;
+                if (!AddBorderTransitions(nodes, pathfinder, z * width + first, (z + 1) * width + first, 1, run)) return false;
+                run = 0;
+            }
+            if (open) run++;
+        }
+    }
+    return true;
+}
+
+typedef struct {
+    MazePathfinder* pathfinder;
+    int* intraFirst;            // Per cluster offset into intraTargets / intraCosts
+    int* intraTargets;          // -1 where a node can't reach another
+    float* intraCosts;
+} PathBuildJob;
+
+// Shortest in-cluster path between every pair of nodes of each cluster
+static void ConnectClusterNodes(void* context, int start, int end) {
+    PathBuildJob* job = (PathBuildJob*)context;
+    MazePathfinder* pathfinder = job->pathfinder;
+    int c = pathfinder->clusterCells;
+    float* distances = (float*)malloc((size_t)c * c * sizeof(float));
+    PathHeap heap = { 0 };
+    if (!distances) return;
+
+    for (int cluster = start; cluster < end; cluster++) {
+        int first = pathfinder->clusterFirstNode[cluster];
+        int count = pathfinder->clusterFirstNode[cluster + 1] - first;
+        if (count < 2) continue;
+        PathBounds bounds = GetClusterBounds(pathfinder, cluster);
+        int w = bounds.x1 - bounds.x0 + 1;
+        int width = pathfinder->maze->width;
+        int out = job->intraFirst[cluster];
+        for (int i = 0; i < count; i++) {
+            int node = pathfinder->clusterNodes[first + i];
+            GetClusterDistances(&bounds, pathfinder->nodeCells[node], distances, &heap);
+            for (int j = 0; j < count; j++) {
+                if (j == i) continue;
+                int other = pathfinder->clusterNodes[first + j];
+                int cell = pathfinder->nodeCells[other];
+                float distance = distances[(cell / width - bounds.z0) * w + cell % width - bounds.x0];
+                job->intraTargets[out] = (distance < FLT_MAX) ? other : -1;
+                job->intraCosts[out] = distance;
+                out++;
+            }
+        }
+    }
+    free(heap.items);
+    free(distances);
+}
+
+MazePathfinder* CreateMazePathfinder(const Maze* maze, int clusterCells) {
+    if (maze->width <= 0 || maze->height <= 0) return NULL;
+    if (clusterCells <= 0) clusterCells = MAZE_PATH_CLUSTER_CELLS;
+
+    MazePathfinder* pathfinder = (MazePathfinder*)calloc(1, sizeof(MazePathfinder));
+    if (!pathfinder) return NULL;
+    pathfinder->maze = maze;
+    pathfinder->clusterCells = clusterCells;
+    pathfinder->clustersX = (maze->width + clusterCells - 1) / clusterCells;
+    pathfinder->clustersZ = (maze->height + clusterCells - 1) / clusterCells;
+    int clusterCount = pathfinder->clustersX * pathfinder->clustersZ;
+
+    PathNodeList nodes = { 0 };
+    bool ok = FindClusterTransitions(pathfinder, &nodes);
+    pathfinder->nodeCount = nodes.count;
+    pathfinder->nodeCells = nodes.cells;
+    pathfinder->nodeClusters = nodes.clusters;
+
+    // Bucket the nodes by cluster
+    pathfinder->clusterFirstNode = (int*)calloc(clusterCount + 1, sizeof(int));
+    pathfinder->clusterNodes = (int*)malloc((nodes.count + 1) * sizeof(int));
+    ok = ok && pathfinder->clusterFirstNode && pathfinder->clusterNodes;
+    if (ok) {
+        for (int i = 0; i < nodes.count; i++) pathfinder->clusterFirstNode[nodes.clusters[i] + 1]++;
+        for (int i = 0; i < clusterCount; i++) pathfinder->clusterFirstNode[i + 1] += pathfinder->clusterFirstNode[i];
+        int* fill = (int*)malloc(clusterCount * sizeof(int));
+        ok = fill != NULL;
+        if (ok) {
+            memcpy(fill, pathfinder->clusterFirstNode, clusterCount * sizeof(int));
+            for (int i = 0; i < nodes.count; i++) pathfinder->clusterNodes[fill[nodes.clusters[i]]++] = i;
+            free(fill);
+        }
+    }
+
+    // In-cluster edges between every node pair, on the thread pool
+    PathBuildJob job = { pathfinder, NULL, NULL, NULL };
+    job.intraFirst = (int*)malloc((clusterCount + 1) * sizeof(int));
+    ok = ok && job.intraFirst;
+    if (ok) {
+        long long total = 0;
+        for (int i = 0; i < clusterCount; i++) {
+            int count = pathfinder->clusterFirstNode[i + 1] - pathfinder->clusterFirstNode[i];
+            job.intraFirst[i] = (int)total;
+            total += (long long)count * (count - 1);
+        }
+        job.intraFirst[clusterCount] = (int)total;
+        ok = total < 0x7fffffff;
+        if (ok) {
+            job.intraTargets = (int*)malloc((total + 1) * sizeof(int));
+            job.intraCosts = (float*)malloc((total + 1) * sizeof(float));
+            ok = job.intraTargets && job.intraCosts;
+        }
+    }
+    if (ok) {
+        int grainSize = clusterCount / (GetThreadPoolSize() * 8);
+        ParallelFor(clusterCount, grainSize > 0 ? grainSize : 1, ConnectClusterNodes, &job);
+    }
+
+    // Adjacency in CSR form: the paired node across the border, then the reachable nodes of the cluster
+    pathfinder->edgeFirst = (int*)calloc(nodes.count + 1, sizeof(int));
+    ok = ok && pathfinder->edgeFirst;
+    if (ok) {
+        for (int cluster = 0; cluster < clusterCount; cluster++) {
+            int first = pathfinder->clusterFirstNode[cluster];
+            int count = pathfinder->clusterFirstNode[cluster + 1] - first;
+            int out = job.intraFirst[cluster];
+            for (int i = 0; i < count; i++) {
+                int node = pathfinder->clusterNodes[first + i];
+                pathfinder->edgeFirst[node + 1] = 1;
+                for (int j = 0; j < count - 1; j++) {
+                    if (job.intraTargets[out++] >= 0) pathfinder->edgeFirst[node + 1]++;
+                }
+            }
+        }
+        for (int i = 0; i < nodes.count; i++) pathfinder->edgeFirst[i + 1] += pathfinder->edgeFirst[i];
+        pathfinder->edgeCount = pathfinder->edgeFirst[nodes.count];
+        pathfinder->edgeTargets = (int*)malloc((pathfinder->edgeCount + 1) * sizeof(int));
+        pathfinder->edgeCosts = (float*)malloc((pathfinder->edgeCount + 1) * sizeof(float));
+        ok = pathfinder->edgeTargets && pathfinder->edgeCosts;
+    }
+    if (ok) {
+        for (int cluster = 0; cluster < clusterCount; cluster++) {
+            int first = pathfinder->clusterFirstNode[cluster];
+            int count = pathfinder->clusterFirstNode[cluster + 1] - first;
+            int out = job.intraFirst[cluster];
+            for (int i = 0; i < count; i++) {
+                int node = pathfinder->clusterNodes[first + i];
+                int edge = pathfinder->edgeFirst[node];
+                pathfinder->edgeTargets[edge] = node ^ 1;
+                pathfinder->edgeCosts[edge] = 1.0f;
+                edge++;
+                for (int j = 0; j < count - 1; j++, out++) {
+                    if (job.intraTargets[out] < 0) continue;
+                    pathfinder->edgeTargets[edge] = job.intraTargets[out];
+                    pathfinder->edgeCosts[edge] = job.intraCosts[out];
+                    edge++;
+                }
+            }
+        }
+    }
+    free(job.intraFirst);
+    free(job.intraTargets);
+    free(job.intraCosts);
+
+    // Query scratch and cache
+    MazePathSearch* search = (MazePathSearch*)calloc(1, sizeof(MazePathSearch));
+    pathfinder->search = search;
+    pathfinder->cache = (MazePathCacheEntry*)calloc(MAZE_PATH_CACHE_SLOTS, sizeof(MazePathCacheEntry));
+    ok = ok && search && pathfinder->cache;
+    if (ok) {
+        int slots = nodes.count + 2;
+        search->nodeG = (float*)malloc(slots * sizeof(float));
+        search->nodeParent = (int*)malloc(slots * sizeof(int));
+        search->nodeStamp = (int*)calloc(slots, sizeof(int));
+        search->nodeClosed = (unsigned char*)malloc(slots);
+        search->nodeToGoal = (float*)malloc(slots * sizeof(float));
+        search->abstractPath = (int*)malloc(slots * sizeof(int));
+        search->localDistances = (float*)malloc((size_t)clusterCells * clusterCells * sizeof(float));
+        search->startTargets = (int*)malloc(2 * slots * sizeof(int));   // Start and goal edges
+        search->startCosts = (float*)malloc(2 * slots * sizeof(float));
+        ok = search->nodeG && search->nodeParent && search->nodeStamp && search->nodeClosed && search->nodeToGoal &&
+             search->abstractPath && search->localDistances && search->startTargets && search->startCosts;
+        if (ok) {
+            for (int i = 0; i < slots; i++) search->nodeToGoal[i] = FLT_MAX;
+            for (int i = 0; i < MAZE_PATH_CACHE_SLOTS; i++) pathfinder->cache[i].start = -1;
+        }
+    }
+    if (!ok) {
+        TraceLog(LOG_ERROR, "PATH: Out of memory building the abstraction of a %dx%d maze", maze->width, maze->height);
+        UnloadMazePathfinder(pathfinder);
+        return NULL;
+    }
+
+    TraceLog(LOG_INFO, "PATH: %dx%d maze, %d clusters, %d nodes, %d edges", maze->width, maze->height, clusterCount,
+             pathfinder->nodeCount, pathfinder->edgeCount);
+    return pathfinder;
+}
+
+void UnloadMazePathfinder(MazePathfinder* pathfinder) {
+    if (!pathfinder) return;
+    MazePathSearch* search = pathfinder->search;
+    if (search) {
+        free(search->records);
+        free(search->heap.items);
+        free(search->nodeG);
+        free(search->nodeParent);
+        free(search->nodeStamp);
+        free(search->nodeClosed);
+        free(search->nodeToGoal);
+        free(search->abstractPath);
+        free(search->localDistances);
+        free(search->startTargets);
+        free(search->startCosts);
+        UnloadMazePath(&search->segment);
+        free(search);
+    }
+    if (pathfinder->cache) {
+        for (int i = 0; i < MAZE_PATH_CACHE_SLOTS; i++) UnloadMazePath(&pathfinder->cache[i].path);
+        free(pathfinder->cache);
+    }
+    free(pathfinder->nodeCells);
+    free(pathfinder->nodeClusters);
+    free(pathfinder->clusterFirstNode);
+    free(pathfinder->clusterNodes);
+    free(pathfinder->edgeFirst);
+    free(pathfinder->edgeTargets);
+    free(pathfinder->edgeCosts);
+    free(pathfinder);
+}
+
+// Distances from a cell to the nodes of its cluster, as (node, cost) pairs in targets / costs
+static int ConnectCellToCluster(MazePathfinder* pathfinder, int cell, int* targets, float* costs) {
+    MazePathSearch* search = pathfinder->search;
+    int cluster = GetCellCluster(pathfinder, cell);
+    PathBounds bounds = GetClusterBounds(pathfinder, cluster);
+    GetClusterDistances(&bounds, cell, search->localDistances, &search->heap);
+
+    int width = pathfinder->maze->width;
+    int w = bounds.x1 - bounds.x0 + 1;
+    int count = 0;
+    for (int i = pathfinder->clusterFirstNode[cluster]; i < pathfinder->clusterFirstNode[cluster + 1]; i++) {
+        int node = pathfinder->clusterNodes[i];
+        int nodeCell = pathfinder->nodeCells[node];
+        float distance = search->localDistances[(nodeCell / width - bounds.z0) * w + nodeCell % width - bounds.x0];
+        if (distance == FLT_MAX) continue;
+        targets[count] = node;
+        costs[count] = distance;
+        count++;
+    }
+    return count;
+}
+
+// A* over the abstract graph from the start cell to the goal cell, returns the node count of the route
+// (start and goal included, stored in abstractPath) or 0 when there is none
+static int SearchAbstractGraph(MazePathfinder* pathfinder, int start, int goal) {
+    MazePathSearch* search = pathfinder->search;
+    int width = pathfinder->maze->width;
+    int startNode = pathfinder->nodeCount;
+    int goalNode = pathfinder->nodeCount + 1;
+    int goalX = goal % width, goalZ = goal / width;
+
+    search->startEdgeCount = ConnectCellToCluster(pathfinder, start, search->startTargets, search->startCosts);
+
+    // Costs into the goal from its cluster's nodes, reusing the tail of startTargets as scratch
+    int* goalTargets = search->startTargets + search->startEdgeCount;
+    float* goalCosts = search->startCosts + search->startEdgeCount;
+    int goalEdgeCount = ConnectCellToCluster(pathfinder, goal, goalTargets, goalCosts);
+    for (int i = 0; i < goalEdgeCount; i++) search->nodeToGoal[goalTargets[i]] = goalCosts[i];
+
+    search->nodeStampValue++;
+    if (search->nodeStampValue == 0) {
+        memset(search->nodeStamp, 0, (pathfinder->nodeCount + 2) * sizeof(int));
+        search->nodeStampValue = 1;
+    }
+    int stamp = search->nodeStampValue;
+    PathHeap* heap = &search->heap;
+    heap->count = 0;
+    search->nodeStamp[startNode] = stamp;
+    search->nodeG[startNode] = 0.0f;
+    search->nodeParent[startNode] = -1;
+    search->nodeClosed[startNode] = 0;
+    PushPathHeap(heap, OctileDistance(start % width, start / width, goalX, goalZ), 0.0f, startNode);
+
+    bool found = false;
+    while (heap->count > 0) {
+        PathHeapItem item = PopPathHeap(heap);
+        int node = item.key;
+        if (search->nodeClosed[node] || item.g > search->nodeG[node]) continue;
+        search->nodeClosed[node] = 1;
+        if (node == goalNode) {
+            found = true;
+            break;
+        }
+
+        // Neighbours: the start's cluster nodes, or the node's edges plus the goal from its cluster
+        int edgeCount;
+        const int* targets;
+        const float* costs;
+        if (node == startNode) {
+            edgeCount = search->startEdgeCount;
+            targets = search->startTargets;
+            costs = search->startCosts;
+        } else {
+            edgeCount = pathfinder->edgeFirst[node + 1] - pathfinder->edgeFirst[node];
+            targets = pathfinder->edgeTargets + pathfinder->edgeFirst[node];
+            costs = pathfinder->edgeCosts + pathfinder->edgeFirst[node];
+        }
+        for (int e = 0; e <= edgeCount; e++) {
+            int next;
+            float cost;
+            if (e < edgeCount) {
+                next = targets[e];
+                cost = costs[e];
+            } else {
+                if (node == startNode || search->nodeToGoal[node] == FLT_MAX) continue;
+                next = goalNode;
+                cost = search->nodeToGoal[node];
+            }
+            float g = item.g + cost;
+            if (search->nodeStamp[next] != stamp) {
+                search->nodeStamp[next] = stamp;
+                search->nodeG[next] = FLT_MAX;
+                search->nodeClosed[next] = 0;
+            }
+            if (search->nodeClosed[next] || g >= search->nodeG[next]) continue;
+            search->nodeG[next] = g;
+            search->nodeParent[next] = node;
+            int cell = (next == goalNode) ? goal : pathfinder->nodeCells[next];
+            PushPathHeap(heap, g + OctileDistance(cell % width, cell / width, goalX, goalZ), g, next);
+        }
+    }
+    for (int i = 0; i < goalEdgeCount; i++) search->nodeToGoal[goalTargets[i]] = FLT_MAX;
+    if (!found) return 0;
+
+    int count = 0;
+    for (int node = goalNode; node >= 0; node = search->nodeParent[node]) search->abstractPath[count++] = node;
+    for (int i = 0, j = count - 1; i < j; i++, j--) {
+        int swap = search->abstractPath[i];
+        search->abstractPath[i] = search->abstractPath[j];
+        search->abstractPath[j] = swap;
+    }
+    return count;
+}
+
+// Turn an abstract route into cell waypoints: border crossings are single steps, moves inside a
+// cluster are searched with JPS limited to the cluster
+static bool RefineAbstractPath(MazePathfinder* pathfinder, int start, int goal, int nodeCount, MazePath* path) {
+    MazePathSearch* search = pathfinder->search;
+    path->count = 0;
+    path->cost = 0.0f;
+    if (!AppendPathCell(path, start)) return false;
+
+    int previous = start;
+    for (int i = 1; i < nodeCount; i++) {
+        int node = search->abstractPath[i];
+        int cell = (node == pathfinder->nodeCount + 1) ? goal : pathfinder->nodeCells[node];
+        int cluster = GetCellCluster(pathfinder, previous);
+        if (cluster != GetCellCluster(pathfinder, cell)) {
+            path->cost += 1.0f;
+            if (!AppendPathCell(path, cell)) return false;
+        } else if (cell != previous) {
+            PathBounds bounds = GetClusterBounds(pathfinder, cluster);
+            if (!SearchJps(search, &bounds, previous, cell, &search->segment)) return false;
+            path->cost += search->segment.cost;
+            for (int j = 1; j < search->segment.count; j++) {
+                if (!AppendPathCell(path, search->segment.cells[j])) return false;
+            }
+        }
+        previous = cell;
+    }
+    return true;
+}
+
+static bool IsPathCellOpen(const MazePathfinder* pathfinder, int col, int row) {
+    const Maze* maze = pathfinder->maze;
+    PathBounds all = { maze, 0, 0, maze->width - 1, maze->height - 1 };
+    return PathCellOpen(&all, col, row);
+}
+
+// 64-bit finalizer mix of a start/goal pair, neighbouring cells land in unrelated cache sets
+static unsigned long long HashPathKey(int start, int goal) {
+    unsigned long long key = ((unsigned long long)(unsigned int)start << 32) | (unsigned int)goal;
+    key ^= key >> 33;
+    key *= 0xff51afd7ed558ccdULL;
+    key ^= key >> 33;
+    key *= 0xc4ceb9fe1a85ec53ULL;
+    key ^= key >> 33;
+    return key;
+}
+
+bool FindMazePath(MazePathfinder* pathfinder, int startCol, int startRow, int goalCol, int goalRow, MazePath* path) {
+    path->count = 0;
+    path->cost = 0.0f;
+    if (!IsPathCellOpen(pathfinder, startCol, startRow) || !IsPathCellOpen(pathfinder, goalCol, goalRow)) return false;
+    int width = pathfinder->maze->width;
+    int start = startRow * width + startCol;
+    int goal = goalRow * width + goalCol;
+
+    // Set-associative lookup, a miss takes over the least recently used slot of the set
+    int setCount = MAZE_PATH_CACHE_SLOTS / MAZE_PATH_CACHE_WAYS;
+    unsigned long long hash = HashPathKey(start, goal);
+    MazePathCacheEntry* set = &pathfinder->cache[(hash & (unsigned long long)(setCount - 1)) * MAZE_PATH_CACHE_WAYS];
+    MazePathCacheEntry* entry = &set[0];
+    pathfinder->queryCount++;
+    for (int way = 0; way < MAZE_PATH_CACHE_WAYS; way++) {
+        if (set[way].start == start && set[way].goal == goal) {
+            set[way].lastUse = pathfinder->queryCount;
+            pathfinder->cacheHits++;
+            return CopyPath(path, &set[way].path);
+        }
+        if (set[way].lastUse < entry->lastUse) entry = &set[way];
+    }
+    pathfinder->cacheMisses++;
+
+    bool found = false;
+    int startCluster = GetCellCluster(pathfinder, start);
+    if (startCluster == GetCellCluster(pathfinder, goal)) {
+        PathBounds bounds = GetClusterBounds(pathfinder, startCluster);
+        found = SearchJps(pathfinder->search, &bounds, start, goal, path);
+    }
+    if (!found) {
+        int nodeCount = SearchAbstractGraph(pathfinder, start, goal);
+        found = nodeCount > 0 && RefineAbstractPath(pathfinder, start, goal, nodeCount, path);
+    }
+    if (!found) {
+        path->count = 0;
+        return false;
+    }
+
+    if (CopyPath(&entry->path, path)) {
+        entry->start = start;
+        entry->goal = goal;
+        entry->lastUse = pathfinder->queryCount;
+    } else {
+        entry->start = -1;
+    }
+    return true;
+}
+
+bool FindMazePathJps(MazePathfinder* pathfinder, int startCol, int startRow, int goalCol, int goalRow, MazePath* path) {
+    path->count = 0;
+    path->cost = 0.0f;
+    if (!IsPathCellOpen(pathfinder, startCol, startRow) || !IsPathCellOpen(pathfinder, goalCol, goalRow)) return false;
+    const Maze* maze = pathfinder->maze;
+    PathBounds all = { maze, 0, 0, maze->width - 1, maze->height - 1 };
+    return SearchJps(pathfinder->search, &all, startRow * maze->width + startCol, goalRow * maze->width + goalCol, path);
+}
+
+void ClearMazePathCache(MazePathfinder* pathfinder) {
+    for (int i = 0; i < MAZE_PATH_CACHE_SLOTS; i++) {
+        pathfinder->cache[i].start = -1;
+        pathfinder->cache[i].lastUse = 0;
+    }
+}
+
+void UnloadMazePath(MazePath* path) {
+    free(path->cells);
+    path->cells = NULL;
+    path->count = path->capacity = 0;
+    path->cost = 0.0f;
+}
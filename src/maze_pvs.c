@@ -0,0 +1,467 @@
+#include "maze_pvs.h"
+#include "maze.h"
+#include "thread_pool.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define PVS_POLYGON_VERTICES 32         // Vertices of a line set, larger ones are replaced by their bounding box
+#define PVS_EPSILON 1e-9                // Relative slack of the clip tests, keeps lines that only graze a portal
+
+// Words appended by the cells of one row
+typedef struct {
+    unsigned int* words;
+    int count;
+    int capacity;
+} PvsRowWords;
+
+typedef struct {
+    const unsigned char* walls;
+    int width, height;
+    int chunkCells, chunksX, chunksZ;
+    MazePvsSet* cellResults;    // Per cell, firstWord indexes the row's words
+    PvsRowWords* rows;
+    bool failed;                // Out of memory on some row, set atomically
+} PvsBakeJob;
+
+// Line z = m * x + q of the octant being swept, as a point in (m, q)
+typedef struct {
+    double m, q;
+} PvsLine;
+
+// Convex set of lines that pass through the source cell and every portal up to some cell
+typedef struct {
+    PvsLine vertices[PVS_POLYGON_VERTICES];
+    int count;                  // 0 when no line gets through
+} PvsLineSet;
+
+// Line set reaching one cell of the wavefront
+typedef struct {
+    int u;
+    PvsLineSet lines;
+} PvsFrontCell;
+
+// Chunks marked for the cell being baked, and the wavefronts of the sweep
+typedef struct {
+    int* stamp;                 // Per chunk, equal to the current cell stamp when marked
+    int* marked;                // Marked chunk indices
+    int markedCount;
+    int stampValue;
+    int minX, minZ, maxX, maxZ;
+    PvsFrontCell* front;
+    PvsFrontCell* nextFront;
+} PvsScratch;
+
+static void MarkPvsChunk(const PvsBakeJob* job, PvsScratch* scratch, int x, int z) {
+    int chunk = z * job->chunksX + x;
+    if (scratch->stamp[chunk] == scratch->stampValue) return;
+    scratch->stamp[chunk] = scratch->stampValue;
+    scratch->marked[scratch->markedCount++] = chunk;
+    if (x < scratch->minX) scratch->minX = x;
+    if (x > scratch->maxX) scratch->maxX = x;
+    if (z < scratch->minZ) scratch->minZ = z;
+    if (z > scratch->maxZ) scratch->maxZ = z;
+}
+
+// Maze cell of (u, v) in the coordinates of an octant: bit 0 mirrors x, bit 1 mirrors z, bit 2 swaps them
+static size_t GetPvsOctantCell(const PvsBakeJob* job, int octant, int u, int v) {
+    int x = (octant & 4) ? v : u;
+    int z = (octant & 4) ? u : v;
+    if (octant & 1) x = job->width - 1 - x;
+    if (octant & 2) z = job->height - 1 - z;
+    return (size_t)z * job->width + x;
+}
+
+// Replace a line set by its bounding box in (m, q), a superset that keeps the sweep conservative
+static void BoundPvsLineSet(PvsLineSet* set, const PvsLine* points, int count) {
+    PvsLine low = points[0], high = points[0];
+    for (int i = 1; i < count; i++) {
+        low.m = fmin(low.m, points[i].m);
+        low.q = fmin(low.q, points[i].q);
+        high.m = fmax(high.m, points[i].m);
+        high.q = fmax(high.q, points[i].q);
+    }
+    set->vertices[0] = low;
+    set->vertices[1] = (PvsLine){ high.m, low.q };
+    set->vertices[2] = high;
+    set->vertices[3] = (PvsLine){ low.m, high.q };
+    set->count = 4;
+}
+
+// Keep the lines with a * m + b * q + c >= 0 (Sutherland-Hodgman on the convex polygon)
+static void ClipPvsLineSet(const PvsLineSet* in, PvsLineSet* out, double a, double b, double c) {
+    PvsLineSet bounded;
+    if (in->count >= PVS_POLYGON_VERTICES) {
+        BoundPvsLineSet(&bounded, in->vertices, in->count);
+        in = &bounded;
+    }
+
+    double slack = PVS_EPSILON * (fabs(a) + fabs(b) + fabs(c) + 1.0);
+    out->count = 0;
+    for (int i = 0; i < in->count; i++) {
+        PvsLine p = in->vertices[i];
+        PvsLine n = in->vertices[(i + 1) % in->count];
+        double dp = a * p.m + b * p.q + c;
+        double dn = a * n.m + b * n.q + c;
+        bool insideP = dp >= -slack;
+        bool insideN = dn >= -slack;
+        if (insideP) out->vertices[out->count++] = p;
+        if (insideP != insideN) {
+            double t = dp / (dp - dn);
+            out->vertices[out->count++] = (PvsLine){ p.m + t * (n.m - p.m), p.q + t * (n.q - p.q) };
+        }
+    }
+}
+
+static int ComparePvsLines(const void* a, const void* b) {
+    const PvsLine* la = (const PvsLine*)a;
+    const PvsLine* lb = (const PvsLine*)b;
+    if (la->m != lb->m) return (la->m < lb->m) ? -1 : 1;
+    if (la->q != lb->q) return (la->q < lb->q) ? -1 : 1;
+    return 0;
+}
+
+static double CrossPvsLines(PvsLine o, PvsLine a, PvsLine b) {
+    return (a.m - o.m) * (b.q - o.q) - (a.q - o.q) * (b.m - o.m);
+}
+
+// Convex hull of two line sets into the first, a superset of the lines reaching a cell along either path
+static void MergePvsLineSets(PvsLineSet* into, const PvsLineSet* other) {
+    PvsLine points[2 * PVS_POLYGON_VERTICES];
+    int count = 0;
+    for (int i = 0; i < into->count; i++) points[count++] = into->vertices[i];
+    for (int i = 0; i < other->count; i++) points[count++] = other->vertices[i];
+    if (count == 0) return;
+    qsort(points, count, sizeof(PvsLine), ComparePvsLines);
+
+    // Monotone chain, collinear points dropped
+    PvsLine hull[2 * PVS_POLYGON_VERTICES + 1];
+    int size = 0;
+    for (int i = 0; i < count; i++) {
+        while (size >= 2 && CrossPvsLines(hull[size - 2], hull[size - 1], points[i]) <= 0.0) size--;
+        hull[size++] = points[i];
+    }
+    for (int i = count - 2, lower = size + 1; i >= 0; i--) {
+        while (size >= lower && CrossPvsLines(hull[size - 2], hull[size - 1], points[i]) <= 0.0) size--;
+        hull[size++] = points[i];
+    }
+    if (size > 1) size--;
+
+    if (size > PVS_POLYGON_VERTICES) {
+        BoundPvsLineSet(into, hull, size);
+        return;
+    }
+    memcpy(into->vertices, hull, size * sizeof(PvsLine));
+    into->count = size;
+}
+
+// Add a line set to the next wavefront, which is filled in increasing u
+static void PushPvsFrontCell(PvsFrontCell* front, int* count, int u, const PvsLineSet* lines) {
+    if (*count > 0 && front[*count - 1].u == u) {
+        MergePvsLineSets(&front[*count - 1].lines, lines);
+        return;
+    }
+    front[*count].u = u;
+    front[*count].lines = *lines;
+    (*count)++;
+}
+
+// Mark the walls seen from the source cell in one octant of directions. In octant coordinates lines
+// are z = m * x + q with 0 <= m <= 1, and stabbing a cell edge is linear in (m, q), so the lines through
+// the whole source cell and a run of open cells form a convex polygon. The sweep moves it one diagonal
+// of cells at a time across the edges between open cells. A wall is visible when some line reaches one of
+// its edges. Sets meeting in one cell are merged into their hull, which can only add lines.
+static void SweepPvsOctant(const PvsBakeJob* job, PvsScratch* scratch, int octant, int col, int row) {
+    int sizeU = (octant & 4) ? job->height : job->width;
+    int sizeV = (octant & 4) ? job->width : job->height;
+    int x = (octant & 1) ? job->width - 1 - col : col;
+    int z = (octant & 2) ? job->height - 1 - row : row;
+    int su = (octant & 4) ? z : x;
+    int sv = (octant & 4) ? x : z;
+
+    // Lines through the source cell: m * su + q <= sv + 1 and m * (su + 1) + q >= sv
+    PvsLineSet start = { .count = 4 };
+    start.vertices[0] = (PvsLine){ 0.0, sv - su - 1.0 };
+    start.vertices[1] = (PvsLine){ 1.0, sv - su - 1.0 };
+    start.vertices[2] = (PvsLine){ 1.0, sv + 1.0 };
+    start.vertices[3] = (PvsLine){ 0.0, sv + 1.0 };
+    PvsLineSet clipped;
+    ClipPvsLineSet(&start, &clipped, -su, -1.0, sv + 1.0);
+    ClipPvsLineSet(&clipped, &start, su + 1.0, 1.0, -sv);
+
+    PvsFrontCell* front = scratch->front;
+    PvsFrontCell* next = scratch->nextFront;
+    int frontCount = 0;
+    PushPvsFrontCell(front, &frontCount, su, &start);
+
+    for (int diagonal = su + sv; frontCount > 0; diagonal++) {
+        int nextCount = 0;
+        for (int i = 0; i < frontCount; i++) {
+            int u = front[i].u;
+            int v = diagonal - u;
+            const PvsLineSet* lines = &front[i].lines;
+            PvsLineSet crossing, through;
+
+            // Top edge: z = v + 1 crossed with u <= x <= u + 1
+            if (v + 1 < sizeV) {
+                ClipPvsLineSet(lines, &crossing, -u, -1.0, v + 1.0);
+                ClipPvsLineSet(&crossing, &through, u + 1.0, 1.0, -(v + 1.0));
+                if (through.count > 0) {
+                    size_t cell = GetPvsOctantCell(job, octant, u, v + 1);
+                    if (job->walls[cell]) {
+                        MarkPvsChunk(job, scratch, (int)(cell % job->width) / job->chunkCells, (int)(cell / job->width) / job->chunkCells);
+                    } else {
+                        PushPvsFrontCell(next, &nextCount, u, &through);
+                    }
+                }
+            }
+
+            // Right edge: x = u + 1 crossed with v <= z <= v + 1
+            if (u + 1 < sizeU) {
+                ClipPvsLineSet(lines, &crossing, u + 1.0, 1.0, -v);
+                ClipPvsLineSet(&crossing, &through, -(u + 1.0), -1.0, v + 1.0);
+                if (through.count > 0) {
+                    size_t cell = GetPvsOctantCell(job, octant, u + 1, v);
+                    if (job->walls[cell]) {
+                        MarkPvsChunk(job, scratch, (int)(cell % job->width) / job->chunkCells, (int)(cell / job->width) / job->chunkCells);
+                    } else {
+                        PushPvsFrontCell(next, &nextCount, u + 1, &through);
+                    }
+                }
+            }
+        }
+
+        PvsFrontCell* swap = front;
+        front = next;
+        next = swap;
+        frontCount = nextCount;
+    }
+}
+
+static bool AppendPvsWord(PvsRowWords* row, unsigned int word) {
+    if (row->count == row->capacity) {
+        int capacity = row->capacity ? row->capacity * 2 : 256;
+        unsigned int* words = (unsigned int*)realloc(row->words, capacity * sizeof(unsigned int));
+        if (!words) return false;
+        row->words = words;
+        row->capacity = capacity;
+    }
+    row->words[row->count++] = word;
+    return true;
+}
+
+static void BakePvsRows(void* context, int start, int end) {
+    PvsBakeJob* job = (PvsBakeJob*)context;
+    int chunkTotal = job->chunksX * job->chunksZ;
+    int frontSize = job->width + job->height;
+    PvsScratch scratch = { 0 };
+    scratch.stamp = (int*)malloc(chunkTotal * sizeof(int));
+    scratch.marked = (int*)malloc(chunkTotal * sizeof(int));
+    scratch.front = (PvsFrontCell*)malloc(frontSize * sizeof(PvsFrontCell));
+    scratch.nextFront = (PvsFrontCell*)malloc(frontSize * sizeof(PvsFrontCell));
+    bool ok = scratch.stamp && scratch.marked && scratch.front && scratch.nextFront;
+    if (ok) {
+        for (int i = 0; i < chunkTotal; i++) scratch.stamp[i] = -1;
+    }
+
+    for (int row = start; row < end && ok; row++) {
+        PvsRowWords* rowWords = &job->rows[row];
+        for (int col = 0; col < job->width && ok; col++) {
+            size_t cell = (size_t)row * job->width + col;
+            if (job->walls[cell]) continue;
+
+            scratch.stampValue = (int)(cell % 0x7fffffff);
+            scratch.markedCount = 0;
+            scratch.minX = scratch.minZ = 1 << 30;
+            scratch.maxX = scratch.maxZ = -1;
+            MarkPvsChunk(job, &scratch, col / job->chunkCells, row / job->chunkCells);
+            for (int octant = 0; octant < 8; octant++) SweepPvsOctant(job, &scratch, octant, col, row);
+
+            // Bits of the marked chunks inside their bounding rectangle
+            MazePvsSet* set = &job->cellResults[cell];
+            set->x0 = scratch.minX;
+            set->z0 = scratch.minZ;
+            set->width = scratch.maxX - scratch.minX + 1;
+            set->height = scratch.maxZ - scratch.minZ + 1;
+            set->firstWord = rowWords->count;
+            set->chunkCount = scratch.markedCount;
+            int wordCount = (set->width * set->height + 31) / 32;
+            for (int w = 0; w < wordCount && ok; w++) ok = AppendPvsWord(rowWords, 0);
+            if (!ok) break;
+            for (int i = 0; i < scratch.markedCount; i++) {
+                int x = scratch.marked[i] % job->chunksX - set->x0;
+                int z = scratch.marked[i] / job->chunksX - set->z0;
+                int bit = z * set->width + x;
+                rowWords->words[set->firstWord + bit / 32] |= 1u << (bit % 32);
+            }
+        }
+    }
+
+    // Cells left unbaked would index words that were never written, fail the whole bake instead
+    if (!ok) __atomic_store_n(&job->failed, true, __ATOMIC_RELAXED);
+    free(scratch.stamp);
+    free(scratch.marked);
+    free(scratch.front);
+    free(scratch.nextFront);
+}
+
+// FNV-1a over the rectangle and its bits
+static unsigned long long HashPvsSet(const MazePvsSet* set, const unsigned int* words) {
+    unsigned long long hash = 1469598103934665603ULL;
+    int header[4] = { set->x0, set->z0, set->width, set->height };
+    const unsigned char* bytes = (const unsigned char*)header;
+    for (size_t i = 0; i < sizeof(header); i++) hash = (hash ^ bytes[i]) * 1099511628211ULL;
+    int wordCount = (set->width * set->height + 31) / 32;
+    bytes = (const unsigned char*)words;
+    for (size_t i = 0; i < wordCount * sizeof(unsigned int); i++) hash = (hash ^ bytes[i]) * 1099511628211ULL;
+    return hash;
+}
+
+static bool AppendUniquePvsSet(MazePvs* pvs, const MazePvsSet* set, const unsigned int* words, int* setCapacity, int* wordCapacity) {
+    int wordCount = (set->width * set->height + 31) / 32;
+    if (pvs->setCount == *setCapacity) {
+        int capacity = *setCapacity ? *setCapacity * 2 : 1024;
+        MazePvsSet* sets = (MazePvsSet*)realloc(pvs->sets, capacity * sizeof(MazePvsSet));
+        if (!sets) return false;
+        pvs->sets = sets;
+        *setCapacity = capacity;
+    }
+    while (pvs->wordCount + wordCount > *wordCapacity) {
+        int capacity = *wordCapacity ? *wordCapacity * 2 : 4096;
+        unsigned int* grown = (unsigned int*)realloc(pvs->words, capacity * sizeof(unsigned int));
+        if (!grown) return false;
+        pvs->words = grown;
+        *wordCapacity = capacity;
+    }
+    MazePvsSet* stored = &pvs->sets[pvs->setCount++];
+    *stored = *set;
+    stored->firstWord = pvs->wordCount;
+    memcpy(&pvs->words[pvs->wordCount], words, wordCount * sizeof(unsigned int));
+    pvs->wordCount += wordCount;
+    return true;
+}
+
+// Give every open cell the index of a unique set, merging cells whose sets are identical
+static bool DeduplicatePvsSets(MazePvs* pvs, const PvsBakeJob* job) {
+    size_t cellCount = (size_t)pvs->width * pvs->height;
+    size_t tableSize = 1024;
+    while (tableSize < cellCount * 2) tableSize *= 2;
+    int* table = (int*)malloc(tableSize * sizeof(int));
+    if (!table) return false;
+    for (size_t i = 0; i < tableSize; i++) table[i] = -1;
+
+    int setCapacity = 0;
+    int wordCapacity = 0;
+    bool ok = true;
+    for (size_t cell = 0; cell < cellCount && ok; cell++) {
+        if (job->walls[cell]) {
+            pvs->cellSets[cell] = -1;
+            continue;
+        }
+        const MazePvsSet* set = &job->cellResults[cell];
+        const unsigned int* words = &job->rows[cell / pvs->width].words[set->firstWord];
+        int wordCount = (set->width * set->height + 31) / 32;
+
+        size_t slot = (size_t)HashPvsSet(set, words) & (tableSize - 1);
+        while (table[slot] >= 0) {
+            const MazePvsSet* other = &pvs->sets[table[slot]];
+            if (other->x0 == set->x0 && other->z0 == set->z0 && other->width == set->width && other->height == set->height &&
+                memcmp(&pvs->words[other->firstWord], words, wordCount * sizeof(unsigned int)) == 0) break;
+            slot = (slot + 1) & (tableSize - 1);
+        }
+        if (table[slot] < 0) {
+            ok = AppendUniquePvsSet(pvs, set, words, &setCapacity, &wordCapacity);
+            table[slot] = pvs->setCount - 1;
+        }
+        pvs->cellSets[cell] = table[slot];
+    }
+
+    free(table);
+    return ok;
+}
+
+MazePvs* BakeMazeGridPvs(const unsigned char* walls, int width, int height, int chunkCells) {
+    if (!walls || width <= 0 || height <= 0 || chunkCells <= 0) return NULL;
+    double start = GetTime();
+
+    PvsBakeJob job = { 0 };
+    job.walls = walls;
+    job.width = width;
+    job.height = height;
+    job.chunkCells = chunkCells;
+    job.chunksX = (width + chunkCells - 1) / chunkCells;
+    job.chunksZ = (height + chunkCells - 1) / chunkCells;
+
+    size_t cellCount = (size_t)width * height;
+    MazePvs* pvs = (MazePvs*)calloc(1, sizeof(MazePvs));
+    job.cellResults = (MazePvsSet*)malloc(cellCount * sizeof(MazePvsSet));
+    job.rows = (PvsRowWords*)calloc(height, sizeof(PvsRowWords));
+    if (pvs) pvs->cellSets = (int*)malloc(cellCount * sizeof(int));
+    bool ok = pvs && pvs->cellSets && job.cellResults && job.rows;
+
+    if (ok) {
+        pvs->width = width;
+        pvs->height = height;
+        pvs->chunkCells = chunkCells;
+        pvs->chunksX = job.chunksX;
+        pvs->chunksZ = job.chunksZ;
+
+        int grainSize = height / (GetThreadPoolSize() * 8);
+        ParallelFor(height, grainSize > 0 ? grainSize : 1, BakePvsRows, &job);
+        ok = !job.failed && DeduplicatePvsSets(pvs, &job);
+    }
+
+    free(job.cellResults);
+    if (job.rows) {
+        for (int row = 0; row < height; row++) free(job.rows[row].words);
+        free(job.rows);
+    }
+    if (!ok) {
+        TraceLog(LOG_WARNING, "PVS: Out of memory baking a %dx%d maze", width, height);
+        UnloadMazePvs(pvs);
+        return NULL;
+    }
+
+    TraceLog(LOG_INFO, "PVS: Baked %dx%d maze into %d unique sets (%d KB) in %.1f ms",
+             width, height, pvs->setCount, (int)(GetMazePvsMemory(pvs) / 1024), (GetTime() - start) * 1000.0);
+    return pvs;
+}
+
+MazePvs* BakeMazePvs(const Maze* maze, int chunkCells) {
+    unsigned char* walls = (unsigned char*)malloc((size_t)maze->width * maze->height);
+    if (!walls) return NULL;
+    for (int row = 0; row < maze->height; row++) {
+        for (int col = 0; col < maze->width; col++) walls[row * maze->width + col] = MazeIsWall(maze, col, row);
+    }
+    MazePvs* pvs = BakeMazeGridPvs(walls, maze->width, maze->height, chunkCells);
+    free(walls);
+    return pvs;
+}
+
+const MazePvsSet* GetMazePvsSet(const MazePvs* pvs, int col, int row) {
+    if (!pvs || col < 0 || row < 0 || col >= pvs->width || row >= pvs->height) return NULL;
+    int set = pvs->cellSets[(size_t)row * pvs->width + col];
+    return (set >= 0) ? &pvs->sets[set] : NULL;
+}
+
+bool IsMazePvsChunkVisible(const MazePvs* pvs, const MazePvsSet* set, int chunkX, int chunkZ) {
+    int x = chunkX - set->x0;
+    int z = chunkZ - set->z0;
+    if (x < 0 || z < 0 || x >= set->width || z >= set->height) return false;
+    int bit = z * set->width + x;
+    return (pvs->words[set->firstWord + bit / 32] >> (bit % 32)) & 1u;
+}
+
+size_t GetMazePvsMemory(const MazePvs* pvs) {
+    if (!pvs) return 0;
+    return (size_t)pvs->width * pvs->height * sizeof(int) + pvs->setCount * sizeof(MazePvsSet) +
+           pvs->wordCount * sizeof(unsigned int);
+}
+
+void UnloadMazePvs(MazePvs* pvs) {
+    if (!pvs) return;
+    free(pvs->cellSets);
+    free(pvs->sets);
+    free(pvs->words);
+    free(pvs);
+}
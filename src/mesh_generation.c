@@ -1,6 +1,7 @@
 #include "mesh_generation.h"
 #include "lighting.h"
 #include "raymath.h"
+#include "thread_pool.h"
 #include <math.h>
 
 #ifndef PI
@@ -73,8 +74,8 @@ static Color GetTerrainColorByHeight(float height, float maxHeight) {
     }
 }
 
-// Generate a custom floor mesh with vertex colors
-Mesh GenMeshFloorWithColors(float width, float height, int resX, int resZ)
+// Build a checkerboard floor grid with unlit base colors (not uploaded)
+static Mesh BuildFloorMesh(float width, float height, int resX, int resZ)
 {
     int vertexCount = resX * resZ;
     int triangleCount = (resX-1) * (resZ-1) * 2;
@@ -112,7 +113,7 @@ Mesh GenMeshFloorWithColors(float width, float height, int resX, int resZ)
             mesh.texcoords[tcCounter] = (float)x/(resX-1);
             mesh.texcoords[tcCounter+1] = (float)z/(resZ-1);
             
-            // Vertex colors - create a checkerboard pattern with lighting
+            // Vertex colors - create a checkerboard pattern
             Color baseColor;
             if ((x + z) % 2 == 0) {
                 baseColor = (Color){ 100, 150, 100, 255 };
@@ -120,14 +121,10 @@ Mesh GenMeshFloorWithColors(float width, float height, int resX, int resZ)
                 baseColor = (Color){ 80, 120, 80, 255 };
             }
             
-            Vector3 vertexPos = { mesh.vertices[vCounter], mesh.vertices[vCounter+1], mesh.vertices[vCounter+2] };
-            Vector3 normal = { mesh.normals[nCounter], mesh.normals[nCounter+1], mesh.normals[nCounter+2] };
-            Color litColor = CalculateSimpleLighting(vertexPos, normal, baseColor);
-            
-            mesh.colors[cCounter] = litColor.r;
-            mesh.colors[cCounter+1] = litColor.g;
-            mesh.colors[cCounter+2] = litColor.b;
-            mesh.colors[cCounter+3] = litColor.a;
+            mesh.colors[cCounter] = baseColor.r;
+            mesh.colors[cCounter+1] = baseColor.g;
+            mesh.colors[cCounter+2] = baseColor.b;
+            mesh.colors[cCounter+3] = baseColor.a;
             
             vCounter += 3;
             nCounter += 3;
@@ -153,15 +150,49 @@ Mesh GenMeshFloorWithColors(float width, float height, int resX, int resZ)
         tCounter += 6;
     }
     
+    return mesh;
+}
+
+// Generate a custom floor mesh with vertex colors and lighting
+Mesh GenMeshFloorWithColors(float width, float height, int resX, int resZ)
+{
+    Mesh mesh = BuildFloorMesh(width, height, resX, resZ);
+    
+    // Simple sun lighting baked into the vertex colors
+    CalculateMeshLighting(&mesh, (Vector3){ 0.0f, 1.0f, 0.0f }, NULL, NULL);
+    
     UploadMesh(&mesh, false);
     return mesh;
 }
 
-// Generate a cube mesh for maze walls with vertex colors and lighting
-Mesh GenMeshMazeWallCube(float size, const LightingSystem* lighting, const GraphicsConfig* config)
+// Generate a floor mesh with unlit base colors for the per-pixel lighting shader
+Mesh GenMeshFloorBase(float width, float height, int resX, int resZ)
+{
+    Mesh mesh = BuildFloorMesh(width, height, resX, resZ);
+    UploadMesh(&mesh, false);
+    return mesh;
+}
+
+// Unlit brick color of a maze wall face (0-3 sides, 4 top, 5 bottom) at face coordinates s, t in [0, 1]
+Color GetMazeWallBaseColor(int face, float s, float t)
+{
+    if (face == 4) return (Color){ 150, 100, 100, 255 };   // Lighter brick for top
+    if (face == 5) return (Color){ 80, 60, 60, 255 };      // Darker for bottom
+    
+    // Side faces with brick pattern
+    int brickX = (int)(s * 8) % 6;
+    int brickY = (int)(t * 6) % 4;
+    if (brickY % 4 < 2 && brickX < 3) {
+        return (Color){ 140, 70, 70, 255 };     // brick red
+    } else if (brickY % 4 >= 2 && (brickX + 3) % 6 < 3) {
+        return (Color){ 140, 70, 70, 255 };     // brick red
+    }
+    return (Color){ 180, 180, 180, 255 };       // mortar
+}
+
+// Build a maze wall cube with res x res vertices per face and unlit brick colors (not uploaded)
+static Mesh BuildMazeWallCube(float size, int res)
 {
-    // Create a cube with subdivisions for better lighting
-    int res = 4; // 4x4 subdivisions per face for smoother lighting
     int faceVertexCount = res * res;
     int facetriangleCount = (res-1) * (res-1) * 2;
     int totalVertices = faceVertexCount * 6; // 6 faces
@@ -244,37 +275,13 @@ Mesh GenMeshMazeWallCube(float size, const LightingSystem* lighting, const Graph
                 mesh.texcoords[tcCounter++] = s;
                 mesh.texcoords[tcCounter++] = t;
                 
-                // Calculate lighting - choose base color based on face
-                Color baseColor;
-                if (face == 4) { // Top face
-                    baseColor = (Color){ 150, 100, 100, 255 }; // Lighter brick for top
-                } else if (face == 5) { // Bottom face
-                    baseColor = (Color){ 80, 60, 60, 255 }; // Darker for bottom
-                } else { // Side faces with brick pattern
-                    int brickX = (int)(s * 8) % 6;
-                    int brickY = (int)(t * 6) % 4;
-                    if (brickY % 4 < 2 && brickX < 3) {
-                        baseColor = (Color){ 140, 70, 70, 255 };  // brick red
-                    } else if (brickY % 4 >= 2 && (brickX + 3) % 6 < 3) {
-                        baseColor = (Color){ 140, 70, 70, 255 };  // brick red
-                    } else {
-                        baseColor = (Color){ 180, 180, 180, 255 }; // mortar
-                    }
-                }
-                
-                // Apply lighting
-                Color litColor;
-                if (config && config->advancedShadingEnabled && lighting) {
-                    Vector3 viewDir = { 0.0f, 0.0f, 1.0f };
-                    litColor = CalculateVertexLighting(vertexPos, normal, viewDir, baseColor, lighting, config);
-                } else {
-                    litColor = CalculateSimpleLighting(vertexPos, normal, baseColor);
-                }
+                Color baseColor = GetMazeWallBaseColor(face, s, t);
                 
-                mesh.colors[cCounter++] = litColor.r;
-                mesh.colors[cCounter++] = litColor.g;
-                mesh.colors[cCounter++] = litColor.b;
-                mesh.colors[cCounter++] = litColor.a;
+                // Base color only, lighting is applied to the whole mesh below
+                mesh.colors[cCounter++] = baseColor.r;
+                mesh.colors[cCounter++] = baseColor.g;
+                mesh.colors[cCounter++] = baseColor.b;
+                mesh.colors[cCounter++] = baseColor.a;
             }
         }
         
@@ -301,6 +308,26 @@ Mesh GenMeshMazeWallCube(float size, const LightingSystem* lighting, const Graph
         vertexIndex += faceVertexCount;
     }
     
+    return mesh;
+}
+
+// Generate a cube mesh for maze walls with vertex colors and lighting
+Mesh GenMeshMazeWallCube(float size, const LightingSystem* lighting, const GraphicsConfig* config)
+{
+    // 4x4 vertices per face so the baked vertex lighting has some detail
+    Mesh mesh = BuildMazeWallCube(size, 4);
+    
+    // Light all vertices in one batch (simple sun lighting unless advanced shading is enabled)
+    CalculateMeshLighting(&mesh, (Vector3){ 0.0f, 0.0f, 1.0f }, lighting, config);
+    
+    UploadMesh(&mesh, false);
+    return mesh;
+}
+
+// Generate a maze wall cube with unlit base colors and 4 vertices per face, lit per pixel by lighting.fs
+Mesh GenMeshMazeWallCubeBase(float size)
+{
+    Mesh mesh = BuildMazeWallCube(size, 2);
     UploadMesh(&mesh, false);
     return mesh;
 }
@@ -595,6 +622,298 @@ float SampleTerrainHeight(const TerrainData* terrain, float u, float v) {
     return h0 + (h1 - h0) * fy;
 }
 
+// Cube face frames shared by the terrain cube generators
+static const Vector3 terrainCubeFaceU[6] = {
+    {1, 0, 0}, {-1, 0, 0}, {0, 0, -1}, {0, 0, 1}, {1, 0, 0}, {1, 0, 0}
+};
+
+static const Vector3 terrainCubeFaceV[6] = {
+    {0, 1, 0}, {0, 1, 0}, {0, 1, 0}, {0, 1, 0}, {0, 0, 1}, {0, 0, -1}
+};
+
+// Shared state for generating terrain cube rows on the thread pool
+typedef struct {
+    Mesh* mesh;
+    const TerrainData* terrain;
+    const Vector3* faceNormals;
+    int segmentsPerFace;
+    float halfSize;
+    float heightScale;
+    float heightMultiplier;     // Used instead of terrain->heightMultiplier, which may change while jobs run
+    float morphFactor;
+    float maxTerrainHeight;
+} TerrainCubeJob;
+
+// Per-row maximum of the scaled terrain heights
+typedef struct {
+    const TerrainData* terrain;
+    float heightScale;
+    float heightMultiplier;
+    float* rowMax;
+} TerrainMaxHeightJob;
+
+static void TerrainMaxHeightRows(void* context, int start, int end) {
+    TerrainMaxHeightJob* job = (TerrainMaxHeightJob*)context;
+    for (int z = start; z < end; z++) {
+        float rowMax = 0.0f;
+        for (int x = 0; x < job->terrain->size; x++) {
+            // Same operation order as the serial scan, (height * heightScale) * heightMultiplier
+            float height = job->terrain->heights[z][x] * job->heightScale * job->heightMultiplier;
+            if (height > rowMax) {
+                rowMax = height;
+            }
+        }
+        job->rowMax[z] = rowMax;
+    }
+}
+
+// Maximum displaced terrain height used for color scaling. Rows are scanned in parallel, and max is exact
+// in any order, so the result is bit-identical to a serial scan.
+static float GetTerrainMaxHeight(const TerrainData* terrain, float heightScale, float heightMultiplier) {
+    float maxTerrainHeight = 0.0f;
+    if (!terrain || !terrain->loaded) return maxTerrainHeight;
+
+    float rowMax[TERRAIN_SIZE];
+    TerrainMaxHeightJob job = { terrain, heightScale, heightMultiplier, rowMax };
+    ParallelFor(terrain->size, 64, TerrainMaxHeightRows, &job);
+
+    for (int z = 0; z < terrain->size; z++) {
+        if (rowMax[z] > maxTerrainHeight) {
+            maxTerrainHeight = rowMax[z];
+        }
+    }
+    return maxTerrainHeight;
+}
+
+// Write the indices of quad row j on one face
+static void GenTerrainCubeRowIndices(Mesh* mesh, int face, int j, int segmentsPerFace) {
+    int verticesPerFace = (segmentsPerFace + 1) * (segmentsPerFace + 1);
+    int iCounter = (face * segmentsPerFace * segmentsPerFace + j * segmentsPerFace) * 6;
+    int vertexIndex = face * verticesPerFace;
+    
+    for (int i = 0; i < segmentsPerFace; i++) {
+        int topLeft = vertexIndex + j * (segmentsPerFace + 1) + i;
+        int topRight = topLeft + 1;
+        int bottomLeft = topLeft + (segmentsPerFace + 1);
+        int bottomRight = bottomLeft + 1;
+        
+        // First triangle
+        mesh->indices[iCounter++] = topLeft;
+        mesh->indices[iCounter++] = bottomLeft;
+        mesh->indices[iCounter++] = topRight;
+        
+        // Second triangle
+        mesh->indices[iCounter++] = topRight;
+        mesh->indices[iCounter++] = bottomLeft;
+        mesh->indices[iCounter++] = bottomRight;
+    }
+}
+
+// Run a terrain cube row function over all vertex rows of all six faces
+static void RunTerrainCubeJob(TerrainCubeJob* job, ParallelForFunc rowFunc) {
+    int rowCount = 6 * (job->segmentsPerFace + 1);
+    int grainSize = rowCount / (GetThreadPoolSize() * 4);
+    if (grainSize < 1) grainSize = 1;
+    ParallelFor(rowCount, grainSize, rowFunc, job);
+}
+
+static const Vector3 terrainCubeFaceNormals[6] = {
+    {0, 0, 1},   // Front (+Z)
+    {0, 0, -1},  // Back (-Z)
+    {-1, 0, 0},  // Left (-X)
+    {1, 0, 0},   // Right (+X)
+    {0, 1, 0},   // Top (+Y)
+    {0, -1, 0}   // Bottom (-Y)
+};
+
+// Generate vertex rows [start, end) of the terrain cube (rows are numbered face by face)
+static void GenTerrainCubeRows(void* context, int start, int end) {
+    TerrainCubeJob* job = (TerrainCubeJob*)context;
+    Mesh* mesh = job->mesh;
+    const TerrainData* terrain = job->terrain;
+    int segmentsPerFace = job->segmentsPerFace;
+    int verticesPerFace = (segmentsPerFace + 1) * (segmentsPerFace + 1);
+    float halfSize = job->halfSize;
+    float heightScale = job->heightScale;
+    float heightMultiplier = job->heightMultiplier;
+    float maxTerrainHeight = job->maxTerrainHeight;
+    
+    for (int row = start; row < end; row++) {
+        int face = row / (segmentsPerFace + 1);
+        int j = row % (segmentsPerFace + 1);
+        Vector3 normal = job->faceNormals[face];
+        Vector3 u = terrainCubeFaceU[face];
+        Vector3 v = terrainCubeFaceV[face];
+        
+        // Every row writes its own slice of the vertex arrays
+        int vertexStart = face * verticesPerFace + j * (segmentsPerFace + 1);
+        int vCounter = vertexStart * 3;
+        int tcCounter = vertexStart * 2;
+        int nCounter = vertexStart * 3;
+        int cCounter = vertexStart * 4;
+        
+        for (int i = 0; i <= segmentsPerFace; i++) {
+            float s = (float)i / segmentsPerFace;
+            float t = (float)j / segmentsPerFace;
+            
+            // Calculate base cube vertex position
+            Vector3 cubePos;
+            cubePos.x = normal.x * halfSize + u.x * halfSize * (s - 0.5f) * 2.0f + v.x * halfSize * (t - 0.5f) * 2.0f;
+            cubePos.y = normal.y * halfSize + u.y * halfSize * (s - 0.5f) * 2.0f + v.y * halfSize * (t - 0.5f) * 2.0f;
+            cubePos.z = normal.z * halfSize + u.z * halfSize * (s - 0.5f) * 2.0f + v.z * halfSize * (t - 0.5f) * 2.0f;
+            
+            // Sample terrain height for displacement
+            float terrainHeight = 0.0f;
+            if (terrain && terrain->loaded) {
+                // Use cube-to-sphere projection for seamless UV mapping
+                // First normalize the cube position to [-1, 1] range
+                Vector3 normalizedCubePos = {
+                    cubePos.x / halfSize,
+                    cubePos.y / halfSize,
+                    cubePos.z / halfSize
+                };
+                
+                // Project cube position to sphere for seamless UV coordinates
+                Vector3 spherePos = ProjectCubeToSphere(normalizedCubePos);
+                
+                // Convert sphere coordinates to spherical UV coordinates
+                float phi = atan2f(spherePos.z, spherePos.x);  // Azimuth angle
+                float theta = asinf(spherePos.y);              // Elevation angle
+                
+                // Normalize to [0, 1] UV coordinates
+                float terrainU = (phi + PI) / (2.0f * PI);     // Wrap phi to [0, 1]
+                float terrainV = (theta + PI/2.0f) / PI;       // Map theta to [0, 1]
+                
+                // Ensure UV coordinates are within bounds
+                terrainU = fmodf(terrainU + 1.0f, 1.0f);
+                terrainV = fmaxf(0.0f, fminf(1.0f, terrainV));
+                
+                terrainHeight = SampleTerrainHeight(terrain, terrainU, terrainV) * heightScale * heightMultiplier;
+            }
+            
+            // Apply terrain displacement along face normal
+            Vector3 displacement = Vector3Scale(normal, terrainHeight);
+            Vector3 finalPos = Vector3Add(cubePos, displacement);
+            
+            mesh->vertices[vCounter++] = finalPos.x;
+            mesh->vertices[vCounter++] = finalPos.y;
+            mesh->vertices[vCounter++] = finalPos.z;
+            
+            // Calculate normal by sampling neighboring heights
+            Vector3 calculatedNormal = normal; // Default to face normal
+            
+            if (terrain && terrain->loaded && i > 0 && i < segmentsPerFace && j > 0 && j < segmentsPerFace) {
+                float offset = 1.0f / segmentsPerFace;
+                
+                // Calculate neighboring cube positions for consistent normal calculation
+                Vector3 leftCubePos = {
+                    normal.x * halfSize + u.x * halfSize * (s - offset - 0.5f) * 2.0f + v.x * halfSize * (t - 0.5f) * 2.0f,
+                    normal.y * halfSize + u.y * halfSize * (s - offset - 0.5f) * 2.0f + v.y * halfSize * (t - 0.5f) * 2.0f,
+                    normal.z * halfSize + u.z * halfSize * (s - offset - 0.5f) * 2.0f + v.z * halfSize * (t - 0.5f) * 2.0f
+                };
+                Vector3 rightCubePos = {
+                    normal.x * halfSize + u.x * halfSize * (s + offset - 0.5f) * 2.0f + v.x * halfSize * (t - 0.5f) * 2.0f,
+                    normal.y * halfSize + u.y * halfSize * (s + offset - 0.5f) * 2.0f + v.y * halfSize * (t - 0.5f) * 2.0f,
+                    normal.z * halfSize + u.z * halfSize * (s + offset - 0.5f) * 2.0f + v.z * halfSize * (t - 0.5f) * 2.0f
+                };
+                Vector3 downCubePos = {
+                    normal.x * halfSize + u.x * halfSize * (s - 0.5f) * 2.0f + v.x * halfSize * (t - offset - 0.5f) * 2.0f,
+                    normal.y * halfSize + u.y * halfSize * (s - 0.5f) * 2.0f + v.y * halfSize * (t - offset - 0.5f) * 2.0f,
+                    normal.z * halfSize + u.z * halfSize * (s - 0.5f) * 2.0f + v.z * halfSize * (t - offset - 0.5f) * 2.0f
+                };
+                Vector3 upCubePos = {
+                    normal.x * halfSize + u.x * halfSize * (s - 0.5f) * 2.0f + v.x * halfSize * (t + offset - 0.5f) * 2.0f,
+                    normal.y * halfSize + u.y * halfSize * (s - 0.5f) * 2.0f + v.y * halfSize * (t + offset - 0.5f) * 2.0f,
+                    normal.z * halfSize + u.z * halfSize * (s - 0.5f) * 2.0f + v.z * halfSize * (t + offset - 0.5f) * 2.0f
+                };
+                
+                // Project neighboring positions to sphere and get terrain heights
+                Vector3 leftNorm = {leftCubePos.x/halfSize, leftCubePos.y/halfSize, leftCubePos.z/halfSize};
+                Vector3 rightNorm = {rightCubePos.x/halfSize, rightCubePos.y/halfSize, rightCubePos.z/halfSize};
+                Vector3 downNorm = {downCubePos.x/halfSize, downCubePos.y/halfSize, downCubePos.z/halfSize};
+                Vector3 upNorm = {upCubePos.x/halfSize, upCubePos.y/halfSize, upCubePos.z/halfSize};
+                
+                Vector3 leftSphere = ProjectCubeToSphere(leftNorm);
+                Vector3 rightSphere = ProjectCubeToSphere(rightNorm);
+                Vector3 downSphere = ProjectCubeToSphere(downNorm);
+                Vector3 upSphere = ProjectCubeToSphere(upNorm);
+                
+                // Convert to spherical coordinates and sample heights
+                float phiL = atan2f(leftSphere.z, leftSphere.x);
+                float thetaL = asinf(leftSphere.y);
+                float uL = fmodf((phiL + PI) / (2.0f * PI) + 1.0f, 1.0f);
+                float vL = fmaxf(0.0f, fminf(1.0f, (thetaL + PI/2.0f) / PI));
+                
+                float phiR = atan2f(rightSphere.z, rightSphere.x);
+                float thetaR = asinf(rightSphere.y);
+                float uR = fmodf((phiR + PI) / (2.0f * PI) + 1.0f, 1.0f);
+                float vR = fmaxf(0.0f, fminf(1.0f, (thetaR + PI/2.0f) / PI));
+                
+                float phiD = atan2f(downSphere.z, downSphere.x);
+                float thetaD = asinf(downSphere.y);
+                float uD = fmodf((phiD + PI) / (2.0f * PI) + 1.0f, 1.0f);
+                float vD = fmaxf(0.0f, fminf(1.0f, (thetaD + PI/2.0f) / PI));
+                
+                float phiU = atan2f(upSphere.z, upSphere.x);
+                float thetaU = asinf(upSphere.y);
+                float uU = fmodf((phiU + PI) / (2.0f * PI) + 1.0f, 1.0f);
+                float vU = fmaxf(0.0f, fminf(1.0f, (thetaU + PI/2.0f) / PI));
+                
+                // Sample terrain heights at neighboring positions
+                float hL = SampleTerrainHeight(terrain, uL, vL) * heightScale * heightMultiplier;
+                float hR = SampleTerrainHeight(terrain, uR, vR) * heightScale * heightMultiplier;
+                float hD = SampleTerrainHeight(terrain, uD, vD) * heightScale * heightMultiplier;
+                float hU = SampleTerrainHeight(terrain, uU, vU) * heightScale * heightMultiplier;
+                
+                // Calculate tangent vectors with terrain displacement
+                Vector3 tangentU = Vector3Add(Vector3Scale(u, halfSize * 2.0f * offset), 
+                                             Vector3Scale(normal, hR - hL));
+                Vector3 tangentV = Vector3Add(Vector3Scale(v, halfSize * 2.0f * offset),
+                                             Vector3Scale(normal, hU - hD));
+                
+                calculatedNormal = Vector3Normalize(Vector3CrossProduct(tangentU, tangentV));
+            }
+            
+            mesh->normals[nCounter++] = calculatedNormal.x;
+            mesh->normals[nCounter++] = calculatedNormal.y;
+            mesh->normals[nCounter++] = calculatedNormal.z;
+            
+            // Texture coordinates
+            mesh->texcoords[tcCounter++] = s;
+            mesh->texcoords[tcCounter++] = t;
+            
+            // Apply terrain-based vertex coloring
+            Color vertexColor;
+            if (terrain && terrain->loaded && maxTerrainHeight > 0.0f) {
+                vertexColor = GetTerrainColorByHeight(terrainHeight, maxTerrainHeight);
+            } else {
+                // Default cube coloring if no terrain
+                Color faceColors[6] = {
+                    {255, 100, 100, 255}, // Red front
+                    {100, 255, 100, 255}, // Green back
+                    {100, 100, 255, 255}, // Blue left
+                    {255, 255, 100, 255}, // Yellow right
+                    {255, 100, 255, 255}, // Magenta top
+                    {100, 255, 255, 255}  // Cyan bottom
+                };
+                vertexColor = faceColors[face];
+            }
+            
+            // Apply simple lighting
+            Color litColor = CalculateSimpleLighting(finalPos, calculatedNormal, vertexColor);
+            
+            mesh->colors[cCounter++] = litColor.r;
+            mesh->colors[cCounter++] = litColor.g;
+            mesh->colors[cCounter++] = litColor.b;
+            mesh->colors[cCounter++] = litColor.a;
+        }
+        
+        if (j < segmentsPerFace) {
+            GenTerrainCubeRowIndices(mesh, face, j, segmentsPerFace);
+        }
+    }
+}
+
 // Generate cube with terrain height map displacement on each face
 Mesh GenMeshTerrainCube(float size, int subdivisions, const TerrainData* terrain, float heightScale) {
     int segmentsPerFace = subdivisions + 1;
@@ -613,239 +932,172 @@ Mesh GenMeshTerrainCube(float size, int subdivisions, const TerrainData* terrain
     mesh.colors = (unsigned char *)MemAlloc(totalVertices * 4 * sizeof(unsigned char));
     mesh.indices = (unsigned short *)MemAlloc(totalTriangles * 3 * sizeof(unsigned short));
     
-    int vCounter = 0;
-    int tcCounter = 0;
-    int nCounter = 0;
-    int cCounter = 0;
-    int iCounter = 0;
-    int vertexIndex = 0;
-    
-    float halfSize = size * 0.5f;
-    float maxTerrainHeight = 0.0f;
-    
-    // Calculate maximum height for color scaling
-    if (terrain && terrain->loaded) {
-        for (int z = 0; z < terrain->size; z++) {
-            for (int x = 0; x < terrain->size; x++) {
-                float height = terrain->heights[z][x] * heightScale * terrain->heightMultiplier;
-                if (height > maxTerrainHeight) {
-                    maxTerrainHeight = height;
-                }
-            }
-        }
-    }
-    
-    // Define face data with proper cube mapping
-    Vector3 faceNormals[6] = {
-        {0, 0, 1},   // Front (+Z)
-        {0, 0, -1},  // Back (-Z)
-        {-1, 0, 0},  // Left (-X)
-        {1, 0, 0},   // Right (+X)
-        {0, 1, 0},   // Top (+Y)
-        {0, -1, 0}   // Bottom (-Y)
-    };
-    
-    Vector3 faceU[6] = {
-        {1, 0, 0}, {-1, 0, 0}, {0, 0, -1}, {0, 0, 1}, {1, 0, 0}, {1, 0, 0}
-    };
+    // Faces and row bands write disjoint slices of the arrays, so rows are generated in parallel
+    TerrainCubeJob job = { 0 };
+    job.mesh = &mesh;
+    job.terrain = terrain;
+    job.faceNormals = terrainCubeFaceNormals;
+    job.segmentsPerFace = segmentsPerFace;
+    job.halfSize = size * 0.5f;
+    job.heightScale = heightScale;
+    job.heightMultiplier = terrain ? terrain->heightMultiplier : 0.0f;
+    job.maxTerrainHeight = GetTerrainMaxHeight(terrain, heightScale, job.heightMultiplier);
+    RunTerrainCubeJob(&job, GenTerrainCubeRows);
     
-    Vector3 faceV[6] = {
-        {0, 1, 0}, {0, 1, 0}, {0, 1, 0}, {0, 1, 0}, {0, 0, 1}, {0, 0, -1}
-    };
-    
-    // Generate vertices for each face
-    for (int face = 0; face < 6; face++) {
-        Vector3 normal = faceNormals[face];
-        Vector3 u = faceU[face];
-        Vector3 v = faceV[face];
+    UploadMesh(&mesh, false);
+    return mesh;
+}
+
+static const Vector3 morphingCubeFaceNormals[6] = {
+    {0, 0, -1},   // Front (+Z)
+    {0, 0, 1},  // Back (-Z)
+    {-1, 0, 0},  // Left (-X)
+    {1, 0, 0},   // Right (+X)
+    {0, 1, 0},   // Top (+Y)
+    {0, -1, 0}   // Bottom (-Y)
+};
+
+// Generate vertex rows [start, end) of the morphing terrain cube (rows are numbered face by face)
+static void GenTerrainCubeMorphingRows(void* context, int start, int end) {
+    TerrainCubeJob* job = (TerrainCubeJob*)context;
+    Mesh* mesh = job->mesh;
+    const TerrainData* terrain = job->terrain;
+    int segmentsPerFace = job->segmentsPerFace;
+    int verticesPerFace = (segmentsPerFace + 1) * (segmentsPerFace + 1);
+    float halfSize = job->halfSize;
+    float heightScale = job->heightScale;
+    float heightMultiplier = job->heightMultiplier;
+    float morphFactor = job->morphFactor;
+    float maxTerrainHeight = job->maxTerrainHeight;
+    
+    for (int row = start; row < end; row++) {
+        int face = row / (segmentsPerFace + 1);
+        int j = row % (segmentsPerFace + 1);
+        Vector3 normal = job->faceNormals[face];
+        Vector3 u = terrainCubeFaceU[face];
+        Vector3 v = terrainCubeFaceV[face];
         
-        for (int j = 0; j <= segmentsPerFace; j++) {
-            for (int i = 0; i <= segmentsPerFace; i++) {
-                float s = (float)i / segmentsPerFace;
-                float t = (float)j / segmentsPerFace;
-                
-                // Calculate base cube vertex position
-                Vector3 cubePos;
-                cubePos.x = normal.x * halfSize + u.x * halfSize * (s - 0.5f) * 2.0f + v.x * halfSize * (t - 0.5f) * 2.0f;
-                cubePos.y = normal.y * halfSize + u.y * halfSize * (s - 0.5f) * 2.0f + v.y * halfSize * (t - 0.5f) * 2.0f;
-                cubePos.z = normal.z * halfSize + u.z * halfSize * (s - 0.5f) * 2.0f + v.z * halfSize * (t - 0.5f) * 2.0f;
-                
-                // Sample terrain height for displacement
-                float terrainHeight = 0.0f;
-                if (terrain && terrain->loaded) {
-                    // Use cube-to-sphere projection for seamless UV mapping
-                    // First normalize the cube position to [-1, 1] range
-                    Vector3 normalizedCubePos = {
-                        cubePos.x / halfSize,
-                        cubePos.y / halfSize,
-                        cubePos.z / halfSize
-                    };
-                    
-                    // Project cube position to sphere for seamless UV coordinates
-                    Vector3 spherePos = ProjectCubeToSphere(normalizedCubePos);
-                    
-                    // Convert sphere coordinates to spherical UV coordinates
-                    float phi = atan2f(spherePos.z, spherePos.x);  // Azimuth angle
-                    float theta = asinf(spherePos.y);              // Elevation angle
-                    
-                    // Normalize to [0, 1] UV coordinates
-                    float terrainU = (phi + PI) / (2.0f * PI);     // Wrap phi to [0, 1]
-                    float terrainV = (theta + PI/2.0f) / PI;       // Map theta to [0, 1]
-                    
-                    // Ensure UV coordinates are within bounds
-                    terrainU = fmodf(terrainU + 1.0f, 1.0f);
-                    terrainV = fmaxf(0.0f, fminf(1.0f, terrainV));
-                    
-                    terrainHeight = SampleTerrainHeight(terrain, terrainU, terrainV) * heightScale * terrain->heightMultiplier;
-                }
-                
-                // Apply terrain displacement along face normal
-                Vector3 displacement = Vector3Scale(normal, terrainHeight);
-                Vector3 finalPos = Vector3Add(cubePos, displacement);
-                
-                mesh.vertices[vCounter++] = finalPos.x;
-                mesh.vertices[vCounter++] = finalPos.y;
-                mesh.vertices[vCounter++] = finalPos.z;
-                
-                // Calculate normal by sampling neighboring heights
-                Vector3 calculatedNormal = normal; // Default to face normal
+        // Every row writes its own slice of the vertex arrays
+        int vertexStart = face * verticesPerFace + j * (segmentsPerFace + 1);
+        int vCounter = vertexStart * 3;
+        int tcCounter = vertexStart * 2;
+        int nCounter = vertexStart * 3;
+        int cCounter = vertexStart * 4;
+        
+        for (int i = 0; i <= segmentsPerFace; i++) {
+            float s = (float)i / segmentsPerFace;
+            float t = (float)j / segmentsPerFace;
+            
+            // Calculate base cube vertex position
+            Vector3 cubePos;
+            cubePos.x = normal.x * halfSize + u.x * halfSize * (s - 0.5f) * 2.0f + v.x * halfSize * (t - 0.5f) * 2.0f;
+            cubePos.y = normal.y * halfSize + u.y * halfSize * (s - 0.5f) * 2.0f + v.y * halfSize * (t - 0.5f) * 2.0f;
+            cubePos.z = normal.z * halfSize + u.z * halfSize * (s - 0.5f) * 2.0f + v.z * halfSize * (t - 0.5f) * 2.0f;
+            
+            // Calculate sphere position (for morphing)
+            float length = sqrtf(cubePos.x * cubePos.x + cubePos.y * cubePos.y + cubePos.z * cubePos.z);
+            Vector3 spherePos = {
+                cubePos.x / length * halfSize,
+                cubePos.y / length * halfSize,
+                cubePos.z / length * halfSize
+            };
+            
+            // Interpolate between cube and sphere based on morphFactor
+            Vector3 basePos = {
+                cubePos.x * (1.0f - morphFactor) + spherePos.x * morphFactor,
+                cubePos.y * (1.0f - morphFactor) + spherePos.y * morphFactor,
+                cubePos.z * (1.0f - morphFactor) + spherePos.z * morphFactor
+            };
+            
+            // Sample terrain height for displacement
+            float terrainHeight = 0.0f;
+            if (terrain && terrain->loaded) {
+                // Use cube-to-sphere projection for seamless UV mapping
+                Vector3 normalizedPos = {
+                    cubePos.x / halfSize,
+                    cubePos.y / halfSize,
+                    cubePos.z / halfSize
+                };
                 
-                if (terrain && terrain->loaded && i > 0 && i < segmentsPerFace && j > 0 && j < segmentsPerFace) {
-                    float offset = 1.0f / segmentsPerFace;
-                    
-                    // Calculate neighboring cube positions for consistent normal calculation
-                    Vector3 leftCubePos = {
-                        normal.x * halfSize + u.x * halfSize * (s - offset - 0.5f) * 2.0f + v.x * halfSize * (t - 0.5f) * 2.0f,
-                        normal.y * halfSize + u.y * halfSize * (s - offset - 0.5f) * 2.0f + v.y * halfSize * (t - 0.5f) * 2.0f,
-                        normal.z * halfSize + u.z * halfSize * (s - offset - 0.5f) * 2.0f + v.z * halfSize * (t - 0.5f) * 2.0f
-                    };
-                    Vector3 rightCubePos = {
-                        normal.x * halfSize + u.x * halfSize * (s + offset - 0.5f) * 2.0f + v.x * halfSize * (t - 0.5f) * 2.0f,
-                        normal.y * halfSize + u.y * halfSize * (s + offset - 0.5f) * 2.0f + v.y * halfSize * (t - 0.5f) * 2.0f,
-                        normal.z * halfSize + u.z * halfSize * (s + offset - 0.5f) * 2.0f + v.z * halfSize * (t - 0.5f) * 2.0f
-                    };
-                    Vector3 downCubePos = {
-                        normal.x * halfSize + u.x * halfSize * (s - 0.5f) * 2.0f + v.x * halfSize * (t - offset - 0.5f) * 2.0f,
-                        normal.y * halfSize + u.y * halfSize * (s - 0.5f) * 2.0f + v.y * halfSize * (t - offset - 0.5f) * 2.0f,
-                        normal.z * halfSize + u.z * halfSize * (s - 0.5f) * 2.0f + v.z * halfSize * (t - offset - 0.5f) * 2.0f
-                    };
-                    Vector3 upCubePos = {
-                        normal.x * halfSize + u.x * halfSize * (s - 0.5f) * 2.0f + v.x * halfSize * (t + offset - 0.5f) * 2.0f,
-                        normal.y * halfSize + u.y * halfSize * (s - 0.5f) * 2.0f + v.y * halfSize * (t + offset - 0.5f) * 2.0f,
-                        normal.z * halfSize + u.z * halfSize * (s - 0.5f) * 2.0f + v.z * halfSize * (t + offset - 0.5f) * 2.0f
-                    };
-                    
-                    // Project neighboring positions to sphere and get terrain heights
-                    Vector3 leftNorm = {leftCubePos.x/halfSize, leftCubePos.y/halfSize, leftCubePos.z/halfSize};
-                    Vector3 rightNorm = {rightCubePos.x/halfSize, rightCubePos.y/halfSize, rightCubePos.z/halfSize};
-                    Vector3 downNorm = {downCubePos.x/halfSize, downCubePos.y/halfSize, downCubePos.z/halfSize};
-                    Vector3 upNorm = {upCubePos.x/halfSize, upCubePos.y/halfSize, upCubePos.z/halfSize};
-                    
-                    Vector3 leftSphere = ProjectCubeToSphere(leftNorm);
-                    Vector3 rightSphere = ProjectCubeToSphere(rightNorm);
-                    Vector3 downSphere = ProjectCubeToSphere(downNorm);
-                    Vector3 upSphere = ProjectCubeToSphere(upNorm);
-                    
-                    // Convert to spherical coordinates and sample heights
-                    float phiL = atan2f(leftSphere.z, leftSphere.x);
-                    float thetaL = asinf(leftSphere.y);
-                    float uL = fmodf((phiL + PI) / (2.0f * PI) + 1.0f, 1.0f);
-                    float vL = fmaxf(0.0f, fminf(1.0f, (thetaL + PI/2.0f) / PI));
-                    
-                    float phiR = atan2f(rightSphere.z, rightSphere.x);
-                    float thetaR = asinf(rightSphere.y);
-                    float uR = fmodf((phiR + PI) / (2.0f * PI) + 1.0f, 1.0f);
-                    float vR = fmaxf(0.0f, fminf(1.0f, (thetaR + PI/2.0f) / PI));
-                    
-                    float phiD = atan2f(downSphere.z, downSphere.x);
-                    float thetaD = asinf(downSphere.y);
-                    float uD = fmodf((phiD + PI) / (2.0f * PI) + 1.0f, 1.0f);
-                    float vD = fmaxf(0.0f, fminf(1.0f, (thetaD + PI/2.0f) / PI));
-                    
-                    float phiU = atan2f(upSphere.z, upSphere.x);
-                    float thetaU = asinf(upSphere.y);
-                    float uU = fmodf((phiU + PI) / (2.0f * PI) + 1.0f, 1.0f);
-                    float vU = fmaxf(0.0f, fminf(1.0f, (thetaU + PI/2.0f) / PI));
-                    
-                    // Sample terrain heights at neighboring positions
-                    float hL = SampleTerrainHeight(terrain, uL, vL) * heightScale * terrain->heightMultiplier;
-                    float hR = SampleTerrainHeight(terrain, uR, vR) * heightScale * terrain->heightMultiplier;
-                    float hD = SampleTerrainHeight(terrain, uD, vD) * heightScale * terrain->heightMultiplier;
-                    float hU = SampleTerrainHeight(terrain, uU, vU) * heightScale * terrain->heightMultiplier;
-                    
-                    // Calculate tangent vectors with terrain displacement
-                    Vector3 tangentU = Vector3Add(Vector3Scale(u, halfSize * 2.0f * offset), 
-                                                 Vector3Scale(normal, hR - hL));
-                    Vector3 tangentV = Vector3Add(Vector3Scale(v, halfSize * 2.0f * offset),
-                                                 Vector3Scale(normal, hU - hD));
-                    
-                    calculatedNormal = Vector3Normalize(Vector3CrossProduct(tangentU, tangentV));
-                }
+                Vector3 sphereUV = ProjectCubeToSphere(normalizedPos);
                 
-                mesh.normals[nCounter++] = calculatedNormal.x;
-                mesh.normals[nCounter++] = calculatedNormal.y;
-                mesh.normals[nCounter++] = calculatedNormal.z;
+                // Convert sphere coordinates to spherical UV coordinates
+                float phi = atan2f(sphereUV.z, sphereUV.x);
+                float theta = asinf(sphereUV.y);
                 
-                // Texture coordinates
-                mesh.texcoords[tcCounter++] = s;
-                mesh.texcoords[tcCounter++] = t;
+                float terrainU = fmodf((phi + PI) / (2.0f * PI) + 1.0f, 1.0f);
+                float terrainV = fmaxf(0.0f, fminf(1.0f, (theta + PI/2.0f) / PI));
                 
-                // Apply terrain-based vertex coloring
-                Color vertexColor;
-                if (terrain && terrain->loaded && maxTerrainHeight > 0.0f) {
-                    vertexColor = GetTerrainColorByHeight(terrainHeight, maxTerrainHeight);
-                } else {
-                    // Default cube coloring if no terrain
-                    Color faceColors[6] = {
-                        {255, 100, 100, 255}, // Red front
-                        {100, 255, 100, 255}, // Green back
-                        {100, 100, 255, 255}, // Blue left
-                        {255, 255, 100, 255}, // Yellow right
-                        {255, 100, 255, 255}, // Magenta top
-                        {100, 255, 255, 255}  // Cyan bottom
-                    };
-                    vertexColor = faceColors[face];
-                }
-                
-                // Apply simple lighting
-                Color litColor = CalculateSimpleLighting(finalPos, calculatedNormal, vertexColor);
-                
-                mesh.colors[cCounter++] = litColor.r;
-                mesh.colors[cCounter++] = litColor.g;
-                mesh.colors[cCounter++] = litColor.b;
-                mesh.colors[cCounter++] = litColor.a;
+                terrainHeight = SampleTerrainHeight(terrain, terrainU, terrainV) * heightScale * heightMultiplier;
             }
-        }
-        
-        // Generate indices for this face
-        for (int j = 0; j < segmentsPerFace; j++) {
-            for (int i = 0; i < segmentsPerFace; i++) {
-                int topLeft = vertexIndex + j * (segmentsPerFace + 1) + i;
-                int topRight = topLeft + 1;
-                int bottomLeft = topLeft + (segmentsPerFace + 1);
-                int bottomRight = bottomLeft + 1;
-                
-                // First triangle
-                mesh.indices[iCounter++] = topLeft;
-                mesh.indices[iCounter++] = bottomLeft;
-                mesh.indices[iCounter++] = topRight;
-                
-                // Second triangle
-                mesh.indices[iCounter++] = topRight;
-                mesh.indices[iCounter++] = bottomLeft;
-                mesh.indices[iCounter++] = bottomRight;
+            
+            // Calculate normal for displacement direction
+            Vector3 displacementNormal = {
+                normal.x * (1.0f - morphFactor) + (basePos.x / halfSize) * morphFactor,
+                normal.y * (1.0f - morphFactor) + (basePos.y / halfSize) * morphFactor,
+                normal.z * (1.0f - morphFactor) + (basePos.z / halfSize) * morphFactor
+            };
+            float normalLength = sqrtf(displacementNormal.x * displacementNormal.x + 
+                                     displacementNormal.y * displacementNormal.y + 
+                                     displacementNormal.z * displacementNormal.z);
+            if (normalLength > 0.001f) {
+                displacementNormal.x /= normalLength;
+                displacementNormal.y /= normalLength;
+                displacementNormal.z /= normalLength;
             }
+            
+            // Apply terrain displacement along normal
+            Vector3 displacement = Vector3Scale(displacementNormal, terrainHeight);
+            Vector3 finalPos = Vector3Add(basePos, displacement);
+            
+            mesh->vertices[vCounter++] = finalPos.x;
+            mesh->vertices[vCounter++] = finalPos.y;
+            mesh->vertices[vCounter++] = finalPos.z;
+            
+            // Use displacement normal as vertex normal
+            mesh->normals[nCounter++] = displacementNormal.x;
+            mesh->normals[nCounter++] = displacementNormal.y;
+            mesh->normals[nCounter++] = displacementNormal.z;
+            
+            // Texture coordinates
+            mesh->texcoords[tcCounter++] = s;
+            mesh->texcoords[tcCounter++] = t;
+            
+            // Apply terrain-based vertex coloring
+            Color vertexColor;
+            if (terrain && terrain->loaded && maxTerrainHeight > 0.0f) {
+                vertexColor = GetTerrainColorByHeight(terrainHeight, maxTerrainHeight);
+            } else {
+                // Default cube coloring if no terrain
+                Color faceColors[6] = {
+                    {255, 100, 100, 255}, // Red front
+                    {100, 255, 100, 255}, // Green back
+                    {100, 100, 255, 255}, // Blue left
+                    {255, 255, 100, 255}, // Yellow right
+                    {255, 100, 255, 255}, // Magenta top
+                    {100, 255, 255, 255}  // Cyan bottom
+                };
+                vertexColor = faceColors[face];
+            }
+            
+            // Apply simple lighting
+            Color litColor = CalculateSimpleLighting(finalPos, displacementNormal, vertexColor);
+            
+            mesh->colors[cCounter++] = litColor.r;
+            mesh->colors[cCounter++] = litColor.g;
+            mesh->colors[cCounter++] = litColor.b;
+            mesh->colors[cCounter++] = litColor.a;
         }
         
-        vertexIndex += verticesPerFace;
+        if (j < segmentsPerFace) {
+            GenTerrainCubeRowIndices(mesh, face, j, segmentsPerFace);
+        }
     }
-    
-    UploadMesh(&mesh, false);
-    return mesh;
 }
 
-// Generate cube with terrain displacement that can morph towards a sphere
-Mesh GenMeshTerrainCubeMorphing(float size, int subdivisions, const TerrainData* terrain, float heightScale, float morphFactor) {
+// Build cube with terrain displacement that can morph towards a sphere, CPU side only (safe to call off the main thread)
+Mesh BuildMeshTerrainCubeMorphing(float size, int subdivisions, const TerrainData* terrain, float heightScale,
+                                  float heightMultiplier, float morphFactor) {
     int segmentsPerFace = subdivisions + 1;
     int verticesPerFace = (segmentsPerFace + 1) * (segmentsPerFace + 1);
     int totalVertices = verticesPerFace * 6;
@@ -862,184 +1114,203 @@ Mesh GenMeshTerrainCubeMorphing(float size, int subdivisions, const TerrainData*
     mesh.colors = (unsigned char *)MemAlloc(totalVertices * 4 * sizeof(unsigned char));
     mesh.indices = (unsigned short *)MemAlloc(totalTriangles * 3 * sizeof(unsigned short));
     
-    int vCounter = 0;
-    int tcCounter = 0;
-    int nCounter = 0;
-    int cCounter = 0;
-    int iCounter = 0;
-    int vertexIndex = 0;
+    // Faces and row bands write disjoint slices of the arrays, so rows are generated in parallel
+    TerrainCubeJob job = { 0 };
+    job.mesh = &mesh;
+    job.terrain = terrain;
+    job.faceNormals = morphingCubeFaceNormals;
+    job.segmentsPerFace = segmentsPerFace;
+    job.halfSize = size * 0.5f;
+    job.heightScale = heightScale;
+    job.heightMultiplier = heightMultiplier;
+    job.morphFactor = morphFactor;
+    job.maxTerrainHeight = GetTerrainMaxHeight(terrain, heightScale, heightMultiplier);
+    RunTerrainCubeJob(&job, GenTerrainCubeMorphingRows);
     
-    float halfSize = size * 0.5f;
-    float maxTerrainHeight = 0.0f;
-    
-    // Calculate maximum height for color scaling
-    if (terrain && terrain->loaded) {
-        for (int z = 0; z < terrain->size; z++) {
-            for (int x = 0; x < terrain->size; x++) {
-                float height = terrain->heights[z][x] * heightScale * terrain->heightMultiplier;
-                if (height > maxTerrainHeight) {
-                    maxTerrainHeight = height;
-                }
+    return mesh;
+}
+
+// Generate cube with terrain displacement that can morph towards a sphere
+Mesh GenMeshTerrainCubeMorphing(float size, int subdivisions, const TerrainData* terrain, float heightScale, float morphFactor) {
+    float heightMultiplier = terrain ? terrain->heightMultiplier : 0.0f;
+    Mesh mesh = BuildMeshTerrainCubeMorphing(size, subdivisions, terrain, heightScale, heightMultiplier, morphFactor);
+    UploadMesh(&mesh, false);
+    return mesh;
+}
+
+// Generate one mesh per cube face with heights from procedural fBm patches instead of the heightmap
+void GenMeshProceduralPlanet(Mesh faceMeshes[6], float size, int level, PlanetHeightCache* cache, float heightScale, float heightMultiplier, float morphFactor) {
+    if (level < 0) level = 0;
+    if (level > PLANET_MAX_PATCH_LEVEL) level = PLANET_MAX_PATCH_LEVEL;
+
+    int patchesPerEdge = 1 << level;
+    int patchCount = 6 * patchesPerEdge * patchesPerEdge;
+    int segmentsPerFace = patchesPerEdge * PLANET_PATCH_RESOLUTION;
+    int verticesPerRow = segmentsPerFace + 1;
+    int verticesPerFace = verticesPerRow * verticesPerRow;
+    int trianglesPerFace = segmentsPerFace * segmentsPerFace * 2;
+
+    // Fetch (or evaluate in parallel) every patch of every face up front
+    PlanetPatchKey* keys = (PlanetPatchKey*)MemAlloc(patchCount * sizeof(PlanetPatchKey));
+    int keyCount = 0;
+    for (int face = 0; face < 6; face++) {
+        for (int py = 0; py < patchesPerEdge; py++) {
+            for (int px = 0; px < patchesPerEdge; px++) {
+                keys[keyCount++] = (PlanetPatchKey){ face, level, px, py };
             }
         }
     }
-    
-    // Define face data with proper cube mapping
+    RequestPlanetPatches(cache, keys, keyCount);
+
+    // Calculate maximum height for color scaling
+    float heightUnits = PLANET_NOISE_HEIGHT_RANGE * heightScale * heightMultiplier;
+    float maxTerrainHeight = 0.0f;
+    for (int k = 0; k < keyCount; k++) {
+        const float* heights = GetPlanetPatchHeights(cache, keys[k]);
+        if (!heights) continue;
+        for (int i = 0; i < PLANET_PATCH_SAMPLES; i++) {
+            if (heights[i] * heightUnits > maxTerrainHeight) maxTerrainHeight = heights[i] * heightUnits;
+        }
+    }
+
+    // Same face basis as GenMeshTerrainCubeMorphing
     Vector3 faceNormals[6] = {
-        {0, 0, -1},   // Front (+Z)
-        {0, 0, 1},  // Back (-Z)
-        {-1, 0, 0},  // Left (-X)
-        {1, 0, 0},   // Right (+X)
-        {0, 1, 0},   // Top (+Y)
-        {0, -1, 0}   // Bottom (-Y)
+        {0, 0, -1}, {0, 0, 1}, {-1, 0, 0}, {1, 0, 0}, {0, 1, 0}, {0, -1, 0}
     };
-    
     Vector3 faceU[6] = {
         {1, 0, 0}, {-1, 0, 0}, {0, 0, -1}, {0, 0, 1}, {1, 0, 0}, {1, 0, 0}
     };
-    
     Vector3 faceV[6] = {
         {0, 1, 0}, {0, 1, 0}, {0, 1, 0}, {0, 1, 0}, {0, 0, 1}, {0, 0, -1}
     };
-    
-    // Generate vertices for each face
+
+    float halfSize = size * 0.5f;
+    float* faceHeights = (float *)MemAlloc(verticesPerFace * sizeof(float));
+    Vector3* displacementNormals = (Vector3 *)MemAlloc(verticesPerFace * sizeof(Vector3));
+
     for (int face = 0; face < 6; face++) {
+        Mesh mesh = { 0 };
+        mesh.vertexCount = verticesPerFace;
+        mesh.triangleCount = trianglesPerFace;
+
+        mesh.vertices = (float *)MemAlloc(verticesPerFace * 3 * sizeof(float));
+        mesh.texcoords = (float *)MemAlloc(verticesPerFace * 2 * sizeof(float));
+        mesh.normals = (float *)MemAlloc(verticesPerFace * 3 * sizeof(float));
+        mesh.colors = (unsigned char *)MemAlloc(verticesPerFace * 4 * sizeof(unsigned char));
+        mesh.indices = (unsigned short *)MemAlloc(trianglesPerFace * 3 * sizeof(unsigned short));
+
         Vector3 normal = faceNormals[face];
         Vector3 u = faceU[face];
         Vector3 v = faceV[face];
-        
+
+        // Gather the face height grid from its patches (shared patch edges hold identical samples)
+        for (int py = 0; py < patchesPerEdge; py++) {
+            for (int px = 0; px < patchesPerEdge; px++) {
+                const float* heights = GetPlanetPatchHeights(cache, (PlanetPatchKey){ face, level, px, py });
+                for (int j = 0; j <= PLANET_PATCH_RESOLUTION; j++) {
+                    for (int i = 0; i <= PLANET_PATCH_RESOLUTION; i++) {
+                        int gx = px * PLANET_PATCH_RESOLUTION + i;
+                        int gy = py * PLANET_PATCH_RESOLUTION + j;
+                        float h = heights ? heights[j * (PLANET_PATCH_RESOLUTION + 1) + i] : 0.0f;
+                        faceHeights[gy * verticesPerRow + gx] = h * heightUnits;
+                    }
+                }
+            }
+        }
+
+        // Displaced positions, same cube/sphere morph as GenMeshTerrainCubeMorphing
         for (int j = 0; j <= segmentsPerFace; j++) {
             for (int i = 0; i <= segmentsPerFace; i++) {
+                int index = j * verticesPerRow + i;
                 float s = (float)i / segmentsPerFace;
                 float t = (float)j / segmentsPerFace;
-                
-                // Calculate base cube vertex position
+
                 Vector3 cubePos;
                 cubePos.x = normal.x * halfSize + u.x * halfSize * (s - 0.5f) * 2.0f + v.x * halfSize * (t - 0.5f) * 2.0f;
                 cubePos.y = normal.y * halfSize + u.y * halfSize * (s - 0.5f) * 2.0f + v.y * halfSize * (t - 0.5f) * 2.0f;
                 cubePos.z = normal.z * halfSize + u.z * halfSize * (s - 0.5f) * 2.0f + v.z * halfSize * (t - 0.5f) * 2.0f;
-                
-                // Calculate sphere position (for morphing)
+
                 float length = sqrtf(cubePos.x * cubePos.x + cubePos.y * cubePos.y + cubePos.z * cubePos.z);
-                Vector3 spherePos = {
-                    cubePos.x / length * halfSize,
-                    cubePos.y / length * halfSize,
-                    cubePos.z / length * halfSize
-                };
-                
-                // Interpolate between cube and sphere based on morphFactor
-                Vector3 basePos = {
-                    cubePos.x * (1.0f - morphFactor) + spherePos.x * morphFactor,
-                    cubePos.y * (1.0f - morphFactor) + spherePos.y * morphFactor,
-                    cubePos.z * (1.0f - morphFactor) + spherePos.z * morphFactor
-                };
-                
-                // Sample terrain height for displacement
-                float terrainHeight = 0.0f;
-                if (terrain && terrain->loaded) {
-                    // Use cube-to-sphere projection for seamless UV mapping
-                    Vector3 normalizedPos = {
-                        cubePos.x / halfSize,
-                        cubePos.y / halfSize,
-                        cubePos.z / halfSize
-                    };
-                    
-                    Vector3 sphereUV = ProjectCubeToSphere(normalizedPos);
-                    
-                    // Convert sphere coordinates to spherical UV coordinates
-                    float phi = atan2f(sphereUV.z, sphereUV.x);
-                    float theta = asinf(sphereUV.y);
-                    
-                    float terrainU = fmodf((phi + PI) / (2.0f * PI) + 1.0f, 1.0f);
-                    float terrainV = fmaxf(0.0f, fminf(1.0f, (theta + PI/2.0f) / PI));
-                    
-                    terrainHeight = SampleTerrainHeight(terrain, terrainU, terrainV) * heightScale * terrain->heightMultiplier;
-                }
-                
-                // Calculate normal for displacement direction
-                Vector3 displacementNormal = {
-                    normal.x * (1.0f - morphFactor) + (basePos.x / halfSize) * morphFactor,
-                    normal.y * (1.0f - morphFactor) + (basePos.y / halfSize) * morphFactor,
-                    normal.z * (1.0f - morphFactor) + (basePos.z / halfSize) * morphFactor
-                };
-                float normalLength = sqrtf(displacementNormal.x * displacementNormal.x + 
-                                         displacementNormal.y * displacementNormal.y + 
-                                         displacementNormal.z * displacementNormal.z);
-                if (normalLength > 0.001f) {
-                    displacementNormal.x /= normalLength;
-                    displacementNormal.y /= normalLength;
-                    displacementNormal.z /= normalLength;
-                }
-                
-                // Apply terrain displacement along normal
-                Vector3 displacement = Vector3Scale(displacementNormal, terrainHeight);
-                Vector3 finalPos = Vector3Add(basePos, displacement);
-                
-                mesh.vertices[vCounter++] = finalPos.x;
-                mesh.vertices[vCounter++] = finalPos.y;
-                mesh.vertices[vCounter++] = finalPos.z;
-                
-                // Use displacement normal as vertex normal
-                mesh.normals[nCounter++] = displacementNormal.x;
-                mesh.normals[nCounter++] = displacementNormal.y;
-                mesh.normals[nCounter++] = displacementNormal.z;
-                
-                // Texture coordinates
-                mesh.texcoords[tcCounter++] = s;
-                mesh.texcoords[tcCounter++] = t;
-                
-                // Apply terrain-based vertex coloring
-                Color vertexColor;
-                if (terrain && terrain->loaded && maxTerrainHeight > 0.0f) {
-                    vertexColor = GetTerrainColorByHeight(terrainHeight, maxTerrainHeight);
-                } else {
-                    // Default cube coloring if no terrain
-                    Color faceColors[6] = {
-                        {255, 100, 100, 255}, // Red front
-                        {100, 255, 100, 255}, // Green back
-                        {100, 100, 255, 255}, // Blue left
-                        {255, 255, 100, 255}, // Yellow right
-                        {255, 100, 255, 255}, // Magenta top
-                        {100, 255, 255, 255}  // Cyan bottom
-                    };
-                    vertexColor = faceColors[face];
+                Vector3 spherePos = Vector3Scale(cubePos, halfSize / length);
+                Vector3 basePos = Vector3Lerp(cubePos, spherePos, morphFactor);
+
+                Vector3 displacementNormal = Vector3Normalize(Vector3Lerp(normal, Vector3Scale(basePos, 1.0f / halfSize), morphFactor));
+                Vector3 finalPos = Vector3Add(basePos, Vector3Scale(displacementNormal, faceHeights[index]));
+
+                displacementNormals[index] = displacementNormal;
+                mesh.vertices[index * 3] = finalPos.x;
+                mesh.vertices[index * 3 + 1] = finalPos.y;
+                mesh.vertices[index * 3 + 2] = finalPos.z;
+
+                mesh.texcoords[index * 2] = s;
+                mesh.texcoords[index * 2 + 1] = t;
+            }
+        }
+
+        // Normals from neighbouring displaced positions, colors and lighting
+        for (int j = 0; j <= segmentsPerFace; j++) {
+            for (int i = 0; i <= segmentsPerFace; i++) {
+                int index = j * verticesPerRow + i;
+                int left = j * verticesPerRow + (i > 0 ? i - 1 : i);
+                int right = j * verticesPerRow + (i < segmentsPerFace ? i + 1 : i);
+                int down = (j > 0 ? j - 1 : j) * verticesPerRow + i;
+                int up = (j < segmentsPerFace ? j + 1 : j) * verticesPerRow + i;
+
+                Vector3 tangentU = Vector3Subtract(
+                    (Vector3){ mesh.vertices[right * 3], mesh.vertices[right * 3 + 1], mesh.vertices[right * 3 + 2] },
+                    (Vector3){ mesh.vertices[left * 3], mesh.vertices[left * 3 + 1], mesh.vertices[left * 3 + 2] });
+                Vector3 tangentV = Vector3Subtract(
+                    (Vector3){ mesh.vertices[up * 3], mesh.vertices[up * 3 + 1], mesh.vertices[up * 3 + 2] },
+                    (Vector3){ mesh.vertices[down * 3], mesh.vertices[down * 3 + 1], mesh.vertices[down * 3 + 2] });
+
+                Vector3 vertexNormal = Vector3Normalize(Vector3CrossProduct(tangentU, tangentV));
+                if (Vector3DotProduct(vertexNormal, displacementNormals[index]) < 0.0f) {
+                    vertexNormal = Vector3Scale(vertexNormal, -1.0f);
                 }
-                
-                // Apply simple lighting
-                Color litColor = CalculateSimpleLighting(finalPos, displacementNormal, vertexColor);
-                
-                mesh.colors[cCounter++] = litColor.r;
-                mesh.colors[cCounter++] = litColor.g;
-                mesh.colors[cCounter++] = litColor.b;
-                mesh.colors[cCounter++] = litColor.a;
+
+                mesh.normals[index * 3] = vertexNormal.x;
+                mesh.normals[index * 3 + 1] = vertexNormal.y;
+                mesh.normals[index * 3 + 2] = vertexNormal.z;
+
+                Vector3 finalPos = { mesh.vertices[index * 3], mesh.vertices[index * 3 + 1], mesh.vertices[index * 3 + 2] };
+                Color vertexColor = GetTerrainColorByHeight(faceHeights[index], maxTerrainHeight);
+                Color litColor = CalculateSimpleLighting(finalPos, vertexNormal, vertexColor);
+
+                mesh.colors[index * 4] = litColor.r;
+                mesh.colors[index * 4 + 1] = litColor.g;
+                mesh.colors[index * 4 + 2] = litColor.b;
+                mesh.colors[index * 4 + 3] = litColor.a;
             }
         }
-        
+
         // Generate indices for this face
+        int iCounter = 0;
         for (int j = 0; j < segmentsPerFace; j++) {
             for (int i = 0; i < segmentsPerFace; i++) {
-                int topLeft = vertexIndex + j * (segmentsPerFace + 1) + i;
+                int topLeft = j * verticesPerRow + i;
                 int topRight = topLeft + 1;
-                int bottomLeft = topLeft + (segmentsPerFace + 1);
+                int bottomLeft = topLeft + verticesPerRow;
                 int bottomRight = bottomLeft + 1;
-                
+
                 // First triangle
                 mesh.indices[iCounter++] = topLeft;
                 mesh.indices[iCounter++] = bottomLeft;
                 mesh.indices[iCounter++] = topRight;
-                
+
                 // Second triangle
                 mesh.indices[iCounter++] = topRight;
                 mesh.indices[iCounter++] = bottomLeft;
                 mesh.indices[iCounter++] = bottomRight;
             }
         }
-        
-        vertexIndex += verticesPerFace;
+
+        UploadMesh(&mesh, false);
+        faceMeshes[face] = mesh;
     }
-    
-    UploadMesh(&mesh, false);
-    return mesh;
+
+    MemFree(displacementNormals);
+    MemFree(faceHeights);
+    MemFree(keys);
 }
 
 // Generate a subdivided cube that can morph towards a sphere
@@ -61,16 +61,11 @@ Mesh GenMeshFloorWithAdvancedLighting(float width, float height, int resX, int r
                 };
             }
             
-            Vector3 vertexPos = { mesh.vertices[vCounter], mesh.vertices[vCounter+1], mesh.vertices[vCounter+2] };
-            Vector3 normal = { mesh.normals[nCounter], mesh.normals[nCounter+1], mesh.normals[nCounter+2] };
-            Vector3 viewDir = { 0.0f, 1.0f, 0.0f }; // Default view direction for pre-calculated lighting
-            
-            Color litColor = CalculateVertexLighting(vertexPos, normal, viewDir, baseColor, lighting, config);
-            
-            mesh.colors[cCounter] = litColor.r;
-            mesh.colors[cCounter+1] = litColor.g;
-            mesh.colors[cCounter+2] = litColor.b;
-            mesh.colors[cCounter+3] = litColor.a;
+            // Base color only, lighting is applied to the whole mesh below
+            mesh.colors[cCounter] = baseColor.r;
+            mesh.colors[cCounter+1] = baseColor.g;
+            mesh.colors[cCounter+2] = baseColor.b;
+            mesh.colors[cCounter+3] = baseColor.a;
             
             vCounter += 3;
             nCounter += 3;
@@ -79,6 +74,9 @@ Mesh GenMeshFloorWithAdvancedLighting(float width, float height, int resX, int r
         }
     }
     
+    // Light all vertices in one batch (default view direction for pre-calculated lighting)
+    CalculateMeshLighting(&mesh, (Vector3){ 0.0f, 1.0f, 0.0f }, lighting, config);
+    
     // Generate indices
     int tCounter = 0;
     for (int quad = 0; quad < (resX-1)*(resZ-1); quad++)
@@ -0,0 +1,229 @@
+#include "planet_lod.h"
+#include "mesh_generation.h"
+#include "thread_pool.h"
+#include "raymath.h"
+#include <stdlib.h>
+#include <string.h>
+
+// One level of a requested build: built by a job, uploaded by the job's completion on the main thread
+typedef struct PlanetLodLevelBuild {
+    struct PlanetLodBuilder* builder;
+    JobHandle job;
+    int level;
+    unsigned int generation;
+    float size;
+    int subdivisions;
+    float heightScale;
+    float heightMultiplier;
+    float morphFactor;
+    Mesh mesh;                              // Built by the job, empty when it was skipped
+    bool handled;                           // Uploaded or dropped, the completion then only frees it
+    struct PlanetLodLevelBuild* next;
+} PlanetLodLevelBuild;
+
+// Build bookkeeping, main thread only. Jobs just read requestedGeneration to skip levels a newer
+// request has made stale.
+struct PlanetLodBuilder {
+    PlanetLodChain* chain;                  // NULL once unloaded, the last completion then frees the builder
+    const TerrainData* terrain;             // The scene's, its heights don't change while the chain exists
+    unsigned int requestedGeneration;
+    int completedLevels;                    // Levels of the requested build uploaded or failed
+    PlanetLodLevelBuild* builds;            // Scheduled builds whose completion hasn't run
+};
+
+// Free a mesh that was never uploaded
+static void FreePlanetLodMesh(Mesh mesh) {
+    MemFree(mesh.vertices);
+    MemFree(mesh.texcoords);
+    MemFree(mesh.normals);
+    MemFree(mesh.colors);
+    MemFree(mesh.indices);
+}
+
+// Job: build one level unless a newer request came in before it started
+static void BuildPlanetLodLevel(void* context) {
+    PlanetLodLevelBuild* build = (PlanetLodLevelBuild*)context;
+    if (__atomic_load_n(&build->builder->requestedGeneration, __ATOMIC_ACQUIRE) != build->generation) return;
+    build->mesh = BuildMeshTerrainCubeMorphing(build->size, build->subdivisions, build->builder->terrain,
+                                               build->heightScale, build->heightMultiplier, build->morphFactor);
+}
+
+// Upload a finished level, or drop it when the chain is gone or a newer build of a level that already
+// has a model is on its way (main thread only)
+static void UploadPlanetLodLevel(PlanetLodLevelBuild* build) {
+    if (build->handled) return;
+    build->handled = true;
+
+    struct PlanetLodBuilder* builder = build->builder;
+    PlanetLodChain* chain = builder->chain;
+    bool current = build->generation == builder->requestedGeneration;
+    if (current) builder->completedLevels++;
+    if (build->mesh.vertexCount == 0) return;
+
+    if (!chain || (!current && chain->models[build->level].meshCount > 0)) {
+        FreePlanetLodMesh(build->mesh);
+        build->mesh = (Mesh){ 0 };
+        return;
+    }
+
+    UploadMesh(&build->mesh, false);
+    if (chain->models[build->level].meshCount > 0) UnloadModel(chain->models[build->level]);
+    chain->models[build->level] = LoadModelFromMesh(build->mesh);
+    if (chain->hasShader) chain->models[build->level].materials[0].shader = chain->shader;
+    build->mesh = (Mesh){ 0 };
+}
+
+// Completion: upload the level and forget the build
+static void CompletePlanetLodLevel(void* context) {
+    PlanetLodLevelBuild* build = (PlanetLodLevelBuild*)context;
+    struct PlanetLodBuilder* builder = build->builder;
+    UploadPlanetLodLevel(build);
+
+    PlanetLodLevelBuild** link = &builder->builds;
+    while (*link != build) link = &(*link)->next;
+    *link = build->next;
+    free(build);
+
+    if (!builder->chain && !builder->builds) free(builder);
+}
+
+// Create a chain for a terrain cube planet, its levels are built on the job system
+PlanetLodChain* CreatePlanetLodChain(const TerrainData* terrain, float size, int finestSubdivisions, float heightScale) {
+    PlanetLodChain* chain = (PlanetLodChain*)calloc(1, sizeof(PlanetLodChain));
+    struct PlanetLodBuilder* builder = (struct PlanetLodBuilder*)calloc(1, sizeof(struct PlanetLodBuilder));
+    if (!chain || !builder) {
+        free(chain);
+        free(builder);
+        TraceLog(LOG_ERROR, "PLANET: Out of memory for the LOD chain");
+        return NULL;
+    }
+    chain->builder = builder;
+    chain->size = size;
+    chain->heightScale = heightScale;
+    chain->currentLevel = 0;
+    builder->chain = chain;
+    builder->terrain = terrain;
+
+    // Every level halves the number of face segments (segments = subdivisions + 1)
+    for (int level = 0; level < PLANET_LOD_LEVELS; level++) {
+        int segments = (finestSubdivisions + 1) >> level;
+        chain->subdivisions[level] = (segments < 2) ? 1 : segments - 1;
+    }
+
+    TraceLog(LOG_INFO, "PLANET: LOD chain created (subdivisions %d/%d/%d/%d)",
+             chain->subdivisions[0], chain->subdivisions[1], chain->subdivisions[2], chain->subdivisions[3]);
+    return chain;
+}
+
+void UnloadPlanetLodChain(PlanetLodChain* chain) {
+    if (!chain) return;
+    struct PlanetLodBuilder* builder = chain->builder;
+
+    // Jobs still running read the scene's heights, so wait for them. Their completions only free what is left.
+    builder->chain = NULL;
+    for (PlanetLodLevelBuild* build = builder->builds; build; build = build->next) {
+        WaitJob(build->job);
+        UploadPlanetLodLevel(build);
+    }
+    if (!builder->builds) free(builder);
+
+    for (int level = 0; level < PLANET_LOD_LEVELS; level++) {
+        if (chain->models[level].meshCount > 0) UnloadModel(chain->models[level]);
+    }
+    free(chain);
+}
+
+// Shader applied to every model in the chain (also to models uploaded later)
+void SetPlanetLodShader(PlanetLodChain* chain, Shader shader) {
+    chain->shader = shader;
+    chain->hasShader = true;
+    for (int level = 0; level < PLANET_LOD_LEVELS; level++) {
+        if (chain->models[level].meshCount > 0) chain->models[level].materials[0].shader = shader;
+    }
+}
+
+// Rebuild all levels on the job system for new height/morph settings
+void RequestPlanetLodBuild(PlanetLodChain* chain, float heightMultiplier, float morphFactor) {
+    struct PlanetLodBuilder* builder = chain->builder;
+    __atomic_store_n(&builder->requestedGeneration, builder->requestedGeneration + 1, __ATOMIC_RELEASE);
+    builder->completedLevels = 0;
+
+    // The level currently on screen first, then the rest from coarse to fine
+    int order[PLANET_LOD_LEVELS];
+    int orderCount = 0;
+    order[orderCount++] = chain->currentLevel;
+    for (int level = PLANET_LOD_LEVELS - 1; level >= 0; level--) {
+        if (level != chain->currentLevel) order[orderCount++] = level;
+    }
+
+    for (int n = 0; n < orderCount; n++) {
+        PlanetLodLevelBuild* build = (PlanetLodLevelBuild*)calloc(1, sizeof(PlanetLodLevelBuild));
+        if (!build) {
+            TraceLog(LOG_WARNING, "PLANET: Out of memory, LOD level %d not rebuilt", order[n]);
+            builder->completedLevels++;
+            continue;
+        }
+        build->builder = builder;
+        build->level = order[n];
+        build->generation = builder->requestedGeneration;
+        build->size = chain->size;
+        build->subdivisions = chain->subdivisions[order[n]];
+        build->heightScale = chain->heightScale;
+        build->heightMultiplier = heightMultiplier;
+        build->morphFactor = morphFactor;
+        build->next = builder->builds;
+        builder->builds = build;
+
+        // Without a pool the job and its completion run right here and the build is already freed
+        JobHandle job = ScheduleJobWithCompletion(BuildPlanetLodLevel, CompletePlanetLodLevel, build, NULL, 0);
+        if (job.generation != 0) build->job = job;
+    }
+}
+
+// Block until the requested build is finished and uploaded
+void WaitPlanetLodBuild(PlanetLodChain* chain) {
+    struct PlanetLodBuilder* builder = chain->builder;
+    for (PlanetLodLevelBuild* build = builder->builds; build; build = build->next) {
+        if (build->generation != builder->requestedGeneration) continue;
+        WaitJob(build->job);
+        UploadPlanetLodLevel(build);
+    }
+}
+
+// Whether every level of the requested build has been uploaded by its completion
+bool IsPlanetLodBuildFinished(const PlanetLodChain* chain) {
+    return chain->builder->completedLevels == PLANET_LOD_LEVELS;
+}
+
+// LOD index for a camera at a given distance from the planet center
+static int GetPlanetLodLevelForDistance(Vector3 center, float distance, float radius) {
+    Vector3 probe = { center.x, center.y, center.z + distance };
+    int subdivisionLevel = CalculateSubdivisionLevel(center, probe, radius, PLANET_LOD_LEVELS);
+    return PLANET_LOD_LEVELS - subdivisionLevel;
+}
+
+// Pick the level for this camera distance
+float UpdatePlanetLodChain(PlanetLodChain* chain, Vector3 center, Vector3 cameraPosition, float radius) {
+    float distance = Vector3Distance(center, cameraPosition);
+
+    // Only switch once the camera is clearly past a band boundary, otherwise keep the current level
+    int nearLevel = GetPlanetLodLevelForDistance(center, distance * (1.0f - PLANET_LOD_HYSTERESIS), radius);
+    int farLevel = GetPlanetLodLevelForDistance(center, distance * (1.0f + PLANET_LOD_HYSTERESIS), radius);
+    if (chain->currentLevel < nearLevel || chain->currentLevel > farLevel) {
+        chain->currentLevel = GetPlanetLodLevelForDistance(center, distance, radius);
+    }
+
+    return distance;
+}
+
+// Model to draw this frame, falls back to the closest built level while the chain is still building
+const Model* GetPlanetLodModel(const PlanetLodChain* chain) {
+    if (!chain) return NULL;
+    for (int offset = 0; offset < PLANET_LOD_LEVELS; offset++) {
+        int finer = chain->currentLevel - offset;
+        int coarser = chain->currentLevel + offset;
+        if (finer >= 0 && chain->models[finer].meshCount > 0) return &chain->models[finer];
+        if (coarser < PLANET_LOD_LEVELS && chain->models[coarser].meshCount > 0) return &chain->models[coarser];
+    }
+    return NULL;
+}
@@ -0,0 +1,315 @@
+#include "planet_noise.h"
+#include "thread_pool.h"
+#include "simd4.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Cube face basis, same orientation as GenMeshTerrainCubeMorphing
+static const Vector3 planetFaceNormals[6] = {
+    {0, 0, -1}, {0, 0, 1}, {-1, 0, 0}, {1, 0, 0}, {0, 1, 0}, {0, -1, 0}
+};
+static const Vector3 planetFaceU[6] = {
+    {1, 0, 0}, {-1, 0, 0}, {0, 0, -1}, {0, 0, 1}, {1, 0, 0}, {1, 0, 0}
+};
+static const Vector3 planetFaceV[6] = {
+    {0, 1, 0}, {0, 1, 0}, {0, 1, 0}, {0, 1, 0}, {0, 0, 1}, {0, 0, -1}
+};
+
+// Lattice hash from tools/heightmap_generator.c extended with a z term, returns [-1, 1]
+static inline float4 HashLattice4(int4 x, int4 y, int4 z, int4 seed131) {
+    int4 n = I4Add(I4Add(x, I4Mul(y, I4Set1(57))), I4Add(I4Mul(z, I4Set1(113)), seed131));
+    n = I4Xor(I4ShiftLeft(n, 13), n);
+    int4 t = I4Add(I4Mul(n, I4Add(I4Mul(I4Mul(n, n), I4Set1(15731)), I4Set1(789221))), I4Set1(1376312589));
+    t = I4And(t, I4Set1(0x7fffffff));
+    return F4Sub(F4Set1(1.0f), F4Mul(I4ToFloat(t), F4Set1(1.0f / 1073741824.0f)));
+}
+
+static inline float4 SmootherStep4(float4 t) {
+    // t * t * t * (t * (t * 6 - 15) + 10)
+    float4 inner = F4MulAdd(t, F4Sub(F4Mul(t, F4Set1(6.0f)), F4Set1(15.0f)), F4Set1(10.0f));
+    return F4Mul(F4Mul(F4Mul(t, t), t), inner);
+}
+
+// Trilinear value noise, the 3D counterpart of perlinNoise() in the heightmap tool
+static inline float4 ValueNoise4(float4 x, float4 y, float4 z, int seed) {
+    float4 fx0 = F4Floor(x), fy0 = F4Floor(y), fz0 = F4Floor(z);
+    int4 xi = F4ToInt(fx0), yi = F4ToInt(fy0), zi = F4ToInt(fz0);
+    int4 one = I4Set1(1);
+    int4 xi1 = I4Add(xi, one), yi1 = I4Add(yi, one), zi1 = I4Add(zi, one);
+    int4 s = I4Set1(seed * 131);
+
+    float4 u = SmootherStep4(F4Sub(x, fx0));
+    float4 v = SmootherStep4(F4Sub(y, fy0));
+    float4 w = SmootherStep4(F4Sub(z, fz0));
+
+    float4 c000 = HashLattice4(xi, yi, zi, s);
+    float4 c100 = HashLattice4(xi1, yi, zi, s);
+    float4 c010 = HashLattice4(xi, yi1, zi, s);
+    float4 c110 = HashLattice4(xi1, yi1, zi, s);
+    float4 c001 = HashLattice4(xi, yi, zi1, s);
+    float4 c101 = HashLattice4(xi1, yi, zi1, s);
+    float4 c011 = HashLattice4(xi, yi1, zi1, s);
+    float4 c111 = HashLattice4(xi1, yi1, zi1, s);
+
+    float4 y0 = F4Lerp(F4Lerp(c000, c100, u), F4Lerp(c010, c110, u), v);
+    float4 y1 = F4Lerp(F4Lerp(c001, c101, u), F4Lerp(c011, c111, u), v);
+    return F4Lerp(y0, y1, w);
+}
+
+// Fractal Brownian Motion with the same octave scheme as fbm() in the heightmap tool
+static inline float4 Fbm4(float4 x, float4 y, float4 z, int octaves, float persistence, float scale, int seed) {
+    float4 value = F4Set1(0.0f);
+    float amplitude = 1.0f;
+    float frequency = scale;
+    float maxValue = 0.0f;
+
+    for (int i = 0; i < octaves; i++) {
+        float4 f = F4Set1(frequency);
+        float4 n = ValueNoise4(F4Mul(x, f), F4Mul(y, f), F4Mul(z, f), seed + i);
+        value = F4MulAdd(n, F4Set1(amplitude), value);
+        maxValue += amplitude;
+        amplitude *= persistence;
+        frequency *= 2.0f;
+    }
+
+    return F4Mul(value, F4Set1(1.0f / maxValue));
+}
+
+// Large, medium and small features blended like GenerateIslandHeightMap (without the island falloff)
+static inline float4 PlanetHeight4(float4 x, float4 y, float4 z, int seed) {
+    float4 largeFeatures = Fbm4(x, y, z, 4, 0.5f, 2.0f, seed);
+    float4 mediumFeatures = Fbm4(x, y, z, 6, 0.4f, 8.0f, seed + 1000);
+    float4 smallFeatures = Fbm4(x, y, z, 8, 0.3f, 32.0f, seed + 2000);
+
+    float4 height = F4Add(F4Add(F4Mul(largeFeatures, F4Set1(0.6f)),
+                                F4Mul(mediumFeatures, F4Set1(0.3f))),
+                          F4Mul(smallFeatures, F4Set1(0.1f)));
+
+    // Normalize to 0-1 range
+    height = F4Mul(F4Add(height, F4Set1(1.0f)), F4Set1(0.5f));
+    return F4Clamp(height, F4Set1(0.0f), F4Set1(1.0f));
+}
+
+// Evaluate the planet fBm height (0-1) for count unit-sphere directions
+void PlanetNoiseHeightBatch(const float* x, const float* y, const float* z, float* heights, int count, int seed) {
+    int i = 0;
+    for (; i + SIMD4_WIDTH <= count; i += SIMD4_WIDTH) {
+        F4Store(&heights[i], PlanetHeight4(F4Load(&x[i]), F4Load(&y[i]), F4Load(&z[i]), seed));
+    }
+
+    // Pad the remainder into a full vector
+    if (i < count) {
+        float px[SIMD4_WIDTH] = {0}, py[SIMD4_WIDTH] = {0}, pz[SIMD4_WIDTH] = {0}, ph[SIMD4_WIDTH];
+        int remaining = count - i;
+        for (int k = 0; k < remaining; k++) {
+            px[k] = x[i + k];
+            py[k] = y[i + k];
+            pz[k] = z[i + k];
+        }
+        F4Store(ph, PlanetHeight4(F4Load(px), F4Load(py), F4Load(pz), seed));
+        for (int k = 0; k < remaining; k++) heights[i + k] = ph[k];
+    }
+}
+
+// Evaluate the planet fBm height (0-1) for a single unit-sphere direction
+float PlanetNoiseHeight(Vector3 direction, int seed) {
+    float height;
+    PlanetNoiseHeightBatch(&direction.x, &direction.y, &direction.z, &height, 1, seed);
+    return height;
+}
+
+// Unit-sphere direction of sample (i, j) inside a patch
+Vector3 GetPlanetPatchDirection(PlanetPatchKey key, int i, int j) {
+    float samplesPerFace = (float)((1 << key.level) * PLANET_PATCH_RESOLUTION);
+    float s = (key.x * PLANET_PATCH_RESOLUTION + i) / samplesPerFace;
+    float t = (key.y * PLANET_PATCH_RESOLUTION + j) / samplesPerFace;
+
+    Vector3 n = planetFaceNormals[key.face];
+    Vector3 u = planetFaceU[key.face];
+    Vector3 v = planetFaceV[key.face];
+
+    Vector3 cubePos = {
+        n.x + u.x * (s - 0.5f) * 2.0f + v.x * (t - 0.5f) * 2.0f,
+        n.y + u.y * (s - 0.5f) * 2.0f + v.y * (t - 0.5f) * 2.0f,
+        n.z + u.z * (s - 0.5f) * 2.0f + v.z * (t - 0.5f) * 2.0f
+    };
+
+    float length = sqrtf(cubePos.x * cubePos.x + cubePos.y * cubePos.y + cubePos.z * cubePos.z);
+    return (Vector3){ cubePos.x / length, cubePos.y / length, cubePos.z / length };
+}
+
+// Pack a patch key into 64 bits: face(3) | level(5) | x(28) | y(28)
+static unsigned long long PackPatchKey(PlanetPatchKey key) {
+    return ((unsigned long long)(key.face & 0x7) << 61) |
+           ((unsigned long long)(key.level & 0x1f) << 56) |
+           ((unsigned long long)(key.x & 0xfffffff) << 28) |
+           (unsigned long long)(key.y & 0xfffffff);
+}
+
+static unsigned int HashPackedKey(unsigned long long k) {
+    k ^= k >> 33;
+    k *= 0xff51afd7ed558ccdULL;
+    k ^= k >> 33;
+    k *= 0xc4ceb9fe1a85ec53ULL;
+    k ^= k >> 33;
+    return (unsigned int)k;
+}
+
+// Find the table position holding this key, or the empty position where it would go
+static int FindTablePosition(const PlanetHeightCache* cache, unsigned long long packedKey) {
+    int mask = cache->tableSize - 1;
+    int pos = (int)(HashPackedKey(packedKey) & (unsigned int)mask);
+    while (cache->table[pos] >= 0 && cache->patches[cache->table[pos]].packedKey != packedKey) {
+        pos = (pos + 1) & mask;
+    }
+    return pos;
+}
+
+// Remove a slot from the table using backward-shift deletion (keeps probe chains intact)
+static void RemoveFromTable(PlanetHeightCache* cache, int slot) {
+    int mask = cache->tableSize - 1;
+    int pos = FindTablePosition(cache, cache->patches[slot].packedKey);
+    if (cache->table[pos] != slot) return;
+
+    int next = pos;
+    while (true) {
+        next = (next + 1) & mask;
+        if (cache->table[next] < 0) break;
+
+        int home = (int)(HashPackedKey(cache->patches[cache->table[next]].packedKey) & (unsigned int)mask);
+        bool canMove = (next > pos) ? (home <= pos || home > next) : (home <= pos && home > next);
+        if (canMove) {
+            cache->table[pos] = cache->table[next];
+            pos = next;
+        }
+    }
+    cache->table[pos] = -1;
+}
+
+// Create a patch height cache
+PlanetHeightCache* CreatePlanetHeightCache(int capacity, int seed) {
+    if (capacity <= 0) capacity = PLANET_DEFAULT_CACHE_PATCHES;
+
+    PlanetHeightCache* cache = (PlanetHeightCache*)MemAlloc(sizeof(PlanetHeightCache));
+    cache->capacity = capacity;
+    cache->patches = (PlanetPatch*)MemAlloc(capacity * sizeof(PlanetPatch));
+    cache->tableSize = 1;
+    while (cache->tableSize < capacity * 2) cache->tableSize <<= 1;
+    cache->table = (int*)MemAlloc(cache->tableSize * sizeof(int));
+    for (int i = 0; i < cache->tableSize; i++) cache->table[i] = -1;
+    cache->seed = seed;
+
+    TraceLog(LOG_INFO, "PLANET: Height cache created (%d patches, %.1f MB)", capacity,
+             capacity * sizeof(PlanetPatch) / (1024.0f * 1024.0f));
+    return cache;
+}
+
+// Destroy a patch height cache
+void UnloadPlanetHeightCache(PlanetHeightCache* cache) {
+    if (!cache) return;
+    MemFree(cache->patches);
+    MemFree(cache->table);
+    MemFree(cache);
+}
+
+// Get cached heights for a patch (NULL if the patch is not resident)
+const float* GetPlanetPatchHeights(const PlanetHeightCache* cache, PlanetPatchKey key) {
+    int pos = FindTablePosition(cache, PackPatchKey(key));
+    int slot = cache->table[pos];
+    return (slot >= 0) ? cache->patches[slot].heights : NULL;
+}
+
+// Pick a free slot, evicting the least recently used patch not touched by the current request
+static int AcquirePatchSlot(PlanetHeightCache* cache) {
+    if (cache->count < cache->capacity) {
+        for (int i = 0; i < cache->capacity; i++) {
+            if (!cache->patches[i].valid) return i;
+        }
+    }
+
+    int victim = -1;
+    for (int i = 0; i < cache->capacity; i++) {
+        const PlanetPatch* patch = &cache->patches[i];
+        if (patch->lastUsed == cache->frame) continue;
+        if (victim < 0 || patch->lastUsed < cache->patches[victim].lastUsed) victim = i;
+    }
+    if (victim < 0) return -1;
+
+    RemoveFromTable(cache, victim);
+    cache->patches[victim].valid = false;
+    cache->count--;
+    return victim;
+}
+
+typedef struct {
+    PlanetHeightCache* cache;
+    const int* slots;
+} PatchEvalJob;
+
+// Evaluate the height samples of patches [start, end) of a PatchEvalJob
+static void EvaluatePatchRange(void* context, int start, int end) {
+    PatchEvalJob* job = (PatchEvalJob*)context;
+    float x[PLANET_PATCH_SAMPLES], y[PLANET_PATCH_SAMPLES], z[PLANET_PATCH_SAMPLES];
+
+    for (int p = start; p < end; p++) {
+        PlanetPatch* patch = &job->cache->patches[job->slots[p]];
+
+        int k = 0;
+        for (int j = 0; j <= PLANET_PATCH_RESOLUTION; j++) {
+            for (int i = 0; i <= PLANET_PATCH_RESOLUTION; i++) {
+                Vector3 dir = GetPlanetPatchDirection(patch->key, i, j);
+                x[k] = dir.x;
+                y[k] = dir.y;
+                z[k] = dir.z;
+                k++;
+            }
+        }
+
+        PlanetNoiseHeightBatch(x, y, z, patch->heights, PLANET_PATCH_SAMPLES, job->cache->seed);
+    }
+}
+
+// Make sure all requested patches are cached, evaluating missing ones in parallel
+void RequestPlanetPatches(PlanetHeightCache* cache, const PlanetPatchKey* keys, int count) {
+    if (count > cache->capacity) {
+        TraceLog(LOG_WARNING, "PLANET: Request for %d patches exceeds cache capacity %d", count, cache->capacity);
+        count = cache->capacity;
+    }
+
+    cache->frame++;
+    int* missing = (int*)MemAlloc(count * sizeof(int));
+    int missingCount = 0;
+
+    for (int k = 0; k < count; k++) {
+        unsigned long long packedKey = PackPatchKey(keys[k]);
+        int pos = FindTablePosition(cache, packedKey);
+
+        if (cache->table[pos] >= 0) {
+            cache->patches[cache->table[pos]].lastUsed = cache->frame;
+            cache->hits++;
+            continue;
+        }
+
+        int slot = AcquirePatchSlot(cache);
+        if (slot < 0) break;
+
+        PlanetPatch* patch = &cache->patches[slot];
+        patch->key = keys[k];
+        patch->packedKey = packedKey;
+        patch->lastUsed = cache->frame;
+        patch->valid = true;
+        cache->count++;
+
+        // Eviction may have shifted table entries, so look the position up again
+        cache->table[FindTablePosition(cache, packedKey)] = slot;
+        missing[missingCount++] = slot;
+        cache->misses++;
+    }
+
+    // Each patch writes only its own slot, so patches are evaluated independently
+    PatchEvalJob job = { cache, missing };
+    ParallelFor(missingCount, 1, EvaluatePatchRange, &job);
+
+    MemFree(missing);
+}
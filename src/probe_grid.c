@@ -0,0 +1,435 @@
+#include "probe_grid.h"
+#include "lighting.h"
+#include "lightmap.h"
+#include "maze.h"
+#include "thread_pool.h"
+#include "raymath.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define PROBE_SURFACE_BIAS 0.01f    // Shadow rays start this far off the hit surface
+
+static const Color probeFloorAlbedo = { 90, 135, 90, 255 };
+static const Color probeWallAlbedo = { 140, 80, 80, 255 };
+
+struct ProbeBakeTask {
+    JobHandle bake;
+    JobHandle save;             // Writes the cache file once the bake is done
+    Maze maze;
+    LightingSystem lighting;    // Copy with its own light array
+    ProbeGrid* result;
+};
+
+typedef struct {
+    const Maze* maze;
+    Light* lights;              // Enabled static lights
+    int lightCount;
+    GraphicsConfig config;      // Advanced shading without specular, like the lightmap's diffuse
+    Vector3 sky;                // Radiance of rays that escape upwards (the flat ambient)
+    Vector3 directions[PROBE_RAYS];
+    float weights[PROBE_RAYS][PROBE_SH_COEFFICIENTS];
+    ProbeGrid* grid;
+} ProbeBakeJob;
+
+// L2 basis without its normalization: 1, y, z, x, xy, yz, 3z^2 - 1, xz, x^2 - y^2
+static void GetProbeBasis(Vector3 n, float basis[PROBE_SH_COEFFICIENTS]) {
+    basis[0] = 1.0f;
+    basis[1] = n.y;
+    basis[2] = n.z;
+    basis[3] = n.x;
+    basis[4] = n.x * n.y;
+    basis[5] = n.y * n.z;
+    basis[6] = 3.0f * n.z * n.z - 1.0f;
+    basis[7] = n.x * n.z;
+    basis[8] = n.x * n.x - n.y * n.y;
+}
+
+// Fibonacci sphere directions, and each direction's projection weight. The weight folds in the squared
+// SH normalization, the Monte Carlo solid angle (4 PI / rays) and the cosine-lobe convolution divided by PI
+// (1, 2/3, 1/4 per band), so evaluating the stored coefficients directly gives irradiance / PI.
+static void InitProbeRays(ProbeBakeJob* job) {
+    const float normalization[PROBE_SH_COEFFICIENTS] = {
+        0.282095f, 0.488603f, 0.488603f, 0.488603f, 1.092548f, 1.092548f, 0.315392f, 1.092548f, 0.546274f
+    };
+    const float band[PROBE_SH_COEFFICIENTS] = { 1.0f, 2.0f / 3.0f, 2.0f / 3.0f, 2.0f / 3.0f, 0.25f, 0.25f, 0.25f, 0.25f, 0.25f };
+    const float goldenAngle = PI * (3.0f - sqrtf(5.0f));
+
+    for (int i = 0; i < PROBE_RAYS; i++) {
+        float y = 1.0f - (i + 0.5f) * 2.0f / PROBE_RAYS;
+        float radius = sqrtf(1.0f - y * y);
+        float azimuth = goldenAngle * i;
+        job->directions[i] = (Vector3){ radius * cosf(azimuth), y, radius * sinf(azimuth) };
+
+        float basis[PROBE_SH_COEFFICIENTS];
+        GetProbeBasis(job->directions[i], basis);
+        for (int k = 0; k < PROBE_SH_COEFFICIENTS; k++) {
+            job->weights[i][k] = normalization[k] * normalization[k] * basis[k] * (4.0f * PI / PROBE_RAYS) * band[k];
+        }
+    }
+}
+
+// Radiance arriving at a probe from one direction: the lit surface it hits, or the sky
+static Vector3 TraceProbeRay(const ProbeBakeJob* job, Vector3 origin, Vector3 dir) {
+    float distance;
+    Vector3 normal;
+    if (!MazeRaycast(job->maze, origin, dir, PROBE_MAX_DISTANCE, &distance, &normal)) {
+        return (dir.y > 0.0f) ? job->sky : Vector3Zero();
+    }
+
+    Vector3 position = Vector3Add(Vector3Add(origin, Vector3Scale(dir, distance)), Vector3Scale(normal, PROBE_SURFACE_BIAS));
+    bool floor = normal.y > 0.5f && position.y < 1.0f;
+    Color albedo = floor ? probeFloorAlbedo : probeWallAlbedo;
+
+    // The surface sees roughly the same sky as the probe, plus the static lights that reach it
+    Vector3 light = job->sky;
+    for (int i = 0; i < job->lightCount; i++) {
+        LightingSystem single = { 0 };
+        single.lights = &job->lights[i];
+        single.lightCount = 1;
+        Color lit = CalculateVertexLighting(position, normal, normal, WHITE, &single, &job->config);
+        if (lit.r == 0 && lit.g == 0 && lit.b == 0) continue;
+
+        const Light* source = &job->lights[i];
+        Vector3 toLight;
+        float lightDistance;
+        if (source->type == LIGHT_DIRECTIONAL) {
+            toLight = Vector3Negate(source->direction);
+            lightDistance = PROBE_MAX_DISTANCE;
+        } else {
+            toLight = Vector3Subtract(source->position, position);
+            lightDistance = Vector3Length(toLight);
+            toLight = Vector3Scale(toLight, 1.0f / fmaxf(lightDistance, 1e-6f));
+        }
+        if (MazeRaycast(job->maze, position, toLight, lightDistance, NULL, NULL)) continue;
+
+        light.x += lit.r / 255.0f;
+        light.y += lit.g / 255.0f;
+        light.z += lit.b / 255.0f;
+    }
+
+    return (Vector3){
+        albedo.r / 255.0f * light.x * PROBE_INDIRECT_STRENGTH,
+        albedo.g / 255.0f * light.y * PROBE_INDIRECT_STRENGTH,
+        albedo.b / 255.0f * light.z * PROBE_INDIRECT_STRENGTH
+    };
+}
+
+static void BakeProbes(void* context, int start, int end) {
+    const ProbeBakeJob* job = (const ProbeBakeJob*)context;
+    ProbeGrid* grid = job->grid;
+
+    for (int p = start; p < end; p++) {
+        float* coefficients = &grid->coefficients[p * PROBE_SH_COEFFICIENTS * 3];
+        memset(coefficients, 0, PROBE_SH_COEFFICIENTS * 3 * sizeof(float));
+        if (!grid->valid[p]) continue;
+
+        int x = p % grid->sizeX;
+        int y = (p / grid->sizeX) % grid->sizeY;
+        int z = p / (grid->sizeX * grid->sizeY);
+        Vector3 origin = { grid->origin.x + x * grid->spacing, grid->origin.y + y * grid->spacing, grid->origin.z + z * grid->spacing };
+
+        for (int i = 0; i < PROBE_RAYS; i++) {
+            Vector3 radiance = TraceProbeRay(job, origin, job->directions[i]);
+            for (int k = 0; k < PROBE_SH_COEFFICIENTS; k++) {
+                coefficients[k] += radiance.x * job->weights[i][k];
+                coefficients[PROBE_SH_COEFFICIENTS + k] += radiance.y * job->weights[i][k];
+                coefficients[PROBE_SH_COEFFICIENTS * 2 + k] += radiance.z * job->weights[i][k];
+            }
+        }
+    }
+}
+
+// FNV-1a over raw bytes
+static unsigned long long HashProbeBytes(unsigned long long hash, const void* data, size_t size) {
+    const unsigned char* bytes = (const unsigned char*)data;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+// Settings the probes are always baked with, whatever the current graphics settings are
+static GraphicsConfig GetProbeBakeConfig(void) {
+    GraphicsConfig config = { 0 };
+    config.advancedShadingEnabled = true;
+    config.specularStrength = 0.0f;
+    config.shininess = 32.0f;
+    return config;
+}
+
+// Cache key for a maze probe grid: maze contents, static lights and ambient light
+unsigned long long GetMazeProbeKey(const Maze* maze, const LightingSystem* lighting) {
+    // The lightmap key covers the maze and static lights, the probes must not depend on themselves
+    LightingSystem sceneLights = *lighting;
+    sceneLights.ambientProbes = NULL;
+    GraphicsConfig config = GetProbeBakeConfig();
+    unsigned long long hash = GetMazeLightmapKey(maze, &sceneLights, &config, MAZE_CELL_SIZE, PROBE_RAYS);
+
+    int version = PROBE_BAKE_VERSION;
+    hash = HashProbeBytes(hash, "SHPG", 4);
+    hash = HashProbeBytes(hash, &version, sizeof(version));
+    return hash;
+}
+
+static ProbeGrid* AllocateProbeGrid(int sizeX, int sizeY, int sizeZ) {
+    ProbeGrid* grid = (ProbeGrid*)calloc(1, sizeof(ProbeGrid));
+    if (!grid) return NULL;
+    grid->sizeX = sizeX;
+    grid->sizeY = sizeY;
+    grid->sizeZ = sizeZ;
+    grid->probeCount = sizeX * sizeY * sizeZ;
+    grid->coefficients = (float*)malloc(grid->probeCount * PROBE_SH_COEFFICIENTS * 3 * sizeof(float));
+    grid->valid = (unsigned char*)malloc(grid->probeCount);
+    if (!grid->coefficients || !grid->valid) {
+        UnloadProbeGrid(grid);
+        return NULL;
+    }
+    return grid;
+}
+
+ProbeGrid* BakeMazeProbeGrid(const Maze* maze, const LightingSystem* lighting) {
+    if (maze->width <= 0 || maze->height <= 0) return NULL;
+    ProbeGrid* grid = AllocateProbeGrid(maze->width, PROBE_LAYERS, maze->height);
+    if (!grid) return NULL;
+
+    // Probes sit at the cell centers, the lower layer inside wall cells is buried
+    Vector2 gridOrigin = GetMazeGridOrigin(maze);
+    grid->spacing = MAZE_CELL_SIZE;
+    grid->origin = (Vector3){ gridOrigin.x + MAZE_CELL_SIZE / 2.0f, PROBE_FLOOR_HEIGHT, gridOrigin.y + MAZE_CELL_SIZE / 2.0f };
+    grid->fallback = (Vector3){
+        lighting->ambientColor.r * lighting->ambientIntensity / 255.0f,
+        lighting->ambientColor.g * lighting->ambientIntensity / 255.0f,
+        lighting->ambientColor.b * lighting->ambientIntensity / 255.0f
+    };
+    grid->key = GetMazeProbeKey(maze, lighting);
+    for (int p = 0; p < grid->probeCount; p++) {
+        int x = p % grid->sizeX;
+        int y = (p / grid->sizeX) % grid->sizeY;
+        int z = p / (grid->sizeX * grid->sizeY);
+        float height = grid->origin.y + y * grid->spacing;
+        grid->valid[p] = (height < MAZE_WALL_TOP && MazeIsWall(maze, x, z)) ? 0 : 1;
+    }
+
+    ProbeBakeJob* job = (ProbeBakeJob*)calloc(1, sizeof(ProbeBakeJob));
+    if (!job) {
+        UnloadProbeGrid(grid);
+        return NULL;
+    }
+    job->maze = maze;
+    job->grid = grid;
+    job->config = GetProbeBakeConfig();
+    job->sky = grid->fallback;
+    InitProbeRays(job);
+
+    // Moving lights are left to the runtime lighting
+    job->lights = (Light*)malloc((lighting->lightCount > 0 ? lighting->lightCount : 1) * sizeof(Light));
+    if (!job->lights) {
+        free(job);
+        UnloadProbeGrid(grid);
+        return NULL;
+    }
+    for (int i = 0; i < lighting->lightCount; i++) {
+        if (lighting->lights[i].enabled && !lighting->lights[i].dynamic) job->lights[job->lightCount++] = lighting->lights[i];
+    }
+
+    double start = GetTime();
+    ParallelFor(grid->probeCount, 4, BakeProbes, job);
+    TraceLog(LOG_INFO, "PROBES: Baked %dx%dx%d probe grid in %.1f ms", grid->sizeX, grid->sizeY, grid->sizeZ,
+             (GetTime() - start) * 1000.0);
+
+    free(job->lights);
+    free(job);
+    return grid;
+}
+
+bool SaveProbeGrid(const ProbeGrid* grid, const char* path) {
+    FILE* file = fopen(path, "wb");
+    if (!file) {
+        TraceLog(LOG_WARNING, "PROBES: Failed to write %s", path);
+        return false;
+    }
+
+    int version = PROBE_BAKE_VERSION;
+    fwrite("SHPG", 1, 4, file);
+    fwrite(&version, sizeof(version), 1, file);
+    fwrite(&grid->key, sizeof(grid->key), 1, file);
+    fwrite(&grid->sizeX, sizeof(grid->sizeX), 1, file);
+    fwrite(&grid->sizeY, sizeof(grid->sizeY), 1, file);
+    fwrite(&grid->sizeZ, sizeof(grid->sizeZ), 1, file);
+    fwrite(&grid->origin, sizeof(grid->origin), 1, file);
+    fwrite(&grid->spacing, sizeof(grid->spacing), 1, file);
+    fwrite(&grid->fallback, sizeof(grid->fallback), 1, file);
+    fwrite(grid->valid, 1, grid->probeCount, file);
+    bool written = fwrite(grid->coefficients, sizeof(float) * PROBE_SH_COEFFICIENTS * 3, grid->probeCount, file) == (size_t)grid->probeCount;
+    fclose(file);
+    return written;
+}
+
+// NULL if the file is missing, from another bake version or truncated
+ProbeGrid* LoadProbeGrid(const char* path) {
+    FILE* file = fopen(path, "rb");
+    if (!file) return NULL;
+
+    char magic[4];
+    int version = 0, sizeX = 0, sizeY = 0, sizeZ = 0;
+    unsigned long long key = 0;
+    bool valid = fread(magic, 1, 4, file) == 4 && memcmp(magic, "SHPG", 4) == 0 &&
+                 fread(&version, sizeof(version), 1, file) == 1 && version == PROBE_BAKE_VERSION &&
+                 fread(&key, sizeof(key), 1, file) == 1 &&
+                 fread(&sizeX, sizeof(sizeX), 1, file) == 1 && sizeX > 0 && sizeX <= 4096 &&
+                 fread(&sizeY, sizeof(sizeY), 1, file) == 1 && sizeY > 0 && sizeY <= 4096 &&
+                 fread(&sizeZ, sizeof(sizeZ), 1, file) == 1 && sizeZ > 0 && sizeZ <= 4096;
+
+    ProbeGrid* grid = valid ? AllocateProbeGrid(sizeX, sizeY, sizeZ) : NULL;
+    if (grid) {
+        grid->key = key;
+        valid = fread(&grid->origin, sizeof(grid->origin), 1, file) == 1 &&
+                fread(&grid->spacing, sizeof(grid->spacing), 1, file) == 1 && grid->spacing > 0.0f &&
+                fread(&grid->fallback, sizeof(grid->fallback), 1, file) == 1 &&
+                fread(grid->valid, 1, grid->probeCount, file) == (size_t)grid->probeCount &&
+                fread(grid->coefficients, sizeof(float) * PROBE_SH_COEFFICIENTS * 3, grid->probeCount, file) == (size_t)grid->probeCount;
+    }
+    fclose(file);
+
+    if (!grid || !valid) {
+        UnloadProbeGrid(grid);
+        TraceLog(LOG_WARNING, "PROBES: Ignoring invalid probe file %s", path);
+        return NULL;
+    }
+    return grid;
+}
+
+static void GetProbeCachePath(unsigned long long key, char* path, size_t size) {
+    snprintf(path, size, "probes_%016llx.bin", key);
+}
+
+ProbeGrid* LoadOrBakeMazeProbeGrid(const Maze* maze, const LightingSystem* lighting) {
+    unsigned long long key = GetMazeProbeKey(maze, lighting);
+    char path[64];
+    GetProbeCachePath(key, path, sizeof(path));
+
+    ProbeGrid* grid = LoadProbeGrid(path);
+    if (grid && grid->key == key) {
+        TraceLog(LOG_INFO, "PROBES: Loaded %dx%dx%d probe grid from cache", grid->sizeX, grid->sizeY, grid->sizeZ);
+        return grid;
+    }
+    UnloadProbeGrid(grid);
+
+    grid = BakeMazeProbeGrid(maze, lighting);
+    if (grid) SaveProbeGrid(grid, path);
+    return grid;
+}
+
+// Irradiance multiplier at a point for a surface normal, trilinear between the valid probes around it
+Vector3 EvaluateProbeGrid(const ProbeGrid* grid, Vector3 position, Vector3 normal) {
+    float cell[3] = {
+        (position.x - grid->origin.x) / grid->spacing,
+        (position.y - grid->origin.y) / grid->spacing,
+        (position.z - grid->origin.z) / grid->spacing
+    };
+    int size[3] = { grid->sizeX, grid->sizeY, grid->sizeZ };
+    int base[3];
+    float t[3];
+    for (int a = 0; a < 3; a++) {
+        float c = fminf(fmaxf(cell[a], 0.0f), (float)(size[a] - 1));
+        base[a] = (int)c;
+        if (base[a] > size[a] - 2) base[a] = (size[a] >= 2) ? size[a] - 2 : 0;
+        t[a] = fminf(c - base[a], 1.0f);
+    }
+
+    // Blend the coefficients of the (up to) eight surrounding probes, skipping buried ones
+    float blended[PROBE_SH_COEFFICIENTS * 3] = { 0 };
+    float totalWeight = 0.0f;
+    for (int corner = 0; corner < 8; corner++) {
+        int index[3];
+        float weight = 1.0f;
+        for (int a = 0; a < 3; a++) {
+            int offset = (corner >> a) & 1;
+            index[a] = base[a] + offset;
+            if (index[a] >= size[a]) index[a] = size[a] - 1;
+            weight *= offset ? t[a] : 1.0f - t[a];
+        }
+        int p = (index[2] * grid->sizeY + index[1]) * grid->sizeX + index[0];
+        if (weight <= 0.0f || !grid->valid[p]) continue;
+
+        const float* coefficients = &grid->coefficients[p * PROBE_SH_COEFFICIENTS * 3];
+        for (int k = 0; k < PROBE_SH_COEFFICIENTS * 3; k++) blended[k] += coefficients[k] * weight;
+        totalWeight += weight;
+    }
+    if (totalWeight < 1e-4f) return grid->fallback;
+
+    float basis[PROBE_SH_COEFFICIENTS];
+    GetProbeBasis(normal, basis);
+    Vector3 irradiance = { 0.0f, 0.0f, 0.0f };
+    for (int k = 0; k < PROBE_SH_COEFFICIENTS; k++) {
+        irradiance.x += blended[k] * basis[k];
+        irradiance.y += blended[PROBE_SH_COEFFICIENTS + k] * basis[k];
+        irradiance.z += blended[PROBE_SH_COEFFICIENTS * 2 + k] * basis[k];
+    }
+
+    // L2 ringing can dip below zero behind bright lobes
+    float scale = 1.0f / totalWeight;
+    return (Vector3){ fmaxf(irradiance.x * scale, 0.0f), fmaxf(irradiance.y * scale, 0.0f), fmaxf(irradiance.z * scale, 0.0f) };
+}
+
+void UnloadProbeGrid(ProbeGrid* grid) {
+    if (!grid) return;
+    free(grid->coefficients);
+    free(grid->valid);
+    free(grid);
+}
+
+static void RunProbeBake(void* context) {
+    ProbeBakeTask* task = (ProbeBakeTask*)context;
+    task->result = BakeMazeProbeGrid(&task->maze, &task->lighting);
+}
+
+static void SaveBakedProbeGrid(void* context) {
+    ProbeBakeTask* task = (ProbeBakeTask*)context;
+    if (!task->result) return;
+    char path[64];
+    GetProbeCachePath(task->result->key, path, sizeof(path));
+    SaveProbeGrid(task->result, path);
+}
+
+ProbeBakeTask* StartMazeProbeBake(const Maze* maze, const LightingSystem* lighting) {
+    ProbeBakeTask* task = (ProbeBakeTask*)calloc(1, sizeof(ProbeBakeTask));
+    if (!task) return NULL;
+    task->maze = CopyMaze(maze);
+    task->lighting = *lighting;
+    task->lighting.ambientProbes = NULL;
+    task->lighting.cache = NULL;
+    task->lighting.lights = NULL;
+    task->lighting.lightCapacity = task->lighting.lightCount;
+    if (lighting->lightCount > 0) {
+        task->lighting.lights = (Light*)malloc(lighting->lightCount * sizeof(Light));
+        if (!task->lighting.lights) {
+            UnloadMaze(&task->maze);
+            free(task);
+            return NULL;
+        }
+        memcpy(task->lighting.lights, lighting->lights, lighting->lightCount * sizeof(Light));
+    }
+
+    task->bake = ScheduleJob(RunProbeBake, task, NULL, 0);
+    task->save = ScheduleJob(SaveBakedProbeGrid, task, &task->bake, 1);
+    return task;
+}
+
+bool IsProbeBakeFinished(ProbeBakeTask* task) {
+    return IsJobDone(task->save);
+}
+
+ProbeGrid* FinishProbeBake(ProbeBakeTask* task) {
+    if (!task) return NULL;
+    WaitJob(task->save);
+
+    ProbeGrid* grid = task->result;
+    free(task->lighting.lights);
+    UnloadMaze(&task->maze);
+    free(task);
+    return grid;
+}
@@ -0,0 +1,369 @@
+#include "relight.h"
+#include "lighting.h"
+#include "probe_grid.h"
+#include "arena.h"
+#include "raymath.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define RELIGHT_MAX_CELLS 1048576
+
+// Create an empty grid (cellSize <= 0 uses RELIGHT_CELL_SIZE)
+RelightGrid* CreateRelightGrid(float cellSize) {
+    RelightGrid* grid = (RelightGrid*)calloc(1, sizeof(RelightGrid));
+    if (!grid) {
+        TraceLog(LOG_WARNING, "RELIGHT: Out of memory for the relight grid");
+        return NULL;
+    }
+    grid->cellSize = (cellSize > 0.0f) ? cellSize : RELIGHT_CELL_SIZE;
+    return grid;
+}
+
+void UnloadRelightGrid(RelightGrid* grid) {
+    if (!grid) return;
+    for (int m = 0; m < grid->meshCount; m++) {
+        free(grid->meshes[m].albedo);
+    }
+    free(grid->cellStart);
+    free(grid->cellVertices);
+    free(grid->cellDirty);
+    free(grid->litLights);
+    if (grid->scratchCapacity > 0) {
+        free(grid->scratchPositions);
+        free(grid->scratchNormals);
+        free(grid->scratchColors);
+        free(grid->scratchIndices);
+    }
+    if (grid->scratchLightCapacity > 0) free(grid->scratchLights);
+    UnloadLightCache(grid->dynamicLightCache);
+    free(grid);
+}
+
+// Register a mesh whose colors currently hold unlit base colors
+int AddRelightMesh(RelightGrid* grid, Mesh* mesh) {
+    if (!grid || grid->meshCount >= RELIGHT_MAX_MESHES || !mesh->colors || !mesh->normals) return -1;
+
+    RelightMesh* relight = &grid->meshes[grid->meshCount];
+    relight->albedo = (unsigned char*)malloc(mesh->vertexCount * 4);
+    if (!relight->albedo) return -1;
+    relight->mesh = mesh;
+    memcpy(relight->albedo, mesh->colors, mesh->vertexCount * 4);
+    relight->firstVertex = grid->vertexCount;
+    relight->dirtyMin = mesh->vertexCount;
+    relight->dirtyMax = -1;
+
+    grid->vertexCount += mesh->vertexCount;
+    grid->built = false;
+    grid->litValid = false;
+    return grid->meshCount++;
+}
+
+// Grid cell of a position (clamped, every vertex lies inside the grid bounds)
+static int GetRelightCell(const RelightGrid* grid, const float* position) {
+    int cx = (int)((position[0] - grid->origin.x) / grid->cellSize);
+    int cy = (int)((position[1] - grid->origin.y) / grid->cellSize);
+    int cz = (int)((position[2] - grid->origin.z) / grid->cellSize);
+    cx = (cx < 0) ? 0 : (cx >= grid->sizeX ? grid->sizeX - 1 : cx);
+    cy = (cy < 0) ? 0 : (cy >= grid->sizeY ? grid->sizeY - 1 : cy);
+    cz = (cz < 0) ? 0 : (cz >= grid->sizeZ ? grid->sizeZ - 1 : cz);
+    return (cz * grid->sizeY + cy) * grid->sizeX + cx;
+}
+
+// Bucket all registered vertices into cells, false when out of memory
+static bool BuildRelightCells(RelightGrid* grid) {
+    BoundingBox bounds = GetMeshBoundingBox(*grid->meshes[0].mesh);
+    for (int m = 1; m < grid->meshCount; m++) {
+        BoundingBox meshBounds = GetMeshBoundingBox(*grid->meshes[m].mesh);
+        bounds.min = Vector3Min(bounds.min, meshBounds.min);
+        bounds.max = Vector3Max(bounds.max, meshBounds.max);
+    }
+
+    Vector3 extent = Vector3Subtract(bounds.max, bounds.min);
+    while (true) {
+        grid->sizeX = (int)(extent.x / grid->cellSize) + 1;
+        grid->sizeY = (int)(extent.y / grid->cellSize) + 1;
+        grid->sizeZ = (int)(extent.z / grid->cellSize) + 1;
+        if ((long long)grid->sizeX * grid->sizeY * grid->sizeZ <= RELIGHT_MAX_CELLS) break;
+        grid->cellSize *= 1.25f;
+    }
+    grid->origin = bounds.min;
+    grid->cellCount = grid->sizeX * grid->sizeY * grid->sizeZ;
+
+    free(grid->cellStart);
+    free(grid->cellVertices);
+    free(grid->cellDirty);
+    grid->cellStart = (int*)calloc(grid->cellCount + 1, sizeof(int));
+    grid->cellVertices = (int*)malloc((grid->vertexCount > 0 ? grid->vertexCount : 1) * sizeof(int));
+    grid->cellDirty = (unsigned char*)calloc(grid->cellCount, 1);
+    if (!grid->cellStart || !grid->cellVertices || !grid->cellDirty) {
+        free(grid->cellStart);
+        free(grid->cellVertices);
+        free(grid->cellDirty);
+        grid->cellStart = NULL;
+        grid->cellVertices = NULL;
+        grid->cellDirty = NULL;
+        grid->cellCount = 0;
+        return false;
+    }
+
+    // Count, inclusive prefix sum, then fill back to front so cells list their vertices in ascending order
+    for (int m = 0; m < grid->meshCount; m++) {
+        const Mesh* mesh = grid->meshes[m].mesh;
+        for (int v = 0; v < mesh->vertexCount; v++) grid->cellStart[GetRelightCell(grid, &mesh->vertices[v * 3])]++;
+    }
+    int total = 0;
+    for (int c = 0; c < grid->cellCount; c++) {
+        total += grid->cellStart[c];
+        grid->cellStart[c] = total;
+    }
+    grid->cellStart[grid->cellCount] = total;
+    for (int m = grid->meshCount - 1; m >= 0; m--) {
+        const Mesh* mesh = grid->meshes[m].mesh;
+        for (int v = mesh->vertexCount - 1; v >= 0; v--) {
+            int cell = GetRelightCell(grid, &mesh->vertices[v * 3]);
+            grid->cellVertices[--grid->cellStart[cell]] = grid->meshes[m].firstVertex + v;
+        }
+    }
+
+    grid->built = true;
+    return true;
+}
+
+// Mark the cells touched by a light sphere
+static void MarkRelightSphere(RelightGrid* grid, Vector3 center, float range) {
+    float c[3] = { center.x, center.y, center.z };
+    float origin[3] = { grid->origin.x, grid->origin.y, grid->origin.z };
+    int size[3] = { grid->sizeX, grid->sizeY, grid->sizeZ };
+    int cellMin[3], cellMax[3];
+    for (int axis = 0; axis < 3; axis++) {
+        cellMin[axis] = (int)floorf((c[axis] - range - origin[axis]) / grid->cellSize);
+        cellMax[axis] = (int)floorf((c[axis] + range - origin[axis]) / grid->cellSize);
+        if (cellMax[axis] < 0 || cellMin[axis] >= size[axis]) return;
+        if (cellMin[axis] < 0) cellMin[axis] = 0;
+        if (cellMax[axis] >= size[axis]) cellMax[axis] = size[axis] - 1;
+    }
+
+    float rangeSqr = range * range;
+    for (int z = cellMin[2]; z <= cellMax[2]; z++) {
+        for (int y = cellMin[1]; y <= cellMax[1]; y++) {
+            for (int x = cellMin[0]; x <= cellMax[0]; x++) {
+                float boxMin[3] = { origin[0] + x * grid->cellSize, origin[1] + y * grid->cellSize, origin[2] + z * grid->cellSize };
+                float distanceSqr = 0.0f;
+                for (int axis = 0; axis < 3; axis++) {
+                    float d = fmaxf(fmaxf(boxMin[axis] - c[axis], 0.0f), c[axis] - (boxMin[axis] + grid->cellSize));
+                    distanceSqr += d * d;
+                }
+                if (distanceSqr <= rangeSqr) grid->cellDirty[(z * grid->sizeY + y) * grid->sizeX + x] = 1;
+            }
+        }
+    }
+}
+
+static unsigned long long GetRelightProbeKey(const LightingSystem* lighting) {
+    return lighting->ambientProbes ? lighting->ambientProbes->key : 0;
+}
+
+static bool LightChanged(const Light* a, const Light* b) {
+    return a->type != b->type || a->enabled != b->enabled || a->intensity != b->intensity || a->range != b->range ||
+           a->spotAngle != b->spotAngle || a->color.r != b->color.r || a->color.g != b->color.g || a->color.b != b->color.b ||
+           a->position.x != b->position.x || a->position.y != b->position.y || a->position.z != b->position.z ||
+           a->direction.x != b->direction.x || a->direction.y != b->direction.y || a->direction.z != b->direction.z;
+}
+
+// Mark cells affected by light changes, false if everything has to be relit
+static bool MarkChangedLights(RelightGrid* grid, const LightingSystem* lighting, const GraphicsConfig* config) {
+    bool advanced = config && config->advancedShadingEnabled;
+    if (!grid->litValid || grid->litAdvanced != advanced || grid->litLightCount != lighting->lightCount) return false;
+    if (!advanced) return true;     // Simple sun lighting ignores the lights
+    if (grid->litSpecularStrength != config->specularStrength || grid->litShininess != config->shininess) return false;
+    if (grid->litProbeKey != GetRelightProbeKey(lighting)) return false;
+    if (grid->litVersion == lighting->version) return true;
+
+    for (int i = 0; i < lighting->lightCount; i++) {
+        const Light* oldLight = &grid->litLights[i];
+        const Light* newLight = &lighting->lights[i];
+        if (!LightChanged(oldLight, newLight)) continue;
+
+        // Directional lights reach every vertex
+        if (oldLight->type == LIGHT_DIRECTIONAL || newLight->type == LIGHT_DIRECTIONAL) return false;
+        if (oldLight->enabled) MarkRelightSphere(grid, oldLight->position, oldLight->range);
+        if (newLight->enabled) MarkRelightSphere(grid, newLight->position, newLight->range);
+    }
+    return true;
+}
+
+// Remember the lights and settings the vertices are now lit with. Without room for the lights the snapshot
+// is left invalid, so the next update relights everything.
+static void SnapshotRelightLights(RelightGrid* grid, const LightingSystem* lighting, const GraphicsConfig* config) {
+    if (lighting->lightCount > grid->litLightCapacity) {
+        free(grid->litLights);
+        grid->litLights = (Light*)malloc(lighting->lightCount * sizeof(Light));
+        grid->litLightCapacity = grid->litLights ? lighting->lightCount : 0;
+        if (!grid->litLights) {
+            grid->litValid = false;
+            return;
+        }
+    }
+    if (lighting->lightCount > 0) {
+        memcpy(grid->litLights, lighting->lights, lighting->lightCount * sizeof(Light));
+    }
+    grid->litLightCount = lighting->lightCount;
+    grid->litVersion = lighting->version;
+    grid->litAdvanced = config && config->advancedShadingEnabled;
+    grid->litSpecularStrength = config ? config->specularStrength : 0.0f;
+    grid->litShininess = config ? config->shininess : 0.0f;
+    grid->litProbeKey = GetRelightProbeKey(lighting);
+    grid->litValid = true;
+}
+
+// Gather buffers for count vertices: from the scratch arena when the grid has one (valid until its
+// reset, so they are taken again on every update), otherwise grown buffers of the grid's own.
+// False when out of memory.
+static bool ReserveRelightScratch(RelightGrid* grid, int count) {
+    if (grid->scratchCapacity > 0 && (grid->scratchArena || count > grid->scratchCapacity)) {
+        free(grid->scratchPositions);
+        free(grid->scratchNormals);
+        free(grid->scratchColors);
+        free(grid->scratchIndices);
+        grid->scratchCapacity = 0;
+    }
+    if (grid->scratchArena) {
+        grid->scratchPositions = (float*)ArenaAlloc(grid->scratchArena, count * 3 * sizeof(float));
+        grid->scratchNormals = (float*)ArenaAlloc(grid->scratchArena, count * 3 * sizeof(float));
+        grid->scratchColors = (unsigned char*)ArenaAlloc(grid->scratchArena, count * 4);
+        grid->scratchIndices = (int*)ArenaAlloc(grid->scratchArena, count * sizeof(int));
+        return grid->scratchPositions && grid->scratchNormals && grid->scratchColors && grid->scratchIndices;
+    }
+    if (count <= grid->scratchCapacity) return true;
+    grid->scratchPositions = (float*)malloc(count * 3 * sizeof(float));
+    grid->scratchNormals = (float*)malloc(count * 3 * sizeof(float));
+    grid->scratchColors = (unsigned char*)malloc(count * 4);
+    grid->scratchIndices = (int*)malloc(count * sizeof(int));
+    if (!grid->scratchPositions || !grid->scratchNormals || !grid->scratchColors || !grid->scratchIndices) {
+        free(grid->scratchPositions);
+        free(grid->scratchNormals);
+        free(grid->scratchColors);
+        free(grid->scratchIndices);
+        return false;
+    }
+    grid->scratchCapacity = count;
+    return true;
+}
+
+// Room for the dynamic lights of a lighting system, same ownership as the gather buffers
+static bool ReserveRelightLights(RelightGrid* grid, int count) {
+    if (count == 0) return true;
+    if (grid->scratchArena) {
+        if (grid->scratchLightCapacity > 0) free(grid->scratchLights);
+        grid->scratchLightCapacity = 0;
+        grid->scratchLights = (Light*)ArenaAlloc(grid->scratchArena, count * sizeof(Light));
+        return grid->scratchLights != NULL;
+    }
+    if (count <= grid->scratchLightCapacity) return true;
+    free(grid->scratchLights);
+    grid->scratchLights = (Light*)malloc(count * sizeof(Light));
+    grid->scratchLightCapacity = grid->scratchLights ? count : 0;
+    return grid->scratchLights != NULL;
+}
+
+// Relight vertices near lights that were added, moved or changed since the last update
+int UpdateRelightGrid(RelightGrid* grid, const LightingSystem* lighting, const GraphicsConfig* config, Vector3 viewDir) {
+    if (!grid) return -1;
+    grid->lastDirtyVertices = 0;
+    if (grid->meshCount == 0) return 0;
+    if (!grid->built && !BuildRelightCells(grid)) {
+        TraceLog(LOG_WARNING, "RELIGHT: Out of memory for the vertex grid, relight skipped");
+        return -1;
+    }
+
+    if (!MarkChangedLights(grid, lighting, config)) {
+        memset(grid->cellDirty, 1, grid->cellCount);
+    }
+
+    // Gather the vertices of dirty cells with their albedo
+    int dirtyCount = 0;
+    for (int c = 0; c < grid->cellCount; c++) {
+        if (grid->cellDirty[c]) dirtyCount += grid->cellStart[c + 1] - grid->cellStart[c];
+    }
+    if (dirtyCount > 0) {
+        // Dirty cells stay marked and the snapshot stays old, so the next update catches up
+        if (!ReserveRelightScratch(grid, dirtyCount) ||
+            (grid->dynamicLightsOnly && !ReserveRelightLights(grid, lighting->lightCount))) {
+            TraceLog(LOG_WARNING, "RELIGHT: Out of memory for %d vertices, relight skipped", dirtyCount);
+            return -1;
+        }
+        int n = 0;
+        int m = 0;
+        for (int c = 0; c < grid->cellCount; c++) {
+            if (!grid->cellDirty[c]) continue;
+            grid->cellDirty[c] = 0;
+            for (int k = grid->cellStart[c]; k < grid->cellStart[c + 1]; k++) {
+                int vertex = grid->cellVertices[k];
+                while (m > 0 && vertex < grid->meshes[m].firstVertex) m--;
+                while (m + 1 < grid->meshCount && vertex >= grid->meshes[m + 1].firstVertex) m++;
+                const RelightMesh* relight = &grid->meshes[m];
+                int v = vertex - relight->firstVertex;
+                memcpy(&grid->scratchPositions[n * 3], &relight->mesh->vertices[v * 3], 3 * sizeof(float));
+                memcpy(&grid->scratchNormals[n * 3], &relight->mesh->normals[v * 3], 3 * sizeof(float));
+                memcpy(&grid->scratchColors[n * 4], &relight->albedo[v * 4], 4);
+                grid->scratchIndices[n++] = vertex;
+            }
+        }
+
+        // Light the gathered vertices as one mesh, then scatter the result back
+        Mesh gathered = { 0 };
+        gathered.vertexCount = dirtyCount;
+        gathered.vertices = grid->scratchPositions;
+        gathered.normals = grid->scratchNormals;
+        gathered.colors = grid->scratchColors;
+        if (grid->dynamicLightsOnly) {
+            LightingSystem dynamicLights = { 0 };
+            dynamicLights.lights = grid->scratchLights;
+            dynamicLights.version = lighting->version;
+            if (!grid->dynamicLightCache) grid->dynamicLightCache = CreateLightCache();
+            dynamicLights.cache = grid->dynamicLightCache;
+            for (int i = 0; i < lighting->lightCount; i++) {
+                if (lighting->lights[i].dynamic) dynamicLights.lights[dynamicLights.lightCount++] = lighting->lights[i];
+            }
+            CalculateMeshLighting(&gathered, viewDir, &dynamicLights, config);
+        } else {
+            CalculateMeshLighting(&gathered, viewDir, lighting, config);
+        }
+
+        m = 0;
+        for (int i = 0; i < dirtyCount; i++) {
+            int vertex = grid->scratchIndices[i];
+            while (m > 0 && vertex < grid->meshes[m].firstVertex) m--;
+            while (m + 1 < grid->meshCount && vertex >= grid->meshes[m + 1].firstVertex) m++;
+            RelightMesh* relight = &grid->meshes[m];
+            int v = vertex - relight->firstVertex;
+            memcpy(&relight->mesh->colors[v * 4], &grid->scratchColors[i * 4], 4);
+            if (v < relight->dirtyMin) relight->dirtyMin = v;
+            if (v > relight->dirtyMax) relight->dirtyMax = v;
+        }
+    }
+
+    SnapshotRelightLights(grid, lighting, config);
+    grid->lastDirtyVertices = dirtyCount;
+    return dirtyCount;
+}
+
+// Push the relit vertex ranges to the GPU (main thread)
+void UploadRelightGrid(RelightGrid* grid) {
+    if (!grid) return;
+    grid->lastUploadBytes = 0;
+    for (int m = 0; m < grid->meshCount; m++) {
+        RelightMesh* relight = &grid->meshes[m];
+        if (relight->dirtyMin > relight->dirtyMax) continue;
+
+        // Buffer 3 is the color buffer (raylib's default color attribute location)
+        int offset = relight->dirtyMin * 4;
+        int size = (relight->dirtyMax - relight->dirtyMin + 1) * 4;
+        UpdateMeshBuffer(*relight->mesh, 3, relight->mesh->colors + offset, size, offset);
+        grid->lastUploadBytes += size;
+
+        relight->dirtyMin = relight->mesh->vertexCount;
+        relight->dirtyMax = -1;
+    }
+}
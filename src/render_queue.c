@@ -0,0 +1,188 @@
+#include "render_queue.h"
+#include "raymath.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+RenderQueue* CreateRenderQueue(void) {
+    RenderQueue* queue = (RenderQueue*)calloc(1, sizeof(RenderQueue));
+    if (!queue) return NULL;
+    queue->commands = (RenderCommand*)malloc(RENDER_QUEUE_INITIAL_CAPACITY * sizeof(RenderCommand));
+    if (!queue->commands) {
+        free(queue);
+        return NULL;
+    }
+    queue->capacity = RENDER_QUEUE_INITIAL_CAPACITY;
+    return queue;
+}
+
+void UnloadRenderQueue(RenderQueue* queue) {
+    if (!queue) return;
+    free(queue->commands);
+    free(queue);
+}
+
+void QueueMesh(RenderQueue* queue, const Mesh* mesh, const Material* material, Matrix transform, Color tint, int blendMode) {
+    if (queue->count == queue->capacity) {
+        int capacity = queue->capacity * 2;
+        RenderCommand* commands = (RenderCommand*)realloc(queue->commands, capacity * sizeof(RenderCommand));
+        if (!commands) return;
+        queue->commands = commands;
+        queue->capacity = capacity;
+    }
+    RenderCommand* command = &queue->commands[queue->count];
+    command->mesh = mesh;
+    command->material = material;
+    command->transform = transform;
+    command->tint = tint;
+    command->blendMode = blendMode;
+    command->key = 0;
+    command->order = queue->count++;
+}
+
+void QueueModel(RenderQueue* queue, Model model, Vector3 position, Color tint, int blendMode) {
+    Matrix transform = MatrixMultiply(model.transform, MatrixTranslate(position.x, position.y, position.z));
+    for (int i = 0; i < model.meshCount; i++) {
+        QueueMesh(queue, &model.meshes[i], &model.materials[model.meshMaterial[i]], transform, tint, blendMode);
+    }
+}
+
+// Bytes of a float or int uniform, 0 for types the queue doesn't handle
+static int GetUniformSize(int uniformType) {
+    switch (uniformType) {
+        case SHADER_UNIFORM_FLOAT: case SHADER_UNIFORM_INT: case SHADER_UNIFORM_SAMPLER2D: return 4;
+        case SHADER_UNIFORM_VEC2: case SHADER_UNIFORM_IVEC2: return 8;
+        case SHADER_UNIFORM_VEC3: case SHADER_UNIFORM_IVEC3: return 12;
+        case SHADER_UNIFORM_VEC4: case SHADER_UNIFORM_IVEC4: return 16;
+        default: return 0;
+    }
+}
+
+void QueueShaderValue(RenderQueue* queue, Shader shader, int locIndex, const void* value, int uniformType) {
+    int size = GetUniformSize(uniformType);
+    if (locIndex < 0 || size == 0) return;
+
+    RenderUniform* uniform = NULL;
+    for (int i = 0; i < queue->uniformCount && !uniform; i++) {
+        if (queue->uniforms[i].shader.id == shader.id && queue->uniforms[i].locIndex == locIndex) uniform = &queue->uniforms[i];
+    }
+    if (!uniform) {
+        // Table full: send it right away, the shader is bound for it anyway
+        if (queue->uniformCount == RENDER_QUEUE_MAX_UNIFORMS) {
+            SetShaderValue(shader, locIndex, value, uniformType);
+            return;
+        }
+        uniform = &queue->uniforms[queue->uniformCount++];
+        memset(uniform, 0, sizeof(RenderUniform));
+        uniform->locIndex = locIndex;
+    }
+    uniform->shader = shader;
+    uniform->uniformType = uniformType;
+    memset(uniform->queued, 0, sizeof(uniform->queued));
+    memcpy(uniform->queued, value, size);
+    uniform->pending = true;
+}
+
+void ResetRenderQueueUniforms(RenderQueue* queue) {
+    queue->uniformCount = 0;
+}
+
+// Blend mode, shader, material and mesh in 4/20/20/20 bits. Only the order matters, so truncated ids
+// and pointers at worst split a group.
+static unsigned long long GetRenderCommandKey(const RenderCommand* command) {
+    const Mesh* mesh = command->mesh;
+    unsigned int meshId = mesh->vaoId ? mesh->vaoId : (mesh->vboId ? mesh->vboId[0] : 0);
+    unsigned long long blend = (unsigned long long)(command->blendMode + 1) & 0xF;
+    unsigned long long shader = command->material->shader.id & 0xFFFFF;
+    unsigned long long material = ((uintptr_t)command->material >> 4) & 0xFFFFF;
+    return (blend << 60) | (shader << 40) | (material << 20) | (meshId & 0xFFFFF);
+}
+
+static int CompareRenderCommands(const void* a, const void* b) {
+    const RenderCommand* first = (const RenderCommand*)a;
+    const RenderCommand* second = (const RenderCommand*)b;
+    if (first->key != second->key) return (first->key < second->key) ? -1 : 1;
+    return first->order - second->order;
+}
+
+// Blend mode, shader and material changes when drawing the commands in their current order, counting
+// the first command's state as changes too
+static int CountRenderStateChanges(const RenderCommand* commands, int count) {
+    int changes = 0;
+    for (int i = 0; i < count; i++) {
+        const RenderCommand* command = &commands[i];
+        const RenderCommand* previous = (i > 0) ? &commands[i - 1] : NULL;
+        int previousBlend = previous ? previous->blendMode : RENDER_OPAQUE;
+        if (command->blendMode != previousBlend) changes++;
+        if (!previous || command->material->shader.id != previous->material->shader.id) changes++;
+        if (!previous || command->material != previous->material) changes++;
+    }
+    return changes;
+}
+
+// Send the uniforms queued for a shader that are not what it already holds
+static void ApplyQueuedUniforms(RenderQueue* queue, unsigned int shaderId, RenderStats* stats) {
+    for (int i = 0; i < queue->uniformCount; i++) {
+        RenderUniform* uniform = &queue->uniforms[i];
+        if (!uniform->pending || uniform->shader.id != shaderId) continue;
+        uniform->pending = false;
+
+        if (uniform->hasSent && memcmp(uniform->sent, uniform->queued, sizeof(uniform->sent)) == 0) {
+            if (stats) stats->uniformsSkipped++;
+            continue;
+        }
+        SetShaderValue(uniform->shader, uniform->locIndex, uniform->queued, uniform->uniformType);
+        memcpy(uniform->sent, uniform->queued, sizeof(uniform->sent));
+        uniform->hasSent = true;
+        if (stats) stats->uniformUploads++;
+    }
+}
+
+void SubmitRenderQueue(RenderQueue* queue, RenderStats* stats) {
+    double start = GetTime();
+    if (stats) stats->unsortedStateChanges += CountRenderStateChanges(queue->commands, queue->count);
+
+    for (int i = 0; i < queue->count; i++) queue->commands[i].key = GetRenderCommandKey(&queue->commands[i]);
+    qsort(queue->commands, queue->count, sizeof(RenderCommand), CompareRenderCommands);
+    if (stats) stats->stateChanges += CountRenderStateChanges(queue->commands, queue->count);
+
+    int blendMode = RENDER_OPAQUE;
+    unsigned int shaderId = 0;
+    for (int i = 0; i < queue->count; i++) {
+        const RenderCommand* command = &queue->commands[i];
+        if (command->blendMode != blendMode) {
+            if (blendMode != RENDER_OPAQUE) EndBlendMode();
+            if (command->blendMode != RENDER_OPAQUE) BeginBlendMode(command->blendMode);
+            blendMode = command->blendMode;
+        }
+        if (i == 0 || command->material->shader.id != shaderId) {
+            shaderId = command->material->shader.id;
+            ApplyQueuedUniforms(queue, shaderId, stats);
+        }
+
+        // Tinted like DrawModel does, through the shared diffuse map
+        MaterialMap* diffuse = &command->material->maps[MATERIAL_MAP_DIFFUSE];
+        Color color = diffuse->color;
+        diffuse->color = (Color){
+            (unsigned char)(color.r * command->tint.r / 255), (unsigned char)(color.g * command->tint.g / 255),
+            (unsigned char)(color.b * command->tint.b / 255), (unsigned char)(color.a * command->tint.a / 255)
+        };
+        DrawMesh(*command->mesh, *command->material, command->transform);
+        diffuse->color = color;
+
+        if (stats) {
+            stats->drawCalls++;
+            stats->triangles += command->mesh->triangleCount;
+        }
+    }
+    if (blendMode != RENDER_OPAQUE) EndBlendMode();
+
+    // Uniforms of shaders nothing drew with this frame are dropped, the shader keeps its old value
+    for (int i = 0; i < queue->uniformCount; i++) queue->uniforms[i].pending = false;
+
+    if (stats) {
+        stats->queuedCommands += queue->count;
+        stats->submitMs += (GetTime() - start) * 1000.0;
+    }
+    queue->count = 0;
+}
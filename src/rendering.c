@@ -2,6 +2,8 @@
 #include "raymath.h"
 #include <math.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 
 // Initialize wireframe shader system
 WireframeShader LoadWireframeShader(void) {
@@ -39,6 +41,193 @@ void UnloadWireframeShader(WireframeShader* wireframeShader) {
     }
 }
 
+// Float RGBA texture for shader data, sampled with point filtering (id 0 when float textures aren't supported)
+static Texture2D LoadDataTexture(int width, int height, float* texels) {
+    Image image = { texels, width, height, 1, PIXELFORMAT_UNCOMPRESSED_R32G32B32A32 };
+    Texture2D texture = LoadTextureFromImage(image);
+    if (texture.id > 0) SetTextureFilter(texture, TEXTURE_FILTER_POINT);
+    return texture;
+}
+
+// Load the per-pixel lighting shader
+LightingShader LoadLightingShader(void) {
+    LightingShader lightingShader = {0};
+    
+    lightingShader.shader = LoadShader("lighting.vs", "lighting.fs");
+    
+    if (lightingShader.shader.id != rlGetShaderIdDefault()) {
+        lightingShader.loaded = true;
+        
+        lightingShader.clusterOriginLoc = GetShaderLocation(lightingShader.shader, "clusterOrigin");
+        lightingShader.clusterCellSizeLoc = GetShaderLocation(lightingShader.shader, "clusterCellSize");
+        lightingShader.clusterSizeLoc = GetShaderLocation(lightingShader.shader, "clusterSize");
+        lightingShader.globalLightsLoc = GetShaderLocation(lightingShader.shader, "globalLights");
+        lightingShader.ambientLoc = GetShaderLocation(lightingShader.shader, "ambient");
+        lightingShader.specularStrengthLoc = GetShaderLocation(lightingShader.shader, "specularStrength");
+        lightingShader.shininessLoc = GetShaderLocation(lightingShader.shader, "shininess");
+        lightingShader.advancedShadingLoc = GetShaderLocation(lightingShader.shader, "advancedShading");
+        lightingShader.sunPositionLoc = GetShaderLocation(lightingShader.shader, "sunPosition");
+        lightingShader.viewPosLoc = GetShaderLocation(lightingShader.shader, "viewPos");
+        
+        // DrawMesh binds material map textures to these locations
+        lightingShader.shader.locs[SHADER_LOC_MAP_EMISSION] = GetShaderLocation(lightingShader.shader, "lightData");
+        lightingShader.shader.locs[SHADER_LOC_MAP_HEIGHT] = GetShaderLocation(lightingShader.shader, "clusterData");
+        
+        Vector3 sunPosition = { SUN_POSITION_X, SUN_POSITION_Y, SUN_POSITION_Z };
+        SetShaderValue(lightingShader.shader, lightingShader.sunPositionLoc, &sunPosition, SHADER_UNIFORM_VEC3);
+        
+        // Fixed sizes, so materials keep valid texture ids
+        lightingShader.lightTexels = (float*)calloc(MAX_SHADER_LIGHTS * LIGHT_DATA_TEXELS * 4, sizeof(float));
+        lightingShader.clusterTexels = (float*)calloc(CLUSTER_TEXTURE_WIDTH * CLUSTER_TEXTURE_HEIGHT * 4, sizeof(float));
+        if (lightingShader.lightTexels && lightingShader.clusterTexels) {
+            lightingShader.lightData = LoadDataTexture(LIGHT_DATA_TEXELS, MAX_SHADER_LIGHTS, lightingShader.lightTexels);
+            lightingShader.clusterData = LoadDataTexture(CLUSTER_TEXTURE_WIDTH, CLUSTER_TEXTURE_HEIGHT, lightingShader.clusterTexels);
+        }
+        if (lightingShader.lightData.id == 0 || lightingShader.clusterData.id == 0) {
+            TraceLog(LOG_WARNING, "SHADER: No float textures for the light clusters, per-pixel lighting disabled");
+            UnloadLightingShader(&lightingShader);
+            return lightingShader;
+        }
+        
+        printf("SHADER: Lighting shader loaded successfully!\n");
+    } else {
+        lightingShader.loaded = false;
+        printf("SHADER: Failed to load lighting shader!\n");
+    }
+    
+    return lightingShader;
+}
+
+// Cleanup lighting shader
+void UnloadLightingShader(LightingShader* lightingShader) {
+    if (lightingShader && lightingShader->loaded) {
+        UnloadShader(lightingShader->shader);
+        if (lightingShader->lightData.id > 0) UnloadTexture(lightingShader->lightData);
+        if (lightingShader->clusterData.id > 0) UnloadTexture(lightingShader->clusterData);
+        free(lightingShader->lightTexels);
+        free(lightingShader->clusterTexels);
+        UnloadLightClusters(&lightingShader->grid);
+        lightingShader->lightData.id = 0;
+        lightingShader->clusterData.id = 0;
+        lightingShader->lightTexels = NULL;
+        lightingShader->clusterTexels = NULL;
+        lightingShader->loaded = false;
+        TraceLog(LOG_INFO, "SHADER: Lighting shader unloaded");
+    }
+}
+
+void SetLightingShaderMaterial(const LightingShader* lightingShader, Material* material) {
+    material->shader = lightingShader->shader;
+    material->maps[MATERIAL_MAP_EMISSION].texture = lightingShader->lightData;
+    material->maps[MATERIAL_MAP_HEIGHT].texture = lightingShader->clusterData;
+}
+
+// Cluster the block's point/spot lights, coarsening the grid until headers and lists fit the cluster texture
+static void BuildShaderLightClusters(LightingShader* lightingShader, const LightBlock* block) {
+    LightClusterGrid* grid = &lightingShader->grid;
+    BoundingBox bounds;
+    if (!GetLocalLightBounds(block, &bounds)) {
+        // Directional lights only: one empty cell
+        BuildLightClusters(grid, block, (BoundingBox){ 0 }, LIGHT_CLUSTER_CELL_SIZE);
+        return;
+    }
+    
+    int capacity = CLUSTER_TEXTURE_WIDTH * CLUSTER_TEXTURE_HEIGHT;
+    float cellSize = LIGHT_CLUSTER_CELL_SIZE;
+    for (;;) {
+        BuildLightClusters(grid, block, bounds, cellSize);
+        if (grid->cellCount + grid->cellLightCount + grid->globalCount <= capacity) return;
+        cellSize *= 1.5f;
+    }
+}
+
+// Upload lights only if the lighting system or shading settings changed
+void UpdateLightingShader(LightingShader* lightingShader, const LightingSystem* lighting, const GraphicsConfig* config, Vector3 viewPos) {
+    if (!lightingShader->loaded) return;
+    
+    SetShaderValue(lightingShader->shader, lightingShader->viewPosLoc, &viewPos, SHADER_UNIFORM_VEC3);
+    
+    if (lightingShader->uploaded && lightingShader->uploadedVersion == lighting->version &&
+        lightingShader->uploadedAdvanced == config->advancedShadingEnabled &&
+        lightingShader->uploadedSpecularStrength == config->specularStrength &&
+        lightingShader->uploadedShininess == config->shininess) {
+        return;
+    }
+    
+    // The first MAX_SHADER_LIGHTS enabled lights go into the light texture
+    LightBlock block = CompileLightBlock(lighting, config);
+    int dropped = 0;            // Lights past MAX_SHADER_LIGHTS
+    int droppedInCells = 0;     // Cell and directional list entries past MAX_SHADER_CELL_LIGHTS
+    if (block.count > MAX_SHADER_LIGHTS) {
+        dropped = block.count - MAX_SHADER_LIGHTS;
+        block.count = MAX_SHADER_LIGHTS;
+    }
+    
+    float* light = lightingShader->lightTexels;
+    for (int i = 0; i < block.count; i++, light += LIGHT_DATA_TEXELS * 4) {
+        float row[LIGHT_DATA_TEXELS * 4] = {
+            block.posX[i], block.posY[i], block.posZ[i], (float)block.type[i],
+            block.dirX[i], block.dirY[i], block.dirZ[i], block.spotCutoff[i],
+            block.colorR[i] / 255.0f, block.colorG[i] / 255.0f, block.colorB[i] / 255.0f, block.intensity[i],
+            block.range[i], 0.0f, 0.0f, 0.0f
+        };
+        memcpy(light, row, sizeof(row));
+    }
+    
+    // Cluster texture: a (first texel, count) header per cell, the cell light lists, then the directional lights
+    BuildShaderLightClusters(lightingShader, &block);
+    const LightClusterGrid* grid = &lightingShader->grid;
+    float* texels = lightingShader->clusterTexels;
+    int listStart = grid->cellCount;
+    for (int c = 0; c < grid->cellCount; c++) {
+        int count = grid->cellStart[c + 1] - grid->cellStart[c];
+        texels[c * 4] = (float)(listStart + grid->cellStart[c]);
+        texels[c * 4 + 1] = (float)count;
+        if (count > MAX_SHADER_CELL_LIGHTS) droppedInCells += count - MAX_SHADER_CELL_LIGHTS;
+    }
+    for (int k = 0; k < grid->cellLightCount; k++) texels[(listStart + k) * 4] = (float)grid->cellLights[k];
+    int globalStart = listStart + grid->cellLightCount;
+    for (int k = 0; k < grid->globalCount; k++) texels[(globalStart + k) * 4] = (float)grid->globalLights[k];
+    if (grid->globalCount > MAX_SHADER_CELL_LIGHTS) droppedInCells += grid->globalCount - MAX_SHADER_CELL_LIGHTS;
+    
+    if ((dropped > 0 || droppedInCells > 0) && dropped + droppedInCells != lightingShader->droppedLights) {
+        TraceLog(LOG_WARNING, "SHADER: lighting.fs takes %d lights and %d per cluster cell, dropped %d lights and %d cell entries",
+                 MAX_SHADER_LIGHTS, MAX_SHADER_CELL_LIGHTS, dropped, droppedInCells);
+    }
+    lightingShader->droppedLights = dropped + droppedInCells;
+    
+    UpdateTexture(lightingShader->lightData, lightingShader->lightTexels);
+    UpdateTexture(lightingShader->clusterData, lightingShader->clusterTexels);
+    
+    Vector3 clusterSize = { (float)grid->sizeX, (float)grid->sizeY, (float)grid->sizeZ };
+    if (grid->cellCount == 0) clusterSize = (Vector3){ 0.0f, 0.0f, 0.0f };
+    Vector2 globalLights = { (float)globalStart, (float)grid->globalCount };
+    Vector3 ambient = {
+        lighting->ambientColor.r * lighting->ambientIntensity / 255.0f,
+        lighting->ambientColor.g * lighting->ambientIntensity / 255.0f,
+        lighting->ambientColor.b * lighting->ambientIntensity / 255.0f
+    };
+    float advanced = config->advancedShadingEnabled ? 1.0f : 0.0f;
+    
+    Shader shader = lightingShader->shader;
+    SetShaderValue(shader, lightingShader->clusterOriginLoc, &grid->origin, SHADER_UNIFORM_VEC3);
+    SetShaderValue(shader, lightingShader->clusterCellSizeLoc, &grid->cellSize, SHADER_UNIFORM_FLOAT);
+    SetShaderValue(shader, lightingShader->clusterSizeLoc, &clusterSize, SHADER_UNIFORM_VEC3);
+    SetShaderValue(shader, lightingShader->globalLightsLoc, &globalLights, SHADER_UNIFORM_VEC2);
+    SetShaderValue(shader, lightingShader->ambientLoc, &ambient, SHADER_UNIFORM_VEC3);
+    SetShaderValue(shader, lightingShader->specularStrengthLoc, &config->specularStrength, SHADER_UNIFORM_FLOAT);
+    SetShaderValue(shader, lightingShader->shininessLoc, &config->shininess, SHADER_UNIFORM_FLOAT);
+    SetShaderValue(shader, lightingShader->advancedShadingLoc, &advanced, SHADER_UNIFORM_FLOAT);
+    UnloadLightBlock(&block);
+    
+    lightingShader->uploaded = true;
+    lightingShader->uploadedVersion = lighting->version;
+    lightingShader->uploadedAdvanced = config->advancedShadingEnabled;
+    lightingShader->uploadedSpecularStrength = config->specularStrength;
+    lightingShader->uploadedShininess = config->shininess;
+    lightingShader->uploadCount++;
+}
+
 // Draw model with wireframe shader
 void DrawModelWireframe(Model model, Vector3 position, float scale, Color tint, 
                        WireframeShader* wireframeShader, GraphicsConfig* config) {
@@ -182,4 +371,64 @@ void DrawCubeSphereWires(Vector3 center, float radius, int subdivisions, Color c
     }
     
     rlSetLineWidth(1.0f); // Reset line width
-}
\ No newline at end of file
+}
+
+// Build a model that owns several already uploaded meshes sharing one default material
+Model LoadModelFromMeshes(const Mesh* meshes, int meshCount) {
+    Model model = { 0 };
+    model.transform = MatrixIdentity();
+
+    model.meshCount = meshCount;
+    model.meshes = (Mesh *)MemAlloc(meshCount * sizeof(Mesh));
+    for (int i = 0; i < meshCount; i++) model.meshes[i] = meshes[i];
+
+    model.materialCount = 1;
+    model.materials = (Material *)MemAlloc(sizeof(Material));
+    model.materials[0] = LoadMaterialDefault();
+
+    // All meshes use material 0
+    model.meshMaterial = (int *)MemAlloc(meshCount * sizeof(int));
+
+    return model;
+}
+
+// Normalize a plane so w is the true distance from the origin
+static Vector4 NormalizePlane(Vector4 plane) {
+    float length = sqrtf(plane.x * plane.x + plane.y * plane.y + plane.z * plane.z);
+    if (length <= 0.0f) return plane;
+    return (Vector4){ plane.x / length, plane.y / length, plane.z / length, plane.w / length };
+}
+
+// Extract the frustum planes from the view-projection matrix (Gribb/Hartmann)
+Frustum GetCameraFrustum(Camera3D camera, float aspect) {
+    Matrix view = MatrixLookAt(camera.position, camera.target, camera.up);
+    Matrix projection = MatrixPerspective(camera.fovy * DEG2RAD, aspect, RL_CULL_DISTANCE_NEAR, RL_CULL_DISTANCE_FAR);
+    Matrix m = MatrixMultiply(view, projection);
+    
+    // Rows of the clip-space transform
+    Vector4 row0 = { m.m0, m.m4, m.m8, m.m12 };
+    Vector4 row1 = { m.m1, m.m5, m.m9, m.m13 };
+    Vector4 row2 = { m.m2, m.m6, m.m10, m.m14 };
+    Vector4 row3 = { m.m3, m.m7, m.m11, m.m15 };
+    
+    Frustum frustum;
+    frustum.planes[0] = NormalizePlane((Vector4){ row3.x + row0.x, row3.y + row0.y, row3.z + row0.z, row3.w + row0.w }); // Left
+    frustum.planes[1] = NormalizePlane((Vector4){ row3.x - row0.x, row3.y - row0.y, row3.z - row0.z, row3.w - row0.w }); // Right
+    frustum.planes[2] = NormalizePlane((Vector4){ row3.x + row1.x, row3.y + row1.y, row3.z + row1.z, row3.w + row1.w }); // Bottom
+    frustum.planes[3] = NormalizePlane((Vector4){ row3.x - row1.x, row3.y - row1.y, row3.z - row1.z, row3.w - row1.w }); // Top
+    frustum.planes[4] = NormalizePlane((Vector4){ row3.x + row2.x, row3.y + row2.y, row3.z + row2.z, row3.w + row2.w }); // Near
+    frustum.planes[5] = NormalizePlane((Vector4){ row3.x - row2.x, row3.y - row2.y, row3.z - row2.z, row3.w - row2.w }); // Far
+    return frustum;
+}
+
+// Test the box corner furthest along each plane normal
+bool IsBoxInFrustum(const Frustum* frustum, BoundingBox box) {
+    for (int i = 0; i < 6; i++) {
+        Vector4 plane = frustum->planes[i];
+        float x = (plane.x >= 0.0f) ? box.max.x : box.min.x;
+        float y = (plane.y >= 0.0f) ? box.max.y : box.min.y;
+        float z = (plane.z >= 0.0f) ? box.max.z : box.min.z;
+        if (plane.x * x + plane.y * y + plane.z * z + plane.w < 0.0f) return false;
+    }
+    return true;
+}
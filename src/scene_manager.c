@@ -2,29 +2,87 @@
 #include "maze.h"
 #include "mesh_generation.h"
 #include "rendering.h"
+#include "planet_noise.h"
+#include "planet_lod.h"
+#include "relight.h"
+#include "lightmap.h"
+#include "horizon_map.h"
+#include "probe_grid.h"
+#include "maze_batch.h"
+#include "maze_pvs.h"
+#include "maze_collision.h"
+#include "maze_crowd.h"
+#include "instancing.h"
+#include "arena.h"
+#include "render_queue.h"
+#include "thread_pool.h"
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
 
+#define MAZE_CROWD_AGENTS 200           // Agents walking the maze scene
+
+// Background load of a scene: its load function runs as a job, the job's completion hands the data to the
+// scene's upload function on the main thread
+struct SceneLoadTask {
+    JobHandle job;
+    SceneLoadFunc load;
+    SceneUploadFunc upload;
+    MemoryArena* arena;             // Of the scene, used by the load job until it finishes
+    void* data;                     // Returned by load
+    float cpuProgress;              // Reported by load, 0 to 1
+    bool completed;                 // The job's completion ran
+    bool uploaded;                  // upload returned true
+    bool abandoned;                 // Finished by FinishSceneLoad first, the completion frees the task
+    double startTime;
+};
+
 // Maze scene specific data
 typedef struct {
     Maze maze;
     Model mazeWallModel;
     Model floorModel;
-    Model advancedFloorModel;
-    bool advancedMeshGenerated;
+    Model advancedFloorModel;       // Lit with the full lighting system, relit as lights move
+    bool advancedMeshGenerated;     // advancedFloorModel and relight are built on first use
+    RelightGrid* relight;           // Dynamic lights only, added on top of the lightmap
+    Model lightmapFloorModel;       // Base colors times the baked floor lightmap
+    unsigned long long lightmapKey; // Key of the lightmap on lightmapFloorModel, 0 = none
+    LightmapBakeTask* lightmapBake; // Background load or rebake in progress
+    unsigned long long lightmapBakeKey; // Key of the last lightmap requested
+    ProbeGrid* probes;              // SH ambient probes, lighting->ambientProbes while the scene is active
+    ProbeBakeTask* probeBake;       // Background rebake in progress
+    unsigned long long probeKey;    // Key of the last probe grid loaded or requested
+    LightingSystem* lighting;
+    const GraphicsConfig* gfxConfig;
+    LightingShader lightingShader;  // Per-pixel lighting path (F7)
+    Model shaderFloorModel;         // Unlit base colors, lit by lightingShader
+    Model shaderWallModel;
+    MazeWallBatch wallBatch;        // Walls merged per chunk (F8), base colors relit in world space by wallRelight
+    RelightGrid* wallRelight;       // All lights and ambient
+    MazeWallBatch shaderWallBatch;  // Unlit base colors, lit by lightingShader
+    MazePvs* pvs;                   // Wall chunks visible from each open cell
+    InstancedRenderer* instancing;  // Instanced path of mazeWallModel and the crowd
+    int wallInstances;
+    MazeCrowd* crowd;               // Agents walking between the first and last open cell
+    Model agentModel;
+    int agentBatches[2];            // One color per goal
 } MazeSceneData;
 
 // Terrain scene specific data
 typedef struct {
     TerrainData terrain;
     Model floorModel;
+    Mesh terrainMesh;               // Built by the loader, uploaded into terrain.terrainModel
 } TerrainSceneData;
 
 // Cube-Sphere scene specific data
 typedef struct {
     CubeSphereData cubeSphere;
     TerrainData terrain;
+    Model markerModel;              // Reference cube drawn through the instanced renderer
+    InstancedRenderer* instancing;
+    int markerBatches[3];           // Red, green and blue markers
+    bool lodRequested;              // First upload call ran and requested the LOD build
 } CubeSphereSceneData;
 
 // Scene manager functions
@@ -33,28 +91,230 @@ SceneManager InitSceneManager(void) {
     manager.sceneCount = 0;
     manager.currentSceneIndex = -1;
     manager.currentScene = NULL;
+    manager.cacheBudget = SCENE_CACHE_BUDGET;
+    manager.pendingSceneIndex = -1;
+    manager.prefetchEnabled = true;
+    manager.frameArena = CreateArena(0);
     return manager;
 }
 
 void AddScene(SceneManager* manager, Scene scene) {
     if (manager->sceneCount < MAX_SCENES) {
+        scene.arena = CreateArena(0);
+        scene.frameArena = manager->frameArena;
+        scene.renderQueue = CreateRenderQueue();
         manager->scenes[manager->sceneCount] = scene;
         manager->sceneCount++;
     }
 }
 
-void SwitchScene(SceneManager* manager, int sceneIndex) {
-    if (sceneIndex >= 0 && sceneIndex < manager->sceneCount) {
-        // Cleanup current scene if switching
-        if (manager->currentScene && manager->currentScene->cleanup) {
-            manager->currentScene->cleanup(manager->currentScene);
+static size_t GetSceneMemory(const Scene* scene) {
+    return (scene->sceneData && scene->memory) ? scene->memory(scene) : 0;
+}
+
+// Release the scene's GPU resources, then everything it allocated from its arena at once
+static void UnloadScene(Scene* scene) {
+    if (scene->cleanup) scene->cleanup(scene);
+    if (scene->arena) ClearArena(scene->arena);
+    if (scene->renderQueue) ResetRenderQueueUniforms(scene->renderQueue);
+    scene->sceneData = NULL;
+    scene->initialized = false;
+}
+
+// Unload suspended scenes, least recently used first, until the rest fit in the budget
+static void EvictSuspendedScenes(SceneManager* manager) {
+    for (;;) {
+        size_t total = GetSceneCacheMemory(manager);
+        if (total <= manager->cacheBudget) return;
+        Scene* oldest = NULL;
+        for (int i = 0; i < manager->sceneCount; i++) {
+            Scene* scene = &manager->scenes[i];
+            if (scene == manager->currentScene || !scene->sceneData) continue;
+            if (!oldest || scene->lastActive < oldest->lastActive) oldest = scene;
+        }
+        if (!oldest) return;
+        TraceLog(LOG_INFO, "SCENE: Unloaded %s (%.1f MB) to fit the %.1f MB warm scene budget", oldest->name,
+                 GetSceneMemory(oldest) / (1024.0 * 1024.0), manager->cacheBudget / (1024.0 * 1024.0));
+        UnloadScene(oldest);
+    }
+}
+
+// Report how far the CPU part of a load has come (0 to 1), ignored for synchronous loads
+static void SetSceneLoadProgress(SceneLoadTask* task, float progress) {
+    if (!task) return;
+    __atomic_store(&task->cpuProgress, &progress, __ATOMIC_RELAXED);
+}
+
+// Job: CPU part of a scene load
+static void RunSceneLoad(void* context) {
+    SceneLoadTask* task = (SceneLoadTask*)context;
+    task->data = task->load(task, task->arena);
+    SetSceneLoadProgress(task, 1.0f);
+}
+
+// Hand the loaded data to the scene's upload function until it reports done (main thread only)
+static void RunSceneUpload(SceneLoadTask* task, bool wait) {
+    if (task->uploaded) return;
+    task->uploaded = !task->data || task->upload(task, task->data, wait);
+}
+
+// Completion of the load job: first go at the upload, or only free a task FinishSceneLoad already handled
+static void CompleteSceneLoad(void* context) {
+    SceneLoadTask* task = (SceneLoadTask*)context;
+    if (task->abandoned) {
+        free(task);
+        return;
+    }
+    task->completed = true;
+    RunSceneUpload(task, false);
+}
+
+static SceneLoadTask* StartSceneLoad(Scene* scene) {
+    SceneLoadTask* task = (SceneLoadTask*)calloc(1, sizeof(SceneLoadTask));
+    if (!task) return NULL;
+    task->load = scene->load;
+    task->upload = scene->upload;
+    task->arena = scene->arena;
+    task->startTime = GetTime();
+    task->job = ScheduleJobWithCompletion(RunSceneLoad, CompleteSceneLoad, task, NULL, 0);
+    return task;
+}
+
+// Wait for the load job, finish the upload and hand the data to the scene. A completion that hasn't run
+// yet is left to free the task.
+static void FinishSceneLoad(Scene* scene) {
+    SceneLoadTask* task = scene->loading;
+    WaitJob(task->job);
+    RunSceneUpload(task, true);
+
+    scene->sceneData = task->data;
+    scene->initialized = task->data != NULL;
+    scene->loading = NULL;
+    TraceLog(LOG_INFO, "SCENE: Loaded %s in the background in %.0f ms", scene->name, (GetTime() - task->startTime) * 1000.0);
+    if (task->completed) free(task);
+    else task->abandoned = true;
+}
+
+// Scene switched to most often from the current one, the next one in order before there is any history.
+// Returns -1 when that scene is loaded, already loading or can't load in the background.
+static int PredictNextScene(const SceneManager* manager) {
+    int from = manager->currentSceneIndex;
+    int best = (from + 1) % manager->sceneCount;
+    int bestCount = 0;
+    for (int i = 0; i < manager->sceneCount; i++) {
+        if (i != from && manager->transitions[from][i] > bestCount) {
+            best = i;
+            bestCount = manager->transitions[from][i];
         }
-        
-        manager->currentSceneIndex = sceneIndex;
-        manager->currentScene = &manager->scenes[sceneIndex];
-        
-        printf("Switched to scene: %s\n", manager->currentScene->name);
     }
+    const Scene* scene = &manager->scenes[best];
+    if (best == from || !scene->load || scene->sceneData || scene->loading) return -1;
+    return best;
+}
+
+bool PreloadScene(SceneManager* manager, int sceneIndex) {
+    if (sceneIndex < 0 || sceneIndex >= manager->sceneCount) return false;
+    Scene* scene = &manager->scenes[sceneIndex];
+    if (scene->sceneData || scene->loading) return true;
+    if (!scene->load) return false;
+    scene->loading = StartSceneLoad(scene);
+    return scene->loading != NULL;
+}
+
+void UpdateSceneLoads(SceneManager* manager, LightingSystem* lighting, GraphicsConfig* gfxConfig) {
+    ResetArena(manager->frameArena);
+    
+    for (int i = 0; i < manager->sceneCount; i++) {
+        Scene* scene = &manager->scenes[i];
+        if (!scene->loading || !scene->loading->completed) continue;
+        RunSceneUpload(scene->loading, false);
+        if (!scene->loading->uploaded) continue;
+
+        FinishSceneLoad(scene);
+        if (i == manager->pendingSceneIndex) {
+            SwitchScene(manager, i, lighting, gfxConfig);
+        } else {
+            // Prefetched, kept as the most recently used of the suspended scenes
+            scene->lastActive = manager->switchCount;
+            EvictSuspendedScenes(manager);
+        }
+    }
+
+    if (manager->prefetchEnabled && !manager->prefetchChecked && manager->currentScene && manager->cacheBudget > 0 &&
+        manager->pendingSceneIndex < 0 && GetTime() - manager->lastSwitchTime >= SCENE_PREFETCH_DELAY) {
+        manager->prefetchChecked = true;
+        int next = PredictNextScene(manager);
+        if (next >= 0 && PreloadScene(manager, next)) {
+            TraceLog(LOG_INFO, "SCENE: Prefetching %s", manager->scenes[next].name);
+        }
+    }
+}
+
+float GetSceneLoadProgress(const SceneManager* manager, int sceneIndex) {
+    if (sceneIndex < 0 || sceneIndex >= manager->sceneCount) return 0.0f;
+    const Scene* scene = &manager->scenes[sceneIndex];
+    if (scene->sceneData) return 1.0f;
+    if (!scene->loading) return 0.0f;
+
+    // The CPU part counts for nine tenths, the rest is the upload
+    float cpuProgress;
+    __atomic_load(&scene->loading->cpuProgress, &cpuProgress, __ATOMIC_RELAXED);
+    return 0.9f * cpuProgress;
+}
+
+void SwitchScene(SceneManager* manager, int sceneIndex, LightingSystem* lighting, GraphicsConfig* gfxConfig) {
+    if (sceneIndex < 0 || sceneIndex >= manager->sceneCount) return;
+    Scene* next = &manager->scenes[sceneIndex];
+    if (next == manager->currentScene && next->sceneData) {
+        manager->pendingSceneIndex = -1;
+        return;
+    }
+    
+    // Keep the current scene running while the next one loads in the background
+    if (!next->sceneData && manager->currentScene && PreloadScene(manager, sceneIndex)) {
+        if (manager->pendingSceneIndex != sceneIndex) printf("Loading scene: %s\n", next->name);
+        manager->pendingSceneIndex = sceneIndex;
+        return;
+    }
+    if (next->loading) FinishSceneLoad(next);
+    double start = GetTime();
+    
+    // The current scene stays loaded, it only lets go of state shared with other scenes
+    if (manager->currentScene && manager->currentScene->sceneData && manager->currentScene->suspend) {
+        manager->currentScene->suspend(manager->currentScene);
+    }
+    
+    if (manager->currentScene) manager->transitions[manager->currentSceneIndex][sceneIndex]++;
+    manager->currentSceneIndex = sceneIndex;
+    manager->currentScene = next;
+    manager->pendingSceneIndex = -1;
+    manager->prefetchChecked = false;
+    manager->lastSwitchWarm = next->sceneData != NULL;
+    if (manager->lastSwitchWarm) {
+        if (next->resume) next->resume(next);
+    } else if (next->init) {
+        next->init(next, lighting, gfxConfig);
+    }
+    next->lastActive = ++manager->switchCount;
+    EvictSuspendedScenes(manager);
+    
+    manager->lastSwitchTime = GetTime();
+    manager->lastSwitchMs = (manager->lastSwitchTime - start) * 1000.0;
+    printf("Switched to scene: %s (%s, %.2f ms)\n", next->name, manager->lastSwitchWarm ? "resumed" : "loaded",
+           manager->lastSwitchMs);
+}
+
+void SetSceneCacheBudget(SceneManager* manager, size_t bytes) {
+    manager->cacheBudget = bytes;
+    EvictSuspendedScenes(manager);
+}
+
+size_t GetSceneCacheMemory(const SceneManager* manager) {
+    size_t total = 0;
+    for (int i = 0; i < manager->sceneCount; i++) {
+        if (&manager->scenes[i] != manager->currentScene) total += GetSceneMemory(&manager->scenes[i]);
+    }
+    return total;
 }
 
 void UpdateCurrentScene(SceneManager* manager, float deltaTime, Camera3D* camera) {
@@ -63,73 +323,340 @@ void UpdateCurrentScene(SceneManager* manager, float deltaTime, Camera3D* camera
     }
 }
 
-void RenderCurrentScene(SceneManager* manager, Camera3D camera, GraphicsConfig* gfxConfig, struct WireframeShader* wireframeShader) {
+Vector3 MoveInCurrentScene(SceneManager* manager, Vector3 position, Vector3 delta, float radius) {
+    if (manager->currentScene && manager->currentScene->move) {
+        return manager->currentScene->move(manager->currentScene, position, delta, radius);
+    }
+    return Vector3Add(position, delta);
+}
+
+void StepCurrentScene(SceneManager* manager, float stepTime) {
+    if (manager->currentScene && manager->currentScene->step) {
+        manager->currentScene->step(manager->currentScene, stepTime);
+    }
+}
+
+void RenderCurrentScene(SceneManager* manager, Camera3D camera, float interpolation, GraphicsConfig* gfxConfig, struct WireframeShader* wireframeShader) {
     if (manager->currentScene && manager->currentScene->render) {
+        manager->currentScene->stats = (RenderStats){ 0 };
+        manager->currentScene->interpolation = interpolation;
         manager->currentScene->render(manager->currentScene, camera, gfxConfig, wireframeShader);
+        if (manager->currentScene->renderQueue) SubmitRenderQueue(manager->currentScene->renderQueue, &manager->currentScene->stats);
     }
 }
 
 void CleanupSceneManager(SceneManager* manager) {
     for (int i = 0; i < manager->sceneCount; i++) {
-        if (manager->scenes[i].cleanup) {
-            manager->scenes[i].cleanup(&manager->scenes[i]);
-        }
+        if (manager->scenes[i].loading) FinishSceneLoad(&manager->scenes[i]);
+        UnloadScene(&manager->scenes[i]);
+        UnloadArena(manager->scenes[i].arena);
+        manager->scenes[i].arena = NULL;
+        UnloadRenderQueue(manager->scenes[i].renderQueue);
+        manager->scenes[i].renderQueue = NULL;
     }
+    UnloadArena(manager->frameArena);
+    manager->frameArena = NULL;
     manager->sceneCount = 0;
     manager->currentScene = NULL;
 }
 
+// Bytes of mesh data in a model (raylib keeps a CPU copy of what it uploads, counted once)
+static size_t GetModelMemory(Model model) {
+    size_t bytes = 0;
+    for (int i = 0; i < model.meshCount; i++) {
+        const Mesh* mesh = &model.meshes[i];
+        size_t vertexBytes = 3 * sizeof(float);
+        if (mesh->normals) vertexBytes += 3 * sizeof(float);
+        if (mesh->texcoords) vertexBytes += 2 * sizeof(float);
+        if (mesh->texcoords2) vertexBytes += 2 * sizeof(float);
+        if (mesh->colors) vertexBytes += 4;
+        if (mesh->tangents) vertexBytes += 4 * sizeof(float);
+        bytes += (size_t)mesh->vertexCount * vertexBytes;
+        if (mesh->indices) bytes += (size_t)mesh->triangleCount * 3 * sizeof(unsigned short);
+    }
+    return bytes;
+}
+
+static size_t GetTextureMemory(Texture2D texture) {
+    return (texture.id > 0) ? (size_t)texture.width * texture.height * 4 : 0;
+}
+
+// Put a loaded or baked lightmap on lightmapFloorModel
+static void SetMazeLightmap(MazeSceneData* data, Lightmap* lightmap) {
+    Image image = { 0 };
+    image.data = lightmap->texels;
+    image.width = lightmap->width;
+    image.height = lightmap->height;
+    image.mipmaps = 1;
+    image.format = PIXELFORMAT_UNCOMPRESSED_R8G8B8A8;
+    Texture2D texture = LoadTextureFromImage(image);
+    SetTextureFilter(texture, TEXTURE_FILTER_BILINEAR);
+    
+    // The material owns the texture (UnloadModel frees it), only the previous lightmap has to go
+    Texture2D* map = &data->lightmapFloorModel.materials[0].maps[MATERIAL_MAP_DIFFUSE].texture;
+    if (data->lightmapKey != 0) UnloadTexture(*map);
+    *map = texture;
+    data->lightmapKey = lightmap->key;
+}
+
+// Load or rebake the floor lightmap in the background when the maze, static lights or shading settings
+// changed. The previous lightmap stays on the floor until the new one is ready.
+static void UpdateMazeLightmap(MazeSceneData* data, bool startBake) {
+    if (data->lightmapBake) {
+        if (!IsLightmapBakeFinished(data->lightmapBake)) return;
+        Lightmap lightmap = FinishLightmapBake(data->lightmapBake);
+        data->lightmapBake = NULL;
+        if (lightmap.texels) SetMazeLightmap(data, &lightmap);
+        UnloadLightmap(&lightmap);
+    }
+    if (!startBake) return;
+    
+    float floorSize = WORLD_SIZE * 2;
+    unsigned long long key = GetMazeLightmapKey(&data->maze, data->lighting, data->gfxConfig, floorSize, LIGHTMAP_RESOLUTION);
+    if (key == data->lightmapKey || key == data->lightmapBakeKey) return;
+    data->lightmapBakeKey = key;
+    data->lightmapBake = StartMazeLightmapBake(&data->maze, data->lighting, data->gfxConfig, floorSize, LIGHTMAP_RESOLUTION);
+}
+
+// Rebake the ambient probes in the background when the maze or static lights change, swap them in when done
+static void UpdateMazeProbes(MazeSceneData* data) {
+    if (data->probeBake) {
+        // A lightmap bake in flight still reads the current probes
+        if (!IsProbeBakeFinished(data->probeBake) || data->lightmapBake) return;
+        ProbeGrid* probes = FinishProbeBake(data->probeBake);
+        data->probeBake = NULL;
+        if (probes) {
+            // Meshes lit from here on (lightmap, relight) pick up the new probes through their keys
+            data->lighting->ambientProbes = probes;
+            UnloadProbeGrid(data->probes);
+            data->probes = probes;
+        }
+    }
+    
+    unsigned long long key = GetMazeProbeKey(&data->maze, data->lighting);
+    if (key == data->probeKey) return;
+    data->probeKey = key;
+    data->probeBake = StartMazeProbeBake(&data->maze, data->lighting);
+}
+
+// Spread MAZE_CROWD_AGENTS over random open cells, half headed for each end of the maze
+static void InitMazeCrowd(MazeSceneData* data) {
+    const Maze* maze = &data->maze;
+    data->agentModel = LoadModelFromMesh(GenMeshCube(CROWD_AGENT_RADIUS * 2.0f, CROWD_AGENT_HEIGHT, CROWD_AGENT_RADIUS * 2.0f));
+    data->agentBatches[0] = AddInstanceBatch(data->instancing, data->agentModel.meshes[0], data->agentModel.materials[0], ORANGE);
+    data->agentBatches[1] = AddInstanceBatch(data->instancing, data->agentModel.meshes[0], data->agentModel.materials[0], SKYBLUE);
+    data->crowd = CreateMazeCrowd(maze, MAZE_CROWD_AGENTS);
+    if (!data->crowd) return;
+
+    int cellCount = maze->width * maze->height;
+    int ends[2] = { -1, -1 };
+    for (int i = 0; i < cellCount && ends[0] < 0; i++) {
+        if (!MazeIsWall(maze, i % maze->width, i / maze->width)) ends[0] = i;
+    }
+    for (int i = cellCount - 1; i >= 0 && ends[1] < 0; i--) {
+        if (!MazeIsWall(maze, i % maze->width, i / maze->width)) ends[1] = i;
+    }
+    if (ends[0] < 0 || AddMazeCrowdGoal(data->crowd, &ends[0], 1) < 0 || AddMazeCrowdGoal(data->crowd, &ends[1], 1) < 0) return;
+
+    Vector2 gridOrigin = GetMazeGridOrigin(maze);
+    for (int i = 0; i < MAZE_CROWD_AGENTS; i++) {
+        int col = GetRandomValue(0, maze->width - 1);
+        int row = GetRandomValue(0, maze->height - 1);
+        if (MazeIsWall(maze, col, row)) continue;
+        Vector2 position = { gridOrigin.x + col * MAZE_CELL_SIZE + GetRandomValue(20, 80) * (MAZE_CELL_SIZE / 100.0f),
+                             gridOrigin.y + row * MAZE_CELL_SIZE + GetRandomValue(20, 80) * (MAZE_CELL_SIZE / 100.0f) };
+        AddMazeCrowdAgent(data->crowd, position, i & 1);
+    }
+}
+
 // Maze scene functions
 void InitMazeScene(Scene* scene, LightingSystem* lighting, GraphicsConfig* gfxConfig) {
-    MazeSceneData* data = (MazeSceneData*)malloc(sizeof(MazeSceneData));
+    MazeSceneData* data = (MazeSceneData*)ArenaCalloc(scene->arena, 1, sizeof(MazeSceneData));
     scene->sceneData = data;
     
     // Load maze
     data->maze = LoadMazeFromFile("maze.txt");
     
+    // Bounce light from the probes replaces the flat ambient while this scene is active
+    data->probes = LoadOrBakeMazeProbeGrid(&data->maze, lighting);
+    data->probeBake = NULL;
+    data->probeKey = GetMazeProbeKey(&data->maze, lighting);
+    lighting->ambientProbes = data->probes;
+    
     // Generate floor mesh
     Mesh floorMesh = GenMeshFloorWithColors(WORLD_SIZE * 2, WORLD_SIZE * 2, FLOOR_SEGMENTS, FLOOR_SEGMENTS);
     data->floorModel = LoadModelFromMesh(floorMesh);
     
     // Generate maze wall mesh
-    Mesh mazeWallMesh = GenMeshMazeWallCube(10.0f, lighting, gfxConfig);
+    Mesh mazeWallMesh = GenMeshMazeWallCube(MAZE_CELL_SIZE, lighting, gfxConfig);
     data->mazeWallModel = LoadModelFromMesh(mazeWallMesh);
     
+    // Minimal meshes with unlit colors for the per-pixel lighting shader
+    data->lighting = lighting;
+    data->lightingShader = LoadLightingShader();
+    data->shaderFloorModel = LoadModelFromMesh(GenMeshFloorBase(WORLD_SIZE * 2, WORLD_SIZE * 2, FLOOR_SEGMENTS, FLOOR_SEGMENTS));
+    data->shaderWallModel = LoadModelFromMesh(GenMeshMazeWallCubeBase(MAZE_CELL_SIZE));
+    if (data->lightingShader.loaded) {
+        SetLightingShaderMaterial(&data->lightingShader, &data->shaderFloorModel.materials[0]);
+        SetLightingShaderMaterial(&data->lightingShader, &data->shaderWallModel.materials[0]);
+    }
+    
+    // The same walls as a few static meshes per spatial chunk, only visible faces with coplanar runs merged.
+    // Vertex-lit walls are split into half-cell quads for the lighting, per-pixel lit walls use whole quads.
+    data->wallBatch = LoadMazeWallBatch(&data->maze, MAZE_CHUNK_CELLS, MAZE_WALL_QUAD_SIZE);
+    data->wallRelight = CreateRelightGrid(RELIGHT_CELL_SIZE);
+    if (data->wallRelight) data->wallRelight->scratchArena = scene->frameArena;
+    for (int i = 0; i < data->wallBatch.chunkCount; i++) {
+        AddRelightMesh(data->wallRelight, &data->wallBatch.model.meshes[i]);
+    }
+    UpdateRelightGrid(data->wallRelight, lighting, gfxConfig, (Vector3){ 0.0f, 0.0f, 1.0f });
+    UploadRelightGrid(data->wallRelight);
+    
+    data->shaderWallBatch = LoadMazeWallBatch(&data->maze, MAZE_CHUNK_CELLS, 0.0f);
+    if (data->lightingShader.loaded && data->shaderWallBatch.chunkCount > 0) {
+        SetLightingShaderMaterial(&data->lightingShader, &data->shaderWallBatch.model.materials[0]);
+    }
+    
+    // Chunks that can be seen from each cell, for eye positions below the wall tops
+    data->pvs = BakeMazePvs(&data->maze, data->wallBatch.chunkCells);
+    
+    // Or every wall cube with one instanced draw
+    data->instancing = CreateInstancedRenderer();
+    data->wallInstances = AddInstanceBatch(data->instancing, data->mazeWallModel.meshes[0], data->mazeWallModel.materials[0], WHITE);
+    
+    // Crowd shuttling between the first and the last open cell, drawn as instanced boxes
+    InitMazeCrowd(data);
+    
+    // Floor lit by static lights from a baked lightmap with wall shadows. Advanced shading adds a second
+    // floor (built by UpdateMazeScene when first needed) with the same vertices that keeps base colors so
+    // only vertices near moving lights get relit.
+    data->gfxConfig = gfxConfig;
+    data->lightmapFloorModel = LoadModelFromMesh(GenMeshFloorBase(WORLD_SIZE * 2, WORLD_SIZE * 2, FLOOR_SEGMENTS * 2, FLOOR_SEGMENTS * 2));
+    data->lightmapKey = 0;
+    data->lightmapBake = NULL;
+    Lightmap lightmap = LoadOrBakeMazeLightmap(&data->maze, lighting, gfxConfig, WORLD_SIZE * 2, LIGHTMAP_RESOLUTION);
+    if (lightmap.texels) SetMazeLightmap(data, &lightmap);
+    UnloadLightmap(&lightmap);
+    data->lightmapBakeKey = data->lightmapKey;
     data->advancedMeshGenerated = false;
+    data->relight = NULL;
+    
     scene->initialized = true;
 }
 
 void UpdateMazeScene(Scene* scene, float deltaTime, Camera3D* camera) {
-    // Maze scene doesn't need much updating
+    MazeSceneData* data = (MazeSceneData*)scene->sceneData;
+    
+    // Static lights or shading settings changed (cache files make switching back instant). The lightmap is
+    // baked with the probes, so it waits for a probe rebake in flight.
+    UpdateMazeProbes(data);
+    UpdateMazeLightmap(data, !data->gfxConfig->perPixelLightingEnabled && !data->probeBake);
+    
+    // Refresh the baked colors around lights that moved since the last frame
+    if (data->gfxConfig->advancedShadingEnabled && !data->gfxConfig->perPixelLightingEnabled) {
+        if (!data->advancedMeshGenerated) {
+            data->advancedFloorModel = LoadModelFromMesh(GenMeshFloorBase(WORLD_SIZE * 2, WORLD_SIZE * 2, FLOOR_SEGMENTS * 2, FLOOR_SEGMENTS * 2));
+            data->advancedMeshGenerated = true;
+            data->relight = CreateRelightGrid(RELIGHT_CELL_SIZE);
+            if (data->relight) {
+                data->relight->dynamicLightsOnly = true;
+                data->relight->scratchArena = scene->frameArena;
+            }
+            AddRelightMesh(data->relight, &data->advancedFloorModel.meshes[0]);
+        }
+        UpdateRelightGrid(data->relight, data->lighting, data->gfxConfig, (Vector3){ 0.0f, 1.0f, 0.0f });
+        UploadRelightGrid(data->relight);
+    }
+    if (data->gfxConfig->wallRenderMode == WALL_RENDER_BATCHED && !data->gfxConfig->perPixelLightingEnabled) {
+        UpdateRelightGrid(data->wallRelight, data->lighting, data->gfxConfig, (Vector3){ 0.0f, 0.0f, 1.0f });
+        UploadRelightGrid(data->wallRelight);
+    }
+}
+
+void StepMazeScene(Scene* scene, float stepTime) {
+    MazeSceneData* data = (MazeSceneData*)scene->sceneData;
+    
+    // Agents that reached their end of the maze turn around
+    if (data->crowd) {
+        StepMazeCrowd(data->crowd, stepTime);
+        for (int i = 0; i < data->crowd->count; i++) {
+            if (data->crowd->arrived[i]) data->crowd->goals[i] ^= 1;
+        }
+    }
 }
 
 void RenderMazeScene(Scene* scene, Camera3D camera, GraphicsConfig* gfxConfig, struct WireframeShader* wireframeShader) {
     MazeSceneData* data = (MazeSceneData*)scene->sceneData;
+    RenderStats* stats = &scene->stats;
+    RenderQueue* queue = scene->renderQueue;
+    
+    // Per-pixel path: lights are uniforms, so moving lights show up without rebuilding meshes
+    bool perPixel = gfxConfig->perPixelLightingEnabled && data->lightingShader.loaded;
+    Model wallModel = data->mazeWallModel;
     
     // Draw floor
-    if (gfxConfig->advancedShadingEnabled && data->advancedMeshGenerated) {
-        DrawModel(data->advancedFloorModel, (Vector3){ 0.0f, 0.0f, 0.0f }, 1.0f, WHITE);
+    if (perPixel) {
+        UpdateLightingShader(&data->lightingShader, data->lighting, gfxConfig, camera.position);
+        QueueModel(queue, data->shaderFloorModel, (Vector3){ 0.0f, 0.0f, 0.0f }, WHITE, RENDER_OPAQUE);
+        wallModel = data->shaderWallModel;
+    } else if (data->lightmapKey != 0) {
+        QueueModel(queue, data->lightmapFloorModel, (Vector3){ 0.0f, 0.0f, 0.0f }, WHITE, RENDER_OPAQUE);
+        if (gfxConfig->advancedShadingEnabled && data->advancedMeshGenerated) {
+            // Moving lights on top: same vertices, so the depth test passes with LEQUAL
+            QueueModel(queue, data->advancedFloorModel, (Vector3){ 0.0f, 0.0f, 0.0f }, WHITE, BLEND_ADDITIVE);
+        }
     } else {
-        DrawModel(data->floorModel, (Vector3){ 0.0f, 0.0f, 0.0f }, 1.0f, WHITE);
+        QueueModel(queue, data->floorModel, (Vector3){ 0.0f, 0.0f, 0.0f }, WHITE, RENDER_OPAQUE);
+    }
+    
+    // Crowd agents, one instanced draw per goal
+    if (data->crowd) {
+        for (int i = 0; i < data->crowd->count; i++) {
+            Vector2 position = GetMazeCrowdRenderPosition(data->crowd, i, scene->interpolation);
+            Matrix transform = MatrixTranslate(position.x, CROWD_AGENT_HEIGHT / 2.0f, position.y);
+            AddInstance(data->instancing, data->agentBatches[data->crowd->goals[i]], transform);
+        }
+        FlushInstancedRenderer(data->instancing, stats);
     }
     
-    // Draw maze walls
-    float cellSize = 10.0f;
+    // Draw maze walls: chunks inside the view frustum, one instanced draw, or one model per wall cell
+    if (gfxConfig->wallRenderMode == WALL_RENDER_BATCHED) {
+        Frustum frustum = GetCameraFrustum(camera, (float)GetScreenWidth() / (float)GetScreenHeight());
+        
+        // Below the wall tops only the PVS of the camera's cell can be seen (NULL inside a wall draws everything)
+        const MazePvsSet* visible = NULL;
+        if (camera.position.y < MAZE_WALL_TOP) {
+            Vector2 gridOrigin = GetMazeGridOrigin(&data->maze);
+            int col = (int)floorf((camera.position.x - gridOrigin.x) / MAZE_CELL_SIZE);
+            int row = (int)floorf((camera.position.z - gridOrigin.y) / MAZE_CELL_SIZE);
+            visible = GetMazePvsSet(data->pvs, col, row);
+        }
+        DrawMazeWallBatch(perPixel ? &data->shaderWallBatch : &data->wallBatch, &frustum, data->pvs, visible, queue, stats);
+        return;
+    }
+    
+    // The instancing shader doesn't do the per-pixel lighting, that path stays per cell
+    bool instanced = gfxConfig->wallRenderMode == WALL_RENDER_INSTANCED && !perPixel;
+    float cellSize = MAZE_CELL_SIZE;
     float mazeStartX = -(data->maze.width * cellSize) / 2.0f;
     float mazeStartZ = -(data->maze.height * cellSize) / 2.0f;
     
     for (int row = 0; row < data->maze.height; row++) {
         for (int col = 0; col < data->maze.width; col++) {
-            if (data->maze.data[row][col] == '#') {
+            if (MazeIsWall(&data->maze, col, row)) {
                 float wallX = mazeStartX + col * cellSize;
                 float wallZ = mazeStartZ + row * cellSize;
                 float wallY = WALL_HEIGHT / 2.0f;
                 
-                Vector3 wallPos = (Vector3){ wallX, wallY, wallZ };
-                DrawModel(data->mazeWallModel, wallPos, 1.0f, WHITE);
+                if (instanced) {
+                    AddInstance(data->instancing, data->wallInstances, MatrixTranslate(wallX, wallY, wallZ));
+                } else {
+                    QueueModel(queue, wallModel, (Vector3){ wallX, wallY, wallZ }, WHITE, RENDER_OPAQUE);
+                }
             }
         }
     }
+    if (instanced) FlushInstancedRenderer(data->instancing, stats);
 }
 
 void CleanupMazeScene(Scene* scene) {
@@ -137,26 +664,59 @@ void CleanupMazeScene(Scene* scene) {
         MazeSceneData* data = (MazeSceneData*)scene->sceneData;
         UnloadModel(data->mazeWallModel);
         UnloadModel(data->floorModel);
+        UnloadRelightGrid(data->relight);
+        UnloadModel(data->lightmapFloorModel);
         if (data->advancedMeshGenerated) {
             UnloadModel(data->advancedFloorModel);
         }
-        free(data);
+        UnloadModel(data->shaderFloorModel);
+        UnloadModel(data->shaderWallModel);
+        UnloadRelightGrid(data->wallRelight);
+        UnloadMazeWallBatch(&data->wallBatch);
+        UnloadMazeWallBatch(&data->shaderWallBatch);
+        UnloadInstancedRenderer(data->instancing);
+        UnloadMazeCrowd(data->crowd);
+        UnloadModel(data->agentModel);
+        UnloadMazePvs(data->pvs);
+        UnloadLightingShader(&data->lightingShader);
+        if (data->lightmapBake) {
+            Lightmap lightmap = FinishLightmapBake(data->lightmapBake);
+            UnloadLightmap(&lightmap);
+        }
+        if (data->probeBake) UnloadProbeGrid(FinishProbeBake(data->probeBake));
+        data->lighting->ambientProbes = NULL;
+        UnloadProbeGrid(data->probes);
+        UnloadMaze(&data->maze);
         scene->sceneData = NULL;
     }
 }
 
-// Terrain scene functions
-void InitTerrainScene(Scene* scene, LightingSystem* lighting, GraphicsConfig* gfxConfig) {
-    TerrainSceneData* data = (TerrainSceneData*)malloc(sizeof(TerrainSceneData));
-    scene->sceneData = data;
-    
-    // Initialize terrain data
-    data->terrain.size = TERRAIN_SIZE;
-    data->terrain.loaded = false;
-    data->terrain.heightMultiplier = 0.0f;  // Start with flat plane (no height)
-    data->terrain.needsRebuild = false;
-    
-    // Try to load height map
+// Probes only light this scene, the others go back to the flat ambient while it is suspended
+void SuspendMazeScene(Scene* scene) {
+    MazeSceneData* data = (MazeSceneData*)scene->sceneData;
+    data->lighting->ambientProbes = NULL;
+}
+
+void ResumeMazeScene(Scene* scene) {
+    MazeSceneData* data = (MazeSceneData*)scene->sceneData;
+    data->lighting->ambientProbes = data->probes;
+}
+
+size_t GetMazeSceneMemory(const Scene* scene) {
+    const MazeSceneData* data = (const MazeSceneData*)scene->sceneData;
+    size_t bytes = sizeof(*data) + (size_t)data->maze.height * data->maze.wordsPerRow * sizeof(unsigned int);
+    bytes += GetModelMemory(data->mazeWallModel) + GetModelMemory(data->floorModel) + GetModelMemory(data->lightmapFloorModel);
+    bytes += GetModelMemory(data->shaderFloorModel) + GetModelMemory(data->shaderWallModel) + GetModelMemory(data->agentModel);
+    bytes += GetModelMemory(data->wallBatch.model) + GetModelMemory(data->shaderWallBatch.model);
+    if (data->advancedMeshGenerated) bytes += GetModelMemory(data->advancedFloorModel);
+    if (data->lightmapKey != 0) bytes += GetTextureMemory(data->lightmapFloorModel.materials[0].maps[MATERIAL_MAP_DIFFUSE].texture);
+    if (data->probes) bytes += (size_t)data->probes->probeCount * (PROBE_SH_COEFFICIENTS * 3 * sizeof(float) + 1);
+    return bytes + GetMazePvsMemory(data->pvs);
+}
+
+// Fill terrain heights from heightmap.png (0-50 units), or an island of random heights when it is missing.
+// The decoded image is kept in heightImage for UploadTerrainHeightTexture, returns whether it was found.
+static bool LoadTerrainHeights(TerrainData* terrain) {
     Image heightImage = LoadImage("heightmap.png");
     if (heightImage.data != NULL) {
         // Convert image to height data
@@ -172,53 +732,101 @@ void InitTerrainScene(Scene* scene, LightingSystem* lighting, GraphicsConfig* gf
         for (int y = 0; y < TERRAIN_SIZE; y++) {
             for (int x = 0; x < TERRAIN_SIZE; x++) {
                 int index = y * TERRAIN_SIZE + x;
-                data->terrain.heights[y][x] = (float)pixels[index] / 255.0f * 50.0f; // Scale to 0-50 units height
+                terrain->heights[y][x] = (float)pixels[index] / 255.0f * 50.0f; // Scale to 0-50 units height
             }
         }
         
-        data->terrain.heightTexture = LoadTextureFromImage(heightImage);
-        UnloadImage(heightImage);
+        terrain->heightImage = heightImage;
+        return true;
+    }
+    
+    // Generate random terrain if no height map found
+    for (int y = 0; y < TERRAIN_SIZE; y++) {
+        for (int x = 0; x < TERRAIN_SIZE; x++) {
+            // Simple noise-like generation
+            float distance = sqrtf((x - TERRAIN_SIZE/2.0f) * (x - TERRAIN_SIZE/2.0f) + 
+                                 (y - TERRAIN_SIZE/2.0f) * (y - TERRAIN_SIZE/2.0f));
+            float normalizedDist = distance / (TERRAIN_SIZE * 0.5f);
+            
+            // Create island-like terrain
+            float height = (1.0f - normalizedDist) * 30.0f;
+            if (height < 0) height = 0;
+            
+            // Add some randomness
+            height += (float)(rand() % 100) / 100.0f * 5.0f - 2.5f;
+            if (height < 0) height = 0;
+            
+            terrain->heights[y][x] = height;
+        }
+    }
+    return false;
+}
+
+// Height texture from the image decoded by LoadTerrainHeights
+static void UploadTerrainHeightTexture(TerrainData* terrain) {
+    terrain->heightTexture = LoadTextureFromImage(terrain->heightImage);
+    UnloadImage(terrain->heightImage);
+    terrain->heightImage = (Image){ 0 };
+}
+
+// GPU part of the terrain load: height texture, and the terrain model from the mesh built by the load
+// job or the flat floor without one
+static bool UploadTerrainScene(SceneLoadTask* task, void* sceneData, bool wait) {
+    TerrainSceneData* data = (TerrainSceneData*)sceneData;
+    if (data->terrain.heightImage.data) UploadTerrainHeightTexture(&data->terrain);
+    if (data->terrainMesh.vertexCount > 0) {
+        UploadMesh(&data->terrainMesh, false);
+        data->terrain.terrainModel = LoadModelFromMesh(data->terrainMesh);
+        printf("Generated terrain mesh with %d vertices\n", data->terrainMesh.vertexCount);
+        data->terrainMesh = (Mesh){ 0 };
+    } else {
+        // Fallback basic floor
+        Mesh floorMesh = GenMeshFloorWithColors(WORLD_SIZE * 2, WORLD_SIZE * 2, FLOOR_SEGMENTS, FLOOR_SEGMENTS);
+        data->floorModel = LoadModelFromMesh(floorMesh);
+    }
+    return true;
+}
+
+// Terrain scene functions
+static void* LoadTerrainScene(SceneLoadTask* task, MemoryArena* arena) {
+    TerrainSceneData* data = (TerrainSceneData*)ArenaCalloc(arena, 1, sizeof(TerrainSceneData));
+    if (!data) return NULL;
+    
+    // Initialize terrain data
+    data->terrain.size = TERRAIN_SIZE;
+    data->terrain.loaded = false;
+    data->terrain.heightMultiplier = 0.0f;  // Start with flat plane (no height)
+    data->terrain.needsRebuild = false;
+    data->terrain.horizonMap = NULL;
+    
+    // Try to load height map
+    if (LoadTerrainHeights(&data->terrain)) {
         data->terrain.loaded = true;
         printf("Loaded height map: heightmap.png\n");
     } else {
-        // Generate random terrain if no height map found
-        printf("No heightmap.png found, generating random terrain\n");
-        for (int y = 0; y < TERRAIN_SIZE; y++) {
-            for (int x = 0; x < TERRAIN_SIZE; x++) {
-                // Simple noise-like generation
-                float distance = sqrtf((x - TERRAIN_SIZE/2.0f) * (x - TERRAIN_SIZE/2.0f) + 
-                                     (y - TERRAIN_SIZE/2.0f) * (y - TERRAIN_SIZE/2.0f));
-                float normalizedDist = distance / (TERRAIN_SIZE * 0.5f);
-                
-                // Create island-like terrain
-                float height = (1.0f - normalizedDist) * 30.0f;
-                if (height < 0) height = 0;
-                
-                // Add some randomness
-                height += (float)(rand() % 100) / 100.0f * 5.0f - 2.5f;
-                if (height < 0) height = 0;
-                
-                data->terrain.heights[y][x] = height;
-            }
-        }
+        printf("No heightmap.png found, generated random terrain\n");
     }
+    SetSceneLoadProgress(task, 0.3f);
     
     // Generate terrain mesh from height data
     if (data->terrain.loaded || data->terrain.size > 0) {
+        // Horizon angles are stored unscaled, so height multiplier changes don't need a rebake
+        data->terrain.horizonMap = BakeTerrainHorizonMap(&data->terrain, TERRAIN_PLANE_SIZE / (data->terrain.size - 1),
+                                                         HORIZON_DIRECTIONS);
+        SetSceneLoadProgress(task, 0.8f);
+
         // Create 102.4x102.4 unit terrain plane centered at origin
         float terrainScale = 0.1f;  // Each pixel = 0.1 units (creates 102.4x102.4 unit terrain)
         float heightScale = 5.0f;   // Maximum height of 5 units
-        
-        Mesh terrainMesh = GenMeshTerrainFromHeightMap(&data->terrain, terrainScale, heightScale);
-        data->terrain.terrainModel = LoadModelFromMesh(terrainMesh);
-        printf("Generated terrain mesh with %d vertices\n", terrainMesh.vertexCount);
-    } else {
-        // Fallback basic floor
-        Mesh floorMesh = GenMeshFloorWithColors(WORLD_SIZE * 2, WORLD_SIZE * 2, FLOOR_SEGMENTS, FLOOR_SEGMENTS);
-        data->floorModel = LoadModelFromMesh(floorMesh);
+        data->terrainMesh = BuildMeshTerrainFromHeightMap(&data->terrain, terrainScale, heightScale, arena);
     }
-    
-    scene->initialized = true;
+    return data;
+}
+
+void InitTerrainScene(Scene* scene, LightingSystem* lighting, GraphicsConfig* gfxConfig) {
+    scene->sceneData = LoadTerrainScene(NULL, scene->arena);
+    if (scene->sceneData) UploadTerrainScene(NULL, scene->sceneData, true);
+    scene->initialized = scene->sceneData != NULL;
 }
 
 void UpdateTerrainScene(Scene* scene, float deltaTime, Camera3D* camera) {
@@ -241,19 +849,10 @@ void UpdateTerrainScene(Scene* scene, float deltaTime, Camera3D* camera) {
         printf("Terrain height multiplier: %.1f\n", data->terrain.heightMultiplier);
     }
     
-    // Rebuild terrain if height changed
-    if (heightChanged && (data->terrain.loaded || data->terrain.size > 0)) {
-        // Unload old model
-        if (data->terrain.terrainModel.meshCount > 0) {
-            UnloadModel(data->terrain.terrainModel);
-        }
-        
-        // Regenerate terrain with new height
-        float terrainScale = 0.1f;  // Each pixel = 0.1 units (creates 102.4x102.4 unit terrain)
+    // Rebuild terrain in its existing buffers if height changed
+    if (heightChanged && data->terrain.terrainModel.meshCount > 0) {
         float heightScale = 5.0f;   // Base height scaling
-        
-        Mesh terrainMesh = GenMeshTerrainFromHeightMap(&data->terrain, terrainScale, heightScale);
-        data->terrain.terrainModel = LoadModelFromMesh(terrainMesh);
+        UpdateMeshTerrainFromHeightMap(&data->terrain.terrainModel.meshes[0], &data->terrain, heightScale);
     }
 }
 
@@ -262,9 +861,9 @@ void RenderTerrainScene(Scene* scene, Camera3D camera, GraphicsConfig* gfxConfig
     
     // Draw terrain or fallback floor
     if (data->terrain.terrainModel.meshCount > 0) {
-        DrawModel(data->terrain.terrainModel, (Vector3){ 0.0f, 0.0f, 0.0f }, 1.0f, WHITE);
+        QueueModel(scene->renderQueue, data->terrain.terrainModel, (Vector3){ 0.0f, 0.0f, 0.0f }, WHITE, RENDER_OPAQUE);
     } else if (data->floorModel.meshCount > 0) {
-        DrawModel(data->floorModel, (Vector3){ 0.0f, 0.0f, 0.0f }, 1.0f, GREEN);
+        QueueModel(scene->renderQueue, data->floorModel, (Vector3){ 0.0f, 0.0f, 0.0f }, GREEN, RENDER_OPAQUE);
     }
     
     // Draw some visual indication this is terrain scene
@@ -275,7 +874,7 @@ void CleanupTerrainScene(Scene* scene) {
     if (scene->sceneData) {
         TerrainSceneData* data = (TerrainSceneData*)scene->sceneData;
         if (data->terrain.terrainModel.meshCount > 0) {
-            UnloadModel(data->terrain.terrainModel);
+            UnloadArenaModel(data->terrain.terrainModel);
         }
         if (data->floorModel.meshCount > 0) {
             UnloadModel(data->floorModel);
@@ -283,12 +882,35 @@ void CleanupTerrainScene(Scene* scene) {
         if (data->terrain.loaded && data->terrain.heightTexture.id > 0) {
             UnloadTexture(data->terrain.heightTexture);
         }
-        free(data);
+        UnloadHorizonMap(data->terrain.horizonMap);
         scene->sceneData = NULL;
     }
 }
 
+size_t GetTerrainSceneMemory(const Scene* scene) {
+    const TerrainSceneData* data = (const TerrainSceneData*)scene->sceneData;
+    size_t bytes = sizeof(*data) + GetModelMemory(data->terrain.terrainModel) + GetModelMemory(data->floorModel);
+    if (data->terrain.loaded) bytes += GetTextureMemory(data->terrain.heightTexture);
+    if (data->terrain.horizonMap) {
+        const HorizonMap* horizon = data->terrain.horizonMap;
+        bytes += (size_t)horizon->size * horizon->size * horizon->directionCount;
+    }
+    return bytes;
+}
+
 // Scene creation functions
+// Slide along the maze walls while below their tops, above them the camera flies freely
+Vector3 MoveInMazeScene(Scene* scene, Vector3 position, Vector3 delta, float radius) {
+    MazeSceneData* data = (MazeSceneData*)scene->sceneData;
+    Vector3 moved = Vector3Add(position, delta);
+    if (!data || (position.y >= MAZE_WALL_TOP && moved.y >= MAZE_WALL_TOP)) return moved;
+    
+    Vector2 flat = MoveCircleInMaze(&data->maze, (Vector2){ position.x, position.z }, (Vector2){ delta.x, delta.z }, radius);
+    moved.x = flat.x;
+    moved.z = flat.y;
+    return moved;
+}
+
 Scene CreateMazeScene(void) {
     Scene scene = {0};
     scene.type = SCENE_MAZE;
@@ -298,8 +920,13 @@ Scene CreateMazeScene(void) {
     
     scene.init = InitMazeScene;
     scene.update = UpdateMazeScene;
+    scene.step = StepMazeScene;
     scene.render = RenderMazeScene;
     scene.cleanup = CleanupMazeScene;
+    scene.move = MoveInMazeScene;
+    scene.suspend = SuspendMazeScene;
+    scene.resume = ResumeMazeScene;
+    scene.memory = GetMazeSceneMemory;
     
     return scene;
 }
@@ -315,110 +942,147 @@ Scene CreateTerrainScene(void) {
     scene.update = UpdateTerrainScene;
     scene.render = RenderTerrainScene;
     scene.cleanup = CleanupTerrainScene;
+    scene.memory = GetTerrainSceneMemory;
+    scene.load = LoadTerrainScene;
+    scene.upload = UploadTerrainScene;
     
     return scene;
 }
 
+// Rebuild the procedural planet model from cached fBm patches
+static void RebuildProceduralPlanet(CubeSphereSceneData* data) {
+    if (!data->cubeSphere.heightCache) {
+        data->cubeSphere.heightCache = CreatePlanetHeightCache(PLANET_DEFAULT_CACHE_PATCHES, 1337);
+    }
+    if (data->cubeSphere.proceduralModel.meshCount > 0) {
+        UnloadModel(data->cubeSphere.proceduralModel);
+    }
+
+    float heightScale = 0.5f; // Same displacement scale as the heightmap planet
+    double startTime = GetTime();
+    Mesh faceMeshes[6];
+    GenMeshProceduralPlanet(faceMeshes, data->cubeSphere.radius, data->cubeSphere.proceduralLevel,
+                            data->cubeSphere.heightCache, heightScale, data->terrain.heightMultiplier, data->cubeSphere.morphFactor);
+    data->cubeSphere.proceduralModel = LoadModelFromMeshes(faceMeshes, 6);
+
+    if (data->cubeSphere.shaderLoaded) {
+        data->cubeSphere.proceduralModel.materials[0].shader = data->cubeSphere.planetShader;
+    }
+
+    printf("Built procedural planet level %d (%d vertices) in %.1f ms, patch cache %d/%d (hits %d, misses %d)\n",
+           data->cubeSphere.proceduralLevel, faceMeshes[0].vertexCount * 6, (GetTime() - startTime) * 1000.0,
+           data->cubeSphere.heightCache->count, data->cubeSphere.heightCache->capacity,
+           data->cubeSphere.heightCache->hits, data->cubeSphere.heightCache->misses);
+}
+
+// Planet wireframe shader, applied to every LOD model
+static void UploadCubeSphereShader(CubeSphereSceneData* data) {
+    data->cubeSphere.planetShader = LoadShader("planet.vs", "planet.fs");
+    if (data->cubeSphere.planetShader.id != rlGetShaderIdDefault()) {
+        data->cubeSphere.shaderLoaded = true;
+        data->cubeSphere.wireframeModeLocation = GetShaderLocation(data->cubeSphere.planetShader, "wireframeMode");
+        SetPlanetLodShader(data->cubeSphere.lodChain, data->cubeSphere.planetShader);
+        printf("Planet shader loaded for scene 3! Wireframe location: %d\n", data->cubeSphere.wireframeModeLocation);
+    } else {
+        data->cubeSphere.shaderLoaded = false;
+        printf("Failed to load planet shader for scene 3!\n");
+    }
+}
+
+// Reference cubes, they share one mesh with one instance batch per color
+static void UploadCubeSphereMarkers(CubeSphereSceneData* data) {
+    data->markerModel = LoadModelFromMesh(GenMeshCube(5.0f, 5.0f, 5.0f));
+    data->instancing = CreateInstancedRenderer();
+    Color markerColors[3] = { RED, GREEN, BLUE };
+    for (int i = 0; i < 3; i++) {
+        data->markerBatches[i] = AddInstanceBatch(data->instancing, data->markerModel.meshes[0], data->markerModel.materials[0], markerColors[i]);
+    }
+}
+
+// GPU part of the planet load: height texture, shader and markers, then the LOD build whose job
+// completions upload the levels as they finish
+static bool UploadCubeSphereScene(SceneLoadTask* task, void* sceneData, bool wait) {
+    CubeSphereSceneData* data = (CubeSphereSceneData*)sceneData;
+    if (!data->lodRequested) {
+        if (data->terrain.heightImage.data) UploadTerrainHeightTexture(&data->terrain);
+        UploadCubeSphereShader(data);
+        UploadCubeSphereMarkers(data);
+        RequestPlanetLodBuild(data->cubeSphere.lodChain, data->terrain.heightMultiplier, data->cubeSphere.morphFactor);
+        data->lodRequested = true;
+    }
+    if (wait) {
+        WaitPlanetLodBuild(data->cubeSphere.lodChain);
+    } else if (!IsPlanetLodBuildFinished(data->cubeSphere.lodChain)) {
+        return false;
+    }
+    
+    data->cubeSphere.loaded = true;
+    data->cubeSphere.needsRebuild = false;
+    printf("Initialized Planet Generation scene with radius %.1f and subdivision level %d\n", 
+           data->cubeSphere.radius, data->cubeSphere.subdivisionLevel);
+    
+    // A level whose build failed has no model and counts as 0
+    int lodVertices[PLANET_LOD_LEVELS] = { 0 };
+    for (int level = 0; level < PLANET_LOD_LEVELS; level++) {
+        const Model* model = &data->cubeSphere.lodChain->models[level];
+        if (model->meshCount > 0) lodVertices[level] = model->meshes[0].vertexCount;
+    }
+    printf("Terrain loaded: %s, LOD vertices: %d/%d/%d/%d\n", data->terrain.loaded ? "YES" : "NO",
+           lodVertices[0], lodVertices[1], lodVertices[2], lodVertices[3]);
+    return true;
+}
+
 // Cube-Sphere scene functions
-void InitCubeSphereScene(Scene* scene, LightingSystem* lighting, GraphicsConfig* gfxConfig) {
-    CubeSphereSceneData* data = (CubeSphereSceneData*)malloc(sizeof(CubeSphereSceneData));
-    scene->sceneData = data;
+static void* LoadCubeSphereScene(SceneLoadTask* task, MemoryArena* arena) {
+    CubeSphereSceneData* data = (CubeSphereSceneData*)ArenaCalloc(arena, 1, sizeof(CubeSphereSceneData));
+    if (!data) return NULL;
     
     // Initialize terrain data first
     data->terrain.size = TERRAIN_SIZE;
     data->terrain.loaded = false;
     data->terrain.heightMultiplier = 1.0f;  // Start with full terrain height
     data->terrain.needsRebuild = false;
+    data->terrain.horizonMap = NULL;
     
     // Try to load height map (same logic as terrain scene)
-    Image heightImage = LoadImage("heightmap.png");
-    if (heightImage.data != NULL) {
-        // Convert image to height data
-        ImageFormat(&heightImage, PIXELFORMAT_UNCOMPRESSED_GRAYSCALE);
-        
-        // Scale image to terrain size if needed
-        if (heightImage.width != TERRAIN_SIZE || heightImage.height != TERRAIN_SIZE) {
-            ImageResize(&heightImage, TERRAIN_SIZE, TERRAIN_SIZE);
-        }
-        
-        // Convert pixel data to height values
-        unsigned char* pixels = (unsigned char*)heightImage.data;
-        for (int y = 0; y < TERRAIN_SIZE; y++) {
-            for (int x = 0; x < TERRAIN_SIZE; x++) {
-                int index = y * TERRAIN_SIZE + x;
-                data->terrain.heights[y][x] = (float)pixels[index] / 255.0f * 50.0f; // Scale to 0-50 units height
-            }
-        }
-        
-        data->terrain.heightTexture = LoadTextureFromImage(heightImage);
-        UnloadImage(heightImage);
-        data->terrain.loaded = true;
+    if (LoadTerrainHeights(&data->terrain)) {
         printf("Loaded height map for terrain cube: heightmap.png\n");
     } else {
-        // Generate random terrain if no height map found
-        printf("No heightmap.png found, generating random terrain for cube\n");
-        for (int y = 0; y < TERRAIN_SIZE; y++) {
-            for (int x = 0; x < TERRAIN_SIZE; x++) {
-                // Simple noise-like generation
-                float distance = sqrtf((x - TERRAIN_SIZE/2.0f) * (x - TERRAIN_SIZE/2.0f) + 
-                                     (y - TERRAIN_SIZE/2.0f) * (y - TERRAIN_SIZE/2.0f));
-                float normalizedDist = distance / (TERRAIN_SIZE * 0.5f);
-                
-                // Create island-like terrain
-                float height = (1.0f - normalizedDist) * 30.0f;
-                if (height < 0) height = 0;
-                
-                // Add some randomness
-                height += (float)(rand() % 100) / 100.0f * 5.0f - 2.5f;
-                if (height < 0) height = 0;
-                
-                data->terrain.heights[y][x] = height;
-            }
-        }
-        data->terrain.loaded = true; // Mark as loaded even with generated terrain
+        printf("No heightmap.png found, generated random terrain for cube\n");
     }
+    data->terrain.loaded = true; // Mark as loaded even with generated terrain
+    SetSceneLoadProgress(task, 0.6f);
     
     // Initialize cube-sphere data
     data->cubeSphere.radius = 50.0f;
     data->cubeSphere.center = (Vector3){0.0f, 0.0f, 0.0f};
-    data->cubeSphere.subdivisionLevel = 16; // Higher subdivision for terrain detail
+    data->cubeSphere.subdivisionLevel = 16; // Finest LOD level, as detailed as the single mesh it replaced
     data->cubeSphere.dynamicSubdivisions = 16;
     data->cubeSphere.lastCameraDistance = 0.0f;
     data->cubeSphere.needsRebuild = true;
     data->cubeSphere.loaded = false;
     data->cubeSphere.morphFactor = 1.0f; // Start as a sphere (planet)
     data->cubeSphere.wireframeMode = false; // Start in solid mode
+    data->cubeSphere.proceduralMode = false; // Start with the heightmap planet
+    data->cubeSphere.proceduralLevel = 2;
+    data->cubeSphere.heightCache = NULL;
+    data->cubeSphere.proceduralModel = (Model){ 0 };
     
-    // Load planet wireframe shader
-    data->cubeSphere.planetShader = LoadShader("planet.vs", "planet.fs");
-    if (data->cubeSphere.planetShader.id != rlGetShaderIdDefault()) {
-        data->cubeSphere.shaderLoaded = true;
-        data->cubeSphere.wireframeModeLocation = GetShaderLocation(data->cubeSphere.planetShader, "wireframeMode");
-        printf("Planet shader loaded for scene 3! Wireframe location: %d\n", data->cubeSphere.wireframeModeLocation);
-    } else {
-        data->cubeSphere.shaderLoaded = false;
-        printf("Failed to load planet shader for scene 3!\n");
-    }
-    
-    // Generate initial mesh using terrain cube with morphing function
+    // LOD chain of terrain cube meshes, its levels are built on the job system once the upload requests them
     float heightScale = 0.5f; // Scale for terrain displacement
-    Mesh terrainCubeMesh = GenMeshTerrainCubeMorphing(data->cubeSphere.radius, data->cubeSphere.subdivisionLevel, &data->terrain, heightScale, data->cubeSphere.morphFactor);
-    data->cubeSphere.sphereModel = LoadModelFromMesh(terrainCubeMesh);
-    data->cubeSphere.sphereMesh = terrainCubeMesh;
-    
-    // Apply planet shader to the model if loaded
-    if (data->cubeSphere.shaderLoaded) {
-        data->cubeSphere.sphereModel.materials[0].shader = data->cubeSphere.planetShader;
-        printf("Planet shader applied to scene 3 model!\n");
+    data->cubeSphere.lodChain = CreatePlanetLodChain(&data->terrain, data->cubeSphere.radius, data->cubeSphere.subdivisionLevel, heightScale);
+    if (!data->cubeSphere.lodChain) {
+        UnloadImage(data->terrain.heightImage);
+        return NULL;
     }
     
-    data->cubeSphere.loaded = true;
-    data->cubeSphere.needsRebuild = false;
-    
-    scene->initialized = true;
-    printf("Initialized Planet Generation scene with radius %.1f and subdivision level %d\n", 
-           data->cubeSphere.radius, data->cubeSphere.subdivisionLevel);
-    printf("Terrain loaded: %s, vertices: %d\n", data->terrain.loaded ? "YES" : "NO", terrainCubeMesh.vertexCount);
+    return data;
+}
+
+void InitCubeSphereScene(Scene* scene, LightingSystem* lighting, GraphicsConfig* gfxConfig) {
+    scene->sceneData = LoadCubeSphereScene(NULL, scene->arena);
+    if (scene->sceneData) UploadCubeSphereScene(NULL, scene->sceneData, true);
+    scene->initialized = scene->sceneData != NULL;
 }
 
 void UpdateCubeSphereScene(Scene* scene, float deltaTime, Camera3D* camera) {
@@ -448,6 +1112,24 @@ void UpdateCubeSphereScene(Scene* scene, float deltaTime, Camera3D* camera) {
         printf("Wireframe mode: %s\n", data->cubeSphere.wireframeMode ? "ON" : "OFF");
     }
     
+    // Toggle procedural fBm heights with P, change patch level with [ and ]
+    bool proceduralChanged = false;
+    if (IsKeyPressed(KEY_P)) {
+        data->cubeSphere.proceduralMode = !data->cubeSphere.proceduralMode;
+        proceduralChanged = data->cubeSphere.proceduralMode;
+        printf("Procedural planet: %s\n", data->cubeSphere.proceduralMode ? "ON" : "OFF");
+    }
+    
+    if (data->cubeSphere.proceduralMode && IsKeyPressed(KEY_RIGHT_BRACKET) && data->cubeSphere.proceduralLevel < PLANET_MAX_PATCH_LEVEL) {
+        data->cubeSphere.proceduralLevel++;
+        proceduralChanged = true;
+    }
+    
+    if (data->cubeSphere.proceduralMode && IsKeyPressed(KEY_LEFT_BRACKET) && data->cubeSphere.proceduralLevel > 0) {
+        data->cubeSphere.proceduralLevel--;
+        proceduralChanged = true;
+    }
+    
     // Handle terrain height adjustment with 0/9 keys
     if (IsKeyPressed(KEY_NINE)) {  // 9 key - increase terrain height
         data->terrain.heightMultiplier += 0.1f;
@@ -466,29 +1148,28 @@ void UpdateCubeSphereScene(Scene* scene, float deltaTime, Camera3D* camera) {
     
 
     
-    // Rebuild terrain cube if terrain height or morph factor changed
+    // Procedural planet only re-evaluates noise for patches missing from the cache
+    if (data->cubeSphere.proceduralMode && (proceduralChanged || terrainChanged || morphChanged)) {
+        RebuildProceduralPlanet(data);
+    }
+    
+    // Rebuild the LOD chain in the background if terrain height or morph factor changed,
+    // the previous models keep rendering until the new ones are uploaded
     if ((terrainChanged || morphChanged) && data->terrain.loaded && data->cubeSphere.loaded) {
-        // Unload old model
-        if (data->cubeSphere.sphereModel.meshCount > 0) {
-            UnloadModel(data->cubeSphere.sphereModel);
-        }
-        
-        // Generate new terrain cube with current height multiplier and morph factor
-        float heightScale = 0.5f; // Base height scaling
-        Mesh newTerrainCubeMesh = GenMeshTerrainCubeMorphing(data->cubeSphere.radius, data->cubeSphere.subdivisionLevel, 
-                                                            &data->terrain, heightScale, data->cubeSphere.morphFactor);
-        data->cubeSphere.sphereModel = LoadModelFromMesh(newTerrainCubeMesh);
-        data->cubeSphere.sphereMesh = newTerrainCubeMesh;
-        
-        // Reapply planet shader after rebuilding
-        if (data->cubeSphere.shaderLoaded) {
-            data->cubeSphere.sphereModel.materials[0].shader = data->cubeSphere.planetShader;
+        RequestPlanetLodBuild(data->cubeSphere.lodChain, data->terrain.heightMultiplier, data->cubeSphere.morphFactor);
+        printf("Rebuilding planet with height multiplier %.1f\n", data->terrain.heightMultiplier);
+    }
+    
+    // Upload finished LOD levels and pick the level for the current camera distance
+    if (data->cubeSphere.loaded) {
+        int previousSubdivisions = data->cubeSphere.dynamicSubdivisions;
+        data->cubeSphere.lastCameraDistance = UpdatePlanetLodChain(data->cubeSphere.lodChain, data->cubeSphere.center,
+                                                                   camera->position, data->cubeSphere.radius);
+        data->cubeSphere.dynamicSubdivisions = data->cubeSphere.lodChain->subdivisions[data->cubeSphere.lodChain->currentLevel];
+        if (data->cubeSphere.dynamicSubdivisions != previousSubdivisions) {
+            printf("Planet LOD switched to subdivision %d at distance %.1f\n",
+                   data->cubeSphere.dynamicSubdivisions, data->cubeSphere.lastCameraDistance);
         }
-        
-        data->cubeSphere.needsRebuild = false;
-        
-        printf("Rebuilt planet with height multiplier %.1f (%d vertices)\n", 
-               data->terrain.heightMultiplier, newTerrainCubeMesh.vertexCount);
     }
 }
 
@@ -501,43 +1182,67 @@ void RenderCubeSphereScene(Scene* scene, Camera3D camera, GraphicsConfig* gfxCon
     if (data->cubeSphere.shaderLoaded) {
         // Set wireframe mode based on toggle state
         float wireframeValue = data->cubeSphere.wireframeMode ? 1.0f : 0.0f;
-        SetShaderValue(data->cubeSphere.planetShader, data->cubeSphere.wireframeModeLocation, &wireframeValue, SHADER_UNIFORM_FLOAT);
+        QueueShaderValue(scene->renderQueue, data->cubeSphere.planetShader, data->cubeSphere.wireframeModeLocation, &wireframeValue, SHADER_UNIFORM_FLOAT);
     }
     
     // Draw the planet model (shader is already assigned to the model material)
-    DrawModel(data->cubeSphere.sphereModel, data->cubeSphere.center, 1.0f, WHITE);
+    const Model* lodModel = GetPlanetLodModel(data->cubeSphere.lodChain);
+    if (data->cubeSphere.proceduralMode && data->cubeSphere.proceduralModel.meshCount > 0) {
+        QueueModel(scene->renderQueue, data->cubeSphere.proceduralModel, data->cubeSphere.center, WHITE, RENDER_OPAQUE);
+    } else if (lodModel) {
+        QueueModel(scene->renderQueue, *lodModel, data->cubeSphere.center, WHITE, RENDER_OPAQUE);
+    }
     
     // Draw some reference objects to show scale
-    DrawCube((Vector3){data->cubeSphere.radius + 20.0f, 0, 0}, 5, 5, 5, RED);
-    DrawCube((Vector3){0, data->cubeSphere.radius + 20.0f, 0}, 5, 5, 5, GREEN);
-    DrawCube((Vector3){0, 0, data->cubeSphere.radius + 20.0f}, 5, 5, 5, BLUE);
+    float markerDistance = data->cubeSphere.radius + 20.0f;
+    AddInstance(data->instancing, data->markerBatches[0], MatrixTranslate(markerDistance, 0.0f, 0.0f));
+    AddInstance(data->instancing, data->markerBatches[1], MatrixTranslate(0.0f, markerDistance, 0.0f));
+    AddInstance(data->instancing, data->markerBatches[2], MatrixTranslate(0.0f, 0.0f, markerDistance));
+    FlushInstancedRenderer(data->instancing, &scene->stats);
     
     // Draw UI info for planet generation
     DrawText(TextFormat("Planet Generation - Height: %.1f, Sphere: %.1f", data->terrain.heightMultiplier, data->cubeSphere.morphFactor), 10, 10, 20, WHITE);
-    DrawText(TextFormat("Subdivision Level: %d", data->cubeSphere.subdivisionLevel), 10, 35, 20, WHITE);
-    DrawText(TextFormat("Vertices: %d", data->cubeSphere.sphereMesh.vertexCount), 10, 60, 20, WHITE);
-    DrawText(TextFormat("Terrain Loaded: %s", data->terrain.loaded ? "YES" : "NO"), 10, 85, 20, WHITE);
-    DrawText("Press +/- for sphere morph, 0/9 for terrain height, F6 for wireframe", 10, 110, 20, YELLOW);
+    DrawText(TextFormat("Subdivision Level: %d (LOD %d, distance %.0f)", data->cubeSphere.dynamicSubdivisions,
+                        data->cubeSphere.lodChain->currentLevel, data->cubeSphere.lastCameraDistance), 10, 35, 20, WHITE);
+    DrawText(TextFormat("Vertices: %d", lodModel ? lodModel->meshes[0].vertexCount : 0), 10, 60, 20, WHITE);
+    if (data->cubeSphere.proceduralMode && data->cubeSphere.heightCache) {
+        DrawText(TextFormat("Procedural fBm: level %d, cached patches %d/%d", data->cubeSphere.proceduralLevel,
+                            data->cubeSphere.heightCache->count, data->cubeSphere.heightCache->capacity), 10, 85, 20, WHITE);
+    } else {
+        DrawText(TextFormat("Terrain Loaded: %s", data->terrain.loaded ? "YES" : "NO"), 10, 85, 20, WHITE);
+    }
+    DrawText("Press +/- for sphere morph, 0/9 for terrain height, F6 for wireframe, P procedural, [/] level", 10, 110, 20, YELLOW);
     DrawText("Terrain colors: Blue=Water, Tan=Beach, Green=Grass, Brown=Mountain, White=Snow", 10, 135, 18, LIGHTGRAY);
 }
 
 void CleanupCubeSphereScene(Scene* scene) {
     if (scene->sceneData) {
         CubeSphereSceneData* data = (CubeSphereSceneData*)scene->sceneData;
-        if (data->cubeSphere.loaded && data->cubeSphere.sphereModel.meshCount > 0) {
-            UnloadModel(data->cubeSphere.sphereModel);
+        UnloadPlanetLodChain(data->cubeSphere.lodChain);
+        if (data->cubeSphere.proceduralModel.meshCount > 0) {
+            UnloadModel(data->cubeSphere.proceduralModel);
         }
+        UnloadPlanetHeightCache(data->cubeSphere.heightCache);
+        UnloadInstancedRenderer(data->instancing);
+        UnloadModel(data->markerModel);
         if (data->cubeSphere.shaderLoaded) {
             UnloadShader(data->cubeSphere.planetShader);
         }
         if (data->terrain.loaded && data->terrain.heightTexture.id > 0) {
             UnloadTexture(data->terrain.heightTexture);
         }
-        free(data);
         scene->sceneData = NULL;
     }
 }
 
+size_t GetCubeSphereSceneMemory(const Scene* scene) {
+    const CubeSphereSceneData* data = (const CubeSphereSceneData*)scene->sceneData;
+    size_t bytes = sizeof(*data) + GetModelMemory(data->markerModel) + GetModelMemory(data->cubeSphere.proceduralModel);
+    for (int i = 0; i < PLANET_LOD_LEVELS; i++) bytes += GetModelMemory(data->cubeSphere.lodChain->models[i]);
+    if (data->terrain.loaded) bytes += GetTextureMemory(data->terrain.heightTexture);
+    return bytes;
+}
+
 Scene CreateCubeSphereScene(void) {
     Scene scene = {0};
     scene.type = SCENE_CUBE_SPHERE;
@@ -549,6 +1254,9 @@ Scene CreateCubeSphereScene(void) {
     scene.update = UpdateCubeSphereScene;
     scene.render = RenderCubeSphereScene;
     scene.cleanup = CleanupCubeSphereScene;
+    scene.memory = GetCubeSphereSceneMemory;
+    scene.load = LoadCubeSphereScene;
+    scene.upload = UploadCubeSphereScene;
     
     return scene;
 }
\ No newline at end of file
@@ -1,6 +1,10 @@
 #include "mesh_generation.h"
+#include "horizon_map.h"
 #include "raylib.h"
 #include "raymath.h"
+#include "arena.h"
+
+#define TERRAIN_AMBIENT 0.45f   // Share of the light that comes from the sky rather than the sun
 
 // Calculate the actual maximum height in the terrain
 float GetTerrainMaxHeight(const TerrainData* terrain, float heightScale) {
@@ -85,28 +89,38 @@ Color GetTerrainColorByHeight(float height, float maxHeight) {
     }
 }
 
-// Generate terrain mesh from height map with proper square quads
-Mesh GenMeshTerrainFromHeightMap(const TerrainData* terrain, float scale, float heightScale)
+// Darken a terrain color by horizon-map AO and sun shadow (heightMapX/Z in height texels)
+static Color ShadeTerrainColor(const TerrainData* terrain, Color color, Vector3 position, Vector3 normal,
+                               float heightMapX, float heightMapZ, float heightScale) {
+    int texelX = (int)(heightMapX + 0.5f);
+    int texelZ = (int)(heightMapZ + 0.5f);
+    float scale = heightScale * terrain->heightMultiplier;
+
+    Vector3 toSun = Vector3Normalize(Vector3Subtract((Vector3){SUN_POSITION_X, SUN_POSITION_Y, SUN_POSITION_Z}, position));
+    float diffuse = Vector3DotProduct(normal, toSun);
+    if (diffuse < 0.0f) diffuse = 0.0f;
+
+    float sun = diffuse * GetHorizonSunVisibility(terrain->horizonMap, texelX, texelZ, toSun, scale);
+    float sky = GetHorizonAmbientOcclusion(terrain->horizonMap, texelX, texelZ, scale);
+    float light = TERRAIN_AMBIENT * sky + (1.0f - TERRAIN_AMBIENT) * sun;
+
+    return (Color){
+        (unsigned char)(color.r * light),
+        (unsigned char)(color.g * light),
+        (unsigned char)(color.b * light),
+        color.a
+    };
+}
+
+// Fill positions, texcoords, normals and colors of a terrain mesh from the height map
+static void FillTerrainMeshVertices(Mesh* meshData, const TerrainData* terrain, float heightScale)
 {
-    // Use a smaller resolution for clearer quad structure
-    int resolution = 128; // 128x128 grid of quads
-    int vertexCount = (resolution + 1) * (resolution + 1);  // Need one extra vertex per dimension
-    int quadCount = resolution * resolution;
-    int triangleCount = quadCount * 2;  // 2 triangles per quad
-    
-    Mesh mesh = { 0 };
-    mesh.vertexCount = vertexCount;
-    mesh.triangleCount = triangleCount;
-    
-    mesh.vertices = (float *)MemAlloc(vertexCount * 3 * sizeof(float));
-    mesh.texcoords = (float *)MemAlloc(vertexCount * 2 * sizeof(float));
-    mesh.normals = (float *)MemAlloc(vertexCount * 3 * sizeof(float));
-    mesh.colors = (unsigned char *)MemAlloc(vertexCount * 4 * sizeof(unsigned char));
-    mesh.indices = (unsigned short *)MemAlloc(triangleCount * 3 * sizeof(unsigned short));
+    Mesh mesh = *meshData;
+    int resolution = TERRAIN_MESH_RESOLUTION;
     
     // Calculate plane dimensions to create equal width/height quads
-    float planeWidth = 100.0f;   // Total plane width
-    float planeHeight = 100.0f;  // Total plane height (same as width for square)
+    float planeWidth = TERRAIN_PLANE_SIZE;   // Total plane width
+    float planeHeight = TERRAIN_PLANE_SIZE;  // Total plane height (same as width for square)
     float quadSize = planeWidth / resolution;  // Size of each quad
     
     int vCounter = 0;
@@ -218,6 +232,10 @@ Mesh GenMeshTerrainFromHeightMap(const TerrainData* terrain, float scale, float
             
             // Get terrain color using new gradual gradient system
             Color vertexColor = GetTerrainColorByHeight(height, maxTerrainHeight);
+            if (terrain->horizonMap) {
+                vertexColor = ShadeTerrainColor(terrain, vertexColor, (Vector3){worldX, height, worldZ}, normal,
+                                                heightMapX, heightMapZ, heightScale);
+            }
             
             mesh.colors[cCounter] = vertexColor.r;
             mesh.colors[cCounter+1] = vertexColor.g;
@@ -230,6 +248,20 @@ Mesh GenMeshTerrainFromHeightMap(const TerrainData* terrain, float scale, float
             cCounter += 4;
         }
     }
+}
+
+// Build terrain mesh from height map with proper square quads, CPU only
+Mesh BuildMeshTerrainFromHeightMap(const TerrainData* terrain, float scale, float heightScale, MemoryArena* arena)
+{
+    // Use a smaller resolution for clearer quad structure
+    int resolution = TERRAIN_MESH_RESOLUTION;
+    int vertexCount = (resolution + 1) * (resolution + 1);  // Need one extra vertex per dimension
+    int quadCount = resolution * resolution;
+    int triangleCount = quadCount * 2;  // 2 triangles per quad
+    
+    Mesh mesh = { 0 };
+    if (!AllocMeshBuffers(&mesh, vertexCount, triangleCount, arena)) return (Mesh){ 0 };
+    FillTerrainMeshVertices(&mesh, terrain, heightScale);
     
     // Generate indices for proper quads (each quad = 2 triangles)
     int tCounter = 0;
@@ -259,6 +291,24 @@ Mesh GenMeshTerrainFromHeightMap(const TerrainData* terrain, float scale, float
         }
     }
     
+    return mesh;
+}
+
+// Generate terrain mesh from height map with proper square quads
+Mesh GenMeshTerrainFromHeightMap(const TerrainData* terrain, float scale, float heightScale)
+{
+    Mesh mesh = BuildMeshTerrainFromHeightMap(terrain, scale, heightScale, NULL);
     UploadMesh(&mesh, false);
     return mesh;
+}
+
+// Recompute a terrain mesh in its existing buffers, indices and texcoords don't depend on the heights
+void UpdateMeshTerrainFromHeightMap(Mesh* mesh, const TerrainData* terrain, float heightScale)
+{
+    FillTerrainMeshVertices(mesh, terrain, heightScale);
+    if (mesh->vboId != NULL) {
+        UpdateMeshBuffer(*mesh, 0, mesh->vertices, mesh->vertexCount * 3 * sizeof(float), 0);
+        UpdateMeshBuffer(*mesh, 2, mesh->normals, mesh->vertexCount * 3 * sizeof(float), 0);
+        UpdateMeshBuffer(*mesh, 3, mesh->colors, mesh->vertexCount * 4, 0);
+    }
 }
\ No newline at end of file
@@ -0,0 +1,654 @@
+#define _DEFAULT_SOURCE
+#include "thread_pool.h"
+#include "raylib.h"
+#include <pthread.h>
+#include <sched.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(_WIN32)
+    // windows.h clashes with raylib.h (CloseWindow, ShowCursor, Rectangle, DrawText), so the one call used
+    // here is declared by hand like raylib does
+    #define ALL_PROCESSOR_GROUPS 0xffff
+    __declspec(dllimport) unsigned long __stdcall GetActiveProcessorCount(unsigned short groupNumber);
+#else
+    #include <unistd.h>
+#endif
+
+#define JOB_NONE -1
+#define JOB_SPIN_COUNT 64           // Failed attempts to find a job before a thread blocks
+#define JOB_CHAIN_DEPENDENCIES 8    // Dependencies kept per job for WaitJob outside the workers
+#define JOB_CHAIN_DEPTH 8           // Levels of dependencies WaitJob follows outside the workers
+
+// Atomics use the GCC/Clang builtins, which follow the C11 memory model without needing -std=c11
+#define ATOMIC_LOAD(p, order) __atomic_load_n((p), (order))
+#define ATOMIC_STORE(p, v, order) __atomic_store_n((p), (v), (order))
+#define ATOMIC_ADD(p, v, order) __atomic_add_fetch((p), (v), (order))
+#define ATOMIC_CAS(p, expected, desired) \
+    __atomic_compare_exchange_n((p), (expected), (desired), false, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED)
+
+typedef struct {
+    JobFunc func;
+    JobFunc completion;
+    void* context;
+    unsigned int generation;                // Bumped when the job finishes
+    int pendingDependencies;                // Unfinished dependencies, plus one while the job is being scheduled
+    int dependents[JOB_MAX_DEPENDENTS];     // Jobs waiting on this one, guarded by dependencyMutex
+    int dependentCount;
+    JobHandle dependencies[JOB_CHAIN_DEPENDENCIES];    // First dependencies, for WaitJob outside the workers
+    int dependencyCount;
+} Job;
+
+// Chase-Lev deque of job indices: the owning worker pushes and pops at the bottom, other threads
+// steal from the top. JOB_CAPACITY entries hold every job in flight, so it never grows.
+typedef struct {
+    long long top;
+    long long bottom;
+    int* jobs;
+    char padding[64];                       // Keeps the next deque's indices off this cache line
+} JobDeque;
+
+typedef struct {
+    JobFunc func;
+    void* context;
+} JobCompletion;
+
+typedef struct {
+    pthread_t threads[MAX_POOL_THREADS];
+    int threadCount;                // Worker threads
+    int size;                       // Threads a ParallelFor is spread over
+    bool initialized;
+    bool shutdown;
+
+    Job* jobs;                      // JOB_CAPACITY slots
+    int* freeJobs;
+    int freeCount;
+    pthread_mutex_t freeMutex;
+    pthread_mutex_t dependencyMutex;
+
+    JobDeque deques[MAX_POOL_THREADS];
+
+    // Jobs made runnable by threads that aren't workers (the main thread, loaders)
+    int* injected;
+    long long injectedHead;
+    long long injectedTail;
+    pthread_mutex_t injectMutex;
+
+    int queuedJobs;                 // Runnable jobs not taken yet
+    int pushes;                     // Jobs made runnable so far, wakes threads waiting on one chain
+    pthread_mutex_t sleepMutex;
+    pthread_cond_t workAvailable;   // Idle workers wait here
+    pthread_cond_t jobFinished;     // WaitJob callers wait here
+    int idleWorkers;
+    int waiters;
+
+    pthread_mutex_t completionMutex;
+    JobCompletion* completions;
+    int completionHead;
+    int completionCount;
+    int completionCapacity;
+
+    JobStats stats;
+} ThreadPool;
+
+static ThreadPool pool = { 0 };
+
+static __thread int workerIndex = -1;   // Deque of the calling thread, -1 outside the workers
+static __thread unsigned int stealSeed = 0;
+
+static void PushDeque(JobDeque* deque, int job) {
+    long long bottom = ATOMIC_LOAD(&deque->bottom, __ATOMIC_RELAXED);
+    ATOMIC_STORE(&deque->jobs[bottom & (JOB_CAPACITY - 1)], job, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    ATOMIC_STORE(&deque->bottom, bottom + 1, __ATOMIC_RELAXED);
+}
+
+// Newest job of the owner's deque, races thieves for the last one
+static int PopDeque(JobDeque* deque) {
+    long long bottom = ATOMIC_LOAD(&deque->bottom, __ATOMIC_RELAXED) - 1;
+    ATOMIC_STORE(&deque->bottom, bottom, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    long long top = ATOMIC_LOAD(&deque->top, __ATOMIC_RELAXED);
+
+    int job = JOB_NONE;
+    if (top <= bottom) {
+        job = ATOMIC_LOAD(&deque->jobs[bottom & (JOB_CAPACITY - 1)], __ATOMIC_RELAXED);
+        if (top == bottom) {
+            if (!ATOMIC_CAS(&deque->top, &top, top + 1)) job = JOB_NONE;
+            ATOMIC_STORE(&deque->bottom, bottom + 1, __ATOMIC_RELAXED);
+        }
+    } else {
+        ATOMIC_STORE(&deque->bottom, bottom + 1, __ATOMIC_RELAXED);
+    }
+    return job;
+}
+
+// Whether a job is the waited job or one it depends on, directly or through up to depth levels of
+// dependencies. Reads the dependency lists without a lock: a waited job that finishes meanwhile can
+// only make the answer wrong, which costs a wait but never runs a job twice.
+static bool IsInJobChain(int index, JobHandle waited, int depth) {
+    if (waited.index < 0 || waited.index >= JOB_CAPACITY) return false;
+    Job* job = &pool.jobs[waited.index];
+    if (ATOMIC_LOAD(&job->generation, __ATOMIC_ACQUIRE) != waited.generation) return false;
+    if (index == waited.index) return true;
+    if (depth <= 0) return false;
+
+    int count = ATOMIC_LOAD(&job->dependencyCount, __ATOMIC_ACQUIRE);
+    for (int i = 0; i < count; i++) {
+        JobHandle dependency = { ATOMIC_LOAD(&job->dependencies[i].index, __ATOMIC_RELAXED),
+                                 ATOMIC_LOAD(&job->dependencies[i].generation, __ATOMIC_RELAXED) };
+        if (IsInJobChain(index, dependency, depth - 1)) return true;
+    }
+    return false;
+}
+
+// Oldest job of another thread's deque, JOB_NONE when it is empty, another thief won or the job isn't
+// in the chain of waited (NULL takes any job)
+static int StealDeque(JobDeque* deque, const JobHandle* waited) {
+    long long top = ATOMIC_LOAD(&deque->top, __ATOMIC_ACQUIRE);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    long long bottom = ATOMIC_LOAD(&deque->bottom, __ATOMIC_ACQUIRE);
+    if (top >= bottom) return JOB_NONE;
+
+    int job = ATOMIC_LOAD(&deque->jobs[top & (JOB_CAPACITY - 1)], __ATOMIC_RELAXED);
+    if (waited && !IsInJobChain(job, *waited, JOB_CHAIN_DEPTH)) return JOB_NONE;
+    if (!ATOMIC_CAS(&deque->top, &top, top + 1)) return JOB_NONE;
+    return job;
+}
+
+// Make a job runnable: onto the calling worker's deque, or the shared queue from other threads
+static void PushJob(int job) {
+    if (workerIndex >= 0) {
+        PushDeque(&pool.deques[workerIndex], job);
+    } else {
+        pthread_mutex_lock(&pool.injectMutex);
+        pool.injected[pool.injectedTail & (JOB_CAPACITY - 1)] = job;
+        ATOMIC_STORE(&pool.injectedTail, pool.injectedTail + 1, __ATOMIC_RELEASE);
+        pthread_mutex_unlock(&pool.injectMutex);
+    }
+
+    // Sleepers recheck queuedJobs after announcing themselves, so one side always sees the other
+    ATOMIC_ADD(&pool.queuedJobs, 1, __ATOMIC_SEQ_CST);
+    ATOMIC_ADD(&pool.pushes, 1, __ATOMIC_SEQ_CST);
+    int idleWorkers = ATOMIC_LOAD(&pool.idleWorkers, __ATOMIC_SEQ_CST);
+    int waiters = ATOMIC_LOAD(&pool.waiters, __ATOMIC_SEQ_CST);
+    if (idleWorkers > 0 || waiters > 0) {
+        pthread_mutex_lock(&pool.sleepMutex);
+        if (idleWorkers > 0) pthread_cond_signal(&pool.workAvailable);
+        if (waiters > 0) pthread_cond_broadcast(&pool.jobFinished);
+        pthread_mutex_unlock(&pool.sleepMutex);
+    }
+}
+
+// Next runnable job for the calling thread: its own newest, then the shared queue, then the oldest
+// job of a random other worker
+static int TakeJob(void) {
+    if (ATOMIC_LOAD(&pool.queuedJobs, __ATOMIC_RELAXED) <= 0) return JOB_NONE;
+
+    int job = JOB_NONE;
+    if (workerIndex >= 0) job = PopDeque(&pool.deques[workerIndex]);
+
+    if (job == JOB_NONE && ATOMIC_LOAD(&pool.injectedHead, __ATOMIC_RELAXED) != ATOMIC_LOAD(&pool.injectedTail, __ATOMIC_ACQUIRE)) {
+        pthread_mutex_lock(&pool.injectMutex);
+        if (pool.injectedHead != pool.injectedTail) {
+            job = pool.injected[pool.injectedHead & (JOB_CAPACITY - 1)];
+            ATOMIC_STORE(&pool.injectedHead, pool.injectedHead + 1, __ATOMIC_RELAXED);
+        }
+        pthread_mutex_unlock(&pool.injectMutex);
+    }
+
+    if (job == JOB_NONE) {
+        stealSeed = stealSeed * 1664525u + 1013904223u;
+        int start = (int)((stealSeed >> 16) % (unsigned int)pool.threadCount);
+        for (int i = 0; i < pool.threadCount && job == JOB_NONE; i++) {
+            int victim = (start + i) % pool.threadCount;
+            if (victim == workerIndex) continue;
+            job = StealDeque(&pool.deques[victim], NULL);
+            if (job != JOB_NONE) ATOMIC_ADD(&pool.stats.stolen, 1, __ATOMIC_RELAXED);
+        }
+    }
+
+    if (job != JOB_NONE) ATOMIC_ADD(&pool.queuedJobs, -1, __ATOMIC_SEQ_CST);
+    return job;
+}
+
+// Runnable job from the chain of waited for a thread that isn't a worker: the first one in the shared
+// queue, else the oldest job of a worker's deque if it belongs to the chain
+static int TakeChainJob(JobHandle waited) {
+    if (ATOMIC_LOAD(&pool.queuedJobs, __ATOMIC_RELAXED) <= 0) return JOB_NONE;
+
+    int job = JOB_NONE;
+    if (ATOMIC_LOAD(&pool.injectedHead, __ATOMIC_RELAXED) != ATOMIC_LOAD(&pool.injectedTail, __ATOMIC_ACQUIRE)) {
+        pthread_mutex_lock(&pool.injectMutex);
+        for (long long position = pool.injectedHead; position != pool.injectedTail && job == JOB_NONE; position++) {
+            int candidate = pool.injected[position & (JOB_CAPACITY - 1)];
+            if (!IsInJobChain(candidate, waited, JOB_CHAIN_DEPTH)) continue;
+
+            // Close the gap by moving the jobs in front of it back one entry
+            for (long long move = position; move != pool.injectedHead; move--) {
+                pool.injected[move & (JOB_CAPACITY - 1)] = pool.injected[(move - 1) & (JOB_CAPACITY - 1)];
+            }
+            ATOMIC_STORE(&pool.injectedHead, pool.injectedHead + 1, __ATOMIC_RELAXED);
+            job = candidate;
+        }
+        pthread_mutex_unlock(&pool.injectMutex);
+    }
+
+    for (int i = 0; i < pool.threadCount && job == JOB_NONE; i++) {
+        job = StealDeque(&pool.deques[i], &waited);
+        if (job != JOB_NONE) ATOMIC_ADD(&pool.stats.stolen, 1, __ATOMIC_RELAXED);
+    }
+
+    if (job != JOB_NONE) ATOMIC_ADD(&pool.queuedJobs, -1, __ATOMIC_SEQ_CST);
+    return job;
+}
+
+static void QueueJobCompletion(JobFunc func, void* context) {
+    pthread_mutex_lock(&pool.completionMutex);
+    if (pool.completionCount == pool.completionCapacity && pool.completionHead > 0) {
+        pool.completionCount -= pool.completionHead;
+        memmove(pool.completions, pool.completions + pool.completionHead, pool.completionCount * sizeof(JobCompletion));
+        pool.completionHead = 0;
+    }
+    if (pool.completionCount == pool.completionCapacity) {
+        int capacity = (pool.completionCapacity > 0) ? pool.completionCapacity * 2 : 64;
+        JobCompletion* completions = (JobCompletion*)realloc(pool.completions, capacity * sizeof(JobCompletion));
+        if (!completions) {
+            pthread_mutex_unlock(&pool.completionMutex);
+            TraceLog(LOG_WARNING, "THREADPOOL: Out of memory, dropped a job completion");
+            return;
+        }
+        pool.completions = completions;
+        pool.completionCapacity = capacity;
+    }
+    pool.completions[pool.completionCount++] = (JobCompletion){ func, context };
+    pthread_mutex_unlock(&pool.completionMutex);
+}
+
+// Mark a job done, queue its completion, free its slot and release the jobs waiting on it
+static void FinishJob(int index) {
+    Job* job = &pool.jobs[index];
+    JobFunc completion = job->completion;
+    void* context = job->context;
+
+    int dependents[JOB_MAX_DEPENDENTS];
+    pthread_mutex_lock(&pool.dependencyMutex);
+    int dependentCount = job->dependentCount;
+    memcpy(dependents, job->dependents, dependentCount * sizeof(int));
+    job->dependentCount = 0;
+    unsigned int generation = job->generation + 1;
+    if (generation == 0) generation = 1;
+    ATOMIC_STORE(&job->generation, generation, __ATOMIC_SEQ_CST);
+    pthread_mutex_unlock(&pool.dependencyMutex);
+
+    if (completion) QueueJobCompletion(completion, context);
+
+    pthread_mutex_lock(&pool.freeMutex);
+    pool.freeJobs[pool.freeCount++] = index;
+    pthread_mutex_unlock(&pool.freeMutex);
+
+    for (int i = 0; i < dependentCount; i++) {
+        if (ATOMIC_ADD(&pool.jobs[dependents[i]].pendingDependencies, -1, __ATOMIC_ACQ_REL) == 0) PushJob(dependents[i]);
+    }
+
+    if (ATOMIC_LOAD(&pool.waiters, __ATOMIC_SEQ_CST) > 0) {
+        pthread_mutex_lock(&pool.sleepMutex);
+        pthread_cond_broadcast(&pool.jobFinished);
+        pthread_mutex_unlock(&pool.sleepMutex);
+    }
+}
+
+static void RunJob(int index) {
+    Job* job = &pool.jobs[index];
+    job->func(job->context);
+    FinishJob(index);
+}
+
+// Free job slot. When all JOB_CAPACITY are in flight workers run queued jobs until one is released,
+// other threads wait for the workers like WaitJob does (they only run jobs when no worker started).
+static int AllocJobSlot(void) {
+    bool anyJob = workerIndex >= 0 || pool.threadCount == 0;
+    int idle = 0;
+    while (true) {
+        pthread_mutex_lock(&pool.freeMutex);
+        int index = (pool.freeCount > 0) ? pool.freeJobs[--pool.freeCount] : JOB_NONE;
+        pthread_mutex_unlock(&pool.freeMutex);
+        if (index != JOB_NONE) return index;
+
+        int job = anyJob ? TakeJob() : JOB_NONE;
+        if (job != JOB_NONE) {
+            RunJob(job);
+            idle = 0;
+            continue;
+        }
+        if (anyJob || ++idle < JOB_SPIN_COUNT) {
+            sched_yield();
+            continue;
+        }
+
+        // FinishJob frees the slot under freeMutex before it checks waiters, so the release can't be missed
+        pthread_mutex_lock(&pool.sleepMutex);
+        ATOMIC_ADD(&pool.waiters, 1, __ATOMIC_SEQ_CST);
+        while (true) {
+            pthread_mutex_lock(&pool.freeMutex);
+            int freeCount = pool.freeCount;
+            pthread_mutex_unlock(&pool.freeMutex);
+            if (freeCount > 0) break;
+            pthread_cond_wait(&pool.jobFinished, &pool.sleepMutex);
+        }
+        ATOMIC_ADD(&pool.waiters, -1, __ATOMIC_SEQ_CST);
+        pthread_mutex_unlock(&pool.sleepMutex);
+        idle = 0;
+    }
+}
+
+static void* WorkerThread(void* arg) {
+    workerIndex = (int)(intptr_t)arg;
+    stealSeed = (unsigned int)workerIndex * 2654435761u + 1u;
+
+    int idle = 0;
+    while (true) {
+        int job = TakeJob();
+        if (job != JOB_NONE) {
+            RunJob(job);
+            idle = 0;
+            continue;
+        }
+        if (ATOMIC_LOAD(&pool.shutdown, __ATOMIC_ACQUIRE)) break;
+        if (++idle < JOB_SPIN_COUNT) {
+            sched_yield();
+            continue;
+        }
+
+        pthread_mutex_lock(&pool.sleepMutex);
+        ATOMIC_ADD(&pool.idleWorkers, 1, __ATOMIC_SEQ_CST);
+        while (!pool.shutdown && ATOMIC_LOAD(&pool.queuedJobs, __ATOMIC_SEQ_CST) <= 0) {
+            pthread_cond_wait(&pool.workAvailable, &pool.sleepMutex);
+        }
+        ATOMIC_ADD(&pool.idleWorkers, -1, __ATOMIC_SEQ_CST);
+        pthread_mutex_unlock(&pool.sleepMutex);
+        ATOMIC_ADD(&pool.stats.sleeps, 1, __ATOMIC_RELAXED);
+        idle = 0;
+    }
+
+    return NULL;
+}
+
+// Number of online CPU cores
+int GetCPUCoreCount(void) {
+#if defined(_WIN32)
+    int cores = (int)GetActiveProcessorCount(ALL_PROCESSOR_GROUPS);
+#else
+    int cores = (int)sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+    return (cores < 1) ? 1 : cores;
+}
+
+// Start worker threads (threadCount <= 0 uses the number of CPU cores)
+void InitThreadPool(int threadCount) {
+    if (pool.initialized) return;
+
+    if (threadCount <= 0) threadCount = GetCPUCoreCount();
+    if (threadCount > MAX_POOL_THREADS) threadCount = MAX_POOL_THREADS;
+
+    pool.jobs = (Job*)calloc(JOB_CAPACITY, sizeof(Job));
+    pool.freeJobs = (int*)malloc(JOB_CAPACITY * sizeof(int));
+    pool.injected = (int*)malloc(JOB_CAPACITY * sizeof(int));
+    int* dequeJobs = (int*)malloc((size_t)MAX_POOL_THREADS * JOB_CAPACITY * sizeof(int));
+    if (!pool.jobs || !pool.freeJobs || !pool.injected || !dequeJobs) {
+        free(pool.jobs);
+        free(pool.freeJobs);
+        free(pool.injected);
+        free(dequeJobs);
+        memset(&pool, 0, sizeof(pool));
+        TraceLog(LOG_ERROR, "THREADPOOL: Out of memory for the job queues");
+        return;
+    }
+
+    // Slots handed out lowest first, generations start at 1 so the zero handle reads as done
+    for (int i = 0; i < JOB_CAPACITY; i++) {
+        pool.jobs[i].generation = 1;
+        pool.freeJobs[i] = JOB_CAPACITY - 1 - i;
+    }
+    pool.freeCount = JOB_CAPACITY;
+    for (int i = 0; i < MAX_POOL_THREADS; i++) {
+        pool.deques[i].top = 0;
+        pool.deques[i].bottom = 0;
+        pool.deques[i].jobs = dequeJobs + (size_t)i * JOB_CAPACITY;
+    }
+    pool.injectedHead = 0;
+    pool.injectedTail = 0;
+    pool.queuedJobs = 0;
+    pool.pushes = 0;
+    pool.idleWorkers = 0;
+    pool.waiters = 0;
+    memset(&pool.stats, 0, sizeof(pool.stats));
+
+    pthread_mutex_init(&pool.freeMutex, NULL);
+    pthread_mutex_init(&pool.dependencyMutex, NULL);
+    pthread_mutex_init(&pool.injectMutex, NULL);
+    pthread_mutex_init(&pool.sleepMutex, NULL);
+    pthread_mutex_init(&pool.completionMutex, NULL);
+    pthread_cond_init(&pool.workAvailable, NULL);
+    pthread_cond_init(&pool.jobFinished, NULL);
+    pool.shutdown = false;
+    pool.threadCount = 0;
+    pool.initialized = true;
+
+    // The calling thread also runs chunks, so start one worker less than requested. One worker is
+    // started on single-core machines as well so scheduled jobs run without anyone waiting on them.
+    int workers = (threadCount > 1) ? threadCount - 1 : 1;
+    for (int i = 0; i < workers; i++) {
+        if (pthread_create(&pool.threads[pool.threadCount], NULL, WorkerThread, (void*)(intptr_t)pool.threadCount) == 0) {
+            pool.threadCount++;
+        }
+    }
+    pool.size = (pool.threadCount > 0) ? threadCount : 1;
+
+    TraceLog(LOG_INFO, "THREADPOOL: Started %d worker threads", pool.threadCount);
+}
+
+// Stop and join all worker threads
+void ShutdownThreadPool(void) {
+    if (!pool.initialized) return;
+
+    pthread_mutex_lock(&pool.sleepMutex);
+    ATOMIC_STORE(&pool.shutdown, true, __ATOMIC_RELEASE);
+    pthread_cond_broadcast(&pool.workAvailable);
+    pthread_mutex_unlock(&pool.sleepMutex);
+
+    for (int i = 0; i < pool.threadCount; i++) {
+        pthread_join(pool.threads[i], NULL);
+    }
+
+    // Jobs scheduled from other threads after the workers ran out
+    int job;
+    while ((job = TakeJob()) != JOB_NONE) RunJob(job);
+
+    int dropped = pool.completionCount - pool.completionHead;
+    if (dropped > 0) TraceLog(LOG_WARNING, "THREADPOOL: Dropped %d job completions that never ran", dropped);
+
+    pthread_cond_destroy(&pool.jobFinished);
+    pthread_cond_destroy(&pool.workAvailable);
+    pthread_mutex_destroy(&pool.completionMutex);
+    pthread_mutex_destroy(&pool.sleepMutex);
+    pthread_mutex_destroy(&pool.injectMutex);
+    pthread_mutex_destroy(&pool.dependencyMutex);
+    pthread_mutex_destroy(&pool.freeMutex);
+    free(pool.completions);
+    free(pool.deques[0].jobs);
+    free(pool.injected);
+    free(pool.freeJobs);
+    free(pool.jobs);
+    memset(&pool, 0, sizeof(pool));
+}
+
+// Number of threads that take part in a ParallelFor (workers + caller)
+int GetThreadPoolSize(void) {
+    return pool.initialized ? pool.size : 1;
+}
+
+JobHandle ScheduleJob(JobFunc func, void* context, const JobHandle* dependencies, int dependencyCount) {
+    return ScheduleJobWithCompletion(func, NULL, context, dependencies, dependencyCount);
+}
+
+JobHandle ScheduleJobWithCompletion(JobFunc func, JobFunc completion, void* context, const JobHandle* dependencies, int dependencyCount) {
+    if (!pool.initialized) InitThreadPool(0);
+    if (!pool.initialized) {
+        func(context);
+        if (completion) completion(context);
+        return (JobHandle){ 0 };
+    }
+
+    int index = AllocJobSlot();
+    Job* job = &pool.jobs[index];
+    job->func = func;
+    job->completion = completion;
+    job->context = context;
+    ATOMIC_STORE(&job->pendingDependencies, 1, __ATOMIC_RELAXED);
+    int keptDependencies = (dependencyCount < JOB_CHAIN_DEPENDENCIES) ? dependencyCount : JOB_CHAIN_DEPENDENCIES;
+    for (int i = 0; i < keptDependencies; i++) {
+        ATOMIC_STORE(&job->dependencies[i].index, dependencies[i].index, __ATOMIC_RELAXED);
+        ATOMIC_STORE(&job->dependencies[i].generation, dependencies[i].generation, __ATOMIC_RELAXED);
+    }
+    ATOMIC_STORE(&job->dependencyCount, (keptDependencies > 0) ? keptDependencies : 0, __ATOMIC_RELEASE);
+    JobHandle handle = { index, ATOMIC_LOAD(&job->generation, __ATOMIC_RELAXED) };
+
+    // A dependency that finishes meanwhile has already bumped its generation under the same lock,
+    // otherwise it will see this job in its dependents and release it
+    pthread_mutex_lock(&pool.dependencyMutex);
+    for (int i = 0; i < dependencyCount; i++) {
+        if (dependencies[i].index < 0 || dependencies[i].index >= JOB_CAPACITY) continue;
+        Job* dependency = &pool.jobs[dependencies[i].index];
+        while (dependency->generation == dependencies[i].generation && dependency->dependentCount == JOB_MAX_DEPENDENTS) {
+            pthread_mutex_unlock(&pool.dependencyMutex);
+            WaitJob(dependencies[i]);
+            pthread_mutex_lock(&pool.dependencyMutex);
+        }
+        if (dependency->generation != dependencies[i].generation) continue;
+        dependency->dependents[dependency->dependentCount++] = index;
+        ATOMIC_ADD(&job->pendingDependencies, 1, __ATOMIC_RELAXED);
+    }
+    pthread_mutex_unlock(&pool.dependencyMutex);
+
+    ATOMIC_ADD(&pool.stats.scheduled, 1, __ATOMIC_RELAXED);
+    if (ATOMIC_ADD(&job->pendingDependencies, -1, __ATOMIC_ACQ_REL) == 0) PushJob(index);
+    return handle;
+}
+
+bool IsJobDone(JobHandle job) {
+    if (!pool.initialized || job.index < 0 || job.index >= JOB_CAPACITY) return true;
+    return ATOMIC_LOAD(&pool.jobs[job.index].generation, __ATOMIC_SEQ_CST) != job.generation;
+}
+
+void WaitJob(JobHandle job) {
+    // Workers run any job meanwhile. Other threads only run the waited job and its dependencies, so the
+    // main thread never ends up inside a long unrelated job such as a probe bake.
+    bool anyJob = workerIndex >= 0;
+    int idle = 0;
+    while (!IsJobDone(job)) {
+        int pushes = ATOMIC_LOAD(&pool.pushes, __ATOMIC_SEQ_CST);
+        int next = anyJob ? TakeJob() : TakeChainJob(job);
+        if (next != JOB_NONE) {
+            RunJob(next);
+            idle = 0;
+            continue;
+        }
+        if (++idle < JOB_SPIN_COUNT) {
+            sched_yield();
+            continue;
+        }
+
+        // Woken when any job finishes or becomes runnable, FinishJob and PushJob check waiters
+        pthread_mutex_lock(&pool.sleepMutex);
+        ATOMIC_ADD(&pool.waiters, 1, __ATOMIC_SEQ_CST);
+        while (!IsJobDone(job) && (anyJob ? ATOMIC_LOAD(&pool.queuedJobs, __ATOMIC_SEQ_CST) <= 0
+                                          : ATOMIC_LOAD(&pool.pushes, __ATOMIC_SEQ_CST) == pushes)) {
+            pthread_cond_wait(&pool.jobFinished, &pool.sleepMutex);
+        }
+        ATOMIC_ADD(&pool.waiters, -1, __ATOMIC_SEQ_CST);
+        pthread_mutex_unlock(&pool.sleepMutex);
+        idle = 0;
+    }
+}
+
+int RunJobCompletions(int maxCount) {
+    if (!pool.initialized) return 0;
+
+    int count = 0;
+    while (maxCount <= 0 || count < maxCount) {
+        pthread_mutex_lock(&pool.completionMutex);
+        if (pool.completionHead == pool.completionCount) {
+            pool.completionHead = 0;
+            pool.completionCount = 0;
+            pthread_mutex_unlock(&pool.completionMutex);
+            break;
+        }
+        JobCompletion completion = pool.completions[pool.completionHead++];
+        pthread_mutex_unlock(&pool.completionMutex);
+
+        // Outside the lock, completions may schedule more jobs
+        completion.func(completion.context);
+        count++;
+    }
+    ATOMIC_ADD(&pool.stats.completions, count, __ATOMIC_RELAXED);
+    return count;
+}
+
+JobStats GetJobStats(void) {
+    JobStats stats;
+    stats.scheduled = ATOMIC_LOAD(&pool.stats.scheduled, __ATOMIC_RELAXED);
+    stats.stolen = ATOMIC_LOAD(&pool.stats.stolen, __ATOMIC_RELAXED);
+    stats.sleeps = ATOMIC_LOAD(&pool.stats.sleeps, __ATOMIC_RELAXED);
+    stats.completions = ATOMIC_LOAD(&pool.stats.completions, __ATOMIC_RELAXED);
+    return stats;
+}
+
+typedef struct {
+    ParallelForFunc func;
+    void* context;
+    int count;
+    int grainSize;
+    int next;                       // First item not handed out yet
+} ParallelForJob;
+
+// Grab chunks of a ParallelFor until none are left
+static void RunParallelForChunks(void* context) {
+    ParallelForJob* job = (ParallelForJob*)context;
+    while (true) {
+        int start = __atomic_fetch_add(&job->next, job->grainSize, __ATOMIC_RELAXED);
+        if (start >= job->count) break;
+        int end = (start > job->count - job->grainSize) ? job->count : start + job->grainSize;
+        job->func(job->context, start, end);
+    }
+}
+
+// Split [0, count) into chunks of grainSize and run them on the pool
+void ParallelFor(int count, int grainSize, ParallelForFunc func, void* context) {
+    if (count <= 0) return;
+    if (grainSize < 1) grainSize = 1;
+
+    if (!pool.initialized) InitThreadPool(0);
+
+    // Small jobs and single-core machines run inline
+    if (GetThreadPoolSize() <= 1 || count <= grainSize) {
+        func(context, 0, count);
+        return;
+    }
+
+    // One helper job per other thread that has a chunk to take. Helpers that start late find nothing
+    // left, the caller waits for all of them since they point at this stack frame.
+    ParallelForJob job = { func, context, count, grainSize, 0 };
+    int chunks = (count - 1) / grainSize + 1;
+    int helperCount = (chunks - 1 < pool.size - 1) ? chunks - 1 : pool.size - 1;
+    JobHandle helpers[MAX_POOL_THREADS];
+    for (int i = 0; i < helperCount; i++) {
+        helpers[i] = ScheduleJob(RunParallelForChunks, &job, NULL, 0);
+    }
+
+    RunParallelForChunks(&job);
+    for (int i = 0; i < helperCount; i++) {
+        WaitJob(helpers[i]);
+    }
+}
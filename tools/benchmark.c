@@ -0,0 +1,1217 @@
+#define _POSIX_C_SOURCE 199309L
+#include "raylib.h"
+#include "lighting.h"
+#include "relight.h"
+#include "horizon_map.h"
+#include "maze.h"
+#include "maze_batch.h"
+#include "maze_collision.h"
+#include "maze_crowd.h"
+#include "maze_path.h"
+#include "thread_pool.h"
+#include "arena.h"
+#include "mesh_generation.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+
+#if defined(_WIN32)
+    // Declared by hand, windows.h clashes with raylib.h
+    __declspec(dllimport) int __stdcall QueryPerformanceCounter(long long* count);
+    __declspec(dllimport) int __stdcall QueryPerformanceFrequency(long long* frequency);
+#endif
+
+#define MIN_BENCH_SECONDS 0.25
+
+// Monotonic wall clock in seconds (no window needed, unlike GetTime)
+static double BenchNow(void) {
+#if defined(_WIN32)
+    long long frequency, counter;
+    QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&counter);
+    return (double)counter / (double)frequency;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+#endif
+}
+
+// Same lights and graphics settings as the game
+static void SetupGameLighting(LightingSystem* lighting, GraphicsConfig* config) {
+    *config = (GraphicsConfig){ 0 };
+    config->advancedShadingEnabled = true;
+    config->specularStrength = 0.5f;
+    config->shininess = 32.0f;
+
+    *lighting = InitLightingSystem();
+    AddLight(lighting, LIGHT_DIRECTIONAL, (Vector3){SUN_POSITION_X, SUN_POSITION_Y, SUN_POSITION_Z},
+             (Vector3){-0.3f, -1.0f, -0.2f}, YELLOW, 1.0f, 1000.0f, 0.0f);
+    int movingLight = AddLight(lighting, LIGHT_POINT, (Vector3){0.0f, 15.0f, 0.0f}, (Vector3){0.0f, 0.0f, 0.0f},
+                               ORANGE, 2.0f, 100.0f, 0.0f);
+    if (movingLight >= 0) lighting->lights[movingLight].dynamic = true;
+    AddLight(lighting, LIGHT_SPOT, (Vector3){50.0f, 20.0f, 0.0f}, (Vector3){-1.0f, -1.0f, 0.0f},
+             BLUE, 1.5f, 80.0f, 45.0f);
+}
+
+// Per-vertex CalculateVertexLighting against the SoA batch kernel
+static int BenchLighting(int argc, char** argv) {
+    int vertexCount = (argc > 0) ? atoi(argv[0]) : 100000;
+    if (vertexCount <= 0) vertexCount = 100000;
+
+    LightingSystem lighting;
+    GraphicsConfig config;
+    SetupGameLighting(&lighting, &config);
+
+    // Floor and wall vertices spread over the maze area
+    float* positions = (float*)malloc(vertexCount * 3 * sizeof(float));
+    float* normals = (float*)malloc(vertexCount * 3 * sizeof(float));
+    unsigned char* baseColors = (unsigned char*)malloc(vertexCount * 4);
+    unsigned char* scalarColors = (unsigned char*)malloc(vertexCount * 4);
+    unsigned char* batchColors = (unsigned char*)malloc(vertexCount * 4);
+    srand(42);
+    for (int i = 0; i < vertexCount; i++) {
+        positions[i * 3] = (float)(rand() % 2000) / 10.0f - 100.0f;
+        positions[i * 3 + 1] = (float)(rand() % 50) / 10.0f;
+        positions[i * 3 + 2] = (float)(rand() % 2000) / 10.0f - 100.0f;
+        int face = rand() % 3;
+        normals[i * 3] = (face == 1) ? 1.0f : 0.0f;
+        normals[i * 3 + 1] = (face == 0) ? 1.0f : 0.0f;
+        normals[i * 3 + 2] = (face == 2) ? 1.0f : 0.0f;
+        baseColors[i * 4] = (unsigned char)(60 + rand() % 120);
+        baseColors[i * 4 + 1] = (unsigned char)(60 + rand() % 120);
+        baseColors[i * 4 + 2] = (unsigned char)(60 + rand() % 120);
+        baseColors[i * 4 + 3] = 255;
+    }
+    Vector3 viewDir = { 0.0f, 1.0f, 0.0f };
+
+    // Scalar path
+    int scalarRuns = 0;
+    double start = BenchNow();
+    do {
+        for (int i = 0; i < vertexCount; i++) {
+            Vector3 position = { positions[i * 3], positions[i * 3 + 1], positions[i * 3 + 2] };
+            Vector3 normal = { normals[i * 3], normals[i * 3 + 1], normals[i * 3 + 2] };
+            Color base = { baseColors[i * 4], baseColors[i * 4 + 1], baseColors[i * 4 + 2], baseColors[i * 4 + 3] };
+            Color lit = CalculateVertexLighting(position, normal, viewDir, base, &lighting, &config);
+            memcpy(&scalarColors[i * 4], &lit, 4);
+        }
+        scalarRuns++;
+    } while (BenchNow() - start < MIN_BENCH_SECONDS);
+    double scalarTime = (BenchNow() - start) / scalarRuns;
+
+    // Batch path (light block compiled once per run, like the mesh generators)
+    int batchRuns = 0;
+    start = BenchNow();
+    do {
+        memcpy(batchColors, baseColors, vertexCount * 4);
+        LightBlock block = CompileLightBlock(&lighting, &config);
+        CalculateVertexLightingBatch(positions, normals, batchColors, vertexCount, viewDir, &block);
+        UnloadLightBlock(&block);
+        batchRuns++;
+    } while (BenchNow() - start < MIN_BENCH_SECONDS);
+    double batchTime = (BenchNow() - start) / batchRuns;
+
+    // The batch kernel clamps once instead of per light, so allow small rounding differences
+    int maxDiff = 0;
+    for (int i = 0; i < vertexCount * 4; i++) {
+        int diff = abs((int)scalarColors[i] - (int)batchColors[i]);
+        if (diff > maxDiff) maxDiff = diff;
+    }
+
+    printf("lighting: %d vertices, %d lights\n", vertexCount, lighting.lightCount);
+    printf("  per-vertex : %8.2f ms  %8.2f Mverts/s\n", scalarTime * 1000.0, vertexCount / scalarTime / 1e6);
+    printf("  batch SoA  : %8.2f ms  %8.2f Mverts/s  (%.1fx)\n", batchTime * 1000.0, vertexCount / batchTime / 1e6, scalarTime / batchTime);
+    printf("  max channel difference: %d\n", maxDiff);
+
+    free(positions);
+    free(normals);
+    free(baseColors);
+    free(scalarColors);
+    free(batchColors);
+    UnloadLightingSystem(&lighting);
+    return 0;
+}
+
+// Cluster grid build time and lights per cell for many point/spot lights over the maze area,
+// plus batch vs clustered vertex lighting on the same vertices
+static int BenchClusters(int argc, char** argv) {
+    int defaultCounts[] = { 64, 256, 1024 };
+    int countCount = (argc > 0) ? argc : 3;
+    const int vertexCount = 100000;
+    BoundingBox bounds = { { -WORLD_SIZE / 2.0f, -5.0f, -WORLD_SIZE / 2.0f }, { WORLD_SIZE / 2.0f, 40.0f, WORLD_SIZE / 2.0f } };
+
+    float* positions = (float*)malloc(vertexCount * 3 * sizeof(float));
+    float* normals = (float*)malloc(vertexCount * 3 * sizeof(float));
+    unsigned char* baseColors = (unsigned char*)malloc(vertexCount * 4);
+    unsigned char* batchColors = (unsigned char*)malloc(vertexCount * 4);
+    unsigned char* clusteredColors = (unsigned char*)malloc(vertexCount * 4);
+    // A floor grid in row order, so neighbouring vertices share cells like in a real mesh
+    int side = (int)sqrtf((float)vertexCount);
+    for (int i = 0; i < vertexCount; i++) {
+        positions[i * 3] = WORLD_SIZE * (float)(i % side) / side - WORLD_SIZE / 2.0f;
+        positions[i * 3 + 1] = 0.0f;
+        positions[i * 3 + 2] = WORLD_SIZE * (float)(i / side) / side - WORLD_SIZE / 2.0f;
+        normals[i * 3] = 0.0f;
+        normals[i * 3 + 1] = 1.0f;
+        normals[i * 3 + 2] = 0.0f;
+        baseColors[i * 4] = 120;
+        baseColors[i * 4 + 1] = 120;
+        baseColors[i * 4 + 2] = 120;
+        baseColors[i * 4 + 3] = 255;
+    }
+    Vector3 viewDir = { 0.0f, 1.0f, 0.0f };
+
+    for (int c = 0; c < countCount; c++) {
+        int lightCount = (argc > 0) ? atoi(argv[c]) : defaultCounts[c];
+        if (lightCount <= 0) continue;
+
+        LightingSystem lighting;
+        GraphicsConfig config;
+        SetupGameLighting(&lighting, &config);
+        srand(1000 + lightCount);
+        for (int i = lighting.lightCount; i < lightCount; i++) {
+            Vector3 position = { (float)(rand() % 2000) / 10.0f - 100.0f, 2.0f + (float)(rand() % 200) / 10.0f,
+                                 (float)(rand() % 2000) / 10.0f - 100.0f };
+            Color color = { (unsigned char)(rand() % 256), (unsigned char)(rand() % 256), (unsigned char)(rand() % 256), 255 };
+            float range = 8.0f + (float)(rand() % 170) / 10.0f;
+            if (rand() % 4 == 0) {
+                AddLight(&lighting, LIGHT_SPOT, position, (Vector3){ 0.0f, -1.0f, 0.0f }, color, 1.5f, range, 40.0f);
+            } else {
+                AddLight(&lighting, LIGHT_POINT, position, (Vector3){ 0.0f, 0.0f, 0.0f }, color, 1.0f, range, 0.0f);
+            }
+        }
+        LightBlock block = CompileLightBlock(&lighting, &config);
+        LightClusterGrid grid = { 0 };
+
+        // Build (allocations are reused after the first run, like a per-frame rebuild)
+        int buildRuns = 0;
+        double start = BenchNow();
+        do {
+            BuildLightClusters(&grid, &block, bounds, LIGHT_CLUSTER_CELL_SIZE);
+            buildRuns++;
+        } while (BenchNow() - start < MIN_BENCH_SECONDS);
+        double buildTime = (BenchNow() - start) / buildRuns;
+
+        int occupiedCells = 0;
+        for (int cell = 0; cell < grid.cellCount; cell++) {
+            if (grid.cellStart[cell + 1] > grid.cellStart[cell]) occupiedCells++;
+        }
+
+        // Shading with every light against shading with the cell lists
+        int batchRuns = 0;
+        start = BenchNow();
+        do {
+            memcpy(batchColors, baseColors, vertexCount * 4);
+            CalculateVertexLightingBatch(positions, normals, batchColors, vertexCount, viewDir, &block);
+            batchRuns++;
+        } while (BenchNow() - start < MIN_BENCH_SECONDS);
+        double batchTime = (BenchNow() - start) / batchRuns;
+
+        int clusteredRuns = 0;
+        start = BenchNow();
+        do {
+            memcpy(clusteredColors, baseColors, vertexCount * 4);
+            CalculateVertexLightingClustered(positions, normals, clusteredColors, vertexCount, viewDir, &block, &grid);
+            clusteredRuns++;
+        } while (BenchNow() - start < MIN_BENCH_SECONDS);
+        double clusteredTime = (BenchNow() - start) / clusteredRuns;
+
+        int maxDiff = 0;
+        for (int i = 0; i < vertexCount * 4; i++) {
+            int diff = abs((int)batchColors[i] - (int)clusteredColors[i]);
+            if (diff > maxDiff) maxDiff = diff;
+        }
+
+        printf("clusters: %d lights, %dx%dx%d cells of %.1f\n", block.count, grid.sizeX, grid.sizeY, grid.sizeZ, grid.cellSize);
+        printf("  build      : %8.3f ms\n", buildTime * 1000.0);
+        printf("  lights/cell: %8.2f avg  %8.2f avg occupied  %d max  (+%d directional)\n",
+               (float)grid.cellLightCount / grid.cellCount, occupiedCells > 0 ? (float)grid.cellLightCount / occupiedCells : 0.0f,
+               grid.maxLightsPerCell, grid.globalCount);
+        printf("  all lights : %8.2f ms  (%d vertices)\n", batchTime * 1000.0, vertexCount);
+        printf("  clustered  : %8.2f ms  (%.1fx)  max channel difference: %d\n", clusteredTime * 1000.0, batchTime / clusteredTime, maxDiff);
+
+        UnloadLightClusters(&grid);
+        UnloadLightBlock(&block);
+        UnloadLightingSystem(&lighting);
+    }
+
+    free(positions);
+    free(normals);
+    free(baseColors);
+    free(batchColors);
+    free(clusteredColors);
+    return 0;
+}
+
+// Floor grid with unlit colors and no GPU buffers, like the maze scene's relit floor
+static Mesh BuildBenchFloor(float size, int res) {
+    Mesh mesh = { 0 };
+    mesh.vertexCount = res * res;
+    mesh.vertices = (float*)malloc(mesh.vertexCount * 3 * sizeof(float));
+    mesh.normals = (float*)malloc(mesh.vertexCount * 3 * sizeof(float));
+    mesh.colors = (unsigned char*)malloc(mesh.vertexCount * 4);
+    for (int z = 0; z < res; z++) {
+        for (int x = 0; x < res; x++) {
+            int v = z * res + x;
+            mesh.vertices[v * 3] = (float)x / (res - 1) * size - size / 2.0f;
+            mesh.vertices[v * 3 + 1] = 0.0f;
+            mesh.vertices[v * 3 + 2] = (float)z / (res - 1) * size - size / 2.0f;
+            mesh.normals[v * 3] = 0.0f;
+            mesh.normals[v * 3 + 1] = 1.0f;
+            mesh.normals[v * 3 + 2] = 0.0f;
+            unsigned char shade = ((x / 4 + z / 4) % 2) ? 150 : 110;
+            mesh.colors[v * 4] = shade;
+            mesh.colors[v * 4 + 1] = shade;
+            mesh.colors[v * 4 + 2] = shade;
+            mesh.colors[v * 4 + 3] = 255;
+        }
+    }
+    return mesh;
+}
+
+// Full relight of a floor against incremental relights while the game's point light orbits
+static int BenchRelight(int argc, char** argv) {
+    int res = (argc > 0) ? atoi(argv[0]) : 200;
+    if (res < 2 || res * res > 4000000) res = 200;
+
+    LightingSystem lighting;
+    GraphicsConfig config;
+    SetupGameLighting(&lighting, &config);
+    Mesh floor = BuildBenchFloor(WORLD_SIZE * 2, res);
+    Mesh reference = BuildBenchFloor(WORLD_SIZE * 2, res);
+    Vector3 viewDir = { 0.0f, 1.0f, 0.0f };
+
+    RelightGrid* grid = CreateRelightGrid(RELIGHT_CELL_SIZE);
+    if (AddRelightMesh(grid, &floor) < 0 || UpdateRelightGrid(grid, &lighting, &config, viewDir) < 0) {
+        UnloadRelightGrid(grid);
+        free(floor.vertices); free(floor.normals); free(floor.colors);
+        free(reference.vertices); free(reference.normals); free(reference.colors);
+        UnloadLightingSystem(&lighting);
+        return 1;
+    }
+
+    // Full relight: what regenerating the mesh colors costs
+    int fullRuns = 0;
+    double start = BenchNow();
+    do {
+        grid->litValid = false;
+        UpdateRelightGrid(grid, &lighting, &config, viewDir);
+        fullRuns++;
+    } while (BenchNow() - start < MIN_BENCH_SECONDS);
+    double fullTime = (BenchNow() - start) / fullRuns;
+
+    // Incremental: one 60 Hz frame of light movement per update
+    int frames = 0;
+    long long relitVertices = 0;
+    start = BenchNow();
+    do {
+        UpdateLightingSystem(&lighting, 1.0f / 60.0f);
+        int relit = UpdateRelightGrid(grid, &lighting, &config, viewDir);
+        if (relit > 0) relitVertices += relit;
+        frames++;
+    } while (BenchNow() - start < MIN_BENCH_SECONDS);
+    double frameTime = (BenchNow() - start) / frames;
+
+    // The incrementally relit colors must match lighting everything from scratch
+    CalculateMeshLighting(&reference, viewDir, &lighting, &config);
+    int maxDiff = 0;
+    for (int i = 0; i < floor.vertexCount * 4; i++) {
+        int diff = abs((int)floor.colors[i] - (int)reference.colors[i]);
+        if (diff > maxDiff) maxDiff = diff;
+    }
+
+    printf("relight: %d vertices, %d lights, %dx%dx%d cells\n", floor.vertexCount, lighting.lightCount, grid->sizeX, grid->sizeY, grid->sizeZ);
+    printf("  full relight : %8.3f ms\n", fullTime * 1000.0);
+    printf("  moving light : %8.3f ms  %8.0f vertices/frame  (%.1fx)\n", frameTime * 1000.0, (double)relitVertices / frames, fullTime / frameTime);
+    printf("  max channel difference to full relight: %d\n", maxDiff);
+
+    UnloadRelightGrid(grid);
+    free(floor.vertices); free(floor.normals); free(floor.colors);
+    free(reference.vertices); free(reference.normals); free(reference.colors);
+    UnloadLightingSystem(&lighting);
+    return 0;
+}
+
+// Rolling hills with sharp ridges, heights 0-50 like the terrain scene
+static float* BuildBenchHeights(int size) {
+    float* heights = (float*)malloc((size_t)size * size * sizeof(float));
+    if (!heights) return NULL;
+    float frequency = 1024.0f / size;
+    for (int z = 0; z < size; z++) {
+        for (int x = 0; x < size; x++) {
+            float fx = x * frequency;
+            float fz = z * frequency;
+            float h = sinf(fx * 0.013f) * cosf(fz * 0.017f) + 0.5f * fabsf(sinf((fx + fz) * 0.041f)) +
+                      0.25f * sinf(fx * 0.11f - fz * 0.07f);
+            heights[(size_t)z * size + x] = (h + 1.75f) / 3.5f * 50.0f;
+        }
+    }
+    return heights;
+}
+
+// Horizon angle (stored units) by marching every texel along the direction, the brute-force reference
+static int BruteForceHorizon(const float* heights, int size, float texelSize, int directionCount, int direction, int x, int z) {
+    float angle = 2.0f * PI * direction / directionCount;
+    float dx = cosf(angle);
+    float dz = sinf(angle);
+    float major = fmaxf(fabsf(dx), fabsf(dz));
+    dx /= major;
+    dz /= major;
+    float stepDistance = sqrtf(dx * dx + dz * dz) * texelSize;
+
+    float h = heights[(size_t)z * size + x];
+    float best = 0.0f;
+    for (int k = 1; ; k++) {
+        int sx = (int)floorf(x + k * dx + 0.5f);
+        int sz = (int)floorf(z + k * dz + 0.5f);
+        if (sx < 0 || sx >= size || sz < 0 || sz >= size) break;
+        float slope = (heights[(size_t)sz * size + sx] - h) / (k * stepDistance);
+        if (slope > best) best = slope;
+    }
+    return (int)(atanf(best) * (255.0f / (PI * 0.5f)) + 0.5f);
+}
+
+// Sweep-line horizon bake at several grid sizes, a 64x64 dirty-region update and a brute-force comparison
+static int BenchHorizon(int argc, char** argv) {
+    int defaultSizes[] = { 1024, 4096 };
+    int sizeCount = (argc > 0) ? argc : 2;
+
+    InitThreadPool(0);
+    printf("horizon: %d directions, %d threads\n", HORIZON_DIRECTIONS, GetThreadPoolSize());
+    for (int i = 0; i < sizeCount; i++) {
+        int size = (argc > 0) ? atoi(argv[i]) : defaultSizes[i];
+        if (size < 64 || size > 8192) continue;
+        float texelSize = TERRAIN_PLANE_SIZE / (TERRAIN_SIZE - 1);
+        float* heights = BuildBenchHeights(size);
+        if (!heights) continue;
+
+        HorizonMap* map = NULL;
+        int bakes = 0;
+        double start = BenchNow();
+        do {
+            UnloadHorizonMap(map);
+            map = BakeHorizonMap(heights, size, texelSize, HORIZON_DIRECTIONS);
+            bakes++;
+        } while (map && BenchNow() - start < MIN_BENCH_SECONDS);
+        double bakeTime = (BenchNow() - start) / bakes;
+        if (!map) {
+            printf("  %4d x %-4d : out of memory\n", size, size);
+            free(heights);
+            continue;
+        }
+
+        // Raise a 64x64 patch and rebake only the lines through it
+        int x0 = size / 2 - 32, z0 = size / 2 - 32;
+        for (int z = z0; z < z0 + 64; z++) {
+            for (int x = x0; x < x0 + 64; x++) heights[(size_t)z * size + x] += 10.0f;
+        }
+        int updates = 0;
+        start = BenchNow();
+        do {
+            UpdateHorizonMapRegion(map, heights, x0, z0, x0 + 63, z0 + 63);
+            updates++;
+        } while (BenchNow() - start < MIN_BENCH_SECONDS);
+        double updateTime = (BenchNow() - start) / updates;
+
+        // Brute force on a sample of texels, extrapolated to the whole map
+        const int samples = 2000;
+        int maxDiff = 0;
+        long long totalDiff = 0;
+        unsigned int seed = 12345;
+        size_t plane = (size_t)size * size;
+        start = BenchNow();
+        for (int s = 0; s < samples; s++) {
+            seed = seed * 1664525u + 1013904223u;
+            int x = (int)((seed >> 8) % (unsigned int)size);
+            seed = seed * 1664525u + 1013904223u;
+            int z = (int)((seed >> 8) % (unsigned int)size);
+            for (int d = 0; d < map->directionCount; d++) {
+                int reference = BruteForceHorizon(heights, size, texelSize, map->directionCount, d, x, z);
+                int diff = abs(reference - (int)map->angles[d * plane + (size_t)z * size + x]);
+                totalDiff += diff;
+                if (diff > maxDiff) maxDiff = diff;
+            }
+        }
+        double bruteTime = (BenchNow() - start) / samples * plane;
+
+        printf("  %4d x %-4d : bake %8.1f ms, 64x64 update %7.2f ms, brute force ~%8.0f ms (%.0fx)\n",
+               size, size, bakeTime * 1000.0, updateTime * 1000.0, bruteTime * 1000.0, bruteTime / bakeTime);
+        printf("                angle difference to brute force: mean %.2f, max %d (of 255 = 90 degrees)\n",
+               (double)totalDiff / ((double)samples * map->directionCount), maxDiff);
+
+        UnloadHorizonMap(map);
+        free(heights);
+    }
+    ShutdownThreadPool();
+    return 0;
+}
+
+// Perfect maze by iterative backtracking on odd cells, then 10% of the remaining inner walls knocked out
+// so corridors form loops and open areas like a hand-drawn maze
+static unsigned char* BuildBenchMaze(int size) {
+    unsigned char* walls = (unsigned char*)malloc((size_t)size * size);
+    int* stack = (int*)malloc((size_t)size * size * sizeof(int));
+    if (!walls || !stack) {
+        free(walls);
+        free(stack);
+        return NULL;
+    }
+    memset(walls, 1, (size_t)size * size);
+
+    static const int stepX[4] = { 2, -2, 0, 0 };
+    static const int stepZ[4] = { 0, 0, 2, -2 };
+    unsigned int seed = 777;
+    int top = 0;
+    walls[size + 1] = 0;
+    stack[top++] = size + 1;
+    while (top > 0) {
+        int cell = stack[top - 1];
+        int x = cell % size, z = cell / size;
+        int options[4], optionCount = 0;
+        for (int d = 0; d < 4; d++) {
+            int nx = x + stepX[d], nz = z + stepZ[d];
+            if (nx > 0 && nz > 0 && nx < size - 1 && nz < size - 1 && walls[(size_t)nz * size + nx]) options[optionCount++] = d;
+        }
+        if (optionCount == 0) {
+            top--;
+            continue;
+        }
+        seed = seed * 1664525u + 1013904223u;
+        int d = options[(seed >> 8) % (unsigned int)optionCount];
+        int nx = x + stepX[d], nz = z + stepZ[d];
+        walls[(size_t)(z + stepZ[d] / 2) * size + x + stepX[d] / 2] = 0;
+        walls[(size_t)nz * size + nx] = 0;
+        stack[top++] = nz * size + nx;
+    }
+    for (int z = 1; z < size - 1; z++) {
+        for (int x = 1; x < size - 1; x++) {
+            seed = seed * 1664525u + 1013904223u;
+            if (walls[(size_t)z * size + x] && (seed >> 8) % 10 == 0) walls[(size_t)z * size + x] = 0;
+        }
+    }
+    free(stack);
+    return walls;
+}
+
+// PVS bake time and visible-set sizes for generated mazes of several sizes
+static int BenchPvs(int argc, char** argv) {
+    int defaultSizes[] = { 50, 100, 250, 500, 1000 };
+    int sizeCount = (argc > 0) ? argc : 5;
+
+    InitThreadPool(0);
+    printf("pvs: %dx%d-cell chunks, %d threads\n", MAZE_CHUNK_CELLS, MAZE_CHUNK_CELLS, GetThreadPoolSize());
+    for (int i = 0; i < sizeCount; i++) {
+        int size = (argc > 0) ? atoi(argv[i]) : defaultSizes[i];
+        if (size < 8 || size > 4096) continue;
+        unsigned char* walls = BuildBenchMaze(size);
+        if (!walls) continue;
+
+        MazePvs* pvs = NULL;
+        int bakes = 0;
+        double start = BenchNow();
+        do {
+            UnloadMazePvs(pvs);
+            pvs = BakeMazeGridPvs(walls, size, size, MAZE_CHUNK_CELLS);
+            bakes++;
+        } while (pvs && BenchNow() - start < MIN_BENCH_SECONDS);
+        double bakeTime = (BenchNow() - start) / bakes;
+        if (!pvs) {
+            printf("  %4d x %-4d : out of memory\n", size, size);
+            free(walls);
+            continue;
+        }
+
+        int openCells = 0, maxChunks = 0;
+        long long totalChunks = 0;
+        for (int c = 0; c < size * size; c++) {
+            if (pvs->cellSets[c] < 0) continue;
+            int chunks = pvs->sets[pvs->cellSets[c]].chunkCount;
+            openCells++;
+            totalChunks += chunks;
+            if (chunks > maxChunks) maxChunks = chunks;
+        }
+        int chunkCount = pvs->chunksX * pvs->chunksZ;
+        double averageChunks = openCells ? (double)totalChunks / openCells : 0.0;
+        printf("  %4d x %-4d : bake %8.1f ms, %7d open cells, %6d unique sets, visible chunks avg %.1f max %d of %d (%.1f%%), %.2f MB\n",
+               size, size, bakeTime * 1000.0, openCells, pvs->setCount, averageChunks, maxChunks, chunkCount,
+               100.0 * averageChunks / chunkCount, GetMazePvsMemory(pvs) / (1024.0 * 1024.0));
+
+        UnloadMazePvs(pvs);
+        free(walls);
+    }
+    ShutdownThreadPool();
+    return 0;
+}
+
+// Time one format: load the file repeatedly for MIN_BENCH_SECONDS, returns seconds per load and the last maze
+static double TimeMazeLoad(const char* path, Maze* maze) {
+    int loads = 0;
+    double start = BenchNow();
+    do {
+        UnloadMaze(maze);
+        *maze = LoadMazeFromFile(path);
+        loads++;
+    } while (BenchNow() - start < MIN_BENCH_SECONDS);
+    return (BenchNow() - start) / loads;
+}
+
+static long BenchFileSize(const char* path) {
+    FILE* file = fopen(path, "rb");
+    if (!file) return 0;
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fclose(file);
+    return size;
+}
+
+// Load a generated maze of each size from a text file (the 1000x1000 generator tiled to size), then
+// from the same maze converted to the binary format
+static int BenchMazeLoad(int argc, char** argv) {
+    int defaultSizes[] = { 1000, 10000 };
+    int sizeCount = (argc > 0) ? argc : 2;
+    const char* path = "bench_maze.txt";
+    const char* binaryPath = "bench_maze.mazb";
+
+    unsigned char* tile = BuildBenchMaze(1000);
+    if (!tile) return 1;
+    printf("maze-load: ASCII and binary files -> 1 bit per cell\n");
+    for (int i = 0; i < sizeCount; i++) {
+        int size = (argc > 0) ? atoi(argv[i]) : defaultSizes[i];
+        if (size < 1 || size > 50000) continue;
+
+        FILE* file = fopen(path, "wb");
+        char* line = (char*)malloc((size_t)size + 1);
+        if (!file || !line) {
+            if (file) fclose(file);
+            free(line);
+            continue;
+        }
+        for (int z = 0; z < size; z++) {
+            for (int x = 0; x < size; x++) line[x] = tile[(size_t)(z % 1000) * 1000 + x % 1000] ? '#' : ' ';
+            line[size] = '\n';
+            fwrite(line, 1, (size_t)size + 1, file);
+        }
+        fclose(file);
+        free(line);
+
+        Maze maze = { 0 };
+        double loadTime = TimeMazeLoad(path, &maze);
+
+        // The binary file has to unpack to exactly the same bits
+        Maze binary = { 0 };
+        double binaryTime = 0.0;
+        bool identical = false;
+        if (ExportMazeBinary(&maze, binaryPath)) {
+            binaryTime = TimeMazeLoad(binaryPath, &binary);
+            identical = binary.width == maze.width && binary.height == maze.height && binary.wordsPerRow == maze.wordsPerRow &&
+                        memcmp(binary.walls, maze.walls, (size_t)maze.height * maze.wordsPerRow * sizeof(unsigned int)) == 0;
+        }
+
+        // Spot-check the packed bits against the generator
+        int mismatches = 0;
+        unsigned int seed = 99;
+        for (int s = 0; s < 100000; s++) {
+            seed = seed * 1664525u + 1013904223u;
+            int x = (int)((seed >> 8) % (unsigned int)size);
+            seed = seed * 1664525u + 1013904223u;
+            int z = (int)((seed >> 8) % (unsigned int)size);
+            if (MazeIsWall(&maze, x, z) != (tile[(size_t)(z % 1000) * 1000 + x % 1000] != 0)) mismatches++;
+        }
+
+        double fileMB = ((double)size + 1.0) * size / (1024.0 * 1024.0);
+        double binaryMB = BenchFileSize(binaryPath) / (1024.0 * 1024.0);
+        double packedMB = (double)maze.wordsPerRow * maze.height * sizeof(unsigned int) / (1024.0 * 1024.0);
+        printf("  %5d x %-5d : text %8.2f ms (%.0f MB/s, %.1f MB), binary %8.2f ms (%.2f MB, %s), packed %.2f MB, %d mismatches\n",
+               maze.width, maze.height, loadTime * 1000.0, fileMB / loadTime, fileMB, binaryTime * 1000.0, binaryMB,
+               identical ? "identical" : "DIFFERENT", packedMB, mismatches);
+        UnloadMaze(&binary);
+        UnloadMaze(&maze);
+    }
+    remove(path);
+    remove(binaryPath);
+    free(tile);
+    return 0;
+}
+
+// Generated maze as a Maze, through the ASCII loader
+static Maze BuildBenchMazeGrid(int size) {
+    Maze maze = { 0 };
+    unsigned char* walls = BuildBenchMaze(size);
+    char* text = (char*)malloc((size_t)(size + 1) * size);
+    if (walls && text) {
+        for (int z = 0; z < size; z++) {
+            for (int x = 0; x < size; x++) text[(size_t)z * (size + 1) + x] = walls[(size_t)z * size + x] ? '#' : ' ';
+            text[(size_t)z * (size + 1) + size] = '\n';
+        }
+        maze = LoadMazeFromMemory(text, (size_t)(size + 1) * size);
+    }
+    free(walls);
+    free(text);
+    return maze;
+}
+
+// Random walkers in a 250x250 maze: one collision step for every body per frame, serial and on the pool
+static int BenchCollision(int argc, char** argv) {
+    int defaultCounts[] = { 1000, 10000, 100000 };
+    int countCount = (argc > 0) ? argc : 3;
+    const int mazeSize = 250;
+    const int frames = 60;
+    const float step = 1.0f;        // World units per frame, 60 u/s at 60 Hz
+
+    Maze maze = BuildBenchMazeGrid(mazeSize);
+    if (maze.width == 0) return 1;
+    Vector2 gridOrigin = GetMazeGridOrigin(&maze);
+    InitThreadPool(0);
+    printf("collision: %dx%d maze, radius %.1f, %.1f units per frame, %d threads\n",
+           maze.width, maze.height, PLAYER_RADIUS, step, GetThreadPoolSize());
+
+    for (int c = 0; c < countCount; c++) {
+        int count = (argc > 0) ? atoi(argv[c]) : defaultCounts[c];
+        if (count <= 0) continue;
+        Vector2* start = (Vector2*)malloc(count * sizeof(Vector2));
+        Vector2* positions = (Vector2*)malloc(count * sizeof(Vector2));
+        Vector2* deltas = (Vector2*)malloc(count * sizeof(Vector2));
+        if (!start || !positions || !deltas) {
+            free(start);
+            free(positions);
+            free(deltas);
+            continue;
+        }
+
+        unsigned int seed = 4242;
+        for (int i = 0; i < count; i++) {
+            int col, row;
+            do {
+                seed = seed * 1664525u + 1013904223u;
+                col = (int)((seed >> 8) % (unsigned int)maze.width);
+                seed = seed * 1664525u + 1013904223u;
+                row = (int)((seed >> 8) % (unsigned int)maze.height);
+            } while (MazeIsWall(&maze, col, row));
+            start[i] = (Vector2){ gridOrigin.x + (col + 0.5f) * MAZE_CELL_SIZE, gridOrigin.y + (row + 0.5f) * MAZE_CELL_SIZE };
+        }
+
+        double times[2];
+        int blocked = 0;
+        for (int pass = 0; pass < 2; pass++) {
+            memcpy(positions, start, count * sizeof(Vector2));
+            seed = 777;
+            for (int i = 0; i < count; i++) {
+                seed = seed * 1664525u + 1013904223u;
+                float angle = (seed >> 8) / 16777216.0f * 2.0f * PI;
+                deltas[i] = (Vector2){ cosf(angle) * step, sinf(angle) * step };
+            }
+            double total = 0.0;
+            blocked = 0;
+            for (int f = 0; f < frames; f++) {
+                double frameStart = BenchNow();
+                if (pass == 0) {
+                    for (int i = 0; i < count; i++) positions[i] = MoveCircleInMaze(&maze, positions[i], deltas[i], PLAYER_RADIUS);
+                } else {
+                    MoveCirclesInMaze(&maze, positions, deltas, count, PLAYER_RADIUS);
+                }
+                total += BenchNow() - frameStart;
+
+                // Turn bodies that hit a wall (one sweep, not timed)
+                for (int i = 0; i < count; i++) {
+                    if (!SweepCircleInMaze(&maze, positions[i], deltas[i], PLAYER_RADIUS, NULL, NULL)) continue;
+                    seed = seed * 1664525u + 1013904223u;
+                    float angle = (seed >> 8) / 16777216.0f * 2.0f * PI;
+                    deltas[i] = (Vector2){ cosf(angle) * step, sinf(angle) * step };
+                    blocked++;
+                }
+            }
+            times[pass] = total / frames;
+        }
+
+        // No body may end up overlapping a wall
+        int overlapping = 0;
+        for (int i = 0; i < count; i++) {
+            int col = (int)floorf((positions[i].x - gridOrigin.x) / MAZE_CELL_SIZE);
+            int row = (int)floorf((positions[i].y - gridOrigin.y) / MAZE_CELL_SIZE);
+            for (int dz = -1; dz <= 1; dz++) {
+                for (int dx = -1; dx <= 1; dx++) {
+                    if (!MazeIsWall(&maze, col + dx, row + dz)) continue;
+                    float minX = gridOrigin.x + (col + dx) * MAZE_CELL_SIZE;
+                    float minZ = gridOrigin.y + (row + dz) * MAZE_CELL_SIZE;
+                    float nx = fminf(fmaxf(positions[i].x, minX), minX + MAZE_CELL_SIZE) - positions[i].x;
+                    float nz = fminf(fmaxf(positions[i].y, minZ), minZ + MAZE_CELL_SIZE) - positions[i].y;
+                    if (nx * nx + nz * nz < (PLAYER_RADIUS - 0.01f) * (PLAYER_RADIUS - 0.01f)) overlapping++;
+                }
+            }
+        }
+
+        printf("  %7d bodies : %8.3f ms/frame serial (%.0f ns/body), %8.3f ms/frame pooled, %d wall turns, %d overlapping\n",
+               count, times[0] * 1000.0, times[0] * 1e9 / count, times[1] * 1000.0, blocked, overlapping);
+        free(start);
+        free(positions);
+        free(deltas);
+    }
+    UnloadMaze(&maze);
+    ShutdownThreadPool();
+    return 0;
+}
+
+// Random open cell of a maze
+static int RandomOpenCell(const Maze* maze, unsigned int* seed) {
+    for (;;) {
+        *seed = *seed * 1664525u + 1013904223u;
+        int col = (int)((*seed >> 8) % (unsigned int)maze->width);
+        *seed = *seed * 1664525u + 1013904223u;
+        int row = (int)((*seed >> 8) % (unsigned int)maze->height);
+        if (!MazeIsWall(maze, col, row)) return row * maze->width + col;
+    }
+}
+
+// Paths per second between random open cells: flat JPS, HPA* with a cold cache and the same queries cached
+static int BenchPath(int argc, char** argv) {
+    int defaultSizes[] = { 50, 256, 1024, 4096 };
+    int sizeCount = (argc > 0) ? argc : 4;
+    const int pairCount = 1000;
+
+    InitThreadPool(0);
+    printf("path: %dx%d-cell clusters, %d random pairs per maze, %d threads\n",
+           MAZE_PATH_CLUSTER_CELLS, MAZE_PATH_CLUSTER_CELLS, pairCount, GetThreadPoolSize());
+    for (int i = 0; i < sizeCount; i++) {
+        int size = (argc > 0) ? atoi(argv[i]) : defaultSizes[i];
+        if (size < 8 || size > 8192) continue;
+        Maze maze = BuildBenchMazeGrid(size);
+        if (maze.width == 0) continue;
+
+        double start = BenchNow();
+        MazePathfinder* pathfinder = CreateMazePathfinder(&maze, 0);
+        double buildTime = BenchNow() - start;
+        int* pairs = (int*)malloc(pairCount * 2 * sizeof(int));
+        if (!pathfinder || !pairs) {
+            printf("  %4d x %-4d : out of memory\n", size, size);
+            UnloadMazePathfinder(pathfinder);
+            free(pairs);
+            UnloadMaze(&maze);
+            continue;
+        }
+        unsigned int seed = 31337;
+        for (int p = 0; p < pairCount * 2; p++) pairs[p] = RandomOpenCell(&maze, &seed);
+
+        // Flat JPS gives the optimal cost the hierarchical paths are compared against
+        MazePath path = { 0 };
+        float* optimal = (float*)malloc(pairCount * sizeof(float));
+        int jpsPaths = 0;
+        start = BenchNow();
+        for (int p = 0; p < pairCount && BenchNow() - start < 8.0 * MIN_BENCH_SECONDS; p++) {
+            int a = pairs[p * 2], b = pairs[p * 2 + 1];
+            optimal[p] = FindMazePathJps(pathfinder, a % size, a / size, b % size, b / size, &path) ? path.cost : -1.0f;
+            jpsPaths++;
+        }
+        double jpsTime = BenchNow() - start;
+
+        // Cold HPA* queries for a while, then the same queries again from the cache
+        double hpaTime[2];
+        double ratioSum = 0.0;
+        int ratioCount = 0;
+        int hpaPaths = pairCount;
+        long long waypoints = 0;
+        for (int pass = 0; pass < 2; pass++) {
+            start = BenchNow();
+            for (int p = 0; p < hpaPaths; p++) {
+                if (pass == 0 && BenchNow() - start > 8.0 * MIN_BENCH_SECONDS) {
+                    hpaPaths = p;
+                    break;
+                }
+                int a = pairs[p * 2], b = pairs[p * 2 + 1];
+                bool found = FindMazePath(pathfinder, a % size, a / size, b % size, b / size, &path);
+                if (pass > 0 || !found) continue;
+                waypoints += path.count;
+                if (p < jpsPaths && optimal[p] > 0.0f) {
+                    ratioSum += path.cost / optimal[p];
+                    ratioCount++;
+                }
+            }
+            hpaTime[pass] = BenchNow() - start;
+        }
+
+        printf("  %4d x %-4d : build %7.1f ms (%d nodes, %d edges), JPS %8.0f paths/s, HPA* %8.0f paths/s "
+               "(%.3fx optimal, %.0f waypoints), cached %9.0f paths/s\n",
+               size, size, buildTime * 1000.0, pathfinder->nodeCount, pathfinder->edgeCount, jpsPaths / jpsTime,
+               hpaPaths / hpaTime[0], ratioCount ? ratioSum / ratioCount : 0.0, (double)waypoints / hpaPaths,
+               hpaPaths / hpaTime[1]);
+
+        UnloadMazePath(&path);
+        free(optimal);
+        free(pairs);
+        UnloadMazePathfinder(pathfinder);
+        UnloadMaze(&maze);
+    }
+    ShutdownThreadPool();
+    return 0;
+}
+
+// Headless crowd in a 250x250 maze: agents walk between two corners and turn around on arrival, timed per 60 Hz step
+static int BenchCrowd(int argc, char** argv) {
+    int defaultCounts[] = { 1000, 10000, 50000 };
+    int countCount = (argc > 0) ? argc : 3;
+    const int mazeSize = 250;
+    const int frames = 300;
+    const float step = 1.0f / 60.0f;
+
+    Maze maze = BuildBenchMazeGrid(mazeSize);
+    if (maze.width == 0) return 1;
+    Vector2 gridOrigin = GetMazeGridOrigin(&maze);
+    InitThreadPool(0);
+
+    // Goals are the open cells of an 8x8 block in two opposite corners
+    int cornerCells[2][64];
+    int cornerCounts[2] = { 0, 0 };
+    for (int z = 0; z < 8; z++) {
+        for (int x = 0; x < 8; x++) {
+            cornerCells[0][cornerCounts[0]++] = (1 + z) * mazeSize + 1 + x;
+            cornerCells[1][cornerCounts[1]++] = (mazeSize - 2 - z) * mazeSize + mazeSize - 2 - x;
+        }
+    }
+    printf("crowd: %dx%d maze, radius %.1f, %d steps of 1/60 s, %d threads\n",
+           maze.width, maze.height, CROWD_AGENT_RADIUS, frames, GetThreadPoolSize());
+
+    for (int c = 0; c < countCount; c++) {
+        int count = (argc > 0) ? atoi(argv[c]) : defaultCounts[c];
+        if (count <= 0) continue;
+        MazeCrowd* crowd = CreateMazeCrowd(&maze, count);
+        if (!crowd) continue;
+        double start = BenchNow();
+        AddMazeCrowdGoal(crowd, cornerCells[0], cornerCounts[0]);
+        AddMazeCrowdGoal(crowd, cornerCells[1], cornerCounts[1]);
+        double fieldTime = (BenchNow() - start) / 2.0;
+
+        unsigned int seed = 4242;
+        for (int i = 0; i < count; i++) {
+            int cell = RandomOpenCell(&maze, &seed);
+            seed = seed * 1664525u + 1013904223u;
+            float jitterX = ((seed >> 8) / 16777216.0f - 0.5f) * MAZE_CELL_SIZE * 0.8f;
+            seed = seed * 1664525u + 1013904223u;
+            float jitterZ = ((seed >> 8) / 16777216.0f - 0.5f) * MAZE_CELL_SIZE * 0.8f;
+            Vector2 position = { gridOrigin.x + (cell % mazeSize + 0.5f) * MAZE_CELL_SIZE + jitterX,
+                                 gridOrigin.y + (cell / mazeSize + 0.5f) * MAZE_CELL_SIZE + jitterZ };
+            AddMazeCrowdAgent(crowd, position, i & 1);
+        }
+
+        double total = 0.0, worst = 0.0;
+        int arrivals = 0;
+        for (int f = 0; f < frames; f++) {
+            double frameStart = BenchNow();
+            StepMazeCrowd(crowd, step);
+            double frameTime = BenchNow() - frameStart;
+            total += frameTime;
+            if (frameTime > worst) worst = frameTime;
+            for (int i = 0; i < count; i++) {
+                if (!crowd->arrived[i]) continue;
+                crowd->goals[i] ^= 1;
+                arrivals++;
+            }
+        }
+
+        // Average speed and agents whose center ended up inside a wall
+        double speedSum = 0.0;
+        int inWalls = 0;
+        for (int i = 0; i < count; i++) {
+            speedSum += sqrtf(crowd->velocityX[i] * crowd->velocityX[i] + crowd->velocityZ[i] * crowd->velocityZ[i]);
+            int col = (int)floorf((crowd->positionX[i] - gridOrigin.x) / MAZE_CELL_SIZE);
+            int row = (int)floorf((crowd->positionZ[i] - gridOrigin.y) / MAZE_CELL_SIZE);
+            if (MazeIsWall(&maze, col, row)) inWalls++;
+        }
+        double average = total / frames;
+        printf("  %7d agents : flow field %6.1f ms, %7.3f ms/step (worst %7.3f, %5.1f%% of 60 Hz, %.0f ns/agent), "
+               "speed %.2f, %d arrivals, %d in walls\n",
+               count, fieldTime * 1000.0, average * 1000.0, worst * 1000.0, average / step * 100.0,
+               average * 1e9 / count, speedSum / count, arrivals, inWalls);
+        UnloadMazeCrowd(crowd);
+    }
+    UnloadMaze(&maze);
+    ShutdownThreadPool();
+    return 0;
+}
+
+// Free the arrays of a mesh built without an arena (no GPU buffers to release)
+static void FreeBenchMesh(Mesh mesh) {
+    MemFree(mesh.vertices);
+    MemFree(mesh.texcoords);
+    MemFree(mesh.normals);
+    MemFree(mesh.colors);
+    MemFree(mesh.indices);
+}
+
+// Terrain mesh rebuilds with a fresh MemAlloc per array, from a reset arena and in the existing buffers,
+// then small scratch allocations with malloc/free against an arena reset every frame
+static int BenchArena(int argc, char** argv) {
+    int rebuilds = (argc > 0) ? atoi(argv[0]) : 200;
+    if (rebuilds <= 0) return 1;
+    const float heightScale = 5.0f;
+
+    TerrainData* terrain = (TerrainData*)calloc(1, sizeof(TerrainData));
+    if (!terrain) return 1;
+    terrain->size = TERRAIN_SIZE;
+    terrain->heightMultiplier = 1.0f;
+    for (int z = 0; z < TERRAIN_SIZE; z++) {
+        for (int x = 0; x < TERRAIN_SIZE; x++) {
+            terrain->heights[z][x] = 25.0f + 20.0f * sinf(x * 0.013f) * cosf(z * 0.017f);
+        }
+    }
+    printf("arena: %dx%d terrain mesh rebuilt %d times\n", TERRAIN_MESH_RESOLUTION, TERRAIN_MESH_RESOLUTION, rebuilds);
+
+    double start = BenchNow();
+    for (int i = 0; i < rebuilds; i++) {
+        terrain->heightMultiplier = 1.0f + (i & 7) * 0.1f;
+        FreeBenchMesh(BuildMeshTerrainFromHeightMap(terrain, 0.1f, heightScale, NULL));
+    }
+    double mallocTime = (BenchNow() - start) / rebuilds;
+
+    MemoryArena* arena = CreateArena(0);
+    start = BenchNow();
+    for (int i = 0; i < rebuilds; i++) {
+        terrain->heightMultiplier = 1.0f + (i & 7) * 0.1f;
+        ResetArena(arena);
+        BuildMeshTerrainFromHeightMap(terrain, 0.1f, heightScale, arena);
+    }
+    double arenaTime = (BenchNow() - start) / rebuilds;
+    printf("  MemAlloc per array : %7.3f ms/rebuild, %d allocations\n", mallocTime * 1000.0, 5 * rebuilds);
+    printf("  arena              : %7.3f ms/rebuild, %lld allocations from %lld block mallocs, peak %.1f KB\n",
+           arenaTime * 1000.0, arena->totalAllocs, arena->blockMallocs, arena->peak / 1024.0);
+
+    Mesh mesh = BuildMeshTerrainFromHeightMap(terrain, 0.1f, heightScale, NULL);
+    start = BenchNow();
+    for (int i = 0; i < rebuilds; i++) {
+        terrain->heightMultiplier = 1.0f + (i & 7) * 0.1f;
+        UpdateMeshTerrainFromHeightMap(&mesh, terrain, heightScale);
+    }
+    double inPlaceTime = (BenchNow() - start) / rebuilds;
+    printf("  in place           : %7.3f ms/rebuild, no allocations\n", inPlaceTime * 1000.0);
+    FreeBenchMesh(mesh);
+
+    // Frame scratch: a burst of small allocations of mixed sizes per frame
+    const int allocsPerFrame = 4096;
+    void** pointers = (void**)malloc(allocsPerFrame * sizeof(void*));
+    int frames = 0;
+    start = BenchNow();
+    do {
+        for (int i = 0; i < allocsPerFrame; i++) {
+            pointers[i] = malloc(16 + (i * 37) % 240);
+            memset(pointers[i], i, 16);
+        }
+        for (int i = 0; i < allocsPerFrame; i++) free(pointers[i]);
+        frames++;
+    } while (BenchNow() - start < MIN_BENCH_SECONDS);
+    double mallocAlloc = (BenchNow() - start) / ((double)frames * allocsPerFrame);
+
+    MemoryArena* scratch = CreateArena(0);
+    long long mallocsBefore = scratch->blockMallocs;
+    frames = 0;
+    start = BenchNow();
+    do {
+        ResetArena(scratch);
+        for (int i = 0; i < allocsPerFrame; i++) {
+            pointers[i] = ArenaAlloc(scratch, 16 + (i * 37) % 240);
+            memset(pointers[i], i, 16);
+        }
+        frames++;
+    } while (BenchNow() - start < MIN_BENCH_SECONDS);
+    double arenaAlloc = (BenchNow() - start) / ((double)frames * allocsPerFrame);
+    printf("  scratch, %d allocations per frame: malloc/free %.1f ns, arena %.1f ns (%lld block mallocs over %d frames)\n",
+           allocsPerFrame, mallocAlloc * 1e9, arenaAlloc * 1e9, scratch->blockMallocs - mallocsBefore, frames);
+
+    free(pointers);
+    UnloadArena(scratch);
+    UnloadArena(arena);
+    free(terrain);
+    return 0;
+}
+
+#define BENCH_JOB_BATCH 1024
+
+typedef struct {
+    volatile float* values;
+    int count;
+    int spin;                       // Work per item, item i of the imbalanced loop does i * spin
+} BenchJobWork;
+
+static void EmptyJob(void* context) {
+    (void)context;
+}
+
+// Counts how often it ran, used by the completion benchmark
+static void CountJob(void* context) {
+    (*(int*)context)++;
+}
+
+static void SpinItems(void* context, int start, int end) {
+    BenchJobWork* work = (BenchJobWork*)context;
+    for (int i = start; i < end; i++) {
+        float value = work->values[i];
+        for (int k = 0; k < work->spin; k++) value = value * 0.999f + 0.5f;
+        work->values[i] = value;
+    }
+}
+
+static void SpinImbalanced(void* context, int start, int end) {
+    BenchJobWork* work = (BenchJobWork*)context;
+    for (int i = start; i < end; i++) {
+        float value = work->values[i];
+        for (int k = 0; k < i * work->spin; k++) value = value * 0.999f + 0.5f;
+        work->values[i] = value;
+    }
+}
+
+// ParallelFor started from a worker, whose helper jobs go on that worker's deque for the others to steal
+static void ImbalancedJob(void* context) {
+    BenchJobWork* work = (BenchJobWork*)context;
+    ParallelFor(work->count, 16, SpinImbalanced, work);
+}
+
+// Scheduling overhead of the job system: empty jobs, dependency chains, main-thread completions and
+// ParallelFor against a plain loop across grain sizes and on an imbalanced loop
+static int BenchJobs(int argc, char** argv) {
+    int jobCount = (argc > 0) ? atoi(argv[0]) : 100000;
+    if (jobCount <= 0) return 1;
+
+    InitThreadPool(0);
+    printf("jobs: %d jobs, %d threads\n", jobCount, GetThreadPoolSize());
+    JobStats before = GetJobStats();
+
+    // Independent empty jobs scheduled from this thread in batches, then waited on
+    JobHandle* handles = (JobHandle*)malloc(BENCH_JOB_BATCH * sizeof(JobHandle));
+    double start = BenchNow();
+    for (int done = 0; done < jobCount; done += BENCH_JOB_BATCH) {
+        int batch = (jobCount - done < BENCH_JOB_BATCH) ? jobCount - done : BENCH_JOB_BATCH;
+        for (int i = 0; i < batch; i++) handles[i] = ScheduleJob(EmptyJob, NULL, NULL, 0);
+        for (int i = 0; i < batch; i++) WaitJob(handles[i]);
+    }
+    double emptyTime = (BenchNow() - start) / jobCount;
+
+    // Each job depends on the one before, so every job pays a full hand-off
+    start = BenchNow();
+    JobHandle previous = { 0 };
+    for (int i = 0; i < jobCount; i++) {
+        previous = ScheduleJob(EmptyJob, NULL, &previous, 1);
+        if ((i % BENCH_JOB_BATCH) == BENCH_JOB_BATCH - 1) WaitJob(previous);
+    }
+    WaitJob(previous);
+    double chainTime = (BenchNow() - start) / jobCount;
+
+    // Completions queued by the pool and drained here, as the game loop does
+    int completed = 0;
+    start = BenchNow();
+    for (int done = 0; done < jobCount; done += BENCH_JOB_BATCH) {
+        int batch = (jobCount - done < BENCH_JOB_BATCH) ? jobCount - done : BENCH_JOB_BATCH;
+        for (int i = 0; i < batch; i++) handles[i] = ScheduleJobWithCompletion(EmptyJob, CountJob, &completed, NULL, 0);
+        for (int i = 0; i < batch; i++) WaitJob(handles[i]);
+        RunJobCompletions(0);
+    }
+    double completionTime = (BenchNow() - start) / jobCount;
+    printf("  empty jobs         : %7.1f ns/job\n", emptyTime * 1e9);
+    printf("  dependency chain   : %7.1f ns/job\n", chainTime * 1e9);
+    printf("  with completion    : %7.1f ns/job, %d completions ran\n", completionTime * 1e9, completed);
+    free(handles);
+
+    // ParallelFor over cheap items, where scheduling shows the most
+    const int itemCount = 1 << 20;
+    float* values = (float*)calloc(itemCount, sizeof(float));
+    if (!values) {
+        ShutdownThreadPool();
+        return 1;
+    }
+    BenchJobWork work = { values, itemCount, 16 };
+
+    int runs = 0;
+    start = BenchNow();
+    do {
+        SpinItems(&work, 0, itemCount);
+        runs++;
+    } while (BenchNow() - start < MIN_BENCH_SECONDS);
+    double serialTime = (BenchNow() - start) / runs;
+    printf("  ParallelFor, %d items of %d steps (serial %.2f ms):\n", itemCount, work.spin, serialTime * 1000.0);
+
+    const int grains[] = { 64, 256, 1024, 4096, 16384, 65536 };
+    for (int g = 0; g < (int)(sizeof(grains) / sizeof(grains[0])); g++) {
+        runs = 0;
+        start = BenchNow();
+        do {
+            ParallelFor(itemCount, grains[g], SpinItems, &work);
+            runs++;
+        } while (BenchNow() - start < MIN_BENCH_SECONDS);
+        double time = (BenchNow() - start) / runs;
+        int chunks = (itemCount + grains[g] - 1) / grains[g];
+        printf("    grain %6d : %7.2f ms, %.2fx serial, %d chunks\n", grains[g], time * 1000.0, serialTime / time, chunks);
+    }
+
+    // Cost grows with the index. Run from a job, so the other workers have to steal the helpers.
+    const int imbalancedCount = 4096;
+    BenchJobWork imbalanced = { values, imbalancedCount, 1 };
+    runs = 0;
+    start = BenchNow();
+    do {
+        SpinImbalanced(&imbalanced, 0, imbalancedCount);
+        runs++;
+    } while (BenchNow() - start < MIN_BENCH_SECONDS);
+    double imbalancedSerial = (BenchNow() - start) / runs;
+    JobStats stealBefore = GetJobStats();
+    runs = 0;
+    start = BenchNow();
+    do {
+        WaitJob(ScheduleJob(ImbalancedJob, &imbalanced, NULL, 0));
+        runs++;
+    } while (BenchNow() - start < MIN_BENCH_SECONDS);
+    double imbalancedTime = (BenchNow() - start) / runs;
+    JobStats after = GetJobStats();
+    printf("  imbalanced loop    : serial %.2f ms, ParallelFor %.2f ms (%.2fx), %.1f steals per call\n",
+           imbalancedSerial * 1000.0, imbalancedTime * 1000.0, imbalancedSerial / imbalancedTime,
+           (double)(after.stolen - stealBefore.stolen) / runs);
+    printf("  totals: %lld jobs scheduled, %lld stolen, %lld worker sleeps\n", after.scheduled - before.scheduled,
+           after.stolen - before.stolen, after.sleeps - before.sleeps);
+
+    free(values);
+    ShutdownThreadPool();
+    return 0;
+}
+
+typedef struct {
+    const char* name;
+    const char* usage;
+    int (*run)(int argc, char** argv);
+} BenchmarkCommand;
+
+static const BenchmarkCommand benchmarks[] = {
+    { "lighting", "lighting [vertexCount]", BenchLighting },
+    { "clusters", "clusters [lightCount...]", BenchClusters },
+    { "relight", "relight [floorResolution]", BenchRelight },
+    { "horizon", "horizon [gridSize...]", BenchHorizon },
+    { "pvs", "pvs [mazeSize...]", BenchPvs },
+    { "maze-load", "maze-load [mazeSize...]", BenchMazeLoad },
+    { "collision", "collision [bodyCount...]", BenchCollision },
+    { "path", "path [mazeSize...]", BenchPath },
+    { "crowd", "crowd [agentCount...]", BenchCrowd },
+    { "arena", "arena [rebuilds]", BenchArena },
+    { "jobs", "jobs [jobCount]", BenchJobs },
+};
+static const int benchmarkCount = sizeof(benchmarks) / sizeof(benchmarks[0]);
+
+int main(int argc, char** argv) {
+    SetTraceLogLevel(LOG_WARNING);
+
+    // No arguments: run every benchmark with its defaults
+    if (argc < 2 || strcmp(argv[1], "all") == 0) {
+        for (int i = 0; i < benchmarkCount; i++) {
+            benchmarks[i].run(0, NULL);
+        }
+        return 0;
+    }
+
+    for (int i = 0; i < benchmarkCount; i++) {
+        if (strcmp(argv[1], benchmarks[i].name) == 0) {
+            return benchmarks[i].run(argc - 2, argv + 2);
+        }
+    }
+
+    printf("Usage: %s [all | <benchmark> [args]]\n", argv[0]);
+    for (int i = 0; i < benchmarkCount; i++) {
+        printf("  %s\n", benchmarks[i].usage);
+    }
+    return 1;
+}
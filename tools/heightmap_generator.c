@@ -1,4 +1,5 @@
 #include "raylib.h"
+#include "thread_pool.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <math.h>
@@ -66,17 +67,25 @@ float fbm(float x, float y, int octaves, float persistence, float scale, int see
     return value / maxValue;
 }
 
-// Generate smooth Perlin noise based terrain
-void GenerateIslandHeightMap(unsigned char* heightData) {
-    printf("Generating Perlin noise terrain...\n");
-    
-    float centerX = HEIGHTMAP_SIZE / 2.0f;
-    float centerY = HEIGHTMAP_SIZE / 2.0f;
-    float maxDistance = sqrt(centerX * centerX + centerY * centerY);
-    
-    int seed = rand();
-    
-    for (int y = 0; y < HEIGHTMAP_SIZE; y++) {
+typedef struct {
+    unsigned char* heightData;
+    float centerX;
+    float centerY;
+    float maxDistance;
+    int seed;
+    int rowsDone;
+} HeightMapJob;
+
+// Generate rows [start, end) of the height map
+static void GenerateHeightMapRows(void* context, int start, int end) {
+    HeightMapJob* job = (HeightMapJob*)context;
+    unsigned char* heightData = job->heightData;
+    float centerX = job->centerX;
+    float centerY = job->centerY;
+    float maxDistance = job->maxDistance;
+    int seed = job->seed;
+    
+    for (int y = start; y < end; y++) {
         for (int x = 0; x < HEIGHTMAP_SIZE; x++) {
             int index = y * HEIGHTMAP_SIZE + x;
             
@@ -126,12 +135,27 @@ void GenerateIslandHeightMap(unsigned char* heightData) {
         }
         
         // Progress indicator
-        if (y % 100 == 0) {
-            printf("Progress: %d%%\n", (y * 100) / HEIGHTMAP_SIZE);
+        int rowsDone = __atomic_add_fetch(&job->rowsDone, 1, __ATOMIC_RELAXED);
+        if (rowsDone % 100 == 0) {
+            printf("Progress: %d%%\n", (rowsDone * 100) / HEIGHTMAP_SIZE);
         }
     }
 }
 
+// Generate smooth Perlin noise based terrain, rows are spread over the thread pool
+void GenerateIslandHeightMap(unsigned char* heightData) {
+    printf("Generating Perlin noise terrain on %d threads...\n", GetThreadPoolSize());
+    
+    HeightMapJob job = { 0 };
+    job.heightData = heightData;
+    job.centerX = HEIGHTMAP_SIZE / 2.0f;
+    job.centerY = HEIGHTMAP_SIZE / 2.0f;
+    job.maxDistance = sqrt(job.centerX * job.centerX + job.centerY * job.centerY);
+    job.seed = rand();
+    
+    ParallelFor(HEIGHTMAP_SIZE, 8, GenerateHeightMapRows, &job);
+}
+
 int main(int argc, char* argv[]) {
     printf("Island Height Map Generator\n");
     printf("Generating %dx%d height map...\n", HEIGHTMAP_SIZE, HEIGHTMAP_SIZE);
@@ -154,7 +178,9 @@ int main(int argc, char* argv[]) {
     }
     
     // Generate the height map
+    InitThreadPool(0);
     GenerateIslandHeightMap(heightData);
+    ShutdownThreadPool();
     
     // Create image from height data
     Image heightImage = {
@@ -0,0 +1,120 @@
+#include "raylib.h"
+#include "raymath.h"
+#include "maze.h"
+#include "mesh_generation.h"
+#include "instancing.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+// Renders the maze walls once with a DrawMesh per wall and once through the instanced renderer, then
+// checks that the images match and that the instanced path took a single draw call.
+// Run from the repository root (needs maze.txt and instancing.vs/instancing.fs), e.g. with Mesa llvmpipe:
+//   LIBGL_ALWAYS_SOFTWARE=1 ./tools/instancing_check
+
+#define IMAGE_SIZE 512
+#define MAX_MEAN_DIFFERENCE 0.5f    // Mean absolute difference per channel (0-255)
+#define MAX_BAD_PIXEL_PERCENT 0.1f  // Pixels with any channel off by more than BAD_PIXEL_THRESHOLD
+#define BAD_PIXEL_THRESHOLD 8
+
+// Draw every wall either directly or as instances, returns the number of draw calls
+static int RenderWalls(RenderTexture2D target, Camera3D camera, const Maze* maze, Model wallModel,
+                       InstancedRenderer* renderer, int batch) {
+    int drawCalls = 0;
+    BeginTextureMode(target);
+    ClearBackground(BLACK);
+    BeginMode3D(camera);
+    for (int row = 0; row < maze->height; row++) {
+        for (int col = 0; col < maze->width; col++) {
+            if (!MazeIsWall(maze, col, row)) continue;
+            Matrix transform = MatrixTranslate(-(maze->width * MAZE_CELL_SIZE) / 2.0f + col * MAZE_CELL_SIZE, WALL_HEIGHT / 2.0f,
+                                               -(maze->height * MAZE_CELL_SIZE) / 2.0f + row * MAZE_CELL_SIZE);
+            if (renderer) {
+                AddInstance(renderer, batch, transform);
+            } else {
+                DrawMesh(wallModel.meshes[0], wallModel.materials[0], transform);
+                drawCalls++;
+            }
+        }
+    }
+    if (renderer) drawCalls = FlushInstancedRenderer(renderer, NULL);
+    EndMode3D();
+    EndTextureMode();
+    return drawCalls;
+}
+
+int main(void) {
+    SetTraceLogLevel(LOG_WARNING);
+    SetConfigFlags(FLAG_WINDOW_HIDDEN);
+    InitWindow(IMAGE_SIZE, IMAGE_SIZE, "instancing check");
+    if (!IsWindowReady()) {
+        printf("instancing_check: failed to create a GL context\n");
+        return 2;
+    }
+
+    Maze maze = LoadMazeFromFile("maze.txt");
+    Model wallModel = LoadModelFromMesh(GenMeshMazeWallCubeBase(MAZE_CELL_SIZE));
+    InstancedRenderer* renderer = CreateInstancedRenderer();
+    if (!renderer || !renderer->shaderLoaded) {
+        printf("instancing_check: instancing shader failed to load (run from the repository root)\n");
+        UnloadInstancedRenderer(renderer);
+        UnloadModel(wallModel);
+        UnloadMaze(&maze);
+        CloseWindow();
+        return 2;
+    }
+    int batch = AddInstanceBatch(renderer, wallModel.meshes[0], wallModel.materials[0], WHITE);
+
+    Camera3D camera = { 0 };
+    camera.position = (Vector3){ 0.0f, 180.0f, 160.0f };
+    camera.target = (Vector3){ 0.0f, 0.0f, 0.0f };
+    camera.up = (Vector3){ 0.0f, 1.0f, 0.0f };
+    camera.fovy = 60.0f;
+    camera.projection = CAMERA_PERSPECTIVE;
+
+    RenderTexture2D target = LoadRenderTexture(IMAGE_SIZE, IMAGE_SIZE);
+
+    int directCalls = RenderWalls(target, camera, &maze, wallModel, NULL, batch);
+    Image direct = LoadImageFromTexture(target.texture);
+    int instancedCalls = RenderWalls(target, camera, &maze, wallModel, renderer, batch);
+    Image instanced = LoadImageFromTexture(target.texture);
+
+    Color* a = LoadImageColors(direct);
+    Color* b = LoadImageColors(instanced);
+    double totalDifference = 0.0;
+    int badPixels = 0;
+    int coveredPixels = 0;
+    int pixelCount = IMAGE_SIZE * IMAGE_SIZE;
+    for (int i = 0; i < pixelCount; i++) {
+        int dr = abs(a[i].r - b[i].r);
+        int dg = abs(a[i].g - b[i].g);
+        int db = abs(a[i].b - b[i].b);
+        totalDifference += dr + dg + db;
+        if (dr > BAD_PIXEL_THRESHOLD || dg > BAD_PIXEL_THRESHOLD || db > BAD_PIXEL_THRESHOLD) badPixels++;
+        if (a[i].r || a[i].g || a[i].b) coveredPixels++;
+    }
+    float meanDifference = (float)(totalDifference / (pixelCount * 3.0));
+    float badPercent = 100.0f * badPixels / pixelCount;
+
+    ExportImage(direct, "instancing_direct.png");
+    ExportImage(instanced, "instancing_instanced.png");
+
+    // An empty image would match trivially
+    bool passed = instancedCalls == 1 && coveredPixels > pixelCount / 20 &&
+                  meanDifference <= MAX_MEAN_DIFFERENCE && badPercent <= MAX_BAD_PIXEL_PERCENT;
+    printf("instancing_check: %d walls, draw calls %d direct / %d instanced, mean difference %.2f (max %.2f), "
+           "pixels off by >%d: %.2f%% (max %.2f%%) -> %s\n",
+           renderer->instanceCount, directCalls, instancedCalls, meanDifference, MAX_MEAN_DIFFERENCE,
+           BAD_PIXEL_THRESHOLD, badPercent, MAX_BAD_PIXEL_PERCENT, passed ? "PASS" : "FAIL");
+
+    UnloadImageColors(a);
+    UnloadImageColors(b);
+    UnloadImage(direct);
+    UnloadImage(instanced);
+    UnloadRenderTexture(target);
+    UnloadInstancedRenderer(renderer);
+    UnloadModel(wallModel);
+    UnloadMaze(&maze);
+    CloseWindow();
+
+    return passed ? 0 : 1;
+}
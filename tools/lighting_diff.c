@@ -0,0 +1,198 @@
+#include "raylib.h"
+#include "raymath.h"
+#include "lighting.h"
+#include "rendering.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Renders the same lit scene with baked vertex lighting and with lighting.fs and compares the images.
+// Run from the repository root (needs lighting.vs/lighting.fs), e.g. with Mesa llvmpipe:
+//   LIBGL_ALWAYS_SOFTWARE=1 ./tools/lighting_diff
+
+#define IMAGE_SIZE 512
+#define DENSE_RESOLUTION 160        // Dense enough that per-vertex lighting matches per-pixel closely
+#define MAX_MEAN_DIFFERENCE 3.0f    // Mean absolute difference per channel (0-255)
+#define MAX_BAD_PIXEL_PERCENT 1.0f  // Pixels with any channel off by more than BAD_PIXEL_THRESHOLD
+#define BAD_PIXEL_THRESHOLD 16
+
+// Build a flat res x res grid with one base color (not uploaded)
+static Mesh BuildGrid(Vector3 origin, Vector3 uAxis, Vector3 vAxis, int res, Color baseColor) {
+    Mesh mesh = { 0 };
+    mesh.vertexCount = res * res;
+    mesh.triangleCount = (res - 1) * (res - 1) * 2;
+    mesh.vertices = (float*)MemAlloc(mesh.vertexCount * 3 * sizeof(float));
+    mesh.normals = (float*)MemAlloc(mesh.vertexCount * 3 * sizeof(float));
+    mesh.texcoords = (float*)MemAlloc(mesh.vertexCount * 2 * sizeof(float));
+    mesh.colors = (unsigned char*)MemAlloc(mesh.vertexCount * 4);
+    mesh.indices = (unsigned short*)MemAlloc(mesh.triangleCount * 3 * sizeof(unsigned short));
+
+    Vector3 normal = Vector3Normalize(Vector3CrossProduct(vAxis, uAxis));
+    for (int j = 0; j < res; j++) {
+        for (int i = 0; i < res; i++) {
+            int v = j * res + i;
+            float s = (float)i / (res - 1);
+            float t = (float)j / (res - 1);
+            Vector3 p = Vector3Add(origin, Vector3Add(Vector3Scale(uAxis, s), Vector3Scale(vAxis, t)));
+            mesh.vertices[v * 3] = p.x;
+            mesh.vertices[v * 3 + 1] = p.y;
+            mesh.vertices[v * 3 + 2] = p.z;
+            mesh.normals[v * 3] = normal.x;
+            mesh.normals[v * 3 + 1] = normal.y;
+            mesh.normals[v * 3 + 2] = normal.z;
+            mesh.texcoords[v * 2] = s;
+            mesh.texcoords[v * 2 + 1] = t;
+            memcpy(&mesh.colors[v * 4], &baseColor, 4);
+        }
+    }
+
+    int index = 0;
+    for (int j = 0; j < res - 1; j++) {
+        for (int i = 0; i < res - 1; i++) {
+            int topLeft = j * res + i;
+            mesh.indices[index++] = topLeft;
+            mesh.indices[index++] = topLeft + res;
+            mesh.indices[index++] = topLeft + 1;
+            mesh.indices[index++] = topLeft + 1;
+            mesh.indices[index++] = topLeft + res;
+            mesh.indices[index++] = topLeft + res + 1;
+        }
+    }
+    return mesh;
+}
+
+// Floor and one wall, either CPU lit at high density or left unlit at minimal density
+static void BuildTestModels(Model models[2], const LightingSystem* lighting, const GraphicsConfig* config, bool bakeLighting) {
+    int res = bakeLighting ? DENSE_RESOLUTION : 2;
+    Mesh meshes[2] = {
+        BuildGrid((Vector3){ -50.0f, 0.0f, -50.0f }, (Vector3){ 100.0f, 0.0f, 0.0f }, (Vector3){ 0.0f, 0.0f, 100.0f }, res, (Color){ 100, 150, 100, 255 }),
+        BuildGrid((Vector3){ 50.0f, 0.0f, -20.0f }, (Vector3){ -100.0f, 0.0f, 0.0f }, (Vector3){ 0.0f, 30.0f, 0.0f }, res, (Color){ 140, 70, 70, 255 })
+    };
+
+    for (int i = 0; i < 2; i++) {
+        if (bakeLighting) {
+            LightBlock block = CompileLightBlock(lighting, config);
+            CalculateVertexLightingBatch(meshes[i].vertices, meshes[i].normals, meshes[i].colors, meshes[i].vertexCount,
+                                         (Vector3){ 0.0f, 1.0f, 0.0f }, &block);
+            UnloadLightBlock(&block);
+        }
+        UploadMesh(&meshes[i], false);
+        models[i] = LoadModelFromMesh(meshes[i]);
+    }
+}
+
+static Image RenderTestScene(RenderTexture2D target, Camera3D camera, Model models[2]) {
+    BeginTextureMode(target);
+    ClearBackground(BLACK);
+    BeginMode3D(camera);
+    DrawModel(models[0], Vector3Zero(), 1.0f, WHITE);
+    DrawModel(models[1], Vector3Zero(), 1.0f, WHITE);
+    EndMode3D();
+    EndTextureMode();
+    return LoadImageFromTexture(target.texture);
+}
+
+int main(void) {
+    SetTraceLogLevel(LOG_WARNING);
+    SetConfigFlags(FLAG_WINDOW_HIDDEN);
+    InitWindow(IMAGE_SIZE, IMAGE_SIZE, "lighting diff");
+    if (!IsWindowReady()) {
+        printf("lighting_diff: failed to create a GL context\n");
+        return 2;
+    }
+
+    // Specular is off: the baked path uses a fixed view direction, the shader uses the camera
+    GraphicsConfig config = { 0 };
+    config.advancedShadingEnabled = true;
+    config.specularStrength = 0.0f;
+    config.shininess = 32.0f;
+
+    LightingSystem lighting = InitLightingSystem();
+    AddLight(&lighting, LIGHT_DIRECTIONAL, (Vector3){SUN_POSITION_X, SUN_POSITION_Y, SUN_POSITION_Z},
+             (Vector3){-0.3f, -1.0f, -0.2f}, YELLOW, 1.0f, 1000.0f, 0.0f);
+    AddLight(&lighting, LIGHT_POINT, (Vector3){10.0f, 8.0f, 0.0f}, (Vector3){0.0f, 0.0f, 0.0f},
+             ORANGE, 2.0f, 100.0f, 0.0f);
+    AddLight(&lighting, LIGHT_SPOT, (Vector3){-20.0f, 20.0f, 10.0f}, (Vector3){0.5f, -1.0f, 0.0f},
+             BLUE, 1.5f, 80.0f, 45.0f);
+
+    // A ring of small lights, enough that both paths use the cluster grid
+    for (int i = 0; i < LIGHT_CLUSTER_MIN_LIGHTS; i++) {
+        float angle = i * 2.0f * PI / LIGHT_CLUSTER_MIN_LIGHTS;
+        Color color = (i % 2 == 0) ? GREEN : RED;
+        AddLight(&lighting, LIGHT_POINT, (Vector3){ cosf(angle) * 35.0f, 4.0f, sinf(angle) * 35.0f }, (Vector3){ 0.0f, 0.0f, 0.0f },
+                 color, 1.0f, 12.0f, 0.0f);
+    }
+
+    LightingShader lightingShader = LoadLightingShader();
+    if (!lightingShader.loaded) {
+        printf("lighting_diff: lighting shader failed to load (run from the repository root)\n");
+        UnloadLightingSystem(&lighting);
+        CloseWindow();
+        return 2;
+    }
+
+    Camera3D camera = { 0 };
+    camera.position = (Vector3){ 0.0f, 60.0f, 70.0f };
+    camera.target = (Vector3){ 0.0f, 0.0f, 0.0f };
+    camera.up = (Vector3){ 0.0f, 1.0f, 0.0f };
+    camera.fovy = 60.0f;
+    camera.projection = CAMERA_PERSPECTIVE;
+
+    RenderTexture2D target = LoadRenderTexture(IMAGE_SIZE, IMAGE_SIZE);
+
+    Model bakedModels[2];
+    Model shaderModels[2];
+    BuildTestModels(bakedModels, &lighting, &config, true);
+    BuildTestModels(shaderModels, &lighting, &config, false);
+    for (int i = 0; i < 2; i++) SetLightingShaderMaterial(&lightingShader, &shaderModels[i].materials[0]);
+    UpdateLightingShader(&lightingShader, &lighting, &config, camera.position);
+
+    Image baked = RenderTestScene(target, camera, bakedModels);
+    Image perPixel = RenderTestScene(target, camera, shaderModels);
+
+    // Compare and write a difference image (scaled x8) for inspection
+    Color* a = LoadImageColors(baked);
+    Color* b = LoadImageColors(perPixel);
+    Image diffImage = GenImageColor(IMAGE_SIZE, IMAGE_SIZE, BLACK);
+    double totalDifference = 0.0;
+    int badPixels = 0;
+    int pixelCount = IMAGE_SIZE * IMAGE_SIZE;
+    for (int i = 0; i < pixelCount; i++) {
+        int dr = abs(a[i].r - b[i].r);
+        int dg = abs(a[i].g - b[i].g);
+        int db = abs(a[i].b - b[i].b);
+        totalDifference += dr + dg + db;
+        if (dr > BAD_PIXEL_THRESHOLD || dg > BAD_PIXEL_THRESHOLD || db > BAD_PIXEL_THRESHOLD) badPixels++;
+        Color d = { (unsigned char)(dr * 8 > 255 ? 255 : dr * 8), (unsigned char)(dg * 8 > 255 ? 255 : dg * 8),
+                    (unsigned char)(db * 8 > 255 ? 255 : db * 8), 255 };
+        ImageDrawPixel(&diffImage, i % IMAGE_SIZE, i / IMAGE_SIZE, d);
+    }
+    float meanDifference = (float)(totalDifference / (pixelCount * 3.0));
+    float badPercent = 100.0f * badPixels / pixelCount;
+
+    ExportImage(baked, "lighting_diff_baked.png");
+    ExportImage(perPixel, "lighting_diff_shader.png");
+    ExportImage(diffImage, "lighting_diff.png");
+
+    bool passed = meanDifference <= MAX_MEAN_DIFFERENCE && badPercent <= MAX_BAD_PIXEL_PERCENT;
+    printf("lighting_diff: mean difference %.2f (max %.2f), pixels off by >%d: %.2f%% (max %.2f%%) -> %s\n",
+           meanDifference, MAX_MEAN_DIFFERENCE, BAD_PIXEL_THRESHOLD, badPercent, MAX_BAD_PIXEL_PERCENT,
+           passed ? "PASS" : "FAIL");
+
+    UnloadImageColors(a);
+    UnloadImageColors(b);
+    UnloadImage(diffImage);
+    UnloadImage(baked);
+    UnloadImage(perPixel);
+    for (int i = 0; i < 2; i++) {
+        UnloadModel(bakedModels[i]);
+        UnloadModel(shaderModels[i]);
+    }
+    UnloadRenderTexture(target);
+    UnloadLightingShader(&lightingShader);
+    UnloadLightingSystem(&lighting);
+    CloseWindow();
+
+    return passed ? 0 : 1;
+}
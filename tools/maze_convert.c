@@ -0,0 +1,44 @@
+#include "raylib.h"
+#include "maze.h"
+#include <stdio.h>
+#include <string.h>
+
+// Converts between the ASCII and binary maze formats. The input format is detected from its first
+// bytes, the output is ASCII when its name ends in .txt and binary otherwise:
+//   ./tools/maze_convert maze.txt maze.mazb
+//   ./tools/maze_convert maze.mazb maze.txt
+
+// Size of a file in bytes, -1 when it can't be opened
+static long GetMazeFileSize(const char* filename) {
+    FILE* file = fopen(filename, "rb");
+    if (!file) return -1;
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fclose(file);
+    return size;
+}
+
+int main(int argc, char** argv) {
+    if (argc != 3) {
+        printf("Usage: %s <input maze> <output maze (.txt for ASCII, anything else binary)>\n", argv[0]);
+        return 1;
+    }
+    SetTraceLogLevel(LOG_WARNING);
+
+    Maze maze = LoadMazeFromFile(argv[1]);
+    if (maze.width == 0 || maze.height == 0) {
+        printf("Failed to load %s\n", argv[1]);
+        UnloadMaze(&maze);
+        return 1;
+    }
+
+    size_t nameLength = strlen(argv[2]);
+    bool text = nameLength >= 4 && strcmp(argv[2] + nameLength - 4, ".txt") == 0;
+    bool ok = text ? ExportMazeText(&maze, argv[2]) : ExportMazeBinary(&maze, argv[2]);
+    if (ok) {
+        printf("%s (%ld bytes) -> %s (%ld bytes, %s), %dx%d cells\n", argv[1], GetMazeFileSize(argv[1]), argv[2],
+               GetMazeFileSize(argv[2]), text ? "ASCII" : "binary", maze.width, maze.height);
+    }
+    UnloadMaze(&maze);
+    return ok ? 0 : 1;
+}